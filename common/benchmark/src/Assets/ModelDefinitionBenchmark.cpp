@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "Assets/ModelDefinition.h"
+#include "BenchmarkUtils.h"
+#include "EL/Value.h"
+#include "EL/VariableStore.h"
+#include "IO/ELParser.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace Assets {
+static constexpr size_t NumEntities = 100'000;
+
+namespace {
+/**
+ * Creates variable stores similar to the properties of point entities, where the model
+ * expression depends on the given property.
+ */
+std::vector<EL::VariableTable> makeVariableStores(const std::string &key, const size_t numValues) {
+    auto result = std::vector<EL::VariableTable>{};
+    result.reserve(NumEntities);
+
+    for (size_t i = 0; i < NumEntities; ++i) {
+        result.emplace_back(std::map<std::string, EL::Value>{
+            {"classname", EL::Value{"item_armor"}},
+            {"origin", EL::Value{std::to_string(i) + " " + std::to_string(2 * i) + " 64"}},
+            {"angle", EL::Value{"90"}},
+            {key, EL::Value{std::to_string(i % numValues)}},
+        });
+    }
+
+    return result;
+}
+
+void evaluate(const ModelDefinition &definition, const std::vector<EL::VariableTable> &stores, const std::string &message) {
+    auto skinIndexSum = size_t(0);
+    timeLambda([&]() {
+        for (const auto &store : stores) {
+            skinIndexSum += definition.modelSpecification(store).skinIndex;
+        }
+    }, message);
+    CHECK(skinIndexSum > 0);
+}
+} // namespace
+
+TEST_CASE("ModelDefinitionBenchmark.modelSpecification") {
+    const auto definition = ModelDefinition{IO::ELParser::parseStrict(R"({{
+        spawnflags & 2 -> { "path": "progs/armor.mdl", "skin": 1 },
+        spawnflags & 4 -> { "path": "progs/armor.mdl", "skin": 2 },
+                          { "path": "progs/armor.mdl", "skin": 0 }
+    }})")};
+
+    evaluate(definition, makeVariableStores("spawnflags", 8), "evaluate model expression for " + std::to_string(NumEntities) + " entities with 8 distinct spawnflags");
+}
+
+TEST_CASE("ModelDefinitionBenchmark.modelSpecificationWithDistinctValues") {
+    const auto definition = ModelDefinition{IO::ELParser::parseStrict(R"({ "path": "progs/player.mdl", "skin": skin })")};
+
+    evaluate(definition, makeVariableStores("skin", NumEntities), "evaluate model expression for " + std::to_string(NumEntities) + " entities with distinct skins");
+}
+} // namespace Assets
+} // namespace TrenchBroom
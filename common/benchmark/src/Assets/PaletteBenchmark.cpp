@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "Assets/Palette.h"
+#include "Assets/TextureBuffer.h"
+#include "BenchmarkUtils.h"
+#include "Color.h"
+#include "Error.h"
+#include "IO/Reader.h"
+
+#include <kdl/result.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace Assets {
+static constexpr size_t TextureSize = 256;
+static constexpr size_t NumTextures = 2'000;
+
+TEST_CASE("PaletteBenchmark.indexedToRgba") {
+    auto rng = std::mt19937{};
+    auto byte = std::uniform_int_distribution<int>{0, 255};
+
+    auto paletteData = std::vector<unsigned char>(768);
+    for (auto &value : paletteData) {
+        value = static_cast<unsigned char>(byte(rng));
+    }
+    const auto palette = makePalette(paletteData, PaletteColorFormat::Rgb).value();
+
+    constexpr auto pixelCount = TextureSize * TextureSize;
+    auto indices = std::vector<char>(pixelCount);
+    for (auto &index : indices) {
+        index = static_cast<char>(byte(rng));
+    }
+
+    const auto transparency = GENERATE(PaletteTransparency::Opaque, PaletteTransparency::Index255Transparent);
+
+    auto rgbaImage = TextureBuffer{4 * pixelCount};
+    auto averageColor = Color{};
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumTextures; ++i) {
+            auto reader = IO::Reader::from(indices.data(), indices.data() + indices.size());
+            palette.indexedToRgba(reader, pixelCount, rgbaImage, transparency, averageColor);
+        }
+    }, "convert " + std::to_string(NumTextures) + " textures with " + (transparency == PaletteTransparency::Opaque ? "an opaque" : "a transparent") + " palette");
+    const auto seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    printf("%.1f megapixels/s\n", double(NumTextures * pixelCount) / seconds / 1'000'000.0);
+}
+} // namespace Assets
+} // namespace TrenchBroom
@@ -0,0 +1,71 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapGenerator.h"
+
+#include <fmt/format.h>
+
+#include <iterator>
+
+namespace TrenchBroom {
+namespace IO {
+static void appendBrush(fmt::memory_buffer &buffer, const size_t index) {
+    // lay the brushes out on a 64 x 64 grid of 32 unit cells
+    const auto x0 = static_cast<int>(index % 64) * 32 - 1024;
+    const auto y0 = static_cast<int>((index / 64) % 64) * 32 - 1024;
+    const auto z0 = static_cast<int>(index / 4096) * 32 - 1024;
+    const auto x1 = x0 + 24, y1 = y0 + 24, z1 = z0 + 24;
+    const auto offset = static_cast<double>(index % 16) * 0.25;
+
+    auto out = std::back_inserter(buffer);
+    fmt::format_to(out, "{{\n");
+    fmt::format_to(out, "( {} {} {} ) ( {} {} {} ) ( {} {} {} ) tex{} [ 0 -1 0 {} ] [ 0 0 -1 0 ] 0 1 1\n", x0, y0, z0, x0, y0 + 1, z0, x0, y0, z0 + 1, index % 32, offset);
+    fmt::format_to(out, "( {} {} {} ) ( {} {} {} ) ( {} {} {} ) tex{} [ 1 0 0 {} ] [ 0 0 -1 0 ] 0 1 1\n", x0, y0, z0, x0, y0, z0 + 1, x0 + 1, y0, z0, index % 32, offset);
+    fmt::format_to(out, "( {} {} {} ) ( {} {} {} ) ( {} {} {} ) tex{} [ -1 0 0 {} ] [ 0 -1 0 0 ] 0 1 1\n", x0, y0, z0, x0 + 1, y0, z0, x0, y0 + 1, z0, index % 32, offset);
+    fmt::format_to(out, "( {} {} {} ) ( {} {} {} ) ( {} {} {} ) tex{} [ 1 0 0 {} ] [ 0 -1 0 0 ] 0 1 1\n", x1, y1, z1, x1, y1 + 1, z1, x1 + 1, y1, z1, index % 32, offset);
+    fmt::format_to(out, "( {} {} {} ) ( {} {} {} ) ( {} {} {} ) tex{} [ -1 0 0 {} ] [ 0 0 -1 0 ] 0 1 1\n", x1, y1, z1, x1 + 1, y1, z1, x1, y1, z1 + 1, index % 32, offset);
+    fmt::format_to(out, "( {} {} {} ) ( {} {} {} ) ( {} {} {} ) tex{} [ 0 1 0 {} ] [ 0 0 -1 0 ] 0 1 1\n", x1, y1, z1, x1, y1, z1 + 1, x1, y1 + 1, z1, index % 32, offset);
+    fmt::format_to(out, "}}\n");
+}
+
+std::string generateValveMap(const size_t entityCount, const size_t brushesPerEntity) {
+    auto buffer = fmt::memory_buffer{};
+    auto out = std::back_inserter(buffer);
+
+    fmt::format_to(out, "// Game: Quake\n// Format: Valve\n");
+
+    size_t brushIndex = 0;
+    for (size_t i = 0; i <= entityCount; ++i) {
+        fmt::format_to(out, "// entity {}\n{{\n", i);
+        if (i == 0) {
+            fmt::format_to(out, "\"classname\" \"worldspawn\"\n\"mapversion\" \"220\"\n");
+        } else {
+            fmt::format_to(out, "\"classname\" \"func_wall\"\n\"targetname\" \"wall{}\"\n", i);
+        }
+        for (size_t j = 0; j < brushesPerEntity; ++j) {
+            fmt::format_to(out, "// brush {}\n", j);
+            appendBrush(buffer, brushIndex++);
+        }
+        fmt::format_to(out, "}}\n");
+    }
+
+    return fmt::to_string(buffer);
+}
+} // namespace IO
+} // namespace TrenchBroom
@@ -0,0 +1,38 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace TrenchBroom {
+namespace IO {
+/**
+ * Generates a Valve 220 map containing a worldspawn and the given number of additional brush entities.
+ * Every entity contains the given number of axis aligned cuboid brushes with non-integer texture offsets,
+ * which makes the result suitable for measuring the throughput of the map parser on large inputs.
+ *
+ * @param entityCount the number of brush entities in addition to the worldspawn
+ * @param brushesPerEntity the number of brushes per entity, including the worldspawn
+ * @return the map source
+ */
+std::string generateValveMap(size_t entityCount, size_t brushesPerEntity);
+} // namespace IO
+} // namespace TrenchBroom
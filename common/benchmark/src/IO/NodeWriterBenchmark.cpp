@@ -0,0 +1,100 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "IO/MapFileSerializer.h"
+#include "IO/MapGenerator.h"
+#include "IO/NodeWriter.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include <vm/bbox.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace TrenchBroom {
+namespace IO {
+static constexpr size_t NumEntities = 100;
+static constexpr size_t NumBrushesPerEntity = 600;
+
+TEST_CASE("NodeWriterBenchmark.writeMap") {
+    const auto map = generateValveMap(NumEntities, NumBrushesPerEntity);
+    const auto worldBounds = vm::bbox3{8192.0};
+
+    auto status = TestParserStatus{};
+    auto reader = WorldReader{map, Model::MapFormat::Valve, {}};
+    const auto world = reader.read(worldBounds, status);
+    REQUIRE(world != nullptr);
+
+    const auto brushCount = std::to_string((NumEntities + 1) * NumBrushesPerEntity);
+
+    auto str = std::stringstream{};
+    timeLambda([&]() {
+        auto writer = NodeWriter{*world, str};
+        writer.writeMap();
+    }, "write " + brushCount + " brushes to a string stream");
+    CHECK(str.str().size() > map.size() / 2);
+
+    const auto path = std::filesystem::temp_directory_path() / "NodeWriterBenchmark.map";
+    timeLambda([&]() {
+        auto stream = std::ofstream{path, std::ios::out};
+        auto writer = NodeWriter{*world, stream};
+        writer.writeMap();
+    }, "write " + brushCount + " brushes to a file");
+    CHECK(std::filesystem::file_size(path) == str.str().size());
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("NodeWriterBenchmark.deferWriteMap") {
+    // autosaves serialize all but the brush faces on the main thread and write them on a
+    // worker thread
+    const auto map = generateValveMap(NumEntities, NumBrushesPerEntity);
+    const auto worldBounds = vm::bbox3{8192.0};
+
+    auto status = TestParserStatus{};
+    auto reader = WorldReader{map, Model::MapFormat::Valve, {}};
+    const auto world = reader.read(worldBounds, status);
+    REQUIRE(world != nullptr);
+
+    const auto brushCount = std::to_string((NumEntities + 1) * NumBrushesPerEntity);
+
+    auto deferredStr = std::stringstream{};
+    auto writeDeferred = MapFileSerializer::DeferredWriter{};
+    timeLambda([&]() {
+        auto [serializer, writer] = MapFileSerializer::createDeferred(world->mapFormat(), deferredStr);
+        NodeWriter{*world, std::move(serializer)}.writeMap();
+        writeDeferred = std::move(writer);
+    }, "copy the faces of " + brushCount + " brushes");
+
+    auto str = std::stringstream{};
+    timeLambda([&]() { writeDeferred(deferredStr.str(), str); }, "write " + brushCount + " copied brushes to a string stream");
+
+    auto expected = std::stringstream{};
+    NodeWriter{*world, expected}.writeMap();
+    CHECK(str.str() == expected.str());
+}
+} // namespace IO
+} // namespace TrenchBroom
@@ -0,0 +1,111 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "IO/MapGenerator.h"
+#include "IO/StandardMapParser.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/EntityProperties.h"
+#include "Model/MapFormat.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/thread_pool.h"
+
+#include <vm/bbox.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace IO {
+static constexpr size_t NumEntities = 100;
+static constexpr size_t NumBrushesPerEntity = 600;
+
+TEST_CASE("StandardMapParserBenchmark.tokenizeNumbers") {
+    const auto map = generateValveMap(NumEntities, NumBrushesPerEntity);
+
+    size_t tokenCount = 0;
+    size_t numberCount = 0;
+    double sum = 0.0;
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    auto tokenizer = QuakeMapTokenizer{map};
+    for (auto token = tokenizer.nextToken(); token.type() != QuakeMapToken::Eof; token = tokenizer.nextToken()) {
+        ++tokenCount;
+        if (token.hasType(QuakeMapToken::Number)) {
+            ++numberCount;
+            sum += token.toFloat<double>();
+        }
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    const auto seconds = std::chrono::duration<double>(end - start).count();
+    printf("Tokenized %zu tokens (%zu numbers, checksum %f) of a %zu byte map in %fms: %.2f million tokens/sec\n", tokenCount, numberCount, sum, map.size(), seconds * 1000.0, static_cast<double>(tokenCount) / seconds / 1'000'000.0);
+}
+
+TEST_CASE("StandardMapParserBenchmark.readWorld") {
+    const auto map = generateValveMap(NumEntities, NumBrushesPerEntity);
+    const auto worldBounds = vm::bbox3{8192.0};
+
+    auto status = TestParserStatus{};
+    auto reader = WorldReader{map, Model::MapFormat::Valve, {}};
+
+    std::unique_ptr<Model::WorldNode> world;
+    timeLambda([&]() { world = reader.read(worldBounds, status); }, "read " + std::to_string((NumEntities + 1) * NumBrushesPerEntity) + " brushes from a " + std::to_string(map.size()) + " byte map");
+
+    CHECK(world != nullptr);
+}
+
+TEST_CASE("StandardMapParserBenchmark.readWorldScaling") {
+    const auto map = generateValveMap(NumEntities, NumBrushesPerEntity);
+    const auto worldBounds = vm::bbox3{8192.0};
+
+    const auto maxThreadCount = kdl::thread_pool::global().thread_count() + 1;
+    auto threadCounts = std::vector<size_t>{};
+    for (size_t threadCount = 1; threadCount < maxThreadCount; threadCount *= 2) {
+        threadCounts.push_back(threadCount);
+    }
+    threadCounts.push_back(maxThreadCount);
+
+    // only parsing is limited to the given number of threads, nodes are always created on all
+    // threads
+    auto sequentialSeconds = 0.0;
+    for (const auto threadCount : threadCounts) {
+        auto status = TestParserStatus{};
+        auto reader = WorldReader{map, Model::MapFormat::Valve, {}};
+        reader.setMaxThreadCount(threadCount);
+
+        const auto start = std::chrono::high_resolution_clock::now();
+        auto world = reader.read(worldBounds, status);
+        const auto end = std::chrono::high_resolution_clock::now();
+        CHECK(world != nullptr);
+
+        const auto seconds = std::chrono::duration<double>(end - start).count();
+        if (threadCount == 1) {
+            sequentialSeconds = seconds;
+        }
+        printf("Read a %zu byte map with %zu thread(s) in %fms: %.2fx\n", map.size(), threadCount, seconds * 1000.0, sequentialSeconds / seconds);
+    }
+}
+} // namespace IO
+} // namespace TrenchBroom
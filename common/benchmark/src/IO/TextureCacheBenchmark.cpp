@@ -0,0 +1,206 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "BenchmarkUtils.h"
+#include "IO/File.h"
+#include "IO/ImageLoaderImpl.h"
+#include "IO/ReadFreeImageTexture.h"
+#include "IO/ReadMipTexture.h"
+#include "IO/Reader.h"
+#include "IO/TextureCache.h"
+
+#include <kdl/resource.h>
+#include <kdl/result.h>
+
+#include <FreeImage.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace IO {
+static constexpr size_t NumTextures = 500;
+static constexpr int32_t TextureSize = 128;
+static constexpr size_t NumImages = 50;
+static constexpr unsigned ImageSize = 512;
+
+namespace {
+void writeInt(char *&cursor, const int32_t value) {
+    std::memcpy(cursor, &value, sizeof(value));
+    cursor += sizeof(value);
+}
+
+/**
+ * Creates a Quake mip texture with four mip levels and noisy contents.
+ */
+std::shared_ptr<File> makeMipTextureFile(const size_t index) {
+    constexpr auto HeaderSize = 16 + 6 * sizeof(int32_t);
+
+    auto mipSizes = std::vector<size_t>{};
+    auto size = HeaderSize;
+    for (size_t level = 0; level < 4; ++level) {
+        mipSizes.push_back(size_t((TextureSize >> level) * (TextureSize >> level)));
+        size += mipSizes.back();
+    }
+
+    auto buffer = std::make_unique<char[]>(size);
+    auto *cursor = buffer.get();
+    std::memset(cursor, 0, 16);
+    cursor += 16;
+    writeInt(cursor, TextureSize);
+    writeInt(cursor, TextureSize);
+
+    auto offset = HeaderSize;
+    for (const auto mipSize : mipSizes) {
+        writeInt(cursor, int32_t(offset));
+        offset += mipSize;
+    }
+
+    for (size_t i = HeaderSize; i < size; ++i) {
+        buffer[i] = static_cast<char>((i * 31 + index * 17) % 251);
+    }
+
+    return std::make_shared<OwningBufferFile>(std::move(buffer), size);
+}
+
+/**
+ * Creates a PNG file with smooth gradients and some noise.
+ */
+std::shared_ptr<File> makePngFile(const size_t index) {
+    InitFreeImage::initialize();
+
+    auto image = kdl::resource{FreeImage_Allocate(ImageSize, ImageSize, 32), FreeImage_Unload};
+    for (unsigned y = 0; y < ImageSize; ++y) {
+        auto *line = FreeImage_GetScanLine(*image, int(y));
+        for (unsigned x = 0; x < ImageSize; ++x) {
+            const auto noise = (x * 7 + y * 13 + index) % 5;
+            line[x * 4 + FI_RGBA_RED] = static_cast<BYTE>(x / 2 + noise);
+            line[x * 4 + FI_RGBA_GREEN] = static_cast<BYTE>(y / 2 + noise);
+            line[x * 4 + FI_RGBA_BLUE] = static_cast<BYTE>((x + y + index) / 4);
+            line[x * 4 + FI_RGBA_ALPHA] = 255;
+        }
+    }
+
+    auto memory = kdl::resource{FreeImage_OpenMemory(), FreeImage_CloseMemory};
+    REQUIRE(FreeImage_SaveToMemory(FIF_PNG, *image, *memory));
+
+    BYTE *data = nullptr;
+    DWORD size = 0;
+    REQUIRE(FreeImage_AcquireMemory(*memory, &data, &size));
+
+    auto buffer = std::make_unique<char[]>(size);
+    std::memcpy(buffer.get(), data, size);
+    return std::make_shared<OwningBufferFile>(std::move(buffer), size);
+}
+} // namespace
+
+TEST_CASE("TextureCacheBenchmark.loadMipTextures") {
+    auto paletteData = std::vector<unsigned char>(768);
+    for (size_t i = 0; i < paletteData.size(); ++i) {
+        paletteData[i] = static_cast<unsigned char>(i);
+    }
+    const auto palette = Assets::makePalette(paletteData, Assets::PaletteColorFormat::Rgb).value();
+
+    auto files = std::vector<std::shared_ptr<File>>{};
+    auto paths = std::vector<std::filesystem::path>{};
+    for (size_t i = 0; i < NumTextures; ++i) {
+        files.push_back(makeMipTextureFile(i));
+        paths.push_back("texture" + std::to_string(i) + ".D");
+    }
+
+    const auto cacheDir = std::filesystem::temp_directory_path() / "TextureCacheBenchmark";
+    std::filesystem::remove_all(cacheDir);
+    auto cache = TextureCache{cacheDir};
+
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumTextures; ++i) {
+            auto reader = files[i]->reader().buffer();
+            const auto texture = readIdMipTexture(paths[i].stem().string(), reader, palette).value();
+            REQUIRE(cache.store(makeTextureCacheKey(paths[i], 0, *files[i], palette), texture).is_success());
+        }
+    }, "decode and store " + std::to_string(NumTextures) + " mip textures");
+
+    auto decoded = size_t(0);
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumTextures; ++i) {
+            auto reader = files[i]->reader().buffer();
+            if (readIdMipTexture(paths[i].stem().string(), reader, palette).is_success()) {
+                ++decoded;
+            }
+        }
+    }, "decode " + std::to_string(NumTextures) + " mip textures");
+    CHECK(decoded == NumTextures);
+
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumTextures; ++i) {
+            cache.load(makeTextureCacheKey(paths[i], 0, *files[i], palette));
+        }
+    }, "hash and load " + std::to_string(NumTextures) + " mip textures from the cache");
+    CHECK(cache.hits() == NumTextures);
+
+    std::filesystem::remove_all(cacheDir);
+}
+
+TEST_CASE("TextureCacheBenchmark.loadPngTextures") {
+    auto files = std::vector<std::shared_ptr<File>>{};
+    auto paths = std::vector<std::filesystem::path>{};
+    for (size_t i = 0; i < NumImages; ++i) {
+        files.push_back(makePngFile(i));
+        paths.push_back("textures/texture" + std::to_string(i) + ".png");
+    }
+
+    const auto cacheDir = std::filesystem::temp_directory_path() / "TextureCacheBenchmark";
+    std::filesystem::remove_all(cacheDir);
+    auto cache = TextureCache{cacheDir};
+
+    auto decoded = size_t(0);
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumImages; ++i) {
+            auto reader = files[i]->reader().buffer();
+            if (readFreeImageTexture(paths[i].stem().string(), reader).is_success()) {
+                ++decoded;
+            }
+        }
+    }, "decode " + std::to_string(NumImages) + " png textures");
+    CHECK(decoded == NumImages);
+
+    for (size_t i = 0; i < NumImages; ++i) {
+        auto reader = files[i]->reader().buffer();
+        const auto texture = readFreeImageTexture(paths[i].stem().string(), reader).value();
+        REQUIRE(cache.store(makeTextureCacheKey(paths[i], 9, *files[i], std::nullopt), texture).is_success());
+    }
+
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumImages; ++i) {
+            cache.load(makeTextureCacheKey(paths[i], 9, *files[i], std::nullopt));
+        }
+    }, "hash and load " + std::to_string(NumImages) + " png textures from the cache");
+    CHECK(cache.hits() == NumImages);
+
+    std::filesystem::remove_all(cacheDir);
+}
+} // namespace IO
+} // namespace TrenchBroom
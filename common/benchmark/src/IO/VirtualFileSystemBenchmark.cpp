@@ -0,0 +1,126 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "IO/File.h"
+#include "IO/ImageFileSystem.h"
+#include "IO/PathInfo.h"
+#include "IO/VirtualFileSystem.h"
+
+#include <kdl/result.h>
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace IO {
+static constexpr size_t NumMounts = 50;
+static constexpr size_t NumFilesPerMount = 500;
+static constexpr size_t NumLookups = 1'000'000;
+
+namespace {
+/**
+ * Simulates a package file. Every package contains some files of its own and overrides
+ * some files of the packages that were mounted before it.
+ */
+class SyntheticFileSystem : public ImageFileSystemBase {
+  private:
+    size_t m_index;
+    std::shared_ptr<File> m_file;
+
+  public:
+    explicit SyntheticFileSystem(const size_t index) : m_index{index}, m_file{std::make_shared<ObjectFile<size_t>>(index)} {
+    }
+
+  private:
+    Result<void> doReadDirectory() override {
+        for (size_t i = 0; i < NumFilesPerMount; ++i) {
+            // half of the files are shared with the other packages
+            const auto dir = i % 2 == 0 ? std::string{"common"} : "pak" + std::to_string(m_index);
+            addFile("textures/" + dir + "/Texture" + std::to_string(i) + ".wal", [file = m_file]() { return Result<std::shared_ptr<File>>{file}; });
+        }
+        return Result<void>{};
+    }
+};
+
+std::vector<std::filesystem::path> makeLookupPaths(std::mt19937 &rng) {
+    auto mount = std::uniform_int_distribution<size_t>{0, NumMounts};
+    auto file = std::uniform_int_distribution<size_t>{0, NumFilesPerMount - 1};
+
+    auto result = std::vector<std::filesystem::path>{};
+    result.reserve(NumLookups);
+    for (size_t i = 0; i < NumLookups; ++i) {
+        // mount index NumMounts yields paths that do not exist, and the lookups use a different case
+        const auto m = mount(rng);
+        const auto f = file(rng);
+        const auto dir = f % 2 == 0 ? std::string{"COMMON"} : "PAK" + std::to_string(m);
+        result.emplace_back("Textures/" + dir + "/texture" + std::to_string(f) + ".WAL");
+    }
+    return result;
+}
+
+void printLookupsPerSecond(const std::chrono::high_resolution_clock::time_point start, const std::string &message) {
+    const auto end = std::chrono::high_resolution_clock::now();
+    const auto seconds = std::chrono::duration<double>(end - start).count();
+    printf("%s: %.0f lookups/s\n", message.c_str(), double(NumLookups) / seconds);
+}
+} // namespace
+
+TEST_CASE("VirtualFileSystemBenchmark.lookup") {
+    auto vfs = VirtualFileSystem{};
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumMounts; ++i) {
+            auto fs = createImageFileSystem<SyntheticFileSystem>(i);
+            REQUIRE(fs.is_success());
+            vfs.mount("", std::move(fs).value());
+        }
+    }, "mount " + std::to_string(NumMounts) + " file systems");
+
+    auto rng = std::mt19937{};
+    const auto paths = makeLookupPaths(rng);
+
+    auto numFiles = size_t(0);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto &path : paths) {
+        if (vfs.pathInfo(path) == PathInfo::File) {
+            ++numFiles;
+        }
+    }
+    printLookupsPerSecond(start, "pathInfo");
+
+    auto numOpened = size_t(0);
+    start = std::chrono::high_resolution_clock::now();
+    for (const auto &path : paths) {
+        if (vfs.openFile(path).is_success()) {
+            ++numOpened;
+        }
+    }
+    printLookupsPerSecond(start, "openFile");
+
+    CHECK(numFiles > 0);
+    CHECK(numOpened == numFiles);
+}
+} // namespace IO
+} // namespace TrenchBroom
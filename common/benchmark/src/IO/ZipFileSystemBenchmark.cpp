@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/ZipFileSystem.h"
+
+#include <kdl/parallel.h>
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <miniz/miniz.h>
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace IO {
+static constexpr size_t NumTextures = 2'000;
+static constexpr size_t TextureSize = 128 * 128;
+
+namespace {
+/**
+ * Writes a pk3 file containing NumTextures textures with noisy, but compressible
+ * contents, similar to paletted textures.
+ */
+void writePk3(const std::filesystem::path &path) {
+    auto rng = std::mt19937{};
+    auto noise = std::uniform_int_distribution<int>{0, 3};
+
+    auto archive = mz_zip_archive{};
+    mz_zip_zero_struct(&archive);
+    REQUIRE(mz_zip_writer_init_file(&archive, path.string().c_str(), 0));
+
+    auto data = std::vector<unsigned char>(TextureSize);
+    for (size_t i = 0; i < NumTextures; ++i) {
+        for (size_t j = 0; j < TextureSize; ++j) {
+            data[j] = static_cast<unsigned char>((i + j / 64) % 256 + size_t(noise(rng)));
+        }
+        const auto name = "textures/base/texture" + std::to_string(i) + ".tga";
+        REQUIRE(mz_zip_writer_add_mem(&archive, name.c_str(), data.data(), data.size(), MZ_DEFAULT_COMPRESSION));
+    }
+
+    REQUIRE(mz_zip_writer_finalize_archive(&archive));
+    REQUIRE(mz_zip_writer_end(&archive));
+}
+} // namespace
+
+TEST_CASE("ZipFileSystemBenchmark.extract") {
+    const auto path = std::filesystem::temp_directory_path() / "ZipFileSystemBenchmark.pk3";
+    writePk3(path);
+
+    const auto fs = Disk::openFile(path).and_then([](auto file) { return createImageFileSystem<ZipFileSystem>(std::move(file)); }).value();
+
+    auto paths = std::vector<std::filesystem::path>{};
+    for (size_t i = 0; i < NumTextures; ++i) {
+        paths.push_back("textures/base/texture" + std::to_string(i) + ".tga");
+    }
+
+    const auto extract = [&](const std::filesystem::path &texturePath) { return fs->openFile(texturePath).value()->size(); };
+
+    auto sizes = std::vector<size_t>{};
+    timeLambda([&]() { sizes = kdl::vec_transform(paths, extract); }, "extract " + std::to_string(NumTextures) + " textures on one thread");
+    CHECK(sizes == std::vector<size_t>(NumTextures, TextureSize));
+
+    timeLambda([&]() { sizes = kdl::vec_parallel_transform(paths, extract); }, "extract " + std::to_string(NumTextures) + " textures in parallel");
+    CHECK(sizes == std::vector<size_t>(NumTextures, TextureSize));
+
+    std::filesystem::remove(path);
+}
+} // namespace IO
+} // namespace TrenchBroom
@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Error.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/MapFormat.h"
+#include "Model/Polyhedron.h"
+
+#include <kdl/result.h>
+
+#include <vm/bbox.h>
+#include <vm/vec.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace Model {
+static constexpr size_t NumBrushes = 20'000;
+static constexpr size_t NumHulls = 5'000;
+static constexpr size_t NumIntersectingHulls = 200;
+
+static std::vector<Brush> makeBrushes(const vm::bbox3 &worldBounds) {
+    const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+    auto result = std::vector<Brush>{};
+    result.reserve(NumBrushes);
+    for (size_t i = 0; i < NumBrushes; ++i) {
+        // alternate between cubes and cylinders so that the brushes have different topologies
+        if (i % 2 == 0) {
+            result.push_back(builder.createCube(64.0, "").value());
+        } else {
+            result.push_back(builder.createCylinder(vm::bbox3{{-32, -32, -32}, {32, 32, 32}}, 12, RadiusMode::ToEdge, vm::axis::z, "").value());
+        }
+    }
+    return result;
+}
+
+TEST_CASE("BrushBenchmark.updateGeometryFromFaces") {
+    const auto worldBounds = vm::bbox3{8192.0};
+
+    auto brushes = std::vector<Brush>{};
+    timeLambda([&]() { brushes = makeBrushes(worldBounds); }, "create " + std::to_string(NumBrushes) + " brushes");
+
+    // Brush::create calls Brush::updateGeometryFromFaces
+    timeLambda([&]() {
+        for (auto &brush : brushes) {
+            brush = Brush::create(worldBounds, brush.faces()).value();
+        }
+    }, "update the geometry of " + std::to_string(NumBrushes) + " brushes");
+
+    auto copies = std::vector<Brush>{};
+    timeLambda([&]() { copies = brushes; }, "copy " + std::to_string(NumBrushes) + " brushes");
+
+    timeLambda([&]() {
+        copies.clear();
+        brushes.clear();
+    }, "destroy " + std::to_string(2 * NumBrushes) + " brushes");
+}
+
+TEST_CASE("BrushBenchmark.convexHull") {
+    auto points = std::vector<vm::vec3>{};
+    for (size_t i = 0; i < 24; ++i) {
+        const auto angle = vm::Cd::two_pi() * FloatType(i) / FloatType(24);
+        points.emplace_back(std::cos(angle) * 64.0, std::sin(angle) * 64.0, -64.0);
+        points.emplace_back(std::cos(angle) * 32.0, std::sin(angle) * 32.0, 64.0);
+    }
+
+    auto numVertices = size_t(0);
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumHulls; ++i) {
+            numVertices += Polyhedron3{points}.vertexCount();
+        }
+    }, "build the convex hull of " + std::to_string(points.size()) + " points " + std::to_string(NumHulls) + " times");
+
+    CHECK(numVertices == NumHulls * points.size());
+}
+
+TEST_CASE("BrushBenchmark.intersects") {
+    auto rng = std::mt19937{1};
+    auto center = std::uniform_real_distribution<FloatType>{-64.0, 64.0};
+    auto direction = std::normal_distribution<FloatType>{};
+
+    // convex hulls of random points on spheres, many of which overlap
+    auto hulls = std::vector<Polyhedron3>{};
+    hulls.reserve(NumIntersectingHulls);
+    for (size_t i = 0; i < NumIntersectingHulls; ++i) {
+        const auto c = vm::vec3{center(rng), center(rng), center(rng)};
+        auto points = std::vector<vm::vec3>{};
+        for (size_t j = 0; j < 16; ++j) {
+            points.push_back(c + 32.0 * vm::normalize(vm::vec3{direction(rng), direction(rng), direction(rng)}));
+        }
+        hulls.emplace_back(std::move(points));
+    }
+
+    auto numIntersections = size_t(0);
+    timeLambda([&]() {
+        for (const auto &lhs : hulls) {
+            for (const auto &rhs : hulls) {
+                if (lhs.intersects(rhs)) {
+                    ++numIntersections;
+                }
+            }
+        }
+    }, "check " + std::to_string(NumIntersectingHulls * NumIntersectingHulls) + " pairs of convex hulls for intersection");
+
+    CHECK(numIntersections >= NumIntersectingHulls);
+}
+} // namespace Model
+} // namespace TrenchBroom
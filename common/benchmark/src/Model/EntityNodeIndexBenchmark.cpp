@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/EntityNodeIndex.h"
+#include "Model/EntityProperties.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace Model {
+static constexpr size_t NumEntities = 20'000;
+
+/**
+ * Creates entities with ten properties each. The entities are linked into a chain using
+ * their target and killtarget properties, similar to a sequence of trigger_relays.
+ */
+static std::vector<std::unique_ptr<EntityNode>> makeEntityNodes() {
+    auto result = std::vector<std::unique_ptr<EntityNode>>{};
+    result.reserve(NumEntities);
+    for (size_t i = 0; i < NumEntities; ++i) {
+        const auto n = std::to_string(i);
+        result.push_back(std::make_unique<EntityNode>(Entity{{}, {
+            {EntityPropertyKeys::Classname, "trigger_relay"},
+            {EntityPropertyKeys::Origin, n + " " + n + " 0"},
+            {EntityPropertyKeys::Targetname, "relay" + n},
+            {EntityPropertyKeys::Target, "relay" + std::to_string(i + 1)},
+            {EntityPropertyKeys::Killtarget, "relay" + std::to_string(i + 2)},
+            {EntityPropertyKeys::Spawnflags, std::to_string(i % 8)},
+            {EntityPropertyKeys::Angle, std::to_string(i % 360)},
+            {"delay", "0.5"},
+            {"wait", "1"},
+            {"message", "message " + n},
+        }}));
+    }
+    return result;
+}
+
+TEST_CASE("EntityNodeIndexBenchmark.insertRemoveLookup") {
+    const auto nodes = makeEntityNodes();
+    const auto numProperties = std::to_string(NumEntities * 10) + " properties";
+
+    auto index = EntityNodeIndex{};
+    timeLambda([&]() {
+        for (const auto &node : nodes) {
+            index.addEntityNode(node.get());
+        }
+    }, "insert " + numProperties);
+
+    auto found = size_t(0);
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumEntities; ++i) {
+            found += index.findEntityNodes(EntityNodeIndexQuery::exact(EntityPropertyKeys::Targetname), "relay" + std::to_string(i)).size();
+        }
+    }, "find " + std::to_string(NumEntities) + " entities by targetname");
+    CHECK(found == NumEntities);
+
+    found = 0;
+    timeLambda([&]() {
+        for (size_t i = 2; i < NumEntities + 2; ++i) {
+            found += index.findEntityNodes(EntityNodeIndexQuery::numbered(EntityPropertyKeys::Target), "relay" + std::to_string(i)).size();
+        }
+    }, "find " + std::to_string(NumEntities) + " entities by numbered target");
+    CHECK(found == NumEntities - 1);
+
+    timeLambda([&]() {
+        for (const auto &node : nodes) {
+            index.removeEntityNode(node.get());
+        }
+    }, "remove " + numProperties);
+    CHECK(index.allKeys().empty());
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,121 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "IO/MapGenerator.h"
+#include "IO/TestParserStatus.h"
+#include "IO/WorldReader.h"
+#include "Model/BrushNode.h"
+#include "Model/EditorContext.h"
+#include "Model/Hit.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
+#include "Model/MapFormat.h"
+#include "Model/PickResult.h"
+#include "Model/WorldNode.h"
+
+#include <vm/bbox.h>
+#include <vm/ray.h>
+#include <vm/vec.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace Model {
+static constexpr size_t NumEntities = 100;
+static constexpr size_t NumBrushesPerEntity = 600;
+static constexpr size_t NumRays = 10'000;
+
+/**
+ * Creates rays that look down at the generated map from above, like a camera that hovers
+ * over a dense map.
+ */
+static std::vector<vm::ray3> makeRays(const size_t count) {
+    auto rng = std::mt19937{0};
+    auto coord = std::uniform_real_distribution<FloatType>{-1024.0, 1024.0};
+    auto tilt = std::uniform_real_distribution<FloatType>{-0.5, 0.5};
+
+    auto result = std::vector<vm::ray3>{};
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.emplace_back(vm::vec3{coord(rng), coord(rng), 0.0}, vm::normalize(vm::vec3{tilt(rng), tilt(rng), -1.0}));
+    }
+    return result;
+}
+
+template<typename F> static std::vector<Node *> benchmarkPicks(const std::string &name, const std::vector<vm::ray3> &rays, const F &pick) {
+    auto result = std::vector<Node *>{};
+    result.reserve(rays.size());
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (const auto &ray : rays) {
+        result.push_back(pick(ray));
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+
+    const auto seconds = std::chrono::duration<double>(end - start).count();
+    printf("%s: %zu picks in %fms, %.0f picks/s\n", name.c_str(), rays.size(), seconds * 1000.0, double(rays.size()) / seconds);
+
+    return result;
+}
+
+TEST_CASE("WorldNodeBenchmark.pick") {
+    const auto map = IO::generateValveMap(NumEntities, NumBrushesPerEntity);
+    const auto worldBounds = vm::bbox3{8192.0};
+
+    auto status = IO::TestParserStatus{};
+    auto reader = IO::WorldReader{map, MapFormat::Valve, {}};
+    auto world = reader.read(worldBounds, status);
+    REQUIRE(world != nullptr);
+
+    const auto editorContext = EditorContext{};
+    const auto rays = makeRays(NumRays);
+    const auto filter = HitFilters::type(BrushNode::BrushHitType);
+
+    const auto allHits = benchmarkPicks("pick all hits", rays, [&](const auto &ray) {
+        auto pickResult = PickResult::byDistance();
+        world->pick(editorContext, ray, pickResult);
+        return hitToNode(pickResult.first(filter));
+    });
+
+    const auto firstHits = benchmarkPicks("pick first hit", rays, [&](const auto &ray) {
+        auto pickResult = PickResult::byDistance();
+        world->pickFirst(editorContext, ray, filter, pickResult);
+        return hitToNode(pickResult.first(filter));
+    });
+
+    // like the tool box pick in the 3D views, where hovering only queries the closest hit
+    const auto deferredHits = benchmarkPicks("pick first hit, defer others", rays, [&](const auto &ray) {
+        auto pickResult = PickResult::byDistance();
+        world->pickFirst(editorContext, ray, filter, pickResult);
+        if (const auto &hit = pickResult.first(filter); hit.isMatch()) {
+            pickResult.deferHitsAfter(hit.distance(), [&](auto &deferredPickResult) { world->pick(editorContext, ray, deferredPickResult); });
+        }
+        return hitToNode(pickResult.first(filter));
+    });
+
+    CHECK(firstHits == allHits);
+    CHECK(deferredHits == allHits);
+}
+} // namespace Model
+} // namespace TrenchBroom
@@ -0,0 +1,119 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+#include "flat_octree.h"
+#include "octree.h"
+
+#include <vm/bbox.h>
+#include <vm/ray.h>
+#include <vm/vec.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+static constexpr size_t NumItems = 100'000;
+static constexpr size_t NumRays = 10'000;
+
+static std::vector<vm::bbox3d> makeBounds(const size_t count, std::mt19937 &rng) {
+    auto coord = std::uniform_real_distribution<double>{-8192.0, 8192.0};
+    auto extent = std::uniform_real_distribution<double>{8.0, 256.0};
+
+    auto result = std::vector<vm::bbox3d>{};
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto min = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+        result.emplace_back(min, min + vm::vec3d{extent(rng), extent(rng), extent(rng)});
+    }
+    return result;
+}
+
+static std::vector<vm::ray3d> makeRays(const size_t count, std::mt19937 &rng) {
+    auto coord = std::uniform_real_distribution<double>{-8192.0, 8192.0};
+    auto direction = std::uniform_real_distribution<double>{-1.0, 1.0};
+
+    auto result = std::vector<vm::ray3d>{};
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.emplace_back(vm::vec3d{coord(rng), coord(rng), coord(rng)}, vm::normalize(vm::vec3d{direction(rng), direction(rng), direction(rng)}));
+    }
+    return result;
+}
+
+template<typename Tree> static void benchmarkTree(Tree &tree, const std::string &name, const std::vector<vm::bbox3d> &bounds, const std::vector<vm::bbox3d> &newBounds, const std::vector<vm::ray3d> &rays) {
+    timeLambda([&]() {
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            tree.insert(bounds[i], i);
+        }
+    }, name + ": insert " + std::to_string(bounds.size()) + " items");
+
+    timeLambda([&]() {
+        for (size_t i = 0; i < newBounds.size(); ++i) {
+            tree.update(newBounds[i], i);
+        }
+    }, name + ": update " + std::to_string(newBounds.size()) + " items");
+
+    auto hits = size_t(0);
+    timeLambda([&]() {
+        for (const auto &ray : rays) {
+            hits += tree.find_intersectors(ray).size();
+        }
+    }, name + ": query " + std::to_string(rays.size()) + " rays");
+    printf("%s: %zu hits\n", name.c_str(), hits);
+
+    timeLambda([&]() {
+        for (size_t i = 0; i < bounds.size(); ++i) {
+            tree.remove(i);
+        }
+    }, name + ": remove " + std::to_string(bounds.size()) + " items");
+}
+
+TEST_CASE("OctreeBenchmark.compareTrees") {
+    auto rng = std::mt19937{0};
+    const auto bounds = makeBounds(NumItems, rng);
+    const auto rays = makeRays(NumRays, rng);
+
+    // half of the updates move an item slightly, the other half move it somewhere else
+    auto newBounds = makeBounds(NumItems, rng);
+    for (size_t i = 0; i < NumItems; i += 2) {
+        newBounds[i] = bounds[i].translate(vm::vec3d{1, 1, 1});
+    }
+
+    auto tree = octree<double, size_t>{256.0};
+    benchmarkTree(tree, "octree", bounds, newBounds, rays);
+
+    auto flatTree = flat_octree<double, size_t>{256.0};
+    benchmarkTree(flatTree, "flat_octree", bounds, newBounds, rays);
+
+    for (size_t i = 0; i < newBounds.size(); ++i) {
+        flatTree.insert(newBounds[i], i);
+    }
+
+    auto batchedHits = size_t(0);
+    timeLambda([&]() {
+        for (const auto &result : flatTree.batch_find_intersectors(rays)) {
+            batchedHits += result.size();
+        }
+    }, "flat_octree: batch query " + std::to_string(rays.size()) + " rays");
+    printf("flat_octree: %zu batched hits\n", batchedHits);
+}
+} // namespace TrenchBroom
@@ -0,0 +1,75 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+#include <kdl/parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom {
+// the previous implementation of kdl::parallel_for, kept for comparison
+template<class L> static void asyncParallelFor(const size_t count, L &&lambda) {
+    const auto numThreads = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(1));
+
+    auto nextIndex = std::atomic<size_t>{0};
+    auto threads = std::vector<std::future<void>>{};
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.push_back(std::async(std::launch::async, [&]() {
+            for (auto index = nextIndex++; index < count; index = nextIndex++) {
+                lambda(index);
+            }
+        }));
+    }
+
+    for (auto &thread : threads) {
+        thread.wait();
+    }
+}
+
+TEST_CASE("ParallelBenchmark.perCallLatency") {
+    auto counter = std::atomic<size_t>{0};
+    const auto work = [&](const size_t) { ++counter; };
+
+    for (const auto count : {size_t(10), size_t(1'000), size_t(100'000)}) {
+        const auto calls = count < 100'000 ? size_t(1'000) : size_t(100);
+        const auto suffix = " " + std::to_string(calls) + " times with " + std::to_string(count) + " items";
+
+        timeLambda([&]() {
+            for (size_t i = 0; i < calls; ++i) {
+                asyncParallelFor(count, work);
+            }
+        }, "std::async parallel_for" + suffix);
+
+        timeLambda([&]() {
+            for (size_t i = 0; i < calls; ++i) {
+                kdl::parallel_for(count, work);
+            }
+        }, "thread pool parallel_for" + suffix);
+    }
+
+    CHECK(counter > 0u);
+}
+} // namespace TrenchBroom
@@ -29,6 +29,7 @@
 #include "Model/MapFormat.h"
 #include "Model/WorldNode.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/BrushRendererBrushCache.h"
 
 #include <kdl/result.h>
 
@@ -158,5 +159,37 @@ validate();
 
 kdl::vec_clear_and_delete(brushes);
 kdl::vec_clear_and_delete(textures);
-}} // namespace Renderer
+}
+
+TEST_CASE("BrushRendererBenchmark.revalidate") {
+    auto brushesTextures = makeBrushes();
+    auto &brushes = brushesTextures.first;
+    auto &textures = brushesTextures.second;
+
+    auto r = BrushRenderer{};
+    for (auto *brush : brushes) {
+        r.addBrush(brush);
+    }
+    r.validate();
+
+    // e.g. after a selection change, the vertex caches are still valid
+    timeLambda([&]() {
+        r.invalidate();
+        r.validate();
+    }, "revalidate " + std::to_string(brushes.size()) + " brushes with valid vertex caches");
+
+    // e.g. after transforming all brushes, every vertex cache must be rebuilt
+    timeLambda([&]() {
+        for (auto *brush : brushes) {
+            brush->brushRendererBrushCache().invalidateVertexCache();
+        }
+        r.invalidate();
+        r.validate();
+    }, "revalidate " + std::to_string(brushes.size()) + " brushes with invalid vertex caches");
+
+    r.clear();
+    kdl::vec_clear_and_delete(brushes);
+    kdl::vec_clear_and_delete(textures);
+}
+} // namespace Renderer
 } // namespace TrenchBroom
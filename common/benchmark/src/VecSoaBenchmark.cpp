@@ -0,0 +1,243 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../test/src/Catch2.h"
+#include "BenchmarkUtils.h"
+
+#include <vm/bbox.h>
+#include <vm/intersection.h>
+#include <vm/mat.h>
+#include <vm/mat_ext.h>
+#include <vm/plane.h>
+#include <vm/ray.h>
+#include <vm/scalar.h>
+#include <vm/vec.h>
+#include <vm/vec_soa.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+// small enough to stay in the cache, so that we measure the computations and not the memory
+static constexpr size_t NumPoints = 10'000;
+static constexpr size_t NumRepetitions = 100;
+
+static std::vector<vm::vec3d> makePoints(const size_t count, std::mt19937 &rng) {
+    auto coord = std::uniform_real_distribution<double>{-8192.0, 8192.0};
+
+    auto result = std::vector<vm::vec3d>{};
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.emplace_back(coord(rng), coord(rng), coord(rng));
+    }
+    return result;
+}
+
+static std::vector<vm::plane3d> makePlanes(const size_t count, std::mt19937 &rng) {
+    auto distance = std::uniform_real_distribution<double>{-4096.0, 4096.0};
+    auto direction = std::uniform_real_distribution<double>{-1.0, 1.0};
+
+    auto result = std::vector<vm::plane3d>{};
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.emplace_back(distance(rng), vm::normalize(vm::vec3d{direction(rng), direction(rng), direction(rng)}));
+    }
+    return result;
+}
+
+// the batch functions may differ from the scalar ones in the last bits if the compiler
+// contracts multiplications and additions differently
+static constexpr double Epsilon = 0.000001;
+
+static bool samePoints(const std::vector<vm::vec3d> &lhs, const std::vector<vm::vec3d> &rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (!vm::is_equal(lhs[i], rhs[i], Epsilon)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool sameDistances(const std::vector<double> &lhs, const std::vector<double> &rhs) {
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        if (!(vm::is_equal(lhs[i], rhs[i], Epsilon) || (vm::is_nan(lhs[i]) && vm::is_nan(rhs[i])))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("VecSoaBenchmark.pointStatus") {
+    auto rng = std::mt19937{1};
+    const auto points = makePoints(NumPoints, rng);
+    const auto planes = makePlanes(NumRepetitions, rng);
+    const auto soa = vm::vec_soa<double, 3>{points};
+
+    auto scalarAbove = size_t(0);
+    timeLambda([&]() {
+        for (const auto &plane : planes) {
+            for (const auto &point : points) {
+                if (plane.point_status(point) == vm::plane_status::above) {
+                    ++scalarAbove;
+                }
+            }
+        }
+    }, "classify " + std::to_string(NumPoints) + " points against " + std::to_string(NumRepetitions) + " planes one by one");
+
+    auto batchAbove = size_t(0);
+    timeLambda([&]() {
+        for (const auto &plane : planes) {
+            batchAbove += vm::count_point_status(plane, soa).above;
+        }
+    }, "classify " + std::to_string(NumPoints) + " points against " + std::to_string(NumRepetitions) + " planes in batches");
+
+    CHECK(batchAbove == scalarAbove);
+}
+
+TEST_CASE("VecSoaBenchmark.transform") {
+    auto rng = std::mt19937{2};
+    const auto points = makePoints(NumPoints, rng);
+    const auto soa = vm::vec_soa<double, 3>{points};
+    const auto transform = vm::translation_matrix(vm::vec3d{16.0, -32.0, 64.0}) * vm::rotation_matrix(0.1, 0.2, 0.3) * vm::scaling_matrix(vm::vec3d{2.0, 2.0, 2.0});
+
+    auto scalarResult = std::vector<vm::vec3d>{};
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumRepetitions; ++i) {
+            scalarResult.clear();
+            for (const auto &point : points) {
+                scalarResult.push_back(transform * point);
+            }
+        }
+    }, "transform " + std::to_string(NumPoints) + " points one by one " + std::to_string(NumRepetitions) + " times");
+
+    auto batchResult = vm::vec_soa<double, 3>{};
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumRepetitions; ++i) {
+            batchResult = vm::transform(transform, soa);
+        }
+    }, "transform " + std::to_string(NumPoints) + " points in a batch " + std::to_string(NumRepetitions) + " times");
+
+    CHECK(samePoints(batchResult.to_vector(), scalarResult));
+}
+
+TEST_CASE("VecSoaBenchmark.bounds") {
+    auto rng = std::mt19937{3};
+    auto points = makePoints(NumPoints, rng);
+    auto soa = vm::vec_soa<double, 3>{points};
+
+    // move one point in every repetition so that the computation cannot be hoisted out of the loop
+    auto scalarBounds = vm::bbox3d{};
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumRepetitions; ++i) {
+            points[i][0] += 1.0;
+            scalarBounds = vm::bbox3d::merge_all(points.begin(), points.end());
+        }
+    }, "compute the bounds of " + std::to_string(NumPoints) + " points one by one " + std::to_string(NumRepetitions) + " times");
+
+    auto batchBounds = vm::bbox3d{};
+    timeLambda([&]() {
+        for (size_t i = 0; i < NumRepetitions; ++i) {
+            soa.component(0)[i] += 1.0;
+            batchBounds = vm::bounds(soa);
+        }
+    }, "compute the bounds of " + std::to_string(NumPoints) + " points in a batch " + std::to_string(NumRepetitions) + " times");
+
+    CHECK(batchBounds == scalarBounds);
+}
+
+TEST_CASE("VecSoaBenchmark.intersectRayTriangles") {
+    auto rng = std::mt19937{4};
+    const auto numTriangles = NumPoints / 3;
+    const auto points = makePoints(numTriangles * 3, rng);
+
+    auto p1 = vm::vec_soa<double, 3>{};
+    auto p2 = vm::vec_soa<double, 3>{};
+    auto p3 = vm::vec_soa<double, 3>{};
+    for (size_t i = 0; i < numTriangles; ++i) {
+        p1.push_back(points[3 * i + 0]);
+        p2.push_back(points[3 * i + 1]);
+        p3.push_back(points[3 * i + 2]);
+    }
+
+    const auto ray = vm::ray3d{vm::vec3d{-8192.0, 0.0, 0.0}, vm::normalize(vm::vec3d{1.0, 0.1, 0.1})};
+
+    auto scalarResult = std::vector<double>{};
+    timeLambda([&]() {
+        for (size_t r = 0; r < NumRepetitions; ++r) {
+            scalarResult.clear();
+            for (size_t i = 0; i < numTriangles; ++i) {
+                scalarResult.push_back(vm::intersect_ray_triangle(ray, points[3 * i + 0], points[3 * i + 1], points[3 * i + 2]));
+            }
+        }
+    }, "intersect a ray with " + std::to_string(numTriangles) + " triangles one by one " + std::to_string(NumRepetitions) + " times");
+
+    auto batchResult = std::vector<double>{};
+    timeLambda([&]() {
+        for (size_t r = 0; r < NumRepetitions; ++r) {
+            batchResult = vm::intersect_ray_triangles(ray, p1, p2, p3);
+        }
+    }, "intersect a ray with " + std::to_string(numTriangles) + " triangles in a batch " + std::to_string(NumRepetitions) + " times");
+
+    CHECK(sameDistances(batchResult, scalarResult));
+}
+
+TEST_CASE("VecSoaBenchmark.intersectRayBBoxes") {
+    auto rng = std::mt19937{5};
+    const auto numBounds = NumPoints / 2;
+    const auto points = makePoints(numBounds, rng);
+    auto extent = std::uniform_real_distribution<double>{8.0, 1024.0};
+
+    auto bounds = std::vector<vm::bbox3d>{};
+    auto min = vm::vec_soa<double, 3>{};
+    auto max = vm::vec_soa<double, 3>{};
+    for (const auto &point : points) {
+        bounds.emplace_back(point, point + vm::vec3d{extent(rng), extent(rng), extent(rng)});
+        min.push_back(bounds.back().min);
+        max.push_back(bounds.back().max);
+    }
+
+    const auto ray = vm::ray3d{vm::vec3d{-8192.0, 0.0, 0.0}, vm::normalize(vm::vec3d{1.0, 0.1, 0.1})};
+
+    auto scalarResult = std::vector<double>{};
+    timeLambda([&]() {
+        for (size_t r = 0; r < NumRepetitions; ++r) {
+            scalarResult.clear();
+            for (const auto &b : bounds) {
+                scalarResult.push_back(vm::intersect_ray_bbox(ray, b));
+            }
+        }
+    }, "intersect a ray with " + std::to_string(numBounds) + " bounding boxes one by one " + std::to_string(NumRepetitions) + " times");
+
+    auto batchResult = std::vector<double>{};
+    timeLambda([&]() {
+        for (size_t r = 0; r < NumRepetitions; ++r) {
+            batchResult = vm::intersect_ray_bboxes(ray, min, max);
+        }
+    }, "intersect a ray with " + std::to_string(numBounds) + " bounding boxes in a batch " + std::to_string(NumRepetitions) + " times");
+
+    CHECK(sameDistances(batchResult, scalarResult));
+}
+} // namespace TrenchBroom
@@ -46,10 +46,11 @@ ModelSpecification::ModelSpecification(const std::filesystem::path &i_path, cons
 
 kdl_reflect_impl(ModelSpecification);
 
-ModelDefinition::ModelDefinition() : m_expression{EL::LiteralExpression{EL::Value::Undefined}, 0, 0} {
+ModelDefinition::ModelDefinition() : m_expression{EL::Expression{EL::LiteralExpression{EL::Value::Undefined}, 0, 0}} {
 }
 
-ModelDefinition::ModelDefinition(const size_t line, const size_t column) : m_expression{EL::LiteralExpression{EL::Value::Undefined}, line, column} {
+ModelDefinition::ModelDefinition(const size_t line, const size_t column)
+    : m_expression{EL::Expression{EL::LiteralExpression{EL::Value::Undefined}, line, column}} {
 }
 
 ModelDefinition::ModelDefinition(EL::Expression expression) : m_expression{std::move(expression)} {
@@ -59,8 +60,8 @@ void ModelDefinition::append(ModelDefinition other) {
     const size_t line = m_expression.line();
     const size_t column = m_expression.column();
 
-    auto cases = std::vector{std::move(m_expression), std::move(other.m_expression)};
-    m_expression = EL::Expression{EL::SwitchExpression{std::move(cases)}, line, column};
+    auto cases = std::vector{m_expression.expression(), other.m_expression.expression()};
+    m_expression = EL::MemoizedExpression{EL::Expression{EL::SwitchExpression{std::move(cases)}, line, column}};
 }
 
 static std::filesystem::path path(const EL::Value &value) {
@@ -98,8 +99,7 @@ static ModelSpecification convertToModel(const EL::Value &value) {
 }
 
 ModelSpecification ModelDefinition::modelSpecification(const EL::VariableStore &variableStore) const {
-    const auto context = EL::EvaluationContext{variableStore};
-    return convertToModel(m_expression.evaluate(context));
+    return convertToModel(m_expression.evaluate(variableStore));
 }
 
 ModelSpecification ModelDefinition::defaultModelSpecification() const {
@@ -148,8 +148,7 @@ static std::optional<vm::vec3> convertToScale(const EL::Value &value) {
 }
 
 vm::vec3 ModelDefinition::scale(const EL::VariableStore &variableStore, const std::optional<EL::Expression> &defaultScaleExpression) const {
-    const auto context = EL::EvaluationContext{variableStore};
-    const auto value = m_expression.evaluate(context);
+    const auto value = m_expression.evaluate(variableStore);
 
     switch (value.type()) {
     case EL::ValueType::Map:
@@ -166,6 +165,7 @@ vm::vec3 ModelDefinition::scale(const EL::VariableStore &variableStore, const st
     }
 
     if (defaultScaleExpression) {
+        const auto context = EL::EvaluationContext{variableStore};
         if (const auto scale = convertToScale(defaultScaleExpression->evaluate(context))) {
             return *scale;
         }
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "EL/Expression.h"
+#include "EL/MemoizedExpression.h"
 #include "FloatType.h"
 
 #include "kdl/reflection_decl.h"
@@ -54,7 +55,7 @@ struct ModelSpecification {
 
 class ModelDefinition {
   private:
-    EL::Expression m_expression;
+    EL::MemoizedExpression m_expression;
 
   public:
     ModelDefinition();
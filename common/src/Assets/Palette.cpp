@@ -19,6 +19,7 @@
 
 #include "Palette.h"
 
+#include "Assets/PaletteKernels.h"
 #include "Assets/TextureBuffer.h"
 #include "Ensure.h"
 #include "Error.h"
@@ -32,6 +33,8 @@
 #include "kdl/result.h"
 #include "kdl/string_format.h"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 #include <ostream>
 #include <string>
@@ -55,42 +58,49 @@ std::ostream &operator<<(std::ostream &lhs, const PaletteColorFormat rhs) {
 Palette::Palette(std::shared_ptr<PaletteData> data) : m_data{std::move(data)} {
 }
 
+const PaletteData &Palette::data() const {
+    return *m_data;
+}
+
+namespace {
+/**
+ * Returns the palette data padded to 256 colors, so that every index can be looked up.
+ * The padding is opaque black, so indices beyond the end of a short palette do not make
+ * the texture transparent.
+ */
+std::array<unsigned char, 1024> makeConversionTable(const std::vector<unsigned char> &paletteData) {
+    auto table = std::array<unsigned char, 1024>{};
+    for (size_t i = 3; i < table.size(); i += 4) {
+        table[i] = 0xFF;
+    }
+    std::copy_n(paletteData.begin(), std::min(paletteData.size(), table.size()), table.begin());
+    return table;
+}
+} // namespace
+
 bool Palette::indexedToRgba(IO::Reader &reader, const size_t pixelCount, TextureBuffer &rgbaImage, const PaletteTransparency transparency, Color &averageColor) const {
     ensure(rgbaImage.size() == 4 * pixelCount, "incorrect destination buffer size");
 
-    const unsigned char *paletteData = (transparency == PaletteTransparency::Opaque) ? m_data->opaqueData.data() : m_data->index255TransparentData.data();
+    static const auto convert = supportedPaletteConversionKernels().front().kernel;
 
-    // Write rgba pixels
-    auto *const rgbaData = rgbaImage.data();
-    for (size_t i = 0; i < pixelCount; ++i) {
-        const int index = reader.readInt<unsigned char>();
+    const auto &paletteData = (transparency == PaletteTransparency::Opaque) ? m_data->opaqueData : m_data->index255TransparentData;
+    const auto table = makeConversionTable(paletteData);
 
-        std::memcpy(rgbaData + (i * 4), &paletteData[index * 4], 4);
-    }
+    // throws if there are fewer than pixelCount indices left
+    const auto indexPosition = reader.position();
+    reader.seekForward(pixelCount);
+    const auto indexReader = reader.subReaderFromBegin(indexPosition, pixelCount).buffer();
+
+    const auto *indices = reinterpret_cast<const unsigned char *>(indexReader.begin());
+    const auto result = convert(indices, pixelCount, table.data(), rgbaImage.data());
 
-    // Check average color
-    uint32_t colorSum[3] = {0, 0, 0};
-    for (size_t i = 0; i < pixelCount; ++i) {
-        colorSum[0] += uint32_t(rgbaData[(i * 4) + 0]);
-        colorSum[1] += uint32_t(rgbaData[(i * 4) + 1]);
-        colorSum[2] += uint32_t(rgbaData[(i * 4) + 2]);
-    }
     averageColor = Color{
-        float(colorSum[0]) / (255.0f * float(pixelCount)), float(colorSum[1]) / (255.0f * float(pixelCount)), float(colorSum[2]) / (255.0f * float(pixelCount)), 1.0f
+        float(result.colorSum[0]) / (255.0f * float(pixelCount)), float(result.colorSum[1]) / (255.0f * float(pixelCount)), float(result.colorSum[2]) / (255.0f * float(pixelCount)), 1.0f
     };
 
-    // Check for transparency
-    auto hasTransparency = false;
-    if (transparency == PaletteTransparency::Index255Transparent) {
-        // Take the bitwise AND of the alpha channel of all pixels
-        unsigned char andAlpha = 0xFF;
-        for (size_t i = 0; i < pixelCount; ++i) {
-            andAlpha = static_cast<unsigned char>(andAlpha & rgbaData[4 * i + 3]);
-        }
-        hasTransparency = (andAlpha != 0xFF);
-    }
-
-    return hasTransparency;
+    // the image is transparent if the bitwise AND of the alpha channel of all pixels is not
+    // 0xFF
+    return transparency == PaletteTransparency::Index255Transparent && result.andAlpha != 0xFF;
 }
 
 bool operator==(const Palette &lhs, const Palette &rhs) {
@@ -69,6 +69,8 @@ class Palette {
   public:
     explicit Palette(std::shared_ptr<PaletteData> m_data);
 
+    const PaletteData &data() const;
+
     /**
      * Reads `pixelCount` bytes from `reader` where each byte is a palette index,
      * and writes `pixelCount` * 4 bytes to `rgbaImage` using the palette to convert
@@ -0,0 +1,186 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PaletteKernels.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TB_PALETTE_X86_64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace TrenchBroom::Assets {
+
+PaletteConversionResult convertIndexedToRgbaScalar(const unsigned char *indices, const size_t pixelCount, const unsigned char *palette, unsigned char *rgbaData) {
+    auto result = PaletteConversionResult{};
+    for (size_t i = 0; i < pixelCount; ++i) {
+        const auto *color = palette + 4 * size_t(indices[i]);
+        std::memcpy(rgbaData + 4 * i, color, 4);
+
+        result.colorSum[0] += color[0];
+        result.colorSum[1] += color[1];
+        result.colorSum[2] += color[2];
+        result.andAlpha = static_cast<unsigned char>(result.andAlpha & color[3]);
+    }
+    return result;
+}
+
+#ifdef TB_PALETTE_X86_64
+namespace {
+#if defined(__GNUC__) || defined(__clang__)
+#define TB_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TB_TARGET_AVX2
+#endif
+
+/*
+ * The x86 kernels look up the colors of several pixels at once and accumulate the color
+ * channels of the looked up pixels while they are still in registers. The sums are
+ * computed with PSADBW, which adds up the bytes of each 64 bit lane, after masking out
+ * all but one channel.
+ */
+
+int loadColor(const unsigned char *palette, const unsigned char index) {
+    auto color = 0;
+    std::memcpy(&color, palette + 4 * size_t(index), 4);
+    return color;
+}
+
+// SSE2 is available on every x86-64 CPU
+PaletteConversionResult convertSse2(const unsigned char *indices, const size_t pixelCount, const unsigned char *palette, unsigned char *rgbaData) {
+    const auto zero = _mm_setzero_si128();
+    const auto redMask = _mm_set1_epi32(0x000000FF);
+    const auto greenMask = _mm_set1_epi32(0x0000FF00);
+    const auto blueMask = _mm_set1_epi32(0x00FF0000);
+
+    auto redSum = zero, greenSum = zero, blueSum = zero;
+    auto andAlpha = _mm_set1_epi32(-1);
+
+    size_t i = 0;
+    for (; i + 4 <= pixelCount; i += 4) {
+        const auto pixels = _mm_setr_epi32(loadColor(palette, indices[i]), loadColor(palette, indices[i + 1]), loadColor(palette, indices[i + 2]), loadColor(palette, indices[i + 3]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(rgbaData + 4 * i), pixels);
+
+        redSum = _mm_add_epi64(redSum, _mm_sad_epu8(_mm_and_si128(pixels, redMask), zero));
+        greenSum = _mm_add_epi64(greenSum, _mm_sad_epu8(_mm_and_si128(pixels, greenMask), zero));
+        blueSum = _mm_add_epi64(blueSum, _mm_sad_epu8(_mm_and_si128(pixels, blueMask), zero));
+        andAlpha = _mm_and_si128(andAlpha, pixels);
+    }
+
+    auto result = convertIndexedToRgbaScalar(indices + i, pixelCount - i, palette, rgbaData + 4 * i);
+
+    uint64_t sums[3][2];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(sums[0]), redSum);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(sums[1]), greenSum);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(sums[2]), blueSum);
+    for (size_t c = 0; c < 3; ++c) {
+        result.colorSum[c] += sums[c][0] + sums[c][1];
+    }
+
+    uint32_t alpha[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(alpha), andAlpha);
+    result.andAlpha = static_cast<unsigned char>(result.andAlpha & ((alpha[0] & alpha[1] & alpha[2] & alpha[3]) >> 24));
+
+    return result;
+}
+
+TB_TARGET_AVX2 PaletteConversionResult convertAvx2(const unsigned char *indices, const size_t pixelCount, const unsigned char *palette, unsigned char *rgbaData) {
+    const auto *colors = reinterpret_cast<const int *>(palette);
+
+    const auto zero = _mm256_setzero_si256();
+    const auto redMask = _mm256_set1_epi32(0x000000FF);
+    const auto greenMask = _mm256_set1_epi32(0x0000FF00);
+    const auto blueMask = _mm256_set1_epi32(0x00FF0000);
+
+    auto redSum = zero, greenSum = zero, blueSum = zero;
+    auto andAlpha = _mm256_set1_epi32(-1);
+
+    size_t i = 0;
+    for (; i + 8 <= pixelCount; i += 8) {
+        const auto offsets = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(indices + i)));
+        const auto pixels = _mm256_i32gather_epi32(colors, offsets, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(rgbaData + 4 * i), pixels);
+
+        redSum = _mm256_add_epi64(redSum, _mm256_sad_epu8(_mm256_and_si256(pixels, redMask), zero));
+        greenSum = _mm256_add_epi64(greenSum, _mm256_sad_epu8(_mm256_and_si256(pixels, greenMask), zero));
+        blueSum = _mm256_add_epi64(blueSum, _mm256_sad_epu8(_mm256_and_si256(pixels, blueMask), zero));
+        andAlpha = _mm256_and_si256(andAlpha, pixels);
+    }
+
+    auto result = convertIndexedToRgbaScalar(indices + i, pixelCount - i, palette, rgbaData + 4 * i);
+
+    uint64_t sums[3][4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums[0]), redSum);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums[1]), greenSum);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(sums[2]), blueSum);
+    for (size_t c = 0; c < 3; ++c) {
+        result.colorSum[c] += sums[c][0] + sums[c][1] + sums[c][2] + sums[c][3];
+    }
+
+    uint32_t alpha[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(alpha), andAlpha);
+    for (const auto a : alpha) {
+        result.andAlpha = static_cast<unsigned char>(result.andAlpha & (a >> 24));
+    }
+
+    return result;
+}
+
+bool cpuSupportsAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // the OS must save the AVX registers on context switches
+    __cpuid(info, 1);
+    const auto osxsave = (info[2] & (1 << 27)) != 0;
+    const auto avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+} // namespace
+#endif
+
+std::vector<NamedPaletteConversionKernel> supportedPaletteConversionKernels() {
+    auto result = std::vector<NamedPaletteConversionKernel>{};
+#ifdef TB_PALETTE_X86_64
+    if (cpuSupportsAvx2()) {
+        result.push_back({"AVX2", convertAvx2});
+    }
+    result.push_back({"SSE2", convertSse2});
+#endif
+    result.push_back({"Scalar", convertIndexedToRgbaScalar});
+    return result;
+}
+
+} // namespace TrenchBroom::Assets
@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom::Assets {
+
+/**
+ * The sums of the color channels and the bitwise AND of the alpha channel of the pixels
+ * written by a conversion kernel.
+ */
+struct PaletteConversionResult {
+  uint64_t colorSum[3] = {0, 0, 0};
+  unsigned char andAlpha = 0xFF;
+};
+
+/**
+ * Converts the given palette indices to RGBA pixels. The palette holds 256 RGBA colors.
+ */
+using PaletteConversionKernel = PaletteConversionResult (*)(const unsigned char *indices, size_t pixelCount, const unsigned char *palette, unsigned char *rgbaData);
+
+struct NamedPaletteConversionKernel {
+  std::string name;
+  PaletteConversionKernel kernel;
+};
+
+/**
+ * The portable reference implementation that all other kernels must agree with.
+ */
+PaletteConversionResult convertIndexedToRgbaScalar(const unsigned char *indices, size_t pixelCount, const unsigned char *palette, unsigned char *rgbaData);
+
+/**
+ * Returns the kernels that the current CPU can run, fastest first. The last kernel is
+ * always the scalar one.
+ */
+std::vector<NamedPaletteConversionKernel> supportedPaletteConversionKernels();
+
+} // namespace TrenchBroom::Assets
@@ -31,8 +31,11 @@
 #include "vm/vec_io.h"
 
 #include <algorithm> // for std::max
+#include <atomic>
 #include <cassert>
+#include <mutex>
 #include <ostream>
+#include <utility>
 
 namespace TrenchBroom::Assets {
 
@@ -88,6 +91,33 @@ kdl_reflect_impl(Q2Data);
 
 kdl_reflect_impl(Texture);
 
+struct Texture::DeferredData {
+    // guards loader and decoded, which are accessed by prefetch tasks, and the transition
+    // of the texture's own members from their placeholder to their decoded values
+    std::mutex mutex;
+    TextureLoader loader;
+    std::optional<Texture> decoded;
+
+    // set with release semantics once the texture's members hold their decoded values, so
+    // that readers which observe it can access the members without locking the mutex
+    std::atomic<bool> adopted = false;
+
+    // the remaining members are only accessed by the thread that owns the GL context
+    std::atomic<bool> uploadPending = false;
+    int minFilter = 0;
+    int magFilter = 0;
+
+    explicit DeferredData(TextureLoader i_loader) : loader{std::move(i_loader)} {
+    }
+
+    void decode() {
+        if (loader) {
+            decoded = loader();
+            loader = nullptr;
+        }
+    }
+};
+
 Texture::Texture(std::string name, const size_t width, const size_t height, const Color &averageColor, Buffer &&buffer, const GLenum format, const TextureType type, GameData gameData)
     : m_name{std::move(name)}, m_width{width}, m_height{height}, m_averageColor{averageColor}, m_usageCount{0u}, m_overridden{false}, m_format{format}, m_type{type}, m_culling{TextureCulling::Default}, m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA}, m_textureId{0}, m_gameData{std::move(gameData)} {
     assert(m_width > 0);
@@ -116,10 +146,16 @@ Texture::Texture(std::string name, const size_t width, const size_t height, cons
     : m_name{std::move(name)}, m_width{width}, m_height{height}, m_averageColor(Color(0.0f, 0.0f, 0.0f, 1.0f)), m_usageCount{0u}, m_overridden{false}, m_format{format}, m_type{type}, m_culling{TextureCulling::Default}, m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA}, m_textureId{0}, m_gameData{std::move(gameData)} {
 }
 
+Texture::Texture(std::string name, const size_t width, const size_t height, TextureLoader loader, GameData gameData)
+    : m_name{std::move(name)}, m_width{width}, m_height{height}, m_averageColor(Color(0.0f, 0.0f, 0.0f, 1.0f)), m_usageCount{0u}, m_overridden{false}, m_format{GL_RGBA}, m_type{TextureType::Opaque}, m_culling{TextureCulling::Default}, m_blendFunc{TextureBlendFunc::Enable::UseDefault, GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA}, m_textureId{0}, m_gameData{std::move(gameData)}, m_deferred{std::make_shared<DeferredData>(std::move(loader))} {
+    assert(m_width > 0);
+    assert(m_height > 0);
+}
+
 Texture::~Texture() = default;
 
 Texture::Texture(Texture &&other)
-    : m_name{std::move(other.m_name)}, m_absolutePath{std::move(other.m_absolutePath)}, m_relativePath{std::move(other.m_relativePath)}, m_width{std::move(other.m_width)}, m_height{std::move(other.m_height)}, m_averageColor{std::move(other.m_averageColor)}, m_usageCount{static_cast<size_t>(other.m_usageCount)}, m_overridden{std::move(other.m_overridden)}, m_format{std::move(other.m_format)}, m_type{std::move(other.m_type)}, m_surfaceParms{std::move(other.m_surfaceParms)}, m_culling{std::move(other.m_culling)}, m_blendFunc{std::move(other.m_blendFunc)}, m_textureId{std::move(other.m_textureId)}, m_buffers{std::move(other.m_buffers)}, m_gameData{std::move(other.m_gameData)} {
+    : m_name{std::move(other.m_name)}, m_absolutePath{std::move(other.m_absolutePath)}, m_relativePath{std::move(other.m_relativePath)}, m_width{std::move(other.m_width)}, m_height{std::move(other.m_height)}, m_averageColor{std::move(other.m_averageColor)}, m_usageCount{static_cast<size_t>(other.m_usageCount)}, m_overridden{std::move(other.m_overridden)}, m_format{std::move(other.m_format)}, m_type{std::move(other.m_type)}, m_surfaceParms{std::move(other.m_surfaceParms)}, m_culling{std::move(other.m_culling)}, m_blendFunc{std::move(other.m_blendFunc)}, m_textureId{std::move(other.m_textureId)}, m_buffers{std::move(other.m_buffers)}, m_gameData{std::move(other.m_gameData)}, m_deferred{std::move(other.m_deferred)} {
 }
 
 Texture &Texture::operator=(Texture &&other) {
@@ -139,6 +175,7 @@ Texture &Texture::operator=(Texture &&other) {
     m_textureId = std::move(other.m_textureId);
     m_buffers = std::move(other.m_buffers);
     m_gameData = std::move(other.m_gameData);
+    m_deferred = std::move(other.m_deferred);
     return *this;
 }
 
@@ -175,14 +212,17 @@ size_t Texture::height() const {
 }
 
 const Color &Texture::averageColor() const {
+    load();
     return m_averageColor;
 }
 
 bool Texture::masked() const {
+    load();
     return m_type == TextureType::Masked;
 }
 
 void Texture::setOpaque() {
+    load();
     m_type = TextureType::Opaque;
 }
 
@@ -238,6 +278,47 @@ void Texture::setOverridden(const bool overridden) {
     m_overridden = overridden;
 }
 
+bool Texture::loaded() const {
+    return !m_deferred || m_deferred->adopted.load(std::memory_order_acquire);
+}
+
+void Texture::load() const {
+    if (loaded()) {
+        return;
+    }
+
+    const auto lock = std::lock_guard{m_deferred->mutex};
+    if (m_deferred->adopted.load(std::memory_order_relaxed)) {
+        // another thread loaded the texture while we were waiting for the lock
+        return;
+    }
+
+    m_deferred->decode();
+    auto decoded = std::exchange(m_deferred->decoded, std::nullopt);
+
+    // the dimensions were determined when the texture was registered; faces depend on them,
+    // so a texture whose file changed in the meantime is left without pixel data
+    if (decoded && decoded->m_width == m_width && decoded->m_height == m_height) {
+        m_averageColor = decoded->m_averageColor;
+        m_format = decoded->m_format;
+        m_type = decoded->m_type;
+        m_buffers = std::move(decoded->m_buffers);
+    }
+
+    m_deferred->adopted.store(true, std::memory_order_release);
+}
+
+std::function<void()> Texture::prefetchTask() const {
+    if (loaded()) {
+        return {};
+    }
+
+    return [deferred = m_deferred]() {
+        const auto lock = std::lock_guard{deferred->mutex};
+        deferred->decode();
+    };
+}
+
 bool Texture::isPrepared() const {
     return m_textureId != 0;
 }
@@ -246,6 +327,19 @@ void Texture::prepare(const GLuint textureId, const int minFilter, const int mag
     assert(textureId > 0);
     assert(m_textureId == 0);
 
+    if (!loaded()) {
+        // defer decoding and uploading until the texture is activated for the first time
+        m_deferred->uploadPending = true;
+        m_deferred->minFilter = minFilter;
+        m_deferred->magFilter = magFilter;
+        m_textureId = textureId;
+        return;
+    }
+
+    upload(textureId, minFilter, magFilter);
+}
+
+void Texture::upload(const GLuint textureId, const int minFilter, const int magFilter) const {
     if (!m_buffers.empty()) {
         const auto compressed = isCompressedFormat(m_format);
 
@@ -309,7 +403,10 @@ void Texture::prepare(const GLuint textureId, const int minFilter, const int mag
 }
 
 void Texture::setMode(const int minFilter, const int magFilter) {
-    if (isPrepared()) {
+    if (m_deferred && m_deferred->uploadPending) {
+        m_deferred->minFilter = minFilter;
+        m_deferred->magFilter = magFilter;
+    } else if (isPrepared()) {
         activate();
         if (m_type == TextureType::Masked) {
             // Force GL_NEAREST filtering for masked textures.
@@ -324,6 +421,11 @@ void Texture::setMode(const int minFilter, const int magFilter) {
 }
 
 void Texture::activate() const {
+    if (m_deferred && m_deferred->uploadPending.exchange(false)) {
+        load();
+        upload(std::exchange(m_textureId, 0), m_deferred->minFilter, m_deferred->magFilter);
+    }
+
     if (isPrepared()) {
         glAssert(glBindTexture(GL_TEXTURE_2D, m_textureId));
 
@@ -372,14 +474,17 @@ void Texture::deactivate() const {
 }
 
 const Texture::BufferList &Texture::buffersIfUnprepared() const {
+    load();
     return m_buffers;
 }
 
 GLenum Texture::format() const {
+    load();
     return m_format;
 }
 
 TextureType Texture::type() const {
+    load();
     return m_type;
 }
 
@@ -29,6 +29,9 @@
 
 #include <atomic>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <variant>
@@ -86,11 +89,21 @@ using GameData = std::variant<std::monostate, Q2Data>;
 
 std::ostream &operator<<(std::ostream &lhs, const GameData &rhs);
 
+class Texture;
+
+/**
+ * Decodes the pixel data of a texture whose decoding was deferred. Returns nothing if the
+ * texture could not be decoded.
+ */
+using TextureLoader = std::function<std::optional<Texture>()>;
+
 class Texture {
   private:
     using Buffer = TextureBuffer;
     using BufferList = std::vector<Buffer>;
 
+    struct DeferredData;
+
   private:
     std::string m_name;
     std::filesystem::path m_absolutePath;
@@ -98,13 +111,13 @@ class Texture {
 
     size_t m_width;
     size_t m_height;
-    Color m_averageColor;
+    mutable Color m_averageColor;
 
     std::atomic<size_t> m_usageCount;
     bool m_overridden;
 
-    GLenum m_format;
-    TextureType m_type;
+    mutable GLenum m_format;
+    mutable TextureType m_type;
 
     // TODO: move these to a Q3Data variant case of m_gameData if possible
     // Quake 3 surface parameters; move these to materials when we add proper support for
@@ -122,6 +135,9 @@ class Texture {
 
     GameData m_gameData;
 
+    // set while the pixel data of a lazily loaded texture has not been decoded yet
+    mutable std::shared_ptr<DeferredData> m_deferred;
+
     kdl_reflect_decl(Texture, m_name, m_absolutePath, m_relativePath, m_width, m_height, m_averageColor, m_usageCount, m_overridden, m_format, m_type, m_surfaceParms, m_culling, m_blendFunc, m_gameData);
 
   public:
@@ -131,6 +147,15 @@ class Texture {
 
     Texture(std::string name, size_t width, size_t height, GLenum format = GL_RGB, TextureType type = TextureType::Opaque, GameData gameData = std::monostate{});
 
+    /**
+     * Creates a texture whose pixel data is decoded by the given loader when it is needed
+     * for the first time. Until then, only the name and the dimensions of the texture are
+     * known.
+     *
+     * The loader must return a texture with the given dimensions.
+     */
+    Texture(std::string name, size_t width, size_t height, TextureLoader loader, GameData gameData = std::monostate{});
+
     Texture(const Texture &) = delete;
 
     Texture &operator=(const Texture &) = delete;
@@ -193,6 +218,28 @@ class Texture {
 
     void setOverridden(bool overridden);
 
+    /**
+     * Indicates whether the pixel data of this texture is available, i.e. whether the
+     * texture was not loaded lazily or whether it has been decoded already.
+     */
+    bool loaded() const;
+
+    /**
+     * Decodes the pixel data of a lazily loaded texture. Does nothing if the texture is
+     * loaded already. If the texture cannot be decoded, it is left without pixel data.
+     *
+     * This is called implicitly by every function that needs the pixel data.
+     */
+    void load() const;
+
+    /**
+     * Returns a function that decodes the pixel data of this texture without modifying
+     * the texture itself, or an empty function if the texture is loaded already. The
+     * function can be called on any thread; the decoded data is adopted by the texture
+     * the next time it is needed.
+     */
+    std::function<void()> prefetchTask() const;
+
     bool isPrepared() const;
 
     void prepare(GLuint textureId, int minFilter, int magFilter);
@@ -203,6 +250,9 @@ class Texture {
 
     void deactivate() const;
 
+  private:
+    void upload(GLuint textureId, int minFilter, int magFilter) const;
+
   public: // exposed for tests only
     /**
      * Returns the texture data in the format returned by format().
@@ -83,16 +83,15 @@ size_t bytesPerPixelForFormat(const GLenum format) {
     return 0U;
 }
 
-void setMipBufferSize(TextureBufferList &buffers, const size_t mipLevels, const size_t width, const size_t height, const GLenum format) {
-    const bool compressed = isCompressedFormat(format);
-    const size_t bytesPerPixel = compressed ? 0U : bytesPerPixelForFormat(format);
-    const size_t blockSize = compressed ? blockSizeForFormat(format) : 0U;
+size_t mipBufferSize(const size_t width, const size_t height, const size_t level, const GLenum format) {
+    const auto mipSize = sizeAtMipLevel(width, height, level);
+    return isCompressedFormat(format) ? (blockSizeForFormat(format) * std::max(size_t(1), mipSize.x() / 4) * std::max(size_t(1), mipSize.y() / 4)) : (bytesPerPixelForFormat(format) * mipSize.x() * mipSize.y());
+}
 
+void setMipBufferSize(TextureBufferList &buffers, const size_t mipLevels, const size_t width, const size_t height, const GLenum format) {
     buffers.resize(mipLevels);
     for (size_t level = 0u; level < buffers.size(); ++level) {
-        const auto mipSize = sizeAtMipLevel(width, height, level);
-        const auto numBytes = compressed ? (blockSize * std::max(size_t(1), mipSize.x() / 4) * std::max(size_t(1), mipSize.y() / 4)) : (bytesPerPixel * mipSize.x() * mipSize.y());
-        buffers[level] = TextureBuffer(numBytes);
+        buffers[level] = TextureBuffer(mipBufferSize(width, height, level, format));
     }
 }
 
@@ -55,6 +55,12 @@ size_t blockSizeForFormat(GLenum format);
 
 size_t bytesPerPixelForFormat(GLenum format);
 
+/**
+ * Returns the number of bytes of the given mip level of a texture with the given size and
+ * format.
+ */
+size_t mipBufferSize(size_t width, size_t height, size_t level, GLenum format);
+
 void setMipBufferSize(TextureBufferList &buffers, size_t mipLevels, size_t width, size_t height, GLenum format);
 
 void resizeMips(TextureBufferList &buffers, const vm::vec2s &oldSize, const vm::vec2s &newSize);
@@ -24,29 +24,93 @@
 #include "Error.h"
 #include "Exceptions.h"
 #include "IO/LoadTextureCollection.h"
+#include "IO/TextureCache.h"
 #include "Logger.h"
 
 #include "kdl/map_utils.h"
 #include "kdl/result.h"
 #include "kdl/string_format.h"
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <iterator>
+#include <mutex>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
 namespace Assets {
 
-TextureManager::TextureManager(int magFilter, int minFilter, Logger &logger) : m_logger{logger}, m_minFilter{minFilter}, m_magFilter{magFilter} {
+struct TextureManager::PrefetchState {
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t pendingCount = 0;
+    std::atomic<bool> cancelled = false;
+};
+
+TextureManager::TextureManager(int magFilter, int minFilter, Logger &logger)
+    : m_logger{logger}, m_loadingMode{IO::TextureLoadingMode::Eager}, m_prefetchState{std::make_shared<PrefetchState>()}, m_minFilter{minFilter}, m_magFilter{magFilter} {
 }
 
-TextureManager::~TextureManager() = default;
+TextureManager::~TextureManager() {
+    // lazily loaded textures refer to the texture cache and the game file system
+    cancelPrefetch();
+}
 
-void TextureManager::reload(const IO::FileSystem &fs, const Model::TextureConfig &textureConfig) {
-    findTextureCollections(fs, textureConfig).transform([&](auto textureCollections) {
+void TextureManager::setTextureCache(std::shared_ptr<IO::TextureCache> textureCache) {
+    cancelPrefetch();
+    m_textureCache = std::move(textureCache);
+}
+
+void TextureManager::setTextureLoadingMode(const IO::TextureLoadingMode loadingMode) {
+    m_loadingMode = loadingMode;
+}
+
+void TextureManager::prefetchUsedTextures() {
+    auto &threadPool = kdl::thread_pool::global();
+    if (threadPool.thread_count() == 0) {
+        return;
+    }
+
+    for (const auto *texture : m_textures) {
+        if (texture->usageCount() == 0) {
+            continue;
+        }
+
+        if (auto task = texture->prefetchTask()) {
+            {
+                const auto lock = std::lock_guard{m_prefetchState->mutex};
+                ++m_prefetchState->pendingCount;
+            }
+
+            threadPool.submit([state = m_prefetchState, task = std::move(task)]() {
+                if (!state->cancelled) {
+                    task();
+                }
+
+                const auto lock = std::lock_guard{state->mutex};
+                --state->pendingCount;
+                state->condition.notify_all();
+            });
+        }
+    }
+}
+
+void TextureManager::cancelPrefetch() {
+    m_prefetchState->cancelled = true;
+    {
+        auto lock = std::unique_lock{m_prefetchState->mutex};
+        m_prefetchState->condition.wait(lock, [&]() { return m_prefetchState->pendingCount == 0; });
+    }
+    m_prefetchState = std::make_shared<PrefetchState>();
+}
+
+void TextureManager::reload(std::shared_ptr<const IO::FileSystem> fs, const Model::TextureConfig &textureConfig) {
+    findTextureCollections(*fs, textureConfig).transform([&](auto textureCollections) {
         setTextureCollections(std::move(textureCollections), fs, textureConfig);
     }).transform_error([&](auto e) {
         m_logger.error() << "Could not reload texture collections: " + e.msg;
@@ -61,17 +125,21 @@ void TextureManager::setTextureCollections(std::vector<TextureCollection> collec
     updateTextures();
 }
 
-void TextureManager::setTextureCollections(const std::vector<std::filesystem::path> &paths, const IO::FileSystem &fs, const Model::TextureConfig &textureConfig) {
+void TextureManager::setTextureCollections(const std::vector<std::filesystem::path> &paths, const std::shared_ptr<const IO::FileSystem> &fs, const Model::TextureConfig &textureConfig) {
     auto collections = std::move(m_collections);
     clear();
 
+    if (m_textureCache) {
+        m_textureCache->resetStatistics();
+    }
+
     for (const auto &path : paths) {
         const auto it = std::find_if(collections.begin(), collections.end(), [&](const auto &c) {
             return c.path() == path;
         });
 
         if (it == collections.end() || !it->loaded()) {
-            IO::loadTextureCollection(path, fs, textureConfig, m_logger).transform_error([&](const auto &error) {
+            IO::loadTextureCollection(path, fs, textureConfig, m_logger, m_textureCache, m_loadingMode).transform_error([&](const auto &error) {
                 if (it == collections.end()) {
                     m_logger.error() << "Could not load texture collection: " << path << " -> " << error.msg;
                 }
@@ -91,6 +159,10 @@ void TextureManager::setTextureCollections(const std::vector<std::filesystem::pa
         }
     }
 
+    if (m_textureCache && m_textureCache->hits() + m_textureCache->misses() > 0) {
+        m_logger.info() << "Texture cache: " << m_textureCache->hits() << " hits, " << m_textureCache->misses() << " misses";
+    }
+
     updateTextures();
     m_toRemove = kdl::vec_concat(std::move(m_toRemove), std::move(collections));
 }
@@ -107,10 +179,12 @@ void TextureManager::addTextureCollection(Assets::TextureCollection collection)
 }
 
 void TextureManager::clear() {
+    cancelPrefetch();
     m_collections.clear();
 
     m_toPrepare.clear();
     m_texturesByName.clear();
+    m_texturesByInternedName.clear();
     m_textures.clear();
 
     // Remove logging because it might fail when the document is already destroyed.
@@ -137,6 +211,15 @@ Texture *TextureManager::texture(const std::string &name) {
     return const_cast<Texture *>(const_cast<const TextureManager *>(this)->texture(name));
 }
 
+const Texture *TextureManager::texture(const TextureName &name) const {
+    auto it = m_texturesByInternedName.find(name.lowerCase());
+    return it != m_texturesByInternedName.end() ? it->second : nullptr;
+}
+
+Texture *TextureManager::texture(const TextureName &name) {
+    return const_cast<Texture *>(const_cast<const TextureManager *>(this)->texture(name));
+}
+
 const std::vector<const Texture *> &TextureManager::textures() const {
     return m_textures;
 }
@@ -164,6 +247,7 @@ void TextureManager::prepare() {
 
 void TextureManager::updateTextures() {
     m_texturesByName.clear();
+    m_texturesByInternedName.clear();
     m_textures.clear();
 
     for (auto &collection : m_collections) {
@@ -181,6 +265,10 @@ void TextureManager::updateTextures() {
         }
     }
 
+    for (const auto &[key, texture] : m_texturesByName) {
+        m_texturesByInternedName.emplace(TextureName{key}, texture);
+    }
+
     m_textures = kdl::vec_transform(kdl::map_values(m_texturesByName), [](auto *t) {
         return const_cast<const Texture *>(t);
     });
@@ -20,10 +20,13 @@
 #pragma once
 
 #include "Assets/TextureCollection.h"
+#include "Assets/TextureName.h"
 
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom {
@@ -31,6 +34,10 @@ class Logger;
 
 namespace IO {
 class FileSystem;
+
+class TextureCache;
+
+enum class TextureLoadingMode;
 } // namespace IO
 
 namespace Model {
@@ -44,7 +51,12 @@ class TextureCollection;
 
 class TextureManager {
   private:
+    struct PrefetchState;
+
     Logger &m_logger;
+    std::shared_ptr<IO::TextureCache> m_textureCache;
+    IO::TextureLoadingMode m_loadingMode;
+    std::shared_ptr<PrefetchState> m_prefetchState;
 
     std::vector<TextureCollection> m_collections;
 
@@ -52,6 +64,7 @@ class TextureManager {
     std::vector<TextureCollection> m_toRemove;
 
     std::map<std::string, Texture *> m_texturesByName;
+    std::unordered_map<TextureName, Texture *> m_texturesByInternedName;
     std::vector<const Texture *> m_textures;
 
     int m_minFilter;
@@ -63,13 +76,35 @@ class TextureManager {
 
     ~TextureManager();
 
-    void reload(const IO::FileSystem &fs, const Model::TextureConfig &textureConfig);
+    /**
+     * Sets the cache that stores decoded textures across sessions. Pass null to disable
+     * caching.
+     */
+    void setTextureCache(std::shared_ptr<IO::TextureCache> textureCache);
+
+    /**
+     * Sets whether textures are decoded when their collections are loaded or when they
+     * are needed. Only affects collections that are loaded afterwards.
+     */
+    void setTextureLoadingMode(IO::TextureLoadingMode loadingMode);
+
+    /**
+     * Decodes the lazily loaded textures that are in use on the worker threads of the
+     * global thread pool, so that they are ready by the time they are rendered.
+     */
+    void prefetchUsedTextures();
+
+    /**
+     * Reloads the texture collections from the given file system. Lazily loaded textures
+     * keep the file system alive until they are decoded.
+     */
+    void reload(std::shared_ptr<const IO::FileSystem> fs, const Model::TextureConfig &textureConfig);
 
     // for testing
     void setTextureCollections(std::vector<TextureCollection> collections);
 
   private:
-    void setTextureCollections(const std::vector<std::filesystem::path> &paths, const IO::FileSystem &fs, const Model::TextureConfig &textureConfig);
+    void setTextureCollections(const std::vector<std::filesystem::path> &paths, const std::shared_ptr<const IO::FileSystem> &fs, const Model::TextureConfig &textureConfig);
 
     void addTextureCollection(Assets::TextureCollection collection);
 
@@ -84,11 +119,17 @@ class TextureManager {
 
     Texture *texture(const std::string &name);
 
+    const Texture *texture(const TextureName &name) const;
+
+    Texture *texture(const TextureName &name);
+
     const std::vector<const Texture *> &textures() const;
 
     const std::vector<TextureCollection> &collections() const;
 
   private:
+    void cancelPrefetch();
+
     void resetTextureMode();
 
     void prepare();
@@ -0,0 +1,79 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureName.h"
+
+#include <kdl/string_format.h>
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace TrenchBroom {
+namespace Assets {
+
+TextureName::TextureName() : TextureName{std::string_view{}} {
+}
+
+TextureName::TextureName(const std::string_view name) : m_entry{intern(name)} {
+}
+
+std::ostream &operator<<(std::ostream &str, const TextureName &textureName) {
+    str << textureName.name();
+    return str;
+}
+
+const TextureName::Entry *TextureName::intern(const std::string_view name) {
+    // the keys are views of the names stored in the entries
+    static auto mutex = std::shared_mutex{};
+    static auto entries = std::unordered_map<std::string_view, std::unique_ptr<Entry>>{};
+
+    {
+        const auto lock = std::shared_lock{mutex};
+        if (const auto it = entries.find(name); it != entries.end()) {
+            return it->second.get();
+        }
+    }
+
+    const auto insert = [&](const std::string_view n) {
+        if (const auto it = entries.find(n); it != entries.end()) {
+            return it->second.get();
+        }
+
+        auto entry = std::make_unique<Entry>(Entry{std::string{n}, nullptr});
+        auto *result = entry.get();
+        entries.emplace(result->name, std::move(entry));
+        return result;
+    };
+
+    const auto lock = std::unique_lock{mutex};
+    auto *entry = insert(name);
+    if (!entry->lowerCase) {
+        const auto lowerCaseName = kdl::str_to_lower(name);
+        auto *lowerCaseEntry = lowerCaseName == name ? entry : insert(lowerCaseName);
+        lowerCaseEntry->lowerCase = lowerCaseEntry;
+        entry->lowerCase = lowerCaseEntry;
+    }
+    return entry;
+}
+
+} // namespace Assets
+} // namespace TrenchBroom
@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace TrenchBroom {
+namespace Assets {
+
+/**
+ * An interned texture name.
+ *
+ * All texture names are stored in a global pool that is shared by all documents, and a
+ * texture name only refers to its entry in the pool. Copying, comparing and hashing
+ * texture names is therefore as cheap as copying, comparing and hashing a pointer. The
+ * pool never shrinks, but a map only uses a few hundred distinct texture names.
+ *
+ * The pool is thread safe so that texture names can be created while parsing a map on
+ * several threads.
+ */
+class TextureName {
+  private:
+    struct Entry {
+      std::string name;
+      const Entry *lowerCase;
+    };
+
+    const Entry *m_entry;
+
+  public:
+    /**
+     * Creates an empty texture name.
+     */
+    TextureName();
+
+    /**
+     * Creates a texture name for the given string.
+     */
+    explicit TextureName(std::string_view name);
+
+    /**
+     * Returns the name as a string.
+     */
+    const std::string &name() const { return m_entry->name; }
+
+    /**
+     * Returns the lower case version of this name. Texture lookups are case insensitive,
+     * so this is used as the key to look up textures.
+     */
+    TextureName lowerCase() const { return TextureName{m_entry->lowerCase}; }
+
+    bool empty() const { return m_entry->name.empty(); }
+
+    friend bool operator==(const TextureName &lhs, const TextureName &rhs) { return lhs.m_entry == rhs.m_entry; }
+
+    friend bool operator!=(const TextureName &lhs, const TextureName &rhs) { return lhs.m_entry != rhs.m_entry; }
+
+    friend std::ostream &operator<<(std::ostream &str, const TextureName &textureName);
+
+  private:
+    explicit TextureName(const Entry *entry) : m_entry{entry} {
+    }
+
+    static const Entry *intern(std::string_view name);
+
+    friend struct std::hash<TextureName>;
+};
+
+} // namespace Assets
+} // namespace TrenchBroom
+
+template<> struct std::hash<TrenchBroom::Assets::TextureName> {
+    size_t operator()(const TrenchBroom::Assets::TextureName &textureName) const noexcept {
+        return std::hash<const void *>{}(textureName.m_entry);
+    }
+};
@@ -24,6 +24,8 @@
 #include "Ensure.h"
 #include "Macros.h"
 
+#include <kdl/vector_utils.h>
+
 #include <sstream>
 
 namespace TrenchBroom {
@@ -73,6 +75,16 @@ Expression Expression::optimize() const {
     return Expression{m_expression->optimize(), m_line, m_column};
 }
 
+std::vector<std::string> Expression::variableNames() const {
+    auto names = std::vector<std::string>{};
+    appendVariableNames(names);
+    return kdl::vec_sort_and_remove_duplicates(std::move(names));
+}
+
+void Expression::appendVariableNames(std::vector<std::string> &names) const {
+    m_expression->appendVariableNames(names);
+}
+
 size_t Expression::line() const {
     return m_line;
 }
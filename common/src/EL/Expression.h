@@ -25,6 +25,7 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
 namespace EL {
@@ -75,6 +76,14 @@ class Expression {
 
     Expression optimize() const;
 
+    /**
+     * Returns the names of the variables that this expression reads when it is evaluated,
+     * sorted and without duplicates.
+     */
+    std::vector<std::string> variableNames() const;
+
+    void appendVariableNames(std::vector<std::string> &names) const;
+
     size_t line() const;
 
     size_t column() const;
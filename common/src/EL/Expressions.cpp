@@ -93,6 +93,9 @@ std::unique_ptr<ExpressionImpl> LiteralExpression::optimize() const {
     return std::make_unique<LiteralExpression>(m_value);
 }
 
+void LiteralExpression::appendVariableNames(std::vector<std::string> &) const {
+}
+
 bool LiteralExpression::operator==(const ExpressionImpl &rhs) const {
     return rhs == *this;
 }
@@ -116,6 +119,10 @@ std::unique_ptr<ExpressionImpl> VariableExpression::optimize() const {
     return std::make_unique<VariableExpression>(m_variableName);
 }
 
+void VariableExpression::appendVariableNames(std::vector<std::string> &names) const {
+    names.push_back(m_variableName);
+}
+
 bool VariableExpression::operator==(const ExpressionImpl &rhs) const {
     return rhs == *this;
 }
@@ -170,6 +177,12 @@ std::unique_ptr<ExpressionImpl> ArrayExpression::optimize() const {
     return std::make_unique<LiteralExpression>(Value{std::move(values)});
 }
 
+void ArrayExpression::appendVariableNames(std::vector<std::string> &names) const {
+    for (const auto &element : m_elements) {
+        element.appendVariableNames(names);
+    }
+}
+
 bool ArrayExpression::operator==(const ExpressionImpl &rhs) const {
     return rhs == *this;
 }
@@ -223,6 +236,12 @@ std::unique_ptr<ExpressionImpl> MapExpression::optimize() const {
     return std::make_unique<LiteralExpression>(Value{std::move(values)});
 }
 
+void MapExpression::appendVariableNames(std::vector<std::string> &names) const {
+    for (const auto &[key, expression] : m_elements) {
+        expression.appendVariableNames(names);
+    }
+}
+
 bool MapExpression::operator==(const ExpressionImpl &rhs) const {
     return rhs == *this;
 }
@@ -349,6 +368,10 @@ std::unique_ptr<ExpressionImpl> UnaryExpression::optimize() const {
     return std::make_unique<UnaryExpression>(m_operator, std::move(optimizedOperand));
 }
 
+void UnaryExpression::appendVariableNames(std::vector<std::string> &names) const {
+    m_operand.appendVariableNames(names);
+}
+
 bool UnaryExpression::operator==(const ExpressionImpl &rhs) const {
     return rhs == *this;
 }
@@ -883,6 +906,11 @@ size_t BinaryExpression::precedence() const {
     };
 }
 
+void BinaryExpression::appendVariableNames(std::vector<std::string> &names) const {
+    m_leftOperand.appendVariableNames(names);
+    m_rightOperand.appendVariableNames(names);
+}
+
 bool BinaryExpression::operator==(const ExpressionImpl &rhs) const {
     return rhs == *this;
 }
@@ -977,6 +1005,11 @@ std::unique_ptr<ExpressionImpl> SubscriptExpression::optimize() const {
     return std::make_unique<SubscriptExpression>(std::move(optimizedLeftOperand), std::move(optimizedRightOperand));
 }
 
+void SubscriptExpression::appendVariableNames(std::vector<std::string> &names) const {
+    m_leftOperand.appendVariableNames(names);
+    m_rightOperand.appendVariableNames(names);
+}
+
 bool SubscriptExpression::operator==(const ExpressionImpl &rhs) const {
     return rhs == *this;
 }
@@ -1015,6 +1048,12 @@ std::unique_ptr<ExpressionImpl> SwitchExpression::optimize() const {
     return std::make_unique<SwitchExpression>(std::move(optimizedExpressions));
 }
 
+void SwitchExpression::appendVariableNames(std::vector<std::string> &names) const {
+    for (const auto &case_ : m_cases) {
+        case_.appendVariableNames(names);
+    }
+}
+
 bool SwitchExpression::operator==(const ExpressionImpl &rhs) const {
     return rhs == *this;
 }
@@ -38,6 +38,8 @@ class ExpressionImpl {
 
     virtual std::unique_ptr<ExpressionImpl> optimize() const = 0;
 
+    virtual void appendVariableNames(std::vector<std::string> &names) const = 0;
+
     virtual size_t precedence() const;
 
     virtual bool operator==(const ExpressionImpl &rhs) const = 0;
@@ -77,6 +79,8 @@ class LiteralExpression : public ExpressionImpl {
 
     std::unique_ptr<ExpressionImpl> optimize() const override;
 
+    void appendVariableNames(std::vector<std::string> &names) const override;
+
     bool operator==(const ExpressionImpl &rhs) const override;
 
     bool operator==(const LiteralExpression &rhs) const override;
@@ -96,6 +100,8 @@ class VariableExpression : public ExpressionImpl {
 
     std::unique_ptr<ExpressionImpl> optimize() const override;
 
+    void appendVariableNames(std::vector<std::string> &names) const override;
+
     bool operator==(const ExpressionImpl &rhs) const override;
 
     bool operator==(const VariableExpression &rhs) const override;
@@ -115,6 +121,8 @@ class ArrayExpression : public ExpressionImpl {
 
     std::unique_ptr<ExpressionImpl> optimize() const override;
 
+    void appendVariableNames(std::vector<std::string> &names) const override;
+
     bool operator==(const ExpressionImpl &rhs) const override;
 
     bool operator==(const ArrayExpression &rhs) const override;
@@ -134,6 +142,8 @@ class MapExpression : public ExpressionImpl {
 
     std::unique_ptr<ExpressionImpl> optimize() const override;
 
+    void appendVariableNames(std::vector<std::string> &names) const override;
+
     bool operator==(const ExpressionImpl &rhs) const override;
 
     bool operator==(const MapExpression &rhs) const override;
@@ -158,6 +168,8 @@ class UnaryExpression : public ExpressionImpl {
 
     std::unique_ptr<ExpressionImpl> optimize() const override;
 
+    void appendVariableNames(std::vector<std::string> &names) const override;
+
     bool operator==(const ExpressionImpl &rhs) const override;
 
     bool operator==(const UnaryExpression &rhs) const override;
@@ -190,6 +202,8 @@ class BinaryExpression : public ExpressionImpl {
 
     std::unique_ptr<ExpressionImpl> optimize() const override;
 
+    void appendVariableNames(std::vector<std::string> &names) const override;
+
     size_t precedence() const override;
 
     bool operator==(const ExpressionImpl &rhs) const override;
@@ -215,6 +229,8 @@ class SubscriptExpression : public ExpressionImpl {
 
     std::unique_ptr<ExpressionImpl> optimize() const override;
 
+    void appendVariableNames(std::vector<std::string> &names) const override;
+
     bool operator==(const ExpressionImpl &rhs) const override;
 
     bool operator==(const SubscriptExpression &rhs) const override;
@@ -234,6 +250,8 @@ class SwitchExpression : public ExpressionImpl {
 
     std::unique_ptr<ExpressionImpl> optimize() const override;
 
+    void appendVariableNames(std::vector<std::string> &names) const override;
+
     bool operator==(const ExpressionImpl &rhs) const override;
 
     bool operator==(const SwitchExpression &rhs) const override;
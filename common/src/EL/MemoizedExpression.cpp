@@ -0,0 +1,139 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoizedExpression.h"
+
+#include "EL/EvaluationContext.h"
+#include "EL/Value.h"
+#include "EL/VariableStore.h"
+
+#include <kdl/vector_utils.h>
+
+#include <functional>
+#include <mutex>
+#include <ostream>
+
+namespace TrenchBroom {
+namespace EL {
+struct MemoizedExpression::Memo {
+    static constexpr size_t Capacity = 32;
+
+    struct Entry {
+        size_t hash;
+        std::vector<Value> variableValues;
+        Value value;
+    };
+
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    // once the memo is full, the entries are replaced in the order in which they were added
+    size_t nextEntry = 0;
+};
+
+namespace {
+/**
+ * Hashes the given values so that most memoized entries can be skipped without comparing
+ * their values. Only scalar values and strings contribute to the hash.
+ */
+size_t hashValues(const std::vector<Value> &values) {
+    auto hash = size_t(0);
+    for (const auto &value : values) {
+        auto valueHash = std::hash<ValueType>{}(value.type());
+        switch (value.type()) {
+        case ValueType::Boolean:valueHash ^= std::hash<BooleanType>{}(value.booleanValue());
+            break;
+        case ValueType::String:valueHash ^= std::hash<StringType>{}(value.stringValue());
+            break;
+        case ValueType::Number:valueHash ^= std::hash<NumberType>{}(value.numberValue());
+            break;
+        case ValueType::Array:
+        case ValueType::Map:
+        case ValueType::Range:
+        case ValueType::Null:
+        case ValueType::Undefined:break;
+        }
+        hash = hash * 31u + valueHash;
+    }
+    return hash;
+}
+} // namespace
+
+MemoizedExpression::MemoizedExpression(Expression expression)
+    : m_expression{std::move(expression)}, m_variableNames{m_expression.variableNames()}, m_memo{std::make_shared<Memo>()} {
+}
+
+const Expression &MemoizedExpression::expression() const {
+    return m_expression;
+}
+
+const std::vector<std::string> &MemoizedExpression::variableNames() const {
+    return m_variableNames;
+}
+
+Value MemoizedExpression::evaluate(const VariableStore &store) const {
+    auto variableValues = kdl::vec_transform(m_variableNames, [&](const auto &name) { return store.value(name); });
+    const auto hash = hashValues(variableValues);
+
+    {
+        const auto lock = std::lock_guard{m_memo->mutex};
+        for (const auto &entry : m_memo->entries) {
+            if (entry.hash == hash && entry.variableValues == variableValues) {
+                return entry.value;
+            }
+        }
+    }
+
+    // don't hold the lock while evaluating, the expression might throw
+    const auto context = EvaluationContext{store};
+    auto value = m_expression.evaluate(context);
+
+    const auto lock = std::lock_guard{m_memo->mutex};
+    auto entry = Memo::Entry{hash, std::move(variableValues), value};
+    if (m_memo->entries.size() < Memo::Capacity) {
+        m_memo->entries.push_back(std::move(entry));
+    } else {
+        m_memo->entries[m_memo->nextEntry] = std::move(entry);
+        m_memo->nextEntry = (m_memo->nextEntry + 1u) % Memo::Capacity;
+    }
+
+    return value;
+}
+
+size_t MemoizedExpression::line() const {
+    return m_expression.line();
+}
+
+size_t MemoizedExpression::column() const {
+    return m_expression.column();
+}
+
+bool operator==(const MemoizedExpression &lhs, const MemoizedExpression &rhs) {
+    return lhs.m_expression == rhs.m_expression;
+}
+
+bool operator!=(const MemoizedExpression &lhs, const MemoizedExpression &rhs) {
+    return !(lhs == rhs);
+}
+
+std::ostream &operator<<(std::ostream &str, const MemoizedExpression &exp) {
+    str << exp.m_expression;
+    return str;
+}
+} // namespace EL
+} // namespace TrenchBroom
@@ -0,0 +1,84 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "EL/EL_Forward.h"
+#include "EL/Expression.h"
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TrenchBroom {
+namespace EL {
+/**
+ * An expression that memoizes the results of evaluating it.
+ *
+ * The result of evaluating an expression only depends on the values of the variables that
+ * it reads, so the results are memoized together with the values of these variables.
+ * Evaluating the expression with a variable store that contains the same values for these
+ * variables returns the memoized result instead of evaluating the expression again. This
+ * pays off for expressions that are evaluated for many entities which share most of their
+ * property values, such as model definitions.
+ *
+ * Only the most recently computed results are kept. Copies of a memoized expression share
+ * their memoized results, and a memoized expression can be evaluated by several threads at
+ * the same time.
+ */
+class MemoizedExpression {
+  private:
+    struct Memo;
+
+    Expression m_expression;
+    std::vector<std::string> m_variableNames;
+    std::shared_ptr<Memo> m_memo;
+
+  public:
+    explicit MemoizedExpression(Expression expression);
+
+    const Expression &expression() const;
+
+    /**
+     * Returns the names of the variables whose values the memoized results depend on.
+     */
+    const std::vector<std::string> &variableNames() const;
+
+    /**
+     * Evaluates the expression using the given variable store to interpolate variables, or
+     * returns the memoized result if the expression was evaluated with the same variable
+     * values before.
+     *
+     * @throws EL::Exception if the expression could not be evaluated
+     */
+    Value evaluate(const VariableStore &store) const;
+
+    size_t line() const;
+
+    size_t column() const;
+
+    friend bool operator==(const MemoizedExpression &lhs, const MemoizedExpression &rhs);
+
+    friend bool operator!=(const MemoizedExpression &lhs, const MemoizedExpression &rhs);
+
+    friend std::ostream &operator<<(std::ostream &str, const MemoizedExpression &exp);
+};
+} // namespace EL
+} // namespace TrenchBroom
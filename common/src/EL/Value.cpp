@@ -34,6 +34,7 @@
 #include <iterator>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 namespace TrenchBroom {
 namespace EL {
@@ -45,63 +46,83 @@ UndefinedType::UndefinedType() = default;
 
 const UndefinedType UndefinedType::Value = UndefinedType{};
 
+namespace {
+template<typename T> struct IsSharedPtr : std::false_type {};
+
+template<typename T> struct IsSharedPtr<std::shared_ptr<T>> : std::true_type {};
+} // namespace
+
+/**
+ * Calls the given visitor with the value stored in this value, dereferencing shared
+ * values.
+ */
+template<typename Visitor> decltype(auto) Value::visit(Visitor &&visitor) const {
+    return std::visit([&](const auto &value) -> decltype(auto) {
+        if constexpr (IsSharedPtr<std::decay_t<decltype(value)>>::value) {
+            return visitor(*value);
+        } else {
+            return visitor(value);
+        }
+    }, m_value);
+}
+
 const Value Value::Null = Value{NullType::Value};
 const Value Value::Undefined = Value{UndefinedType::Value};
 
-Value::Value() : m_value{std::make_shared<VariantType>(NullType::Value)} {
+Value::Value() : m_value{NullType::Value} {
 }
 
 Value::Value(const BooleanType value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(value)}, m_expression{std::move(expression)} {
+    : m_value{value}, m_expression{std::move(expression)} {
 }
 
 Value::Value(StringType value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(std::move(value))}, m_expression{std::move(expression)} {
+    : m_value{std::move(value)}, m_expression{std::move(expression)} {
 }
 
 Value::Value(const char *value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(StringType(value))}, m_expression{std::move(expression)} {
+    : m_value{StringType(value)}, m_expression{std::move(expression)} {
 }
 
 Value::Value(const NumberType value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(value)}, m_expression{std::move(expression)} {
+    : m_value{value}, m_expression{std::move(expression)} {
 }
 
 Value::Value(const int value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(static_cast<NumberType>(value))}, m_expression{std::move(expression)} {
+    : m_value{static_cast<NumberType>(value)}, m_expression{std::move(expression)} {
 }
 
 Value::Value(const long value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(static_cast<NumberType>(value))}, m_expression{std::move(expression)} {
+    : m_value{static_cast<NumberType>(value)}, m_expression{std::move(expression)} {
 }
 
 Value::Value(const size_t value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(static_cast<NumberType>(value))}, m_expression{std::move(expression)} {
+    : m_value{static_cast<NumberType>(value)}, m_expression{std::move(expression)} {
 }
 
 Value::Value(ArrayType value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(std::move(value))}, m_expression{std::move(expression)} {
+    : m_value{std::make_shared<const ArrayType>(std::move(value))}, m_expression{std::move(expression)} {
 }
 
 Value::Value(MapType value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(std::move(value))}, m_expression{std::move(expression)} {
+    : m_value{std::make_shared<const MapType>(std::move(value))}, m_expression{std::move(expression)} {
 }
 
 Value::Value(RangeType value, std::optional<Expression> expression)
-    : m_value{std::make_shared<VariantType>(std::move(value))}, m_expression{std::move(expression)} {
+    : m_value{std::make_shared<const RangeType>(std::move(value))}, m_expression{std::move(expression)} {
 }
 
-Value::Value(NullType value, std::optional<Expression> expression) : m_value{std::make_shared<VariantType>(value)}, m_expression{std::move(expression)} {
+Value::Value(NullType value, std::optional<Expression> expression) : m_value{value}, m_expression{std::move(expression)} {
 }
 
-Value::Value(UndefinedType value, std::optional<Expression> expression) : m_value{std::make_shared<VariantType>(value)}, m_expression{std::move(expression)} {
+Value::Value(UndefinedType value, std::optional<Expression> expression) : m_value{value}, m_expression{std::move(expression)} {
 }
 
 Value::Value(Value value, std::optional<Expression> expression) : m_value{std::move(value.m_value)}, m_expression{std::move(expression)} {
 }
 
 ValueType Value::type() const {
-    return std::visit(kdl::overload([](const BooleanType &) { return ValueType::Boolean; }, [](const StringType &) { return ValueType::String; }, [](const NumberType &) { return ValueType::Number; }, [](const ArrayType &) { return ValueType::Array; }, [](const MapType &) { return ValueType::Map; }, [](const RangeType &) { return ValueType::Range; }, [](const NullType &) { return ValueType::Null; }, [](const UndefinedType &) { return ValueType::Undefined; }), *m_value);
+    return visit(kdl::overload([](const BooleanType &) { return ValueType::Boolean; }, [](const StringType &) { return ValueType::String; }, [](const NumberType &) { return ValueType::Number; }, [](const ArrayType &) { return ValueType::Array; }, [](const MapType &) { return ValueType::Map; }, [](const RangeType &) { return ValueType::Range; }, [](const NullType &) { return ValueType::Null; }, [](const UndefinedType &) { return ValueType::Undefined; }));
 }
 
 bool Value::hasType(ValueType type) const {
@@ -129,7 +150,7 @@ size_t Value::column() const {
 }
 
 const BooleanType &Value::booleanValue() const {
-    return std::visit(kdl::overload([&](const BooleanType &b) -> const BooleanType & { return b; }, [&](const StringType &) -> const BooleanType & {
+    return visit(kdl::overload([&](const BooleanType &b) -> const BooleanType & { return b; }, [&](const StringType &) -> const BooleanType & {
         throw DereferenceError{describe(), type(), ValueType::String};
     }, [&](const NumberType &) -> const BooleanType & {
         throw DereferenceError{describe(), type(), ValueType::Number};
@@ -144,11 +165,11 @@ const BooleanType &Value::booleanValue() const {
         return b;
     }, [&](const UndefinedType &) -> const BooleanType & {
         throw DereferenceError{describe(), type(), ValueType::Undefined};
-    }), *m_value);
+    }));
 }
 
 const StringType &Value::stringValue() const {
-    return std::visit(kdl::overload([&](const BooleanType &) -> const StringType & {
+    return visit(kdl::overload([&](const BooleanType &) -> const StringType & {
         throw DereferenceError{describe(), type(), ValueType::Boolean};
     }, [&](const StringType &s) -> const StringType & { return s; }, [&](const NumberType &) -> const StringType & {
         throw DereferenceError{describe(), type(), ValueType::Number};
@@ -163,11 +184,11 @@ const StringType &Value::stringValue() const {
         return s;
     }, [&](const UndefinedType &) -> const StringType & {
         throw DereferenceError{describe(), type(), ValueType::Undefined};
-    }), *m_value);
+    }));
 }
 
 const NumberType &Value::numberValue() const {
-    return std::visit(kdl::overload([&](const BooleanType &) -> const NumberType & {
+    return visit(kdl::overload([&](const BooleanType &) -> const NumberType & {
         throw DereferenceError{describe(), type(), ValueType::Boolean};
     }, [&](const StringType &) -> const NumberType & {
         throw DereferenceError{describe(), type(), ValueType::String};
@@ -182,7 +203,7 @@ const NumberType &Value::numberValue() const {
         return n;
     }, [&](const UndefinedType &) -> const NumberType & {
         throw DereferenceError{describe(), type(), ValueType::Undefined};
-    }), *m_value);
+    }));
 }
 
 IntegerType Value::integerValue() const {
@@ -190,7 +211,7 @@ IntegerType Value::integerValue() const {
 }
 
 const ArrayType &Value::arrayValue() const {
-    return std::visit(kdl::overload([&](const BooleanType &) -> const ArrayType & {
+    return visit(kdl::overload([&](const BooleanType &) -> const ArrayType & {
         throw DereferenceError{describe(), type(), ValueType::Boolean};
     }, [&](const StringType &) -> const ArrayType & {
         throw DereferenceError{describe(), type(), ValueType::String};
@@ -205,11 +226,11 @@ const ArrayType &Value::arrayValue() const {
         return a;
     }, [&](const UndefinedType &) -> const ArrayType & {
         throw DereferenceError{describe(), type(), ValueType::Undefined};
-    }), *m_value);
+    }));
 }
 
 const MapType &Value::mapValue() const {
-    return std::visit(kdl::overload([&](const BooleanType &) -> const MapType & {
+    return visit(kdl::overload([&](const BooleanType &) -> const MapType & {
         throw DereferenceError{describe(), type(), ValueType::Boolean};
     }, [&](const StringType &) -> const MapType & {
         throw DereferenceError{describe(), type(), ValueType::String};
@@ -224,11 +245,11 @@ const MapType &Value::mapValue() const {
         return m;
     }, [&](const UndefinedType &) -> const MapType & {
         throw DereferenceError{describe(), type(), ValueType::Undefined};
-    }), *m_value);
+    }));
 }
 
 const RangeType &Value::rangeValue() const {
-    return std::visit(kdl::overload([&](const BooleanType &) -> const RangeType & {
+    return visit(kdl::overload([&](const BooleanType &) -> const RangeType & {
         throw DereferenceError{describe(), type(), ValueType::Boolean};
     }, [&](const StringType &) -> const RangeType & {
         throw DereferenceError{describe(), type(), ValueType::String};
@@ -242,7 +263,7 @@ const RangeType &Value::rangeValue() const {
         throw DereferenceError{describe(), type(), ValueType::Null};
     }, [&](const UndefinedType &) -> const RangeType & {
         throw DereferenceError{describe(), type(), ValueType::Undefined};
-    }), *m_value);
+    }));
 }
 
 const std::vector<std::string> Value::asStringList() const {
@@ -269,11 +290,11 @@ const std::vector<std::string> Value::asStringSet() const {
 }
 
 size_t Value::length() const {
-    return std::visit(kdl::overload([](const BooleanType &) -> size_t { return 1u; }, [](const StringType &s) -> size_t { return s.length(); }, [](const NumberType &) -> size_t { return 1u; }, [](const ArrayType &a) -> size_t { return a.size(); }, [](const MapType &m) -> size_t { return m.size(); }, [](const RangeType &r) -> size_t { return r.size(); }, [](const NullType &) -> size_t { return 0u; }, [](const UndefinedType &) -> size_t { return 0u; }), *m_value);
+    return visit(kdl::overload([](const BooleanType &) -> size_t { return 1u; }, [](const StringType &s) -> size_t { return s.length(); }, [](const NumberType &) -> size_t { return 1u; }, [](const ArrayType &a) -> size_t { return a.size(); }, [](const MapType &m) -> size_t { return m.size(); }, [](const RangeType &r) -> size_t { return r.size(); }, [](const NullType &) -> size_t { return 0u; }, [](const UndefinedType &) -> size_t { return 0u; }));
 }
 
 bool Value::convertibleTo(const ValueType toType) const {
-    return std::visit(kdl::overload([&](const BooleanType &) {
+    return visit(kdl::overload([&](const BooleanType &) {
         switch (toType) {
         case ValueType::Boolean:
         case ValueType::String:
@@ -388,11 +409,11 @@ bool Value::convertibleTo(const ValueType toType) const {
         }
 
         return false;
-    }), *m_value);
+    }));
 }
 
 Value Value::convertTo(const ValueType toType) const {
-    return std::visit(kdl::overload([&](const BooleanType &b) -> Value {
+    return visit(kdl::overload([&](const BooleanType &b) -> Value {
         switch (toType) {
         case ValueType::Boolean:return *this;
         case ValueType::String:return Value{b ? "true" : "false", m_expression};
@@ -507,7 +528,7 @@ Value Value::convertTo(const ValueType toType) const {
         }
 
         throw ConversionError{describe(), type(), toType};
-    }), *m_value);
+    }));
 }
 
 std::optional<Value> Value::tryConvertTo(const ValueType toType) const {
@@ -525,7 +546,7 @@ std::string Value::asString(const bool multiline) const {
 }
 
 void Value::appendToStream(std::ostream &str, const bool multiline, const std::string &indent) const {
-    std::visit(kdl::overload([&](const BooleanType &b) { str << (b ? "true" : "false"); }, [&](const StringType &s) {
+    visit(kdl::overload([&](const BooleanType &b) { str << (b ? "true" : "false"); }, [&](const StringType &s) {
         // Unescaping happens in IO::ELParser::parseLiteral
         str << "\"" << kdl::str_escape(s, "\\\"") << "\"";
     }, [&](const NumberType &n) {
@@ -611,7 +632,7 @@ void Value::appendToStream(std::ostream &str, const bool multiline, const std::s
             }
         }
         str << "]";
-    }, [&](const NullType &) { str << "null"; }, [&](const UndefinedType &) { str << "undefined"; }), *m_value);
+    }, [&](const NullType &) { str << "null"; }, [&](const UndefinedType &) { str << "undefined"; }));
 }
 
 static size_t computeIndex(const long index, const size_t indexableSize) {
@@ -949,7 +970,7 @@ Value Value::operator[](const char *key) const {
 }
 
 bool operator==(const Value &lhs, const Value &rhs) {
-    return std::visit(kdl::overload([](const BooleanType &lhsBool, const BooleanType &rhsBool) {
+    const auto equals = kdl::overload([](const BooleanType &lhsBool, const BooleanType &rhsBool) {
         return lhsBool == rhsBool;
     }, [](const StringType &lhsString, const StringType &rhsString) {
         return lhsString == rhsString;
@@ -959,7 +980,11 @@ bool operator==(const Value &lhs, const Value &rhs) {
         return lhsArray == rhsArray;
     }, [](const MapType &lhsMap, const MapType &rhsMap) { return lhsMap == rhsMap; }, [](const RangeType &lhsRange, const RangeType &rhsRange) {
         return lhsRange == rhsRange;
-    }, [](const NullType &, const NullType &) { return true; }, [](const UndefinedType &, const UndefinedType &) { return true; }, [](const auto &, const auto &) { return false; }), *lhs.m_value, *rhs.m_value);
+    }, [](const NullType &, const NullType &) { return true; }, [](const UndefinedType &, const UndefinedType &) { return true; }, [](const auto &, const auto &) { return false; });
+
+    return lhs.visit([&](const auto &lhsValue) {
+        return rhs.visit([&](const auto &rhsValue) { return equals(lhsValue, rhsValue); });
+    });
 }
 
 bool operator!=(const Value &lhs, const Value &rhs) {
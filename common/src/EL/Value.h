@@ -50,8 +50,13 @@ class UndefinedType {
 
 class Value {
   private:
-    using VariantType = std::variant<BooleanType, StringType, NumberType, ArrayType, MapType, RangeType, NullType, UndefinedType>;
-    std::shared_ptr<VariantType> m_value;
+    /*
+     * Booleans, numbers and strings are stored inline so that evaluating an expression does
+     * not allocate memory for every intermediate value. Arrays, maps and ranges can be
+     * large, so they are shared between copies of a value.
+     */
+    using VariantType = std::variant<BooleanType, StringType, NumberType, std::shared_ptr<const ArrayType>, std::shared_ptr<const MapType>, std::shared_ptr<const RangeType>, NullType, UndefinedType>;
+    VariantType m_value;
     std::optional<Expression> m_expression;
 
   public:
@@ -157,6 +162,9 @@ class Value {
     friend bool operator!=(const Value &lhs, const Value &rhs);
 
     friend std::ostream &operator<<(std::ostream &lhs, const Value &rhs);
+
+  private:
+    template<typename Visitor> decltype(auto) visit(Visitor &&visitor) const;
 };
 } // namespace EL
 } // namespace TrenchBroom
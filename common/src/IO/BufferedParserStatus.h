@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "IO/ParserStatus.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+namespace IO {
+/**
+ * Collects the messages logged to it and passes them on to another parser status when
+ * flushed. This allows parsers running on worker threads to report their messages in a
+ * deterministic order. Progress updates are dropped.
+ */
+class BufferedParserStatus : public ParserStatus {
+  private:
+    ParserStatus &m_target;
+    std::vector<std::pair<LogLevel, std::string>> m_messages;
+
+  public:
+    /**
+     * Creates a buffer for the given target status. Messages are formatted with the target's
+     * prefix.
+     */
+    explicit BufferedParserStatus(ParserStatus &target);
+
+    /**
+     * Passes the collected messages to the target status in the order in which they were
+     * logged and clears them. Must be called on the thread that owns the target status.
+     */
+    void flush();
+
+  private:
+    void doProgress(double progress) override;
+
+    void doLog(LogLevel level, const std::string &str) override;
+};
+} // namespace IO
+} // namespace TrenchBroom
@@ -51,6 +51,13 @@ Result<std::vector<std::filesystem::path>> find(const std::filesystem::path &pat
 
 Result<std::shared_ptr<CFile>> openFile(const std::filesystem::path &path);
 
+/**
+ * Opens the file at the given path and maps its contents into memory if it is large
+ * enough. The returned file must be released as soon as it has been read, see
+ * createMappedCFile.
+ */
+Result<std::shared_ptr<CFile>> openMappedFile(const std::filesystem::path &path);
+
 template<typename Stream, typename F> auto withStream(const std::filesystem::path &path, const std::ios::openmode mode, const F &function) -> kdl::wrap_result_t<decltype(function(std::declval<Stream &>())), Error> {
     using FnResultType = decltype(function(std::declval<Stream &>()));
     using ResultType = kdl::wrap_result_t<FnResultType, Error>;
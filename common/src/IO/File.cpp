@@ -26,6 +26,13 @@
 #include <cstdio>
 #include <cstring>
 
+#if defined _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
 namespace TrenchBroom::IO {
 
 File::File() = default;
@@ -86,9 +93,86 @@ Result<size_t> fileSize(std::FILE *file) {
 
     return static_cast<size_t>(size);
 }
+
+/**
+ * Smaller files are read through the C file API because mapping them costs more than it
+ * saves and every mapping occupies a slot in the process's limited number of mappings.
+ */
+constexpr size_t MinMappedFileSize = 64 * 1024;
 } // namespace
 
-CFile::CFile(kdl::resource<std::FILE *> file, const size_t size) : m_file{std::move(file)}, m_size{size} {
+/**
+ * A read only memory mapping of the entire contents of a file.
+ */
+class FileMapping {
+  private:
+    const char *m_begin;
+    size_t m_size;
+#if defined _WIN32
+    HANDLE m_mappingHandle;
+#endif
+
+  public:
+#if defined _WIN32
+    FileMapping(const char *begin, const size_t size, HANDLE mappingHandle) : m_begin{begin}, m_size{size}, m_mappingHandle{mappingHandle} {
+    }
+#else
+    FileMapping(const char *begin, const size_t size) : m_begin{begin}, m_size{size} {
+    }
+#endif
+
+    FileMapping(const FileMapping &) = delete;
+
+    FileMapping &operator=(const FileMapping &) = delete;
+
+    ~FileMapping() {
+#if defined _WIN32
+        UnmapViewOfFile(m_begin);
+        CloseHandle(m_mappingHandle);
+#else
+        munmap(const_cast<char *>(m_begin), m_size);
+#endif
+    }
+
+    const char *begin() const { return m_begin; }
+};
+
+namespace {
+std::shared_ptr<const FileMapping> mapFile(std::FILE *file, const size_t size) {
+    if (size < MinMappedFileSize) {
+        return nullptr;
+    }
+
+#if defined _WIN32
+    const auto fileHandle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file)));
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    auto mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        return nullptr;
+    }
+
+    const auto *view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mappingHandle);
+        return nullptr;
+    }
+
+    return std::make_shared<const FileMapping>(static_cast<const char *>(view), size, mappingHandle);
+#else
+    auto *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+    if (addr == MAP_FAILED) {
+        return nullptr;
+    }
+
+    return std::make_shared<const FileMapping>(static_cast<const char *>(addr), size);
+#endif
+}
+} // namespace
+
+CFile::CFile(kdl::resource<std::FILE *> file, const size_t size, std::shared_ptr<const FileMapping> mapping) : m_file{std::move(file)}, m_size{size}, m_mapping{std::move(mapping)} {
 }
 
 Reader CFile::reader() const {
@@ -103,12 +187,22 @@ std::FILE *CFile::file() const {
     return *m_file;
 }
 
+bool CFile::isMapped() const {
+    return m_mapping != nullptr;
+}
+
 std::unique_ptr<OwningBufferFile> CFile::buffer() const {
+    auto buffer = std::make_unique<char[]>(size());
+    if (m_mapping) {
+        std::memcpy(buffer.get(), m_mapping->begin(), size());
+        return std::make_unique<OwningBufferFile>(std::move(buffer), size());
+    }
+
+    auto guard = std::lock_guard{m_mutex};
     if (std::fseek(file(), 0, SEEK_SET)) {
         return nullptr;
     }
 
-    auto buffer = std::make_unique<char[]>(size());
     if (std::fread(buffer.get(), 1, size(), file()) != size()) {
         return nullptr;
     }
@@ -117,6 +211,14 @@ std::unique_ptr<OwningBufferFile> CFile::buffer() const {
 }
 
 Result<void> CFile::read(char *val, const size_t position, const size_t size) const {
+    if (m_mapping) {
+        if (position > m_size || size > m_size - position) {
+            return Error{"read failed: unexpected end of file"};
+        }
+        std::memcpy(val, m_mapping->begin() + position, size);
+        return kdl::void_success;
+    }
+
     auto guard = std::lock_guard{m_mutex};
 
     const auto currentPosition = std::ftell(m_file.get());
@@ -136,6 +238,14 @@ Result<void> CFile::read(char *val, const size_t position, const size_t size) co
 }
 
 Result<CFile::BufferType> CFile::buffer(const size_t position, const size_t size) const {
+    if (m_mapping) {
+        if (position > m_size || size > m_size - position) {
+            return Error{"read failed: unexpected end of file"};
+        }
+        // share ownership of the mapping instead of copying the requested region
+        return BufferType{m_mapping, const_cast<char *>(m_mapping->begin() + position)};
+    }
+
 #if defined __APPLE__
     // AppleClang doesn't support std::shared_ptr<T[]> (new as of C++17)
     auto buffer = BufferType{new char[size], std::default_delete<char[]>{}};
@@ -157,7 +267,17 @@ Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path &path) {
     return openPathAsFILE(path, "rb").and_then([](auto file) {
         return fileSize(*file).transform([&](auto size) {
             // NOLINTNEXTLINE
-            return std::shared_ptr<CFile>{new CFile{std::move(file), size}};
+            return std::shared_ptr<CFile>{new CFile{std::move(file), size, nullptr}};
+        });
+    });
+}
+
+Result<std::shared_ptr<CFile>> createMappedCFile(const std::filesystem::path &path) {
+    return openPathAsFILE(path, "rb").and_then([](auto file) {
+        return fileSize(*file).transform([&](auto size) {
+            auto mapping = mapFile(*file, size);
+            // NOLINTNEXTLINE
+            return std::shared_ptr<CFile>{new CFile{std::move(file), size, std::move(mapping)}};
         });
     });
 }
@@ -76,9 +76,18 @@ class OwningBufferFile : public File {
     size_t size() const override;
 };
 
+class FileMapping;
+
 /**
  * A file that is backed by a physical file on the disk. The file is opened in the
  * constructor and closed in the destructor.
+ *
+ * Files created by createMappedCFile are additionally mapped into memory read only if
+ * they are large enough. Reads from such files are served from the mapping without
+ * locking, and buffers requested from them point directly into the mapping instead of
+ * holding a private copy of the contents, so parsing a large file does not require any
+ * memory beyond the operating system's page cache. If the mapping cannot be created, the
+ * file falls back to reading through the C file API.
  */
 class CFile : public File {
   public:
@@ -92,16 +101,20 @@ class CFile : public File {
   private:
     kdl::resource<std::FILE *> m_file;
     size_t m_size;
+    std::shared_ptr<const FileMapping> m_mapping;
     mutable std::mutex m_mutex;
 
     /**
-     * Creates a new file with the given file ptr and size in bytes.
+     * Creates a new file with the given file ptr, size in bytes and optional memory
+     * mapping of its contents.
      */
-    CFile(kdl::resource<std::FILE *> file, size_t size);
+    CFile(kdl::resource<std::FILE *> file, size_t size, std::shared_ptr<const FileMapping> mapping);
 
   public:
     friend Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path &path);
 
+    friend Result<std::shared_ptr<CFile>> createMappedCFile(const std::filesystem::path &path);
+
     Reader reader() const override;
 
     size_t size() const override;
@@ -111,6 +124,11 @@ class CFile : public File {
      */
     std::FILE *file() const;
 
+    /**
+     * Indicates whether the contents of this file are mapped into memory.
+     */
+    bool isMapped() const;
+
     std::unique_ptr<OwningBufferFile> buffer() const;
 
   private:
@@ -125,6 +143,17 @@ class CFile : public File {
 
 Result<std::shared_ptr<CFile>> createCFile(const std::filesystem::path &path);
 
+/**
+ * Creates a file whose contents are mapped into memory if the file is large enough.
+ *
+ * Only use this for files that are read once and released right away, such as a map file
+ * during loading. If the file is truncated or rewritten on disk while it is mapped, reading
+ * from the mapping crashes the process, and on Windows the mapping prevents the file from
+ * being replaced. Files that are kept open, such as pak, wad and zip archives, must be
+ * created with createCFile.
+ */
+Result<std::shared_ptr<CFile>> createMappedCFile(const std::filesystem::path &path);
+
 /**
  * A file that is backed by a portion of a physical file.
  */
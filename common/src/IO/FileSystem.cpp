@@ -37,6 +37,10 @@ namespace TrenchBroom::IO {
 
 FileSystem::~FileSystem() = default;
 
+bool FileSystem::hasStaticContents() const {
+    return false;
+}
+
 Result<std::vector<std::filesystem::path>> FileSystem::find(const std::filesystem::path &path, const TraversalMode traversalMode, const PathMatcher &pathMatcher) const {
     if (path.is_absolute()) {
         return Error{"Path '" + path.string() + "' is absolute"};
@@ -50,6 +50,12 @@ class FileSystem {
      */
     virtual PathInfo pathInfo(const std::filesystem::path &path) const = 0;
 
+    /** Indicates whether the contents of this file system only change when it is explicitly
+     * reloaded. A VirtualFileSystem indexes the contents of such file systems when they are
+     * mounted instead of querying them for every lookup.
+     */
+    virtual bool hasStaticContents() const;
+
     /** Returns a vector of paths listing the contents of the directory  at the given path
      * that satisfy the given path matcher. The returned paths are relative to the root of
      * this file system.
@@ -51,38 +51,6 @@ template<typename I> auto findEntry(I begin, I end, const std::filesystem::path
     });
 }
 
-template<typename F> auto withEntry(const std::filesystem::path &searchPath, const ImageEntry &currentEntry, const std::filesystem::path &currentPath, const F &f, decltype(f(std::declval<const ImageEntry &>(), std::declval<const std::filesystem::path &>())) defaultResult) {
-    if (searchPath.empty()) {
-        return f(currentEntry, currentPath);
-    }
-
-    return std::visit(kdl::overload([&](const ImageDirectoryEntry &directoryEntry) {
-        const auto name = kdl::path_front(searchPath);
-        const auto entryIt = findEntry(directoryEntry.entries.begin(), directoryEntry.entries.end(), name);
-
-        return entryIt != directoryEntry.entries.end() ? withEntry(kdl::path_pop_front(searchPath), *entryIt, currentPath / name, f, defaultResult) : defaultResult;
-    }, [&](const ImageFileEntry &) { return defaultResult; }), currentEntry);
-}
-
-template<typename F> void withEntry(const std::filesystem::path &searchPath, const ImageEntry &currentEntry, const std::filesystem::path &currentPath, const F &f) {
-    if (searchPath.empty()) {
-        f(currentEntry, currentPath);
-    } else {
-        std::visit(kdl::overload([&](const ImageDirectoryEntry &directoryEntry) {
-            const auto name = kdl::path_front(searchPath);
-            const auto entryIt = findEntry(directoryEntry.entries.begin(), directoryEntry.entries.end(), name);
-
-            if (entryIt != directoryEntry.entries.end()) {
-                withEntry(kdl::path_pop_front(searchPath), *entryIt, currentPath / name, f);
-            }
-        }, [&](const ImageFileEntry &) {}), currentEntry);
-    }
-}
-
-const ImageEntry *findEntry(const std::filesystem::path &path, const ImageEntry &parent) {
-    return withEntry(path, parent, std::filesystem::path{}, [](const ImageEntry &entry, const std::filesystem::path &) { return &entry; }, nullptr);
-}
-
 ImageDirectoryEntry &findOrCreateDirectory(const std::filesystem::path &path, ImageDirectoryEntry &parent) {
     if (path.empty()) {
         return parent;
@@ -101,9 +69,27 @@ ImageDirectoryEntry &findOrCreateDirectory(const std::filesystem::path &path, Im
         return findOrCreateDirectory(kdl::path_pop_front(path), std::get<ImageDirectoryEntry>(parent.entries.emplace_back(ImageDirectoryEntry{std::move(name), {}})));
     }
 }
+
+std::string makeIndexKey(const std::filesystem::path &path) {
+    auto key = kdl::path_to_lower(path).generic_string();
+    if (!key.empty() && key.back() == '/') {
+        key.pop_back();
+    }
+    return key;
+}
+
+template<typename Index> void addToIndex(const ImageEntry &entry, const std::filesystem::path &entryPath, Index &index) {
+    index[makeIndexKey(entryPath)] = {&entry, entryPath};
+    std::visit(kdl::overload([&](const ImageDirectoryEntry &directoryEntry) {
+        for (const auto &childEntry : directoryEntry.entries) {
+            addToIndex(childEntry, entryPath / getName(childEntry), index);
+        }
+    }, [](const ImageFileEntry &) {}), entry);
+}
 } // namespace
 
 ImageFileSystemBase::ImageFileSystemBase() : m_root{ImageDirectoryEntry{{}, {}}} {
+    updateIndex();
 }
 
 ImageFileSystemBase::~ImageFileSystemBase() = default;
@@ -112,9 +98,15 @@ Result<std::filesystem::path> ImageFileSystemBase::makeAbsolute(const std::files
     return Result<std::filesystem::path>{"/" / path};
 }
 
+bool ImageFileSystemBase::hasStaticContents() const {
+    return true;
+}
+
 Result<void> ImageFileSystemBase::reload() {
     m_root = ImageDirectoryEntry{{}, {}};
-    return doReadDirectory();
+    auto result = doReadDirectory();
+    updateIndex();
+    return result;
 }
 
 void ImageFileSystemBase::addFile(const std::filesystem::path &path, GetImageFile getFile) {
@@ -130,8 +122,8 @@ void ImageFileSystemBase::addFile(const std::filesystem::path &path, GetImageFil
 }
 
 PathInfo ImageFileSystemBase::pathInfo(const std::filesystem::path &path) const {
-    const auto *entry = findEntry(path, m_root);
-    return entry ? isDirectory(*entry) ? PathInfo::Directory : PathInfo::File : PathInfo::Unknown;
+    const auto *indexedEntry = findIndexedEntry(path);
+    return indexedEntry ? isDirectory(*indexedEntry->entry) ? PathInfo::Directory : PathInfo::File : PathInfo::Unknown;
 }
 
 namespace {
@@ -150,18 +142,29 @@ void doFindImpl(const ImageEntry &entry, const std::filesystem::path &entryPath,
 
 Result<std::vector<std::filesystem::path>> ImageFileSystemBase::doFind(const std::filesystem::path &path, const TraversalMode traversalMode) const {
     auto result = std::vector<std::filesystem::path>{};
-    withEntry(path, m_root, {}, [&](const ImageEntry &entry, const std::filesystem::path &entryPath) {
-        doFindImpl(entry, entryPath, traversalMode, result);
-    });
+    if (const auto *indexedEntry = findIndexedEntry(path)) {
+        doFindImpl(*indexedEntry->entry, indexedEntry->path, traversalMode, result);
+    }
     return result;
 }
 
 Result<std::shared_ptr<File>> ImageFileSystemBase::doOpenFile(const std::filesystem::path &path) const {
-    return withEntry(path, m_root, std::filesystem::path{}, [&](const ImageEntry &entry, const std::filesystem::path &) {
+    if (const auto *indexedEntry = findIndexedEntry(path)) {
         return std::visit(kdl::overload([&](const ImageDirectoryEntry &) {
             return Result<std::shared_ptr<File>>{
                 Error{"Cannot open directory entry at '" + path.string() + "'"}};
-        }, [](const ImageFileEntry &fileEntry) { return fileEntry.getFile(); }), entry);
-    }, Result<std::shared_ptr<File>>{Error{"'" + path.string() + "' not found"}});
+        }, [](const ImageFileEntry &fileEntry) { return fileEntry.getFile(); }), *indexedEntry->entry);
+    }
+    return Result<std::shared_ptr<File>>{Error{"'" + path.string() + "' not found"}};
+}
+
+const ImageFileSystemBase::IndexedEntry *ImageFileSystemBase::findIndexedEntry(const std::filesystem::path &path) const {
+    const auto it = m_index.find(makeIndexKey(path));
+    return it != m_index.end() ? &it->second : nullptr;
+}
+
+void ImageFileSystemBase::updateIndex() {
+    m_index.clear();
+    addToIndex(m_root, std::filesystem::path{}, m_index);
 }
 } // namespace TrenchBroom::IO
@@ -30,6 +30,8 @@
 #include <filesystem>
 #include <functional>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <variant>
 
 namespace TrenchBroom::IO {
@@ -56,6 +58,19 @@ class ImageFileSystemBase : public FileSystem {
   protected:
     ImageEntry m_root;
 
+  private:
+    struct IndexedEntry {
+        const ImageEntry *entry;
+        /** The path of the entry as it is stored in this file system. */
+        std::filesystem::path path;
+    };
+
+    /**
+     * Maps the lower case paths of all entries to the entries.
+     */
+    std::unordered_map<std::string, IndexedEntry> m_index;
+
+  protected:
     ImageFileSystemBase();
 
   public:
@@ -63,6 +78,8 @@ class ImageFileSystemBase : public FileSystem {
 
     Result<std::filesystem::path> makeAbsolute(const std::filesystem::path &path) const override;
 
+    bool hasStaticContents() const override;
+
     /**
      * Reload this file system.
      */
@@ -79,6 +96,10 @@ class ImageFileSystemBase : public FileSystem {
     Result<std::shared_ptr<File>> doOpenFile(const std::filesystem::path &path) const override;
 
     virtual Result<void> doReadDirectory() = 0;
+
+    const IndexedEntry *findIndexedEntry(const std::filesystem::path &path) const;
+
+    void updateIndex();
 };
 
 template<typename FileType> class ImageFileSystem : public ImageFileSystemBase {
@@ -35,6 +35,7 @@
 #include "IO/ReadQuake3ShaderTexture.h"
 #include "IO/ReadWalTexture.h"
 #include "IO/ResourceUtils.h"
+#include "IO/TextureCache.h"
 #include "IO/TextureUtils.h"
 #include "IO/TraversalMode.h"
 #include "Logger.h"
@@ -49,6 +50,8 @@
 #include "kdl/string_format.h"
 #include "kdl/vector_utils.h"
 
+#include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -115,11 +118,55 @@ Result<Assets::Texture, ReadTextureError> readTexture(const File &file, const st
     };
 }
 
-Result<ReadTextureFunc> makeReadTextureFunc(const FileSystem &gameFS, const Model::TextureConfig &textureConfig) {
-    return loadPalette(gameFS, textureConfig).transform([](auto palette) { return std::optional{std::move(palette)}; }).transform_error([](auto) -> std::optional<Assets::Palette> { return std::nullopt; }).and_then([&](auto palette) -> Result<ReadTextureFunc> {
-        return [&, palette = std::move(palette), prefixLength = kdl::path_length(textureConfig.root)](const File &file, const std::filesystem::path &path) {
-            return readTexture(file, path, gameFS, prefixLength, palette);
+/**
+ * Only images decoded by FreeImage are cached and deferred. The other formats are decoded
+ * faster than a cache file can be hashed and read, see TextureCacheBenchmark, and only
+ * the dimensions of FreeImage images can be read without decoding them. Quake 3 shaders
+ * refer to other files, so the textures created for them can be neither cached nor
+ * deferred.
+ */
+bool isFreeImageTexture(const std::filesystem::path &path) {
+    const auto extension = path.extension().string();
+    return !extension.empty() && isSupportedFreeImageExtension(extension);
+}
+
+Result<ReadTextureFunc> makeReadTextureFunc(std::shared_ptr<const FileSystem> gameFS, const Model::TextureConfig &textureConfig, std::shared_ptr<TextureCache> textureCache) {
+    return loadPalette(*gameFS, textureConfig).transform([](auto palette) { return std::optional{std::move(palette)}; }).transform_error([](auto) -> std::optional<Assets::Palette> { return std::nullopt; }).and_then([&](auto palette) -> Result<ReadTextureFunc> {
+        // the function is kept by lazily loaded textures, so it must own everything it uses
+        return [gameFS = std::move(gameFS), textureCache = std::move(textureCache), palette = std::move(palette), prefixLength = kdl::path_length(textureConfig.root)](const File &file, const std::filesystem::path &path) -> Result<Assets::Texture, ReadTextureError> {
+            if (!textureCache || !isFreeImageTexture(path)) {
+                return readTexture(file, path, *gameFS, prefixLength, palette);
+            }
+
+            const auto key = makeTextureCacheKey(path, prefixLength, file, palette);
+            if (auto texture = textureCache->load(key)) {
+                return std::move(*texture);
+            }
+
+            return readTexture(file, path, *gameFS, prefixLength, palette).transform([&](auto texture) {
+                textureCache->store(key, texture).or_else([](auto) { return kdl::void_success; });
+                return texture;
+            });
+        };
+    });
+}
+
+/**
+ * Creates a texture that has the dimensions of the given image, but that is only decoded
+ * when it is needed.
+ */
+Result<Assets::Texture, ReadTextureError> readDeferredTexture(const File &file, const std::filesystem::path &path, std::shared_ptr<const FileSystem> gameFS, const size_t prefixLength, std::shared_ptr<const ReadTextureFunc> readTexture) {
+    auto name = getTextureNameFromPathSuffix(path, prefixLength);
+    auto reader = file.reader().buffer();
+    return readFreeImageTextureSize(name, reader).transform([&](const auto &size) {
+        auto loader = [gameFS = std::move(gameFS), path, readTexture = std::move(readTexture)]() {
+            return gameFS->openFile(path).and_then([&](const auto &textureFile) {
+                return (*readTexture)(*textureFile, path);
+            }).transform([](auto texture) {
+                return std::optional{std::move(texture)};
+            }).value_or(std::nullopt);
         };
+        return Assets::Texture{std::move(name), size.x(), size.y(), std::move(loader)};
     });
 }
 
@@ -132,7 +179,8 @@ Result<std::vector<std::filesystem::path>> findTextureCollections(const FileSyst
     });
 }
 
-Result<Assets::TextureCollection> loadTextureCollection(const std::filesystem::path &path, const FileSystem &gameFS, const Model::TextureConfig &textureConfig, Logger &) {
+Result<Assets::TextureCollection> loadTextureCollection(const std::filesystem::path &path, std::shared_ptr<const FileSystem> gameFSPtr, const Model::TextureConfig &textureConfig, Logger &, std::shared_ptr<TextureCache> textureCache, const TextureLoadingMode loadingMode) {
+    const auto &gameFS = *gameFSPtr;
     if (gameFS.pathInfo(path) != PathInfo::Directory) {
         return Error{
             "Could not load texture collection '" + path.string() + "': not a directory"
@@ -145,11 +193,15 @@ Result<Assets::TextureCollection> loadTextureCollection(const std::filesystem::p
         return kdl::vec_filter(std::move(texturePaths), [&](const auto &texturePath) {
             return !shouldExclude(texturePath.stem().string(), textureConfig.excludes);
         });
-    }).join(makeReadTextureFunc(gameFS, textureConfig)).and_then([&](auto texturePaths, const auto &readTexture) {
+    }).join(makeReadTextureFunc(gameFSPtr, textureConfig, std::move(textureCache))).and_then([&](auto texturePaths, auto readTextureFunc) {
+        const auto readTexture = std::make_shared<const ReadTextureFunc>(std::move(readTextureFunc));
+        const auto prefixLength = kdl::path_length(textureConfig.root);
+
         auto nullLogger = NullLogger{};
         return kdl::fold_results(kdl::vec_parallel_transform(std::move(texturePaths), [&](const auto texturePath) {
             return gameFS.openFile(texturePath).and_then([&](const auto &file) {
-                return readTexture(*file, texturePath).transform([&](auto texture) {
+                const auto defer = loadingMode == TextureLoadingMode::Lazy && isFreeImageTexture(texturePath);
+                return (defer ? readDeferredTexture(*file, texturePath, gameFSPtr, prefixLength, readTexture) : (*readTexture)(*file, texturePath)).transform([&](auto texture) {
                     gameFS.makeAbsolute(texturePath).transform([&](auto absPath) {
                         texture.setAbsolutePath(std::move(absPath));
                     }).or_else([](auto) { return kdl::void_success; });
@@ -41,8 +41,29 @@ struct TextureConfig;
 namespace TrenchBroom::IO {
 class FileSystem;
 
+class TextureCache;
+
+enum class TextureLoadingMode {
+  /**
+   * All textures are decoded when the collection is loaded.
+   */
+  Eager,
+  /**
+   * Textures whose dimensions can be read without decoding them are decoded when they are
+   * needed for the first time.
+   */
+  Lazy
+};
+
 Result<std::vector<std::filesystem::path>> findTextureCollections(const FileSystem &gameFS, const Model::TextureConfig &textureConfig);
 
-Result<Assets::TextureCollection> loadTextureCollection(const std::filesystem::path &path, const FileSystem &gameFS, const Model::TextureConfig &textureConfig, Logger &logger);
+/**
+ * Loads the textures in the given directory of the game file system. If a texture cache
+ * is given, decoded textures are read from and written to the cache.
+ *
+ * Lazily loaded textures share ownership of the given game file system and texture cache,
+ * so both stay alive until the textures are decoded or destroyed.
+ */
+Result<Assets::TextureCollection> loadTextureCollection(const std::filesystem::path &path, std::shared_ptr<const FileSystem> gameFS, const Model::TextureConfig &textureConfig, Logger &logger, std::shared_ptr<TextureCache> textureCache = nullptr, TextureLoadingMode loadingMode = TextureLoadingMode::Eager);
 
 } // namespace TrenchBroom::IO
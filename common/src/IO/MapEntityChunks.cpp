@@ -0,0 +1,201 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MapEntityChunks.h"
+
+#include "Macros.h"
+
+namespace TrenchBroom::IO {
+namespace {
+struct Position {
+  size_t offset;
+  size_t line;
+  size_t column;
+};
+
+/**
+ * Walks over the characters of a map source while keeping track of the line and column in
+ * the same way as the map tokenizer does.
+ */
+class EntityScanner {
+  private:
+    std::string_view m_str;
+    Position m_position{0, 1, 1};
+
+  public:
+    explicit EntityScanner(const std::string_view str) : m_str{str} {
+    }
+
+    bool eof() const { return m_position.offset >= m_str.size(); }
+
+    const Position &position() const { return m_position; }
+
+    char curChar() const { return lookAhead(0); }
+
+    char lookAhead(const size_t offset = 1) const {
+        return m_position.offset + offset < m_str.size() ? m_str[m_position.offset + offset] : 0;
+    }
+
+    void advance() {
+        switch (curChar()) {
+        case '\r':
+            if (lookAhead() == '\n') {
+                ++m_position.column;
+                break;
+            }
+            switchFallthrough();
+        case '\n':++m_position.line;
+            m_position.column = 1;
+            break;
+        default:++m_position.column;
+            break;
+        }
+        ++m_position.offset;
+    }
+
+    void discardUntilEol() {
+        while (!eof() && curChar() != '\n' && curChar() != '\r') {
+            advance();
+        }
+    }
+
+    void discardWord() {
+        while (!eof() && curChar() != ' ' && curChar() != '\t' && curChar() != '\n' && curChar() != '\r') {
+            advance();
+        }
+    }
+
+    /**
+     * Skips the remainder of a quoted string whose opening quote has already been consumed.
+     * Mirrors the tokenizer's handling of escaped quotes, including the special case for
+     * paths with a trailing backslash. Returns false if the string is not terminated.
+     */
+    bool discardQuotedString() {
+        auto escaped = false;
+        while (!eof()) {
+            const auto c = curChar();
+            if (c == '"' && (!escaped || lookAhead() == '\n' || lookAhead() == '}')) {
+                advance();
+                return true;
+            }
+            escaped = c == '\\' && !escaped;
+            advance();
+        }
+        return false;
+    }
+};
+} // namespace
+
+std::vector<MapEntityChunk> splitIntoEntityChunks(const std::string_view str, const size_t minChunkSize) {
+    auto result = std::vector<MapEntityChunk>{};
+
+    auto scanner = EntityScanner{str};
+    auto chunkStart = scanner.position();
+    auto entityCount = size_t(0);
+    auto depth = size_t(0);
+    auto tokenOnLine = false;
+
+    const auto closeChunk = [&]() {
+        const auto &end = scanner.position();
+        result.push_back(MapEntityChunk{str.substr(chunkStart.offset, end.offset - chunkStart.offset), chunkStart.line, chunkStart.column, entityCount});
+        chunkStart = end;
+        entityCount = 0;
+    };
+
+    while (!scanner.eof()) {
+        switch (scanner.curChar()) {
+        case '\n':
+        case '\r':scanner.advance();
+            tokenOnLine = false;
+            break;
+        case ' ':
+        case '\t':scanner.advance();
+            break;
+        case '/':scanner.advance();
+            if (scanner.curChar() == '/') {
+                if (scanner.lookAhead() == '/' && scanner.lookAhead(2) == ' ') {
+                    // a "/// " comment is a token of its own, the rest of the line is tokenized
+                    scanner.advance();
+                    scanner.advance();
+                    tokenOnLine = true;
+                } else {
+                    scanner.discardUntilEol();
+                }
+            }
+            break;
+        case ';':scanner.discardUntilEol();
+            break;
+        case '"':scanner.advance();
+            if (!scanner.discardQuotedString()) {
+                return {};
+            }
+            tokenOnLine = true;
+            break;
+        case '{':
+            if (depth < 2 || !tokenOnLine) {
+                scanner.advance();
+                ++depth;
+            } else {
+                // a texture name such as {fence
+                scanner.discardWord();
+            }
+            tokenOnLine = true;
+            break;
+        case '}':
+            if (depth < 2 || !tokenOnLine) {
+                if (depth == 0) {
+                    return {};
+                }
+                scanner.advance();
+                if (--depth == 0) {
+                    ++entityCount;
+                    if (scanner.position().offset - chunkStart.offset >= minChunkSize) {
+                        closeChunk();
+                    }
+                }
+            } else {
+                scanner.discardWord();
+            }
+            tokenOnLine = true;
+            break;
+        default:scanner.discardWord();
+            tokenOnLine = true;
+            break;
+        }
+    }
+
+    if (depth != 0) {
+        return {};
+    }
+
+    if (chunkStart.offset < str.size()) {
+        if (entityCount > 0 || result.empty()) {
+            closeChunk();
+        } else {
+            // only whitespace and comments are left, let the last chunk cover them
+            const auto offset = static_cast<size_t>(result.back().str.data() - str.data());
+            result.back().str = str.substr(offset);
+        }
+    }
+
+    return result;
+}
+
+} // namespace TrenchBroom::IO
@@ -0,0 +1,62 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom::IO {
+
+/**
+ * A slice of a map source that contains one or more complete top level entities.
+ */
+struct MapEntityChunk {
+  /** The text of the chunk. */
+  std::string_view str;
+  /** The line at which the chunk starts in the original source. */
+  size_t line;
+  /** The column at which the chunk starts in the original source. */
+  size_t column;
+  /** The number of top level entities contained in the chunk. */
+  size_t entityCount;
+};
+
+/**
+ * Splits the given map source into consecutive chunks of whole entities so that each chunk can
+ * be parsed independently.
+ *
+ * The source is scanned for the braces that open and close top level entities, skipping quoted
+ * strings and comments the same way the map tokenizer does. Within brushes and patches, a brace
+ * is only considered structural if it is the first token on its line, because texture names may
+ * start with a brace, too. A chunk is closed after the first entity that makes it at least
+ * `minChunkSize` bytes long, and any trailing text is added to the last chunk, so the chunks
+ * cover the entire source.
+ *
+ * The scan is heuristic. If the braces do not balance or a quoted string is not terminated, an
+ * empty vector is returned and the caller should parse the source in one piece.
+ *
+ * @param str the map source
+ * @param minChunkSize the minimum number of bytes per chunk
+ * @return the chunks in source order, or an empty vector if the source cannot be split
+ */
+std::vector<MapEntityChunk> splitIntoEntityChunks(std::string_view str, size_t minChunkSize);
+
+} // namespace TrenchBroom::IO
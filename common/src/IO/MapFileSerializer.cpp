@@ -39,32 +39,96 @@
 
 #include <fmt/format.h>
 
-#include <iterator> // for std::ostreambuf_iterator
+#include <cmath>
+#include <iterator> // for std::back_inserter
 #include <memory>
-#include <sstream>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
 
 namespace TrenchBroom {
 namespace IO {
+namespace {
+void append(fmt::memory_buffer &buffer, const std::string_view str) {
+    buffer.append(str.data(), str.data() + str.size());
+}
+
+/**
+ * Appends the given number in the same format as formatting it with "{}". Most numbers in
+ * a map are integers, and these are formatted much faster than arbitrary floating point
+ * numbers.
+ */
+template<typename T> void appendNumber(fmt::memory_buffer &buffer, const T number) {
+    if constexpr (std::is_integral_v<T>) {
+        const auto str = fmt::format_int{number};
+        buffer.append(str.data(), str.data() + str.size());
+    } else {
+        // larger numbers may not be exactly representable, or fmt may choose a shorter
+        // representation or exponent notation for them; fmt writes negative zero as "-0"
+        constexpr auto Limit = std::is_same_v<T, float> ? T(1e7) : T(1e15);
+        if (number == std::trunc(number) && std::abs(number) < Limit && !(number == T(0) && std::signbit(number))) {
+            const auto str = fmt::format_int{static_cast<long long>(number)};
+            buffer.append(str.data(), str.data() + str.size());
+        } else {
+            fmt::format_to(std::back_inserter(buffer), "{}", number);
+        }
+    }
+}
+
+/**
+ * Appends the given numbers, each preceded by a space.
+ */
+template<typename... T> void appendNumbers(fmt::memory_buffer &buffer, const T... numbers) {
+    (..., (buffer.push_back(' '), appendNumber(buffer, numbers)));
+}
+
+/**
+ * Returns a copy of the given faces without texture references, which must not be
+ * released on another thread. The surface attributes that the faces take from their
+ * textures are stored in the copies.
+ */
+std::vector<Model::BrushFace> copyFacesWithoutTextures(const std::vector<Model::BrushFace> &faces) {
+    auto result = faces;
+    for (auto &face : result) {
+        if (face.attributes().hasSurfaceAttributes()) {
+            auto attributes = face.attributes();
+            attributes.setSurfaceContents(face.resolvedSurfaceContents());
+            attributes.setSurfaceFlags(face.resolvedSurfaceFlags());
+            attributes.setSurfaceValue(face.resolvedSurfaceValue());
+            face.setAttributes(attributes);
+        }
+        face.setTexture(nullptr);
+    }
+    return result;
+}
+} // namespace
+
 class QuakeFileSerializer : public MapFileSerializer {
   public:
     explicit QuakeFileSerializer(std::ostream &stream) : MapFileSerializer(stream) {
     }
 
   private:
-    void doWriteBrushFace(std::ostream &stream, const Model::BrushFace &face) const override {
-        writeFacePoints(stream, face);
-        writeTextureInfo(stream, face);
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    void doWriteBrushFace(fmt::memory_buffer &buffer, const Model::BrushFace &face) const override {
+        writeFacePoints(buffer, face);
+        writeTextureInfo(buffer, face);
+        buffer.push_back('\n');
     }
 
   protected:
-    void writeFacePoints(std::ostream &stream, const Model::BrushFace &face) const {
+    void writeFacePoints(fmt::memory_buffer &buffer, const Model::BrushFace &face) const {
         const Model::BrushFace::Points &points = face.points();
 
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), "( {} {} {} ) ( {} {} {} ) ( {} {} {} )", points[0].x(), points[0].y(), points[0].z(), points[1].x(), points[1].y(), points[1].z(), points[2].x(), points[2].y(), points[2].z());
+        append(buffer, "(");
+        appendNumbers(buffer, points[0].x(), points[0].y(), points[0].z());
+        append(buffer, " ) (");
+        appendNumbers(buffer, points[1].x(), points[1].y(), points[1].z());
+        append(buffer, " ) (");
+        appendNumbers(buffer, points[2].x(), points[2].y(), points[2].z());
+        append(buffer, " )");
     }
 
     static bool shouldQuoteTextureName(const std::string &textureName) {
@@ -75,24 +139,27 @@ class QuakeFileSerializer : public MapFileSerializer {
         return "\"" + kdl::str_escape(textureName, "\"") + "\"";
     }
 
-    void writeTextureInfo(std::ostream &stream, const Model::BrushFace &face) const {
+    void writeTextureInfo(fmt::memory_buffer &buffer, const Model::BrushFace &face) const {
         const std::string &textureName = face.attributes().textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face.attributes().textureName();
 
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} {} {} {} {} {}", shouldQuoteTextureName(textureName) ? quoteTextureName(textureName) : textureName, face.attributes().xOffset(), face.attributes().yOffset(), face.attributes().rotation(), face.attributes().xScale(), face.attributes().yScale());
+        append(buffer, " ");
+        append(buffer, shouldQuoteTextureName(textureName) ? quoteTextureName(textureName) : textureName);
+        appendNumbers(buffer, face.attributes().xOffset(), face.attributes().yOffset(), face.attributes().rotation(), face.attributes().xScale(), face.attributes().yScale());
     }
 
-    void writeValveTextureInfo(std::ostream &stream, const Model::BrushFace &face) const {
+    void writeValveTextureInfo(fmt::memory_buffer &buffer, const Model::BrushFace &face) const {
         const std::string &textureName = face.attributes().textureName().empty() ? Model::BrushFaceAttributes::NoTextureName : face.attributes().textureName();
         const vm::vec3 xAxis = face.textureXAxis();
         const vm::vec3 yAxis = face.textureYAxis();
 
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} [ {} {} {} {} ] [ {} {} {} {} ] {} {} {}", shouldQuoteTextureName(textureName) ? quoteTextureName(textureName) : textureName,
-
-                       xAxis.x(), xAxis.y(), xAxis.z(), face.attributes().xOffset(),
-
-                       yAxis.x(), yAxis.y(), yAxis.z(), face.attributes().yOffset(),
-
-                       face.attributes().rotation(), face.attributes().xScale(), face.attributes().yScale());
+        append(buffer, " ");
+        append(buffer, shouldQuoteTextureName(textureName) ? quoteTextureName(textureName) : textureName);
+        append(buffer, " [");
+        appendNumbers(buffer, xAxis.x(), xAxis.y(), xAxis.z(), face.attributes().xOffset());
+        append(buffer, " ] [");
+        appendNumbers(buffer, yAxis.x(), yAxis.y(), yAxis.z(), face.attributes().yOffset());
+        append(buffer, " ]");
+        appendNumbers(buffer, face.attributes().rotation(), face.attributes().xScale(), face.attributes().yScale());
     }
 };
 
@@ -102,20 +169,20 @@ class Quake2FileSerializer : public QuakeFileSerializer {
     }
 
   private:
-    void doWriteBrushFace(std::ostream &stream, const Model::BrushFace &face) const override {
-        writeFacePoints(stream, face);
-        writeTextureInfo(stream, face);
+    void doWriteBrushFace(fmt::memory_buffer &buffer, const Model::BrushFace &face) const override {
+        writeFacePoints(buffer, face);
+        writeTextureInfo(buffer, face);
 
         if (face.attributes().hasSurfaceAttributes()) {
-            writeSurfaceAttributes(stream, face);
+            writeSurfaceAttributes(buffer, face);
         }
 
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+        buffer.push_back('\n');
     }
 
   protected:
-    void writeSurfaceAttributes(std::ostream &stream, const Model::BrushFace &face) const {
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} {} {}", face.resolvedSurfaceContents(), face.resolvedSurfaceFlags(), face.resolvedSurfaceValue());
+    void writeSurfaceAttributes(fmt::memory_buffer &buffer, const Model::BrushFace &face) const {
+        appendNumbers(buffer, face.resolvedSurfaceContents(), face.resolvedSurfaceFlags(), face.resolvedSurfaceValue());
     }
 };
 
@@ -125,15 +192,15 @@ class Quake2ValveFileSerializer : public Quake2FileSerializer {
     }
 
   private:
-    void doWriteBrushFace(std::ostream &stream, const Model::BrushFace &face) const override {
-        writeFacePoints(stream, face);
-        writeValveTextureInfo(stream, face);
+    void doWriteBrushFace(fmt::memory_buffer &buffer, const Model::BrushFace &face) const override {
+        writeFacePoints(buffer, face);
+        writeValveTextureInfo(buffer, face);
 
         if (face.attributes().hasSurfaceAttributes()) {
-            writeSurfaceAttributes(stream, face);
+            writeSurfaceAttributes(buffer, face);
         }
 
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+        buffer.push_back('\n');
     }
 };
 
@@ -146,23 +213,23 @@ class DaikatanaFileSerializer : public Quake2FileSerializer {
     }
 
   private:
-    void doWriteBrushFace(std::ostream &stream, const Model::BrushFace &face) const override {
-        writeFacePoints(stream, face);
-        writeTextureInfo(stream, face);
+    void doWriteBrushFace(fmt::memory_buffer &buffer, const Model::BrushFace &face) const override {
+        writeFacePoints(buffer, face);
+        writeTextureInfo(buffer, face);
 
         if (face.attributes().hasSurfaceAttributes() || face.attributes().hasColor()) {
-            writeSurfaceAttributes(stream, face);
+            writeSurfaceAttributes(buffer, face);
         }
         if (face.attributes().hasColor()) {
-            writeSurfaceColor(stream, face);
+            writeSurfaceColor(buffer, face);
         }
 
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+        buffer.push_back('\n');
     }
 
   protected:
-    void writeSurfaceColor(std::ostream &stream, const Model::BrushFace &face) const {
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), " {} {} {}", static_cast<int>(face.resolvedColor().r()), static_cast<int>(face.resolvedColor().g()), static_cast<int>(face.resolvedColor().b()));
+    void writeSurfaceColor(fmt::memory_buffer &buffer, const Model::BrushFace &face) const {
+        appendNumbers(buffer, static_cast<int>(face.resolvedColor().r()), static_cast<int>(face.resolvedColor().g()), static_cast<int>(face.resolvedColor().b()));
     }
 };
 
@@ -172,10 +239,10 @@ class Hexen2FileSerializer : public QuakeFileSerializer {
     }
 
   private:
-    void doWriteBrushFace(std::ostream &stream, const Model::BrushFace &face) const override {
-        writeFacePoints(stream, face);
-        writeTextureInfo(stream, face);
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), " 0\n"); // extra value written here
+    void doWriteBrushFace(fmt::memory_buffer &buffer, const Model::BrushFace &face) const override {
+        writeFacePoints(buffer, face);
+        writeTextureInfo(buffer, face);
+        append(buffer, " 0\n"); // extra value written here
     }
 };
 
@@ -185,14 +252,23 @@ class ValveFileSerializer : public QuakeFileSerializer {
     }
 
   private:
-    void doWriteBrushFace(std::ostream &stream, const Model::BrushFace &face) const override {
-        writeFacePoints(stream, face);
-        writeValveTextureInfo(stream, face);
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), "\n");
+    void doWriteBrushFace(fmt::memory_buffer &buffer, const Model::BrushFace &face) const override {
+        writeFacePoints(buffer, face);
+        writeValveTextureInfo(buffer, face);
+        buffer.push_back('\n');
     }
 };
 
-std::unique_ptr<NodeSerializer> MapFileSerializer::create(const Model::MapFormat format, std::ostream &stream) {
+struct MapFileSerializer::DeferredContents {
+  using Contents = std::variant<std::vector<Model::BrushFace>, Model::BezierPatch>;
+
+  /**
+   * The copied contents and the positions in the text at which they are inserted.
+   */
+  std::vector<std::pair<size_t, Contents>> contents;
+};
+
+std::unique_ptr<MapFileSerializer> MapFileSerializer::create(const Model::MapFormat format, std::ostream &stream) {
     switch (format) {
     case Model::MapFormat::Standard:return std::make_unique<QuakeFileSerializer>(stream);
     case Model::MapFormat::Quake2:
@@ -209,12 +285,27 @@ std::unique_ptr<NodeSerializer> MapFileSerializer::create(const Model::MapFormat
     }
 }
 
+std::pair<std::unique_ptr<MapFileSerializer>, MapFileSerializer::DeferredWriter> MapFileSerializer::createDeferred(const Model::MapFormat format, std::ostream &stream) {
+    auto serializer = create(format, stream);
+    serializer->m_deferredContents = std::make_shared<DeferredContents>();
+
+    auto writer = [format, deferredContents = serializer->m_deferredContents](const std::string &text, std::ostream &out) {
+        create(format, out)->writeDeferred(std::move(*deferredContents), text);
+    };
+    return {std::move(serializer), std::move(writer)};
+}
+
 MapFileSerializer::MapFileSerializer(std::ostream &stream) : m_line(1), m_stream(stream) {
 }
 
 void MapFileSerializer::doBeginFile(const std::vector<const Model::Node *> &rootNodes) {
     ensure(m_nodeToPrecomputedString.empty(), "MapFileSerializer may not be reused");
 
+    if (m_deferredContents) {
+        // the contents are copied when they are written
+        return;
+    }
+
     // collect nodes
     std::vector<std::variant<const Model::BrushNode *, const Model::PatchNode *>> nodesToSerialize;
     nodesToSerialize.reserve(rootNodes.size());
@@ -233,83 +324,135 @@ void MapFileSerializer::doBeginFile(const std::vector<const Model::Node *> &root
     using Entry = std::pair<const Model::Node *, PrecomputedString>;
     std::vector<Entry> result = kdl::vec_parallel_transform(std::move(nodesToSerialize), [&](const auto &node) {
         return std::visit(kdl::overload([&](const Model::BrushNode *brushNode) {
-            return Entry{brushNode, writeBrushFaces(brushNode->brush())};
+            return Entry{brushNode, writeBrushFaces(brushNode->brush().faces())};
         }, [&](const Model::PatchNode *patchNode) {
             return Entry{patchNode, writePatch(patchNode->patch())};
         }), node);
     });
 
     // move strings into a map
+    m_nodeToPrecomputedString.reserve(result.size());
     for (auto &entry : result) {
         m_nodeToPrecomputedString.insert(std::move(entry));
     }
 }
 
-void MapFileSerializer::doEndFile() {}
+void MapFileSerializer::doEndFile() {
+    flush();
+}
 
 void MapFileSerializer::doBeginEntity(const Model::Node * /* node */) {
-    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// entity {}\n", entityNo());
+    fmt::format_to(std::back_inserter(m_buffer), "// entity {}\n", entityNo());
     ++m_line;
     m_startLineStack.push_back(m_line);
-    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+    fmt::format_to(std::back_inserter(m_buffer), "{{\n");
     ++m_line;
 }
 
 void MapFileSerializer::doEndEntity(const Model::Node *node) {
-    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
+    fmt::format_to(std::back_inserter(m_buffer), "}}\n");
     ++m_line;
     setFilePosition(node);
+    flushIfFull();
 }
 
 void MapFileSerializer::doEntityProperty(const Model::EntityProperty &attribute) {
-    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "\"{}\" \"{}\"\n", escapeEntityProperties(attribute.key()), escapeEntityProperties(attribute.value()));
+    fmt::format_to(std::back_inserter(m_buffer), "\"{}\" \"{}\"\n", escapeEntityProperties(attribute.key()), escapeEntityProperties(attribute.value()));
     ++m_line;
+    flushIfFull();
 }
 
 void MapFileSerializer::doBrush(const Model::BrushNode *brush) {
-    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+    fmt::format_to(std::back_inserter(m_buffer), "// brush {}\n", brushNo());
     ++m_line;
     m_startLineStack.push_back(m_line);
-    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "{{\n");
+    fmt::format_to(std::back_inserter(m_buffer), "{{\n");
     ++m_line;
 
-    // write pre-serialized brush faces
-    auto it = m_nodeToPrecomputedString.find(brush);
-    ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a brush which was not passed to doBeginFile");
-    const PrecomputedString &precomputedString = it->second;
-    m_stream << precomputedString.string;
-    m_line += precomputedString.lineCount;
+    if (m_deferredContents) {
+        flush();
+        m_deferredContents->contents.emplace_back(static_cast<size_t>(m_stream.tellp()), copyFacesWithoutTextures(brush->brush().faces()));
+    } else {
+        // write pre-serialized brush faces
+        auto it = m_nodeToPrecomputedString.find(brush);
+        ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a brush which was not passed to doBeginFile");
+        const PrecomputedString &precomputedString = it->second;
+        m_buffer.append(precomputedString.string.data(), precomputedString.string.data() + precomputedString.string.size());
+        m_line += precomputedString.lineCount;
+    }
 
-    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "}}\n");
+    fmt::format_to(std::back_inserter(m_buffer), "}}\n");
     ++m_line;
     setFilePosition(brush);
+    flushIfFull();
 }
 
 void MapFileSerializer::doBrushFace(const Model::BrushFace &face) {
     const size_t lines = 1u;
-    doWriteBrushFace(m_stream, face);
+    doWriteBrushFace(m_buffer, face);
     face.setFilePosition(m_line, lines);
     m_line += lines;
+    flushIfFull();
 }
 
 void MapFileSerializer::doPatch(const Model::PatchNode *patchNode) {
-    fmt::format_to(std::ostreambuf_iterator<char>(m_stream), "// brush {}\n", brushNo());
+    fmt::format_to(std::back_inserter(m_buffer), "// brush {}\n", brushNo());
     ++m_line;
     m_startLineStack.push_back(m_line);
 
-    // write pre-serialized patch
-    auto it = m_nodeToPrecomputedString.find(patchNode);
-    ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a patch which was not passed to doBeginFile");
-    const PrecomputedString &precomputedString = it->second;
-    m_stream << precomputedString.string;
-    m_line += precomputedString.lineCount;
+    if (m_deferredContents) {
+        auto patch = patchNode->patch();
+        // texture references must not be released on another thread
+        patch.setTexture(nullptr);
+        flush();
+        m_deferredContents->contents.emplace_back(static_cast<size_t>(m_stream.tellp()), std::move(patch));
+    } else {
+        // write pre-serialized patch
+        auto it = m_nodeToPrecomputedString.find(patchNode);
+        ensure(it != std::end(m_nodeToPrecomputedString), "attempted to serialize a patch which was not passed to doBeginFile");
+        const PrecomputedString &precomputedString = it->second;
+        m_buffer.append(precomputedString.string.data(), precomputedString.string.data() + precomputedString.string.size());
+        m_line += precomputedString.lineCount;
+    }
 
     setFilePosition(patchNode);
+    flushIfFull();
 }
 
 void MapFileSerializer::setFilePosition(const Model::Node *node) {
     const size_t start = startLine();
-    node->setFilePosition(start, m_line - start);
+    if (!m_deferredContents) {
+        node->setFilePosition(start, m_line - start);
+    }
+}
+
+void MapFileSerializer::writeDeferred(DeferredContents deferredContents, const std::string &text) {
+    const auto strings = kdl::vec_parallel_transform(std::move(deferredContents.contents), [&](const auto &entry) {
+        return std::pair{entry.first, std::visit(kdl::overload([&](const std::vector<Model::BrushFace> &faces) {
+            return writeBrushFaces(faces).string;
+        }, [&](const Model::BezierPatch &patch) {
+            return writePatch(patch).string;
+        }), entry.second)};
+    });
+
+    auto position = size_t(0);
+    for (const auto &[insertPosition, string] : strings) {
+        m_stream.write(text.data() + position, static_cast<std::streamsize>(insertPosition - position));
+        m_stream.write(string.data(), static_cast<std::streamsize>(string.size()));
+        position = insertPosition;
+    }
+    m_stream.write(text.data() + position, static_cast<std::streamsize>(text.size() - position));
+}
+
+void MapFileSerializer::flushIfFull() {
+    if (m_buffer.size() >= FlushThreshold) {
+        flush();
+    }
+}
+
+void MapFileSerializer::flush() {
+    m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+    m_buffer.clear();
 }
 
 size_t MapFileSerializer::startLine() {
@@ -322,49 +465,51 @@ size_t MapFileSerializer::startLine() {
 /**
  * Threadsafe
  */
-MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(const Model::Brush &brush) const {
-    std::stringstream stream;
-    for (const Model::BrushFace &face : brush.faces()) {
-        doWriteBrushFace(stream, face);
+MapFileSerializer::PrecomputedString MapFileSerializer::writeBrushFaces(const std::vector<Model::BrushFace> &faces) const {
+    fmt::memory_buffer buffer;
+    for (const Model::BrushFace &face : faces) {
+        doWriteBrushFace(buffer, face);
     }
-    return PrecomputedString{stream.str(), brush.faces().size()};
+    return PrecomputedString{fmt::to_string(buffer), faces.size()};
 }
 
 MapFileSerializer::PrecomputedString MapFileSerializer::writePatch(const Model::BezierPatch &patch) const {
     size_t lineCount = 0u;
-    std::stringstream stream;
+    fmt::memory_buffer buffer;
 
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "{{\n");
+    fmt::format_to(std::back_inserter(buffer), "{{\n");
     ++lineCount;
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "patchDef2\n");
+    fmt::format_to(std::back_inserter(buffer), "patchDef2\n");
     ++lineCount;
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "{{\n");
+    fmt::format_to(std::back_inserter(buffer), "{{\n");
     ++lineCount;
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "{}\n", patch.textureName());
+    fmt::format_to(std::back_inserter(buffer), "{}\n", patch.textureName());
     ++lineCount;
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "( {} {} 0 0 0 )\n", patch.pointRowCount(), patch.pointColumnCount());
+    fmt::format_to(std::back_inserter(buffer), "( {} {} 0 0 0 )\n", patch.pointRowCount(), patch.pointColumnCount());
     ++lineCount;
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "(\n");
+    fmt::format_to(std::back_inserter(buffer), "(\n");
     ++lineCount;
 
     for (size_t row = 0u; row < patch.pointRowCount(); ++row) {
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), "( ");
+        fmt::format_to(std::back_inserter(buffer), "( ");
         for (size_t col = 0u; col < patch.pointColumnCount(); ++col) {
             const auto &p = patch.controlPoint(row, col);
-            fmt::format_to(std::ostreambuf_iterator<char>(stream), "( {} {} {} {} {} ) ", p[0], p[1], p[2], p[3], p[4]);
+            append(buffer, "(");
+            appendNumbers(buffer, p[0], p[1], p[2], p[3], p[4]);
+            append(buffer, " ) ");
         }
-        fmt::format_to(std::ostreambuf_iterator<char>(stream), ")\n");
+        fmt::format_to(std::back_inserter(buffer), ")\n");
         ++lineCount;
     }
 
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), ")\n");
+    fmt::format_to(std::back_inserter(buffer), ")\n");
     ++lineCount;
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n");
+    fmt::format_to(std::back_inserter(buffer), "}}\n");
     ++lineCount;
-    fmt::format_to(std::ostreambuf_iterator<char>(stream), "}}\n");
+    fmt::format_to(std::back_inserter(buffer), "}}\n");
     ++lineCount;
 
-    return PrecomputedString{stream.str(), lineCount};
+    return PrecomputedString{fmt::to_string(buffer), lineCount};
 }
 } // namespace IO
 } // namespace TrenchBroom
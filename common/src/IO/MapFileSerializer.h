@@ -22,16 +22,19 @@
 #include "IO/NodeSerializer.h"
 #include "Model/MapFormat.h"
 
+#include <fmt/format.h>
+
+#include <functional>
 #include <iosfwd>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
 namespace Model {
 class BezierPatch;
 
-class Brush;
-
 class BrushNode;
 
 class BrushFace;
@@ -51,14 +54,45 @@ class MapFileSerializer : public NodeSerializer {
     size_t m_line;
     std::ostream &m_stream;
 
+    /**
+     * The output is collected here and written to the stream in large chunks to avoid the
+     * overhead of writing many small strings to the stream.
+     */
+    static constexpr size_t FlushThreshold = 64 * 1024;
+    fmt::memory_buffer m_buffer;
+
     struct PrecomputedString {
       std::string string;
       size_t lineCount;
     };
     std::unordered_map<const Model::Node *, PrecomputedString> m_nodeToPrecomputedString;
 
+    struct DeferredContents;
+    /**
+     * If set, the faces of brushes and patches are copied here instead of being written.
+     */
+    std::shared_ptr<DeferredContents> m_deferredContents;
+
   public:
-    static std::unique_ptr<NodeSerializer> create(Model::MapFormat format, std::ostream &stream);
+    /**
+     * Writes a file from the text that a deferred serializer wrote to its stream and the
+     * brush faces and patches that it copied.
+     */
+    using DeferredWriter = std::function<void(const std::string &text, std::ostream &stream)>;
+
+    static std::unique_ptr<MapFileSerializer> create(Model::MapFormat format, std::ostream &stream);
+
+    /**
+     * Creates a serializer that writes everything except the brush faces and patches to the
+     * given stream, which must support tellp. The brush faces and patches are copied, which
+     * is much cheaper than formatting them, and the file positions of the serialized nodes
+     * are not updated.
+     *
+     * The returned writer formats the copied brush faces and patches and writes the complete
+     * file to another stream. It does not access any nodes, so it can be called on another
+     * thread while the nodes are being edited. It can only be called once.
+     */
+    static std::pair<std::unique_ptr<MapFileSerializer>, DeferredWriter> createDeferred(Model::MapFormat format, std::ostream &stream);
 
   protected:
     explicit MapFileSerializer(std::ostream &stream);
@@ -83,12 +117,18 @@ class MapFileSerializer : public NodeSerializer {
   private:
     void setFilePosition(const Model::Node *node);
 
+    void writeDeferred(DeferredContents deferredContents, const std::string &text);
+
+    void flushIfFull();
+
+    void flush();
+
     size_t startLine();
 
   private: // threadsafe
-    virtual void doWriteBrushFace(std::ostream &stream, const Model::BrushFace &face) const = 0;
+    virtual void doWriteBrushFace(fmt::memory_buffer &buffer, const Model::BrushFace &face) const = 0;
 
-    PrecomputedString writeBrushFaces(const Model::Brush &brush) const;
+    PrecomputedString writeBrushFaces(const std::vector<Model::BrushFace> &faces) const;
 
     PrecomputedString writePatch(const Model::BezierPatch &patch) const;
 };
@@ -0,0 +1,171 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "MapFormatDetector.h"
+
+#include "Exceptions.h"
+#include "Macros.h"
+#include "IO/StandardMapParser.h"
+#include "Model/MapFormat.h"
+
+#include "kdl/vector_utils.h"
+
+#include <optional>
+
+namespace TrenchBroom::IO {
+namespace {
+/**
+ * The shape of a brush face, i.e. whether it contains two bracketed texture axes, and how many
+ * values follow the texture name (excluding the texture axes).
+ */
+struct FaceSignature {
+  bool hasTextureAxes;
+  size_t attributeCount;
+};
+
+bool acceptsFace(const Model::MapFormat format, const FaceSignature &face) {
+    const auto n = face.attributeCount;
+    switch (format) {
+    case Model::MapFormat::Standard:return !face.hasTextureAxes && n == 5;
+    case Model::MapFormat::Quake2:
+    case Model::MapFormat::Quake3_Legacy:
+    case Model::MapFormat::Quake3:return !face.hasTextureAxes && (n == 5 || n == 8);
+    case Model::MapFormat::Hexen2:return !face.hasTextureAxes && (n == 5 || n == 6);
+    case Model::MapFormat::Daikatana:return !face.hasTextureAxes && (n == 5 || n == 8 || n == 11);
+    case Model::MapFormat::Valve:return face.hasTextureAxes && n == 3;
+    case Model::MapFormat::Quake2_Valve:
+    case Model::MapFormat::Quake3_Valve:return face.hasTextureAxes && (n == 3 || n == 6);
+    case Model::MapFormat::Unknown:return false;
+        switchDefault();
+    }
+}
+
+bool acceptsPatch(const Model::MapFormat format) {
+    return format == Model::MapFormat::Quake3 || format == Model::MapFormat::Quake3_Valve || format == Model::MapFormat::Quake3_Legacy;
+}
+
+bool acceptsBrushPrimitive(const Model::MapFormat format) {
+    return format == Model::MapFormat::Quake3;
+}
+
+bool readPoint(QuakeMapTokenizer &tokenizer) {
+    if (!tokenizer.nextToken().hasType(QuakeMapToken::OParenthesis)) {
+        return false;
+    }
+    for (size_t i = 0; i < 3; ++i) {
+        if (!tokenizer.nextToken().hasType(QuakeMapToken::Number)) {
+            return false;
+        }
+    }
+    return tokenizer.nextToken().hasType(QuakeMapToken::CParenthesis);
+}
+
+/**
+ * Reads a face whose opening parenthesis is the next token. Returns the signature of the face, or
+ * an empty optional if the tokens do not form a face in any of the supported formats.
+ */
+std::optional<FaceSignature> readFace(QuakeMapTokenizer &tokenizer) {
+    for (size_t i = 0; i < 3; ++i) {
+        if (!readPoint(tokenizer)) {
+            return std::nullopt;
+        }
+    }
+
+    // texture names can contain characters such as '{' that would otherwise be read as separate tokens
+    if (tokenizer.peekToken().hasType(QuakeMapToken::Eof)) {
+        return std::nullopt;
+    }
+    tokenizer.readAnyString(QuakeMapTokenizer::Whitespace());
+
+    size_t textureAxisCount = 0;
+    size_t attributeCount = 0;
+    for (auto token = tokenizer.peekToken(); !token.hasType(QuakeMapToken::OParenthesis | QuakeMapToken::CBrace | QuakeMapToken::Eof); token = tokenizer.peekToken()) {
+        tokenizer.nextToken();
+        if (token.hasType(QuakeMapToken::OBracket)) {
+            for (size_t i = 0; i < 4; ++i) {
+                if (!tokenizer.nextToken().hasType(QuakeMapToken::Number)) {
+                    return std::nullopt;
+                }
+            }
+            if (!tokenizer.nextToken().hasType(QuakeMapToken::CBracket)) {
+                return std::nullopt;
+            }
+            ++textureAxisCount;
+        } else if (!token.hasType(QuakeMapToken::Comment)) {
+            ++attributeCount;
+        }
+    }
+
+    if (textureAxisCount != 0 && textureAxisCount != 2) {
+        return std::nullopt;
+    }
+    return FaceSignature{textureAxisCount == 2, attributeCount};
+}
+
+} // namespace
+
+std::vector<Model::MapFormat> detectMapFormats(std::string_view str, const std::vector<Model::MapFormat> &candidates, const size_t maxObjectCount) {
+    auto result = candidates;
+
+    try {
+        auto tokenizer = QuakeMapTokenizer{str};
+
+        // depth 1 is the inside of an entity, depth 2 the inside of a brush or patch
+        size_t depth = 0;
+        size_t objectCount = 0;
+
+        auto token = tokenizer.peekToken();
+        while (!token.hasType(QuakeMapToken::Eof) && objectCount < maxObjectCount && !result.empty()) {
+            if (depth == 2 && token.hasType(QuakeMapToken::OParenthesis)) {
+                const auto face = readFace(tokenizer);
+                if (!face) {
+                    return {};
+                }
+                result = kdl::vec_filter(std::move(result), [&](const auto format) { return acceptsFace(format, *face); });
+            } else {
+                tokenizer.nextToken();
+                if (token.hasType(QuakeMapToken::OBrace)) {
+                    ++depth;
+                } else if (token.hasType(QuakeMapToken::CBrace)) {
+                    if (depth == 0) {
+                        return {};
+                    }
+                    if (--depth == 1) {
+                        ++objectCount;
+                    }
+                } else if (depth == 2 && token.hasType(QuakeMapToken::String)) {
+                    const auto data = std::string_view{token.begin(), token.length()};
+                    if (data == "patchDef2") {
+                        result = kdl::vec_filter(std::move(result), acceptsPatch);
+                    } else if (data == "brushDef") {
+                        result = kdl::vec_filter(std::move(result), acceptsBrushPrimitive);
+                    }
+                }
+            }
+            token = tokenizer.peekToken();
+        }
+    } catch (const ParserException &) {
+        return {};
+    }
+
+    return result;
+}
+
+} // namespace TrenchBroom::IO
@@ -0,0 +1,50 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace TrenchBroom::Model {
+enum class MapFormat;
+} // namespace TrenchBroom::Model
+
+namespace TrenchBroom::IO {
+
+/**
+ * Inspects the structure of the first brushes and patches of the given map source and returns those
+ * of the given candidate formats that can parse them, in their original order.
+ *
+ * Only the tokens up to the given number of brushes and patches are examined, so this is much
+ * cheaper than parsing the entire source. The result may contain more than one format because
+ * some formats are indistinguishable on a small sample, e.g. a Quake 2 map whose faces omit the
+ * optional surface attributes looks exactly like a Standard map. If the source cannot be tokenized
+ * or is not consistent with any of the candidates, an empty vector is returned.
+ *
+ * @param str the map source
+ * @param candidates the formats to consider
+ * @param maxObjectCount the maximum number of brushes and patches to inspect
+ * @return the candidates that are consistent with the inspected objects
+ */
+std::vector<Model::MapFormat> detectMapFormats(std::string_view str, const std::vector<Model::MapFormat> &candidates, size_t maxObjectCount = 16);
+
+} // namespace TrenchBroom::IO
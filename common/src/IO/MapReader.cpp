@@ -20,6 +20,9 @@
 #include "MapReader.h"
 
 #include "Error.h"
+#include "Exceptions.h"
+#include "IO/BufferedParserStatus.h"
+#include "IO/MapEntityChunks.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushFace.h"
 #include "Model/BrushNode.h"
@@ -40,12 +43,15 @@
 #include "kdl/result_fold.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
 #include "vm/mat.h"
 #include "vm/mat_io.h"
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -55,13 +61,19 @@
 
 namespace TrenchBroom::IO {
 
-MapReader::MapReader(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, Model::EntityPropertyConfig entityPropertyConfig)
-    : StandardMapParser{std::move(str), sourceMapFormat, targetMapFormat}, m_entityPropertyConfig{std::move(entityPropertyConfig)} {
+MapReader::MapReader(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, Model::EntityPropertyConfig entityPropertyConfig, const size_t line, const size_t column)
+    : StandardMapParser{str, sourceMapFormat, targetMapFormat, line, column}, m_str{str}, m_entityPropertyConfig{std::move(entityPropertyConfig)} {
+}
+
+void MapReader::setMaxThreadCount(const size_t maxThreadCount) {
+    m_maxThreadCount = maxThreadCount;
 }
 
 void MapReader::readEntities(const vm::bbox3 &worldBounds, ParserStatus &status) {
     m_worldBounds = worldBounds;
-    parseEntities(status);
+    if (!parseEntitiesInParallel(status)) {
+        parseEntities(status);
+    }
     createNodes(status);
 }
 
@@ -129,6 +141,51 @@ void MapReader::onPatch(const size_t startLine, const size_t lineCount, Model::M
 // helper methods
 
 namespace {
+/** Sources smaller than twice this size are always parsed sequentially. */
+constexpr size_t MinEntityChunkSize = 64 * 1024;
+
+/** The number of chunks per thread, more chunks balance the load better. */
+constexpr size_t EntityChunksPerThread = 4;
+
+/**
+ * Parses one chunk of a source on a worker thread. Records object infos like any other
+ * reader, but never creates nodes; the object infos are merged by the reader that owns the
+ * entire source. Messages are buffered until that reader flushes them.
+ */
+class EntityChunkReader : public MapReader {
+  private:
+    size_t m_expectedEntityCount;
+    size_t m_entityCount{0};
+    BufferedParserStatus m_status;
+
+  public:
+    EntityChunkReader(const MapEntityChunk &chunk, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, const Model::EntityPropertyConfig &entityPropertyConfig, ParserStatus &status)
+        : MapReader{chunk.str, sourceMapFormat, targetMapFormat, entityPropertyConfig, chunk.line, chunk.column}, m_expectedEntityCount{chunk.entityCount}, m_status{status} {
+    }
+
+    void read() { parseEntities(m_status); }
+
+    /**
+     * Indicates whether the parser found exactly as many complete entities as the pre-scan.
+     * If not, the chunk boundaries do not match the actual entity boundaries.
+     */
+    bool foundExpectedEntities() const { return m_entityCount == m_expectedEntityCount; }
+
+    void flushStatus() { m_status.flush(); }
+
+  private:
+    void onEndEntity(const size_t startLine, const size_t lineCount, ParserStatus &status) override {
+        MapReader::onEndEntity(startLine, lineCount, status);
+        ++m_entityCount;
+    }
+
+    Model::Node *onWorldNode(std::unique_ptr<Model::WorldNode>, ParserStatus &) override { return nullptr; }
+
+    void onLayerNode(std::unique_ptr<Model::Node>, ParserStatus &) override {}
+
+    void onNode(Model::Node *, std::unique_ptr<Model::Node>, ParserStatus &) override {}
+};
+
 /** The type of a node's container. */
 enum class ContainerType {
   Layer, Group,
@@ -630,6 +687,71 @@ std::unordered_map<Model::Node *, Model::Node *> buildNodeToParentMap(std::vecto
 }
 } // namespace
 
+/**
+ * Splits the source into chunks of whole entities, parses the chunks in parallel and
+ * appends the recorded object infos to m_objectInfos in source order. Since every chunk
+ * starts at the line and column where it is located in the source, only the parent
+ * indices of brushes and patches must be adjusted when merging.
+ *
+ * Returns false without recording anything if the source is too small, cannot be split,
+ * or if any chunk fails to parse. The caller must then parse the source sequentially.
+ */
+bool MapReader::parseEntitiesInParallel(ParserStatus &status) {
+    const auto threadCount = m_maxThreadCount > 0 ? m_maxThreadCount : kdl::thread_pool::global().thread_count() + 1;
+    if (threadCount < 2 || m_str.size() < 2 * MinEntityChunkSize) {
+        return false;
+    }
+
+    const auto chunkSize = std::max(m_str.size() / (threadCount * EntityChunksPerThread), MinEntityChunkSize);
+    const auto chunks = splitIntoEntityChunks(m_str, chunkSize);
+    if (chunks.size() < 2) {
+        return false;
+    }
+
+    // with a thread limit, hand out the chunks in as many batches as there are threads
+    const auto grainSize = m_maxThreadCount > 0 ? (chunks.size() + threadCount - 1) / threadCount : size_t(1);
+
+    auto readers = std::vector<std::unique_ptr<EntityChunkReader>>(chunks.size());
+    try {
+        kdl::parallel_for(chunks.size(), grainSize, [&](const size_t i) {
+            auto reader = std::make_unique<EntityChunkReader>(chunks[i], m_sourceMapFormat, m_targetMapFormat, m_entityPropertyConfig, status);
+            reader->read();
+            readers[i] = std::move(reader);
+        });
+    } catch (const ParserException &) {
+        return false;
+    }
+
+    if (!std::all_of(std::begin(readers), std::end(readers), [](const auto &reader) {
+        return reader->foundExpectedEntities() && !reader->m_currentEntityInfo;
+    })) {
+        return false;
+    }
+
+    auto objectInfoCount = m_objectInfos.size();
+    for (const auto &reader : readers) {
+        objectInfoCount += reader->m_objectInfos.size();
+    }
+    m_objectInfos.reserve(objectInfoCount);
+
+    for (auto &reader : readers) {
+        const auto offset = m_objectInfos.size();
+        const auto adjustParentIndex = [&](std::optional<size_t> &parentIndex) {
+            if (parentIndex) {
+                *parentIndex += offset;
+            }
+        };
+
+        for (auto &objectInfo : reader->m_objectInfos) {
+            std::visit(kdl::overload([](EntityInfo &) {}, [&](BrushInfo &brushInfo) { adjustParentIndex(brushInfo.parentIndex); }, [&](PatchInfo &patchInfo) { adjustParentIndex(patchInfo.parentIndex); }), objectInfo);
+            m_objectInfos.push_back(std::move(objectInfo));
+        }
+        reader->flushStatus();
+    }
+
+    return true;
+}
+
 /**
  * Creates nodes from the recorded object infos and resolves parent / child relationships.
  *
@@ -71,7 +71,8 @@ class ParserStatus;
  * The flow of control is:
  *
  * 1. MapParser callbacks get called with the raw data, which we just store
- * (m_objectInfos).
+ * (m_objectInfos). Large sources are split into chunks of whole entities, which are parsed
+ * in parallel and then merged (readEntities).
  * 2. Convert the raw data to nodes in parallel (createNodes) and record any additional
  * information necessary to restore the parent / child relationships.
  * 3. Validate the created nodes.
@@ -106,8 +107,10 @@ class MapReader : public StandardMapParser {
     using ObjectInfo = std::variant<EntityInfo, BrushInfo, PatchInfo>;
 
   private:
+    std::string_view m_str;
     Model::EntityPropertyConfig m_entityPropertyConfig;
     vm::bbox3 m_worldBounds;
+    size_t m_maxThreadCount{0};
 
   private: // data populated in response to MapParser callbacks
     std::vector<ObjectInfo> m_objectInfos;
@@ -123,12 +126,28 @@ class MapReader : public StandardMapParser {
      * @param targetMapFormat the format to convert the created objects to
      * @param entityPropertyConfig the entity property config to use
      * if orphaned
+     * @param line the line at which the given string starts in its source
+     * @param column the column at which the given string starts in its source
      */
-    MapReader(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat, Model::EntityPropertyConfig entityPropertyConfig);
+    MapReader(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat, Model::EntityPropertyConfig entityPropertyConfig, size_t line = 1, size_t column = 1);
 
+  public:
+    /**
+     * Limits the number of threads that readEntities uses to parse a large source. Passing 0
+     * (the default) uses all threads of the global thread pool, and passing 1 disables
+     * parallel parsing.
+     */
+    void setMaxThreadCount(size_t maxThreadCount);
+
+  protected:
     /**
      * Attempts to parse as one or more entities.
      *
+     * Large sources are split into chunks of whole entities which are parsed in parallel. If
+     * the source cannot be split or any chunk fails to parse, the whole source is parsed
+     * again sequentially, so errors are always reported as if the source had been parsed
+     * in one piece.
+     *
      * @throws ParserException if parsing fails
      */
     void readEntities(const vm::bbox3 &worldBounds, ParserStatus &status);
@@ -163,6 +182,8 @@ class MapReader : public StandardMapParser {
     void onPatch(size_t startLine, size_t lineCount, Model::MapFormat targetMapFormat, size_t rowCount, size_t columnCount, std::vector<vm::vec<FloatType, 5>> controlPoints, std::string textureName, ParserStatus &status) override;
 
   private: // helper methods
+    bool parseEntitiesInParallel(ParserStatus &status);
+
     void createNodes(ParserStatus &status);
 
   private: // subclassing interface - these will be called in the order that nodes should be
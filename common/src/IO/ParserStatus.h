@@ -28,6 +28,8 @@ enum class LogLevel;
 
 namespace IO {
 class ParserStatus {
+    friend class BufferedParserStatus;
+
   private:
     Logger &m_logger;
     std::string m_prefix;
@@ -159,6 +159,42 @@ Result<Assets::Texture, ReadTextureError> readFreeImageTexture(std::string name,
     return readFreeImageTextureFromMemory(std::move(name), imageBegin, imageSize);
 }
 
+Result<vm::vec2s, ReadTextureError> readFreeImageTextureSize(std::string name, Reader &reader) {
+    try {
+        InitFreeImage::initialize();
+
+        auto bufferedReader = reader.buffer();
+        auto *imageBegin = reinterpret_cast<BYTE *>(const_cast<char *>(bufferedReader.begin()));
+        const auto imageSize = size_t(bufferedReader.end() - bufferedReader.begin());
+
+        auto imageMemory = kdl::resource{
+            FreeImage_OpenMemory(imageBegin, static_cast<DWORD>(imageSize)), FreeImage_CloseMemory
+        };
+
+        const auto imageFormat = FreeImage_GetFileTypeFromMemory(*imageMemory);
+        auto image = kdl::resource{
+            FreeImage_LoadFromMemory(imageFormat, *imageMemory, FIF_LOAD_NOPIXELS), FreeImage_Unload
+        };
+
+        if (!image) {
+            return ReadTextureError{std::move(name), "FreeImage could not load image header"};
+        }
+
+        const auto imageWidth = size_t(FreeImage_GetWidth(*image));
+        const auto imageHeight = size_t(FreeImage_GetHeight(*image));
+
+        if (!checkTextureDimensions(imageWidth, imageHeight)) {
+            return ReadTextureError{
+                std::move(name), fmt::format("Invalid texture dimensions: {}*{}", imageWidth, imageHeight)
+            };
+        }
+
+        return vm::vec2s{imageWidth, imageHeight};
+    } catch (const std::exception &e) {
+        return ReadTextureError{std::move(name), e.what()};
+    }
+}
+
 namespace {
 std::vector<std::string> getSupportedFreeImageExtensions() {
     auto result = std::vector<std::string>{};
@@ -24,6 +24,8 @@
 #include "Renderer/GL.h"
 #include "Result.h"
 
+#include "vm/vec.h"
+
 #include <string>
 
 namespace TrenchBroom::Assets {
@@ -40,6 +42,11 @@ Result<Assets::Texture, ReadTextureError> readFreeImageTextureFromMemory(std::st
 
 Result<Assets::Texture, ReadTextureError> readFreeImageTexture(std::string name, Reader &reader);
 
+/**
+ * Determines the dimensions of the given image without decoding its pixel data.
+ */
+Result<vm::vec2s, ReadTextureError> readFreeImageTextureSize(std::string name, Reader &reader);
+
 bool isSupportedFreeImageExtension(const std::string &extension);
 
 } // namespace TrenchBroom::IO
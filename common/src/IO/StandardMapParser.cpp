@@ -39,7 +39,7 @@ const std::string &QuakeMapTokenizer::NumberDelim() {
     return numberDelim;
 }
 
-QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str) : Tokenizer(std::move(str), "\"", '\\'), m_skipEol(true) {
+QuakeMapTokenizer::QuakeMapTokenizer(std::string_view str, const size_t line, const size_t column) : Tokenizer(std::move(str), "\"", '\\', line, column), m_skipEol(true) {
 }
 
 void QuakeMapTokenizer::setSkipEol(bool skipEol) {
@@ -128,8 +128,8 @@ QuakeMapTokenizer::Token QuakeMapTokenizer::emitToken() {
 const std::string StandardMapParser::BrushPrimitiveId = "brushDef";
 const std::string StandardMapParser::PatchId = "patchDef2";
 
-StandardMapParser::StandardMapParser(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat)
-    : m_tokenizer(QuakeMapTokenizer(std::move(str))), m_sourceMapFormat(sourceMapFormat), m_targetMapFormat(targetMapFormat) {
+StandardMapParser::StandardMapParser(std::string_view str, const Model::MapFormat sourceMapFormat, const Model::MapFormat targetMapFormat, const size_t line, const size_t column)
+    : m_tokenizer(QuakeMapTokenizer(std::move(str), line, column)), m_sourceMapFormat(sourceMapFormat), m_targetMapFormat(targetMapFormat) {
     assert(m_sourceMapFormat != Model::MapFormat::Unknown);
     assert(targetMapFormat != Model::MapFormat::Unknown);
 }
@@ -61,7 +61,7 @@ class QuakeMapTokenizer : public Tokenizer<QuakeMapToken::Type> {
     bool m_skipEol;
 
   public:
-    explicit QuakeMapTokenizer(std::string_view str);
+    explicit QuakeMapTokenizer(std::string_view str, size_t line = 1, size_t column = 1);
 
     void setSkipEol(bool skipEol);
 
@@ -91,8 +91,10 @@ class StandardMapParser : public MapParser, public Parser<QuakeMapToken::Type> {
      * @param str the string to parse
      * @param sourceMapFormat the expected format of the given string
      * @param targetMapFormat the format to convert the created objects to
+     * @param line the line at which the given string starts in its source
+     * @param column the column at which the given string starts in its source
      */
-    StandardMapParser(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat);
+    StandardMapParser(std::string_view str, Model::MapFormat sourceMapFormat, Model::MapFormat targetMapFormat, size_t line = 1, size_t column = 1);
 
     ~StandardMapParser() override;
 
@@ -0,0 +1,385 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TextureCache.h"
+
+#include "Assets/Palette.h"
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Error.h"
+#include "IO/DiskIO.h"
+#include "IO/File.h"
+#include "IO/PathInfo.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
+
+#include "kdl/overload.h"
+#include "kdl/result.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <system_error>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TrenchBroom::IO {
+
+namespace CacheLayout {
+constexpr char Magic[] = "TBTC";
+constexpr size_t MagicSize = 4;
+// increment when the format changes or when the texture readers produce different results
+constexpr uint32_t Version = 1;
+constexpr uint32_t NoGameData = 0;
+constexpr uint32_t Q2GameData = 1;
+// larger textures are neither stored nor loaded
+constexpr size_t MaxTextureSize = 32768;
+} // namespace CacheLayout
+
+namespace {
+/**
+ * Hashes the given bytes eight at a time. This must yield the same value in every run of
+ * the application, so std::hash cannot be used.
+ */
+uint64_t hashBytes(const char *begin, const size_t size, uint64_t hash = 0xcbf29ce484222325ull) {
+    constexpr auto Prime = 0x100000001b3ull;
+
+    auto i = size_t(0);
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        auto word = uint64_t(0);
+        std::memcpy(&word, begin + i, sizeof(uint64_t));
+        hash = (hash ^ word) * Prime;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(begin[i])) * Prime;
+    }
+    return hash;
+}
+
+uint64_t hashBytes(const std::vector<unsigned char> &bytes, const uint64_t hash) {
+    return hashBytes(reinterpret_cast<const char *>(bytes.data()), bytes.size(), hash);
+}
+
+bool isSupportedFormat(const GLenum format) {
+    switch (format) {
+    case GL_RGB:
+    case GL_BGR:
+    case GL_RGBA:
+    case GL_BGRA:
+    case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+    case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:return true;
+    }
+    return false;
+}
+
+bool isSupportedType(const Assets::TextureType type) {
+    return type == Assets::TextureType::Opaque || type == Assets::TextureType::Masked;
+}
+
+bool isValidTextureSize(const size_t width, const size_t height) {
+    return width > 0 && height > 0 && width <= CacheLayout::MaxTextureSize && height <= CacheLayout::MaxTextureSize;
+}
+
+size_t maxMipLevels(const size_t width, const size_t height) {
+    auto levels = size_t(1);
+    for (auto size = std::max(width, height); size > 1; size >>= 1) {
+        ++levels;
+    }
+    return levels;
+}
+
+/**
+ * Checks that the given texture can be read back from the cache, i.e. that its size,
+ * format and type are supported and that every buffer has the size of its mip level.
+ */
+bool hasSupportedLayout(const Assets::Texture &texture) {
+    const auto &buffers = texture.buffersIfUnprepared();
+    if (!isValidTextureSize(texture.width(), texture.height()) || !isSupportedFormat(texture.format()) || !isSupportedType(texture.type()) || buffers.size() > maxMipLevels(texture.width(), texture.height())) {
+        return false;
+    }
+
+    for (size_t level = 0; level < buffers.size(); ++level) {
+        if (buffers[level].size() != Assets::mipBufferSize(texture.width(), texture.height(), level, texture.format())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T> void write(std::ostream &stream, const T value) {
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void write(std::ostream &stream, const std::string &str) {
+    write(stream, static_cast<uint32_t>(str.size()));
+    stream.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+void writeKey(std::ostream &stream, const TextureCacheKey &key) {
+    write(stream, key.path.generic_string());
+    write(stream, static_cast<uint64_t>(key.prefixLength));
+    write(stream, key.fileSize);
+    write(stream, key.contentHash);
+    write(stream, key.paletteHash);
+}
+
+void writeTexture(std::ostream &stream, const Assets::Texture &texture) {
+    write(stream, texture.name());
+    write(stream, static_cast<uint64_t>(texture.width()));
+    write(stream, static_cast<uint64_t>(texture.height()));
+    for (size_t i = 0; i < 4; ++i) {
+        write(stream, texture.averageColor()[i]);
+    }
+    write(stream, static_cast<uint32_t>(texture.format()));
+    write(stream, static_cast<uint32_t>(texture.type()));
+
+    std::visit(kdl::overload([&](const std::monostate &) {
+        write(stream, CacheLayout::NoGameData);
+    }, [&](const Assets::Q2Data &q2Data) {
+        write(stream, CacheLayout::Q2GameData);
+        write(stream, static_cast<int32_t>(q2Data.flags));
+        write(stream, static_cast<int32_t>(q2Data.contents));
+        write(stream, static_cast<int32_t>(q2Data.value));
+    }), texture.gameData());
+
+    const auto &buffers = texture.buffersIfUnprepared();
+    write(stream, static_cast<uint32_t>(buffers.size()));
+    for (const auto &buffer : buffers) {
+        write(stream, static_cast<uint64_t>(buffer.size()));
+        stream.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    }
+}
+
+size_t remaining(const Reader &reader) {
+    return reader.size() - reader.position();
+}
+
+std::string readString(Reader &reader) {
+    const auto size = reader.readSize<uint32_t>();
+    if (size > remaining(reader)) {
+        throw ReaderException{"String of size " + std::to_string(size) + " exceeds the cache file"};
+    }
+    return reader.readString(size);
+}
+
+bool readKey(Reader &reader, const TextureCacheKey &key) {
+    return readString(reader) == key.path.generic_string() && reader.readSize<uint64_t>() == key.prefixLength && reader.read<uint64_t, uint64_t>() == key.fileSize && reader.read<uint64_t, uint64_t>() == key.contentHash && reader.read<uint64_t, uint64_t>() == key.paletteHash;
+}
+
+std::optional<Assets::Texture> readTexture(Reader &reader) {
+    auto name = readString(reader);
+    const auto width = reader.readSize<uint64_t>();
+    const auto height = reader.readSize<uint64_t>();
+    if (!isValidTextureSize(width, height)) {
+        return std::nullopt;
+    }
+
+    const auto r = reader.readFloat<float>();
+    const auto g = reader.readFloat<float>();
+    const auto b = reader.readFloat<float>();
+    const auto a = reader.readFloat<float>();
+    const auto format = reader.read<uint32_t, GLenum>();
+    const auto type = reader.read<uint32_t, Assets::TextureType>();
+    if (!isSupportedFormat(format) || !isSupportedType(type)) {
+        return std::nullopt;
+    }
+
+    auto gameData = Assets::GameData{};
+    const auto gameDataType = reader.read<uint32_t, uint32_t>();
+    if (gameDataType == CacheLayout::Q2GameData) {
+        const auto flags = reader.readInt<int32_t>();
+        const auto contents = reader.readInt<int32_t>();
+        const auto value = reader.readInt<int32_t>();
+        gameData = Assets::Q2Data{flags, contents, value};
+    } else if (gameDataType != CacheLayout::NoGameData) {
+        return std::nullopt;
+    }
+
+    auto buffers = Assets::TextureBufferList{};
+    const auto bufferCount = reader.readSize<uint32_t>();
+    if (bufferCount == 0 || bufferCount > maxMipLevels(width, height)) {
+        return std::nullopt;
+    }
+
+    buffers.reserve(bufferCount);
+    for (size_t i = 0; i < bufferCount; ++i) {
+        // check the size before allocating the buffer so that a corrupt file cannot make us
+        // allocate an arbitrary amount of memory
+        const auto size = reader.readSize<uint64_t>();
+        if (size != Assets::mipBufferSize(width, height, i, format) || size > remaining(reader)) {
+            return std::nullopt;
+        }
+
+        auto &buffer = buffers.emplace_back(size);
+        reader.read(buffer.data(), size);
+    }
+
+    return Assets::Texture{
+        std::move(name), width, height, Color{r, g, b, a}, std::move(buffers), format, type, std::move(gameData)
+    };
+}
+} // namespace
+
+TextureCacheKey makeTextureCacheKey(const std::filesystem::path &path, const size_t prefixLength, const File &file, const std::optional<Assets::Palette> &palette) {
+    const auto contents = file.reader().buffer();
+    const auto paletteHash = palette ? hashBytes(palette->data().index255TransparentData, hashBytes(palette->data().opaqueData, 0xcbf29ce484222325ull)) : uint64_t(0);
+    return TextureCacheKey{
+        path, prefixLength, static_cast<uint64_t>(contents.size()), hashBytes(contents.begin(), contents.size()), paletteHash
+    };
+}
+
+TextureCache::TextureCache(std::filesystem::path directory) : m_directory{std::move(directory)} {
+}
+
+const std::filesystem::path &TextureCache::directory() const {
+    return m_directory;
+}
+
+std::optional<Assets::Texture> TextureCache::load(const TextureCacheKey &key) {
+    const auto path = cacheFilePath(key);
+    if (Disk::pathInfo(path) != PathInfo::File) {
+        ++m_misses;
+        return std::nullopt;
+    }
+
+    auto texture = Disk::openFile(path).transform([&](const std::shared_ptr<CFile> &file) -> std::optional<Assets::Texture> {
+        try {
+            auto reader = file->reader();
+            if (reader.readString(CacheLayout::MagicSize) != CacheLayout::Magic || reader.read<uint32_t, uint32_t>() != CacheLayout::Version || !readKey(reader, key)) {
+                return std::nullopt;
+            }
+            return readTexture(reader);
+        } catch (const ReaderException &) {
+            return std::nullopt;
+        } catch (const std::bad_alloc &) {
+            return std::nullopt;
+        }
+    }).value_or(std::nullopt);
+
+    if (texture) {
+        // mark the file as recently used so that prune keeps it
+        auto error = std::error_code{};
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+        ++m_hits;
+    } else {
+        ++m_misses;
+    }
+    return texture;
+}
+
+Result<void> TextureCache::store(const TextureCacheKey &key, const Assets::Texture &texture) {
+    if (texture.buffersIfUnprepared().empty()) {
+        return Error{"Texture '" + texture.name() + "' has no data"};
+    }
+    if (!hasSupportedLayout(texture)) {
+        return Error{"Texture '" + texture.name() + "' has an unsupported layout"};
+    }
+
+    const auto path = cacheFilePath(key);
+
+    auto tempPathStr = std::stringstream{};
+    tempPathStr << path.filename().string() << "." << std::this_thread::get_id() << ".tmp";
+    const auto tempPath = path.parent_path() / tempPathStr.str();
+
+    return Disk::createDirectory(m_directory).and_then([&](auto) {
+        return Disk::withOutputStream(tempPath, std::ios::out | std::ios::binary, [&](auto &stream) {
+            stream.write(CacheLayout::Magic, CacheLayout::MagicSize);
+            write(stream, CacheLayout::Version);
+            writeKey(stream, key);
+            writeTexture(stream, texture);
+        });
+    }).and_then([&]() {
+        return Disk::moveFile(tempPath, path);
+    }).or_else([&](auto e) {
+        auto error = std::error_code{};
+        std::filesystem::remove(tempPath, error);
+        return Result<void>{std::move(e)};
+    });
+}
+
+void TextureCache::prune(const uint64_t maxSize) {
+    struct CacheFile {
+        std::filesystem::path path;
+        uint64_t size;
+        std::filesystem::file_time_type lastUsed;
+    };
+
+    auto files = std::vector<CacheFile>{};
+    auto totalSize = uint64_t(0);
+
+    // errors are ignored because a cache that cannot be pruned still works
+    auto error = std::error_code{};
+    for (auto it = std::filesystem::directory_iterator{m_directory, error}; !error && it != std::filesystem::directory_iterator{}; it.increment(error)) {
+        auto fileError = std::error_code{};
+        if (it->is_regular_file(fileError)) {
+            const auto size = it->file_size(fileError);
+            const auto lastUsed = fileError ? std::filesystem::file_time_type{} : it->last_write_time(fileError);
+            if (!fileError) {
+                files.push_back(CacheFile{it->path(), size, lastUsed});
+                totalSize += size;
+            }
+        }
+    }
+
+    std::sort(files.begin(), files.end(), [](const auto &lhs, const auto &rhs) { return lhs.lastUsed < rhs.lastUsed; });
+    for (const auto &file : files) {
+        if (totalSize <= maxSize) {
+            break;
+        }
+
+        // files that are open cannot be removed on Windows
+        auto removeError = std::error_code{};
+        if (std::filesystem::remove(file.path, removeError)) {
+            totalSize -= file.size;
+        }
+    }
+}
+
+size_t TextureCache::hits() const {
+    return m_hits;
+}
+
+size_t TextureCache::misses() const {
+    return m_misses;
+}
+
+void TextureCache::resetStatistics() {
+    m_hits = 0;
+    m_misses = 0;
+}
+
+std::filesystem::path TextureCache::cacheFilePath(const TextureCacheKey &key) const {
+    auto hash = hashBytes(key.path.generic_string().data(), key.path.generic_string().size());
+    for (const auto value : {uint64_t(key.prefixLength), key.fileSize, key.contentHash, key.paletteHash}) {
+        hash = hashBytes(reinterpret_cast<const char *>(&value), sizeof(value), hash);
+    }
+
+    auto str = std::stringstream{};
+    str << std::hex << std::setw(16) << std::setfill('0') << hash << ".tbtex";
+    return m_directory / str.str();
+}
+
+} // namespace TrenchBroom::IO
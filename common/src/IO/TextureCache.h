@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Assets/Palette.h"
+#include "Result.h"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+
+namespace TrenchBroom::Assets {
+class Texture;
+}
+
+namespace TrenchBroom::IO {
+class File;
+
+/**
+ * Identifies the decoded contents of a texture file.
+ *
+ * The key is derived from the contents of the texture file rather than from its
+ * modification time because textures are mostly loaded from package files, and the
+ * entries of package files have no modification times.
+ */
+struct TextureCacheKey {
+  /**
+   * The path of the texture file in the game file system.
+   */
+  std::filesystem::path path;
+  /**
+   * The length of the prefix that is stripped from the path to determine the texture
+   * name.
+   */
+  size_t prefixLength;
+  uint64_t fileSize;
+  uint64_t contentHash;
+  /**
+   * The hash of the palette that was used to decode the texture, or 0 if there is none.
+   */
+  uint64_t paletteHash;
+};
+
+TextureCacheKey makeTextureCacheKey(const std::filesystem::path &path, size_t prefixLength, const File &file, const std::optional<Assets::Palette> &palette);
+
+/**
+ * A persistent cache of decoded textures.
+ *
+ * Decoding textures and generating their mipmaps is expensive, so the decoded textures
+ * are written to the cache directory and read back the next time the same texture file
+ * is loaded. Every texture is stored in its own file, which is named after the hash of
+ * its key and mapped into memory when it is read. The files store the full key, so hash
+ * collisions are detected when a texture is read.
+ *
+ * The cache files are validated when they are read, so a corrupt or truncated cache file
+ * results in a miss. The cache does not limit its own size; call prune to delete the least
+ * recently used files.
+ *
+ * The cache can be used by several threads at the same time. A cache file is written to
+ * a temporary file first and then moved into place, so readers never see partially
+ * written files.
+ */
+class TextureCache {
+  private:
+    std::filesystem::path m_directory;
+    std::atomic<size_t> m_hits{0};
+    std::atomic<size_t> m_misses{0};
+
+  public:
+    explicit TextureCache(std::filesystem::path directory);
+
+    const std::filesystem::path &directory() const;
+
+    /**
+     * Reads the texture with the given key from the cache. Returns nothing if the cache
+     * does not contain the texture or if the cache file cannot be read.
+     */
+    std::optional<Assets::Texture> load(const TextureCacheKey &key);
+
+    /**
+     * Writes the given texture to the cache. Fails if the texture is larger than the cache
+     * supports or if its buffers do not have the sizes of its mip levels.
+     */
+    Result<void> store(const TextureCacheKey &key, const Assets::Texture &texture);
+
+    /**
+     * Deletes the least recently used cache files until the cache directory takes up at most
+     * the given number of bytes. Loading a texture from the cache marks its file as used.
+     */
+    void prune(uint64_t maxSize);
+
+    size_t hits() const;
+
+    size_t misses() const;
+
+    void resetStatistics();
+
+  private:
+    std::filesystem::path cacheFilePath(const TextureCacheKey &key) const;
+};
+
+} // namespace TrenchBroom::IO
@@ -22,10 +22,98 @@
 #include "kdl/string_utils.h"
 
 #include <cassert>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace TrenchBroom {
 namespace IO {
+namespace detail {
+/**
+ * Integers with at most this many digits cannot overflow a long long and are parsed without
+ * going through the general purpose conversion functions.
+ */
+static constexpr size_t MaxFastIntegerDigits = 18;
+
+/**
+ * Decimals with at most this many digits have a mantissa that is exactly representable as a double
+ * (10^15 < 2^53), so dividing it by the matching power of ten yields the correctly rounded value.
+ */
+static constexpr size_t MaxFastDecimalDigits = 15;
+
+inline bool isFastDigit(const char c) {
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * Parses an optionally signed integer consisting only of digits in the given range. Returns an empty
+ * optional if the range contains any other characters or too many digits, in which case the caller
+ * must fall back to a general purpose conversion.
+ */
+inline std::optional<long long> parseFastInteger(const char *begin, const char *end) {
+    const auto negative = begin != end && *begin == '-';
+    if (begin != end && (*begin == '-' || *begin == '+')) {
+        ++begin;
+    }
+
+    const auto digits = static_cast<size_t>(end - begin);
+    if (digits == 0 || digits > MaxFastIntegerDigits) {
+        return std::nullopt;
+    }
+
+    long long value = 0;
+    for (const auto *c = begin; c != end; ++c) {
+        if (!isFastDigit(*c)) {
+            return std::nullopt;
+        }
+        value = value * 10 + (*c - '0');
+    }
+    return negative ? -value : value;
+}
+
+/**
+ * Parses an optionally signed decimal without exponent, such as "-12.5", in the given range. Returns
+ * an empty optional if the range is not of this form or has too many digits to be converted exactly,
+ * in which case the caller must fall back to a general purpose conversion.
+ */
+inline std::optional<double> parseFastDecimal(const char *begin, const char *end) {
+    static constexpr double PowersOfTen[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
+    const auto negative = begin != end && *begin == '-';
+    if (begin != end && (*begin == '-' || *begin == '+')) {
+        ++begin;
+    }
+
+    uint64_t mantissa = 0;
+    size_t digits = 0;
+    size_t fractionDigits = 0;
+    auto seenDot = false;
+    for (const auto *c = begin; c != end; ++c) {
+        if (isFastDigit(*c)) {
+            if (++digits > MaxFastDecimalDigits) {
+                return std::nullopt;
+            }
+            mantissa = mantissa * 10u + static_cast<uint64_t>(*c - '0');
+            if (seenDot) {
+                ++fractionDigits;
+            }
+        } else if (*c == '.' && !seenDot) {
+            seenDot = true;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    if (digits == 0) {
+        return std::nullopt;
+    }
+
+    const auto value = static_cast<double>(mantissa) / PowersOfTen[fractionDigits];
+    return negative ? -value : value;
+}
+} // namespace detail
+
 template<typename Type> class TokenTemplate {
   private:
     Type m_type;
@@ -62,12 +150,26 @@ template<typename Type> class TokenTemplate {
 
     size_t column() const { return m_column; }
 
+    /**
+     * Converts this token to a floating point value without copying its characters. Plain decimals are
+     * converted directly, everything else (exponents, long mantissas) is handed to kdl::str_to_double.
+     */
     template<typename T> T toFloat() const {
-        return static_cast<T>(kdl::str_to_double(std::string(m_begin, m_end)).value_or(0.0));
+        if (const auto value = detail::parseFastDecimal(m_begin, m_end)) {
+            return static_cast<T>(*value);
+        }
+        return static_cast<T>(kdl::str_to_double(std::string_view(m_begin, length())).value_or(0.0));
     }
 
+    /**
+     * Converts this token to an integer value without copying its characters. Short integers are
+     * converted directly, everything else is handed to kdl::str_to_long.
+     */
     template<typename T> T toInteger() const {
-        return static_cast<T>(kdl::str_to_long(std::string(m_begin, m_end)).value_or(0l));
+        if (const auto value = detail::parseFastInteger(m_begin, m_end)) {
+            return static_cast<T>(*value);
+        }
+        return static_cast<T>(kdl::str_to_long(std::string_view(m_begin, length())).value_or(0l));
     }
 };
 } // namespace IO
@@ -22,6 +22,7 @@
 #include "Error.h"
 #include "IO/File.h"
 #include "IO/PathInfo.h"
+#include "IO/TraversalMode.h"
 
 #include "kdl/path_utils.h"
 #include "kdl/result.h"
@@ -40,15 +41,22 @@ size_t getMountPointId() {
     return ++mountPointId;
 }
 
-bool matches(const VirtualMountPoint &mountPoint, const std::filesystem::path &path) {
-    return kdl::path_has_prefix(kdl::path_to_lower(path), kdl::path_to_lower(mountPoint.path));
+bool matches(const VirtualMountPoint &mountPoint, const std::filesystem::path &lowerCasePath) {
+    return kdl::path_has_prefix(lowerCasePath, mountPoint.lowerCasePath);
 }
 
 std::filesystem::path suffix(const VirtualMountPoint &mountPoint, const std::filesystem::path &path) {
-    assert(matches(mountPoint, path));
     return kdl::path_clip(path, kdl::path_length(mountPoint.path));
 }
 
+std::string makeIndexKey(const std::filesystem::path &lowerCasePath) {
+    auto key = lowerCasePath.generic_string();
+    if (!key.empty() && key.back() == '/') {
+        key.pop_back();
+    }
+    return key;
+}
+
 } // namespace
 
 VirtualMountPointId::VirtualMountPointId() : m_id{getMountPointId()} {
@@ -63,9 +71,10 @@ bool operator!=(const VirtualMountPointId &lhs, const VirtualMountPointId &rhs)
 }
 
 Result<std::filesystem::path> VirtualFileSystem::makeAbsolute(const std::filesystem::path &path) const {
+    const auto lowerCasePath = kdl::path_to_lower(path);
     for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it) {
         const auto &mountPoint = *it;
-        if (matches(mountPoint, path)) {
+        if (matches(mountPoint, lowerCasePath)) {
             const auto pathSuffix = suffix(mountPoint, path);
             const auto absPath = mountPoint.mountedFileSystem->makeAbsolute(pathSuffix);
             if (absPath.is_success() && mountPoint.mountedFileSystem->pathInfo(pathSuffix) != PathInfo::Unknown) {
@@ -78,25 +87,21 @@ Result<std::filesystem::path> VirtualFileSystem::makeAbsolute(const std::filesys
 }
 
 PathInfo VirtualFileSystem::pathInfo(const std::filesystem::path &path) const {
-    for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it) {
-        const auto &mountPoint = *it;
-        if (matches(mountPoint, path)) {
-            const auto pathSuffix = suffix(mountPoint, path);
-            if (const auto pathInfo = mountPoint.mountedFileSystem->pathInfo(pathSuffix);
-                pathInfo != PathInfo::Unknown) {
-                return pathInfo;
-            }
-        }
+    if (const auto mountPointAndPathInfo = findMountPoint(path)) {
+        return std::get<1>(*mountPointAndPathInfo);
     }
 
+    const auto lowerCasePath = kdl::path_to_lower(path);
     return std::any_of(m_mountPoints.rbegin(), m_mountPoints.rend(), [&](const auto &mountPoint) {
-        return kdl::path_has_prefix(kdl::path_to_lower(mountPoint.path), kdl::path_to_lower(path));
+        return kdl::path_has_prefix(mountPoint.lowerCasePath, lowerCasePath);
     }) ? PathInfo::Directory : PathInfo::Unknown;
 }
 
 VirtualMountPointId VirtualFileSystem::mount(const std::filesystem::path &path, std::unique_ptr<FileSystem> fs) {
     const auto id = VirtualMountPointId{};
-    m_mountPoints.push_back({id, path, std::move(fs)});
+    const auto indexed = fs->hasStaticContents();
+    m_mountPoints.push_back({id, path, std::move(fs), kdl::path_to_lower(path), indexed});
+    addToIndex(m_mountPoints.size() - 1);
     return id;
 }
 
@@ -104,6 +109,7 @@ bool VirtualFileSystem::unmount(const VirtualMountPointId &id) {
     if (const auto it = std::find_if(m_mountPoints.begin(), m_mountPoints.end(), [&](const auto &mountPoint) { return mountPoint.id == id; });
         it != m_mountPoints.end()) {
         m_mountPoints.erase(it);
+        updateIndex();
         return true;
     }
     return false;
@@ -111,11 +117,63 @@ bool VirtualFileSystem::unmount(const VirtualMountPointId &id) {
 
 void VirtualFileSystem::unmountAll() {
     m_mountPoints.clear();
+    m_index.clear();
+}
+
+void VirtualFileSystem::updateIndex() {
+    m_index.clear();
+    for (size_t i = 0; i < m_mountPoints.size(); ++i) {
+        addToIndex(i);
+    }
+}
+
+void VirtualFileSystem::addToIndex(const size_t mountPointIndex) {
+    const auto &mountPoint = m_mountPoints[mountPointIndex];
+    if (!mountPoint.indexed) {
+        return;
+    }
+
+    const auto &fs = *mountPoint.mountedFileSystem;
+    if (const auto rootPathInfo = fs.pathInfo(std::filesystem::path{}); rootPathInfo != PathInfo::Unknown) {
+        m_index[makeIndexKey(mountPoint.lowerCasePath)] = {mountPointIndex, rootPathInfo};
+    }
+
+    if (const auto paths = fs.find(std::filesystem::path{}, TraversalMode::Recursive); paths.is_success()) {
+        for (const auto &path : paths.value()) {
+            m_index[makeIndexKey(mountPoint.lowerCasePath / kdl::path_to_lower(path))] = {mountPointIndex, fs.pathInfo(path)};
+        }
+    }
+}
+
+std::optional<std::tuple<const VirtualMountPoint *, PathInfo>> VirtualFileSystem::findMountPoint(const std::filesystem::path &path) const {
+    const auto lowerCasePath = kdl::path_to_lower(path);
+
+    const auto indexIt = m_index.find(makeIndexKey(lowerCasePath));
+    const auto firstUnindexed = indexIt != m_index.end() ? indexIt->second.mountPointIndex + 1 : 0;
+
+    // mount points that are not indexed and were mounted after the indexed mount point
+    // override it
+    for (auto i = m_mountPoints.size(); i > firstUnindexed; --i) {
+        const auto &mountPoint = m_mountPoints[i - 1];
+        if (!mountPoint.indexed && matches(mountPoint, lowerCasePath)) {
+            if (const auto pathInfo = mountPoint.mountedFileSystem->pathInfo(suffix(mountPoint, path));
+                pathInfo != PathInfo::Unknown) {
+                return std::tuple{&mountPoint, pathInfo};
+            }
+        }
+    }
+
+    if (indexIt != m_index.end()) {
+        return std::tuple{&m_mountPoints[indexIt->second.mountPointIndex], indexIt->second.pathInfo};
+    }
+
+    return std::nullopt;
 }
 
 Result<std::vector<std::filesystem::path>> VirtualFileSystem::doFind(const std::filesystem::path &path, const TraversalMode traversalMode) const {
+    const auto lowerCasePath = kdl::path_to_lower(path);
     return kdl::fold_results(kdl::vec_transform(m_mountPoints, [&](const auto &mountPoint) -> Result<std::vector<std::filesystem::path>> {
-        if (kdl::path_has_prefix(kdl::path_to_lower(path), kdl::path_to_lower(mountPoint.path))) {
+        if (matches(mountPoint, lowerCasePath)) {
             // path points into the mounted filesystem, search there
             const auto pathSuffix = kdl::path_clip(path, kdl::path_length(mountPoint.path));
             if (mountPoint.mountedFileSystem->pathInfo(pathSuffix) == PathInfo::Directory) {
@@ -123,7 +181,7 @@ Result<std::vector<std::filesystem::path>> VirtualFileSystem::doFind(const std::
                     return kdl::vec_transform(std::move(paths), [&](auto p) { return mountPoint.path / p; });
                 });
             }
-        } else if (kdl::path_length(path) < kdl::path_length(mountPoint.path) && kdl::path_has_prefix(kdl::path_to_lower(mountPoint.path), kdl::path_to_lower(path))) {
+        } else if (kdl::path_length(path) < kdl::path_length(mountPoint.path) && kdl::path_has_prefix(mountPoint.lowerCasePath, lowerCasePath)) {
             // path is a prefix of the mount point path, treat as a match
             return std::vector<std::filesystem::path>{
                 kdl::path_clip(mountPoint.path, 0, kdl::path_length(path) + 1)
@@ -163,14 +221,9 @@ Result<std::vector<std::filesystem::path>> VirtualFileSystem::doFind(const std::
 }
 
 Result<std::shared_ptr<File>> VirtualFileSystem::doOpenFile(const std::filesystem::path &path) const {
-    for (auto it = m_mountPoints.rbegin(); it != m_mountPoints.rend(); ++it) {
-        const auto &mountPoint = *it;
-        if (matches(mountPoint, path)) {
-            const auto pathSuffix = suffix(mountPoint, path);
-            if (mountPoint.mountedFileSystem->pathInfo(pathSuffix) != PathInfo::Unknown) {
-                return mountPoint.mountedFileSystem->openFile(pathSuffix);
-            }
-        }
+    if (const auto mountPointAndPathInfo = findMountPoint(path)) {
+        const auto *mountPoint = std::get<0>(*mountPointAndPathInfo);
+        return mountPoint->mountedFileSystem->openFile(suffix(*mountPoint, path));
     }
 
     return Error{"'" + path.string() + "' not found"};
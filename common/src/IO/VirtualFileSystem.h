@@ -20,10 +20,15 @@
 #pragma once
 
 #include "IO/FileSystem.h"
+#include "IO/PathInfo.h"
 #include "Result.h"
 
 #include <filesystem>
 #include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace TrenchBroom::IO {
@@ -46,11 +51,29 @@ struct VirtualMountPoint {
   VirtualMountPointId id;
   std::filesystem::path path;
   std::unique_ptr<FileSystem> mountedFileSystem;
+  std::filesystem::path lowerCasePath;
+  bool indexed;
 };
 
+/**
+ * Combines several file systems into one. Each file system is mounted at a path, and file
+ * systems that are mounted later override the contents of earlier file systems.
+ *
+ * Most mounted file systems are package files whose contents are static. The contents of
+ * these file systems are merged into one index that maps every lower case path to the
+ * mount point that provides it. A lookup then only has to query the index and the mounted
+ * file systems that are not indexed and were mounted after the mount point found in the
+ * index.
+ */
 class VirtualFileSystem : public FileSystem {
   private:
+    struct IndexEntry {
+      size_t mountPointIndex;
+      PathInfo pathInfo;
+    };
+
     std::vector<VirtualMountPoint> m_mountPoints;
+    std::unordered_map<std::string, IndexEntry> m_index;
 
   public:
     Result<std::filesystem::path> makeAbsolute(const std::filesystem::path &path) const override;
@@ -63,10 +86,25 @@ class VirtualFileSystem : public FileSystem {
 
     void unmountAll();
 
+    /**
+     * Rebuilds the index. This must be called if the contents of a mounted file system with
+     * static contents were reloaded.
+     */
+    void updateIndex();
+
   protected:
     Result<std::vector<std::filesystem::path>> doFind(const std::filesystem::path &path, TraversalMode traversalMode) const override;
 
     Result<std::shared_ptr<File>> doOpenFile(const std::filesystem::path &path) const override;
+
+  private:
+    void addToIndex(size_t mountPointIndex);
+
+    /**
+     * Returns the mount point that provides the given path along with the path info, or
+     * nothing if no mounted file system contains the given path.
+     */
+    std::optional<std::tuple<const VirtualMountPoint *, PathInfo>> findMountPoint(const std::filesystem::path &path) const;
 };
 
 class WritableVirtualFileSystem : public WritableFileSystem {
@@ -21,6 +21,7 @@
 
 #include "Color.h"
 #include "Error.h"
+#include "IO/MapFormatDetector.h"
 #include "IO/ParserStatus.h"
 #include "Model/BrushNode.h"
 #include "Model/Entity.h"
@@ -41,6 +42,7 @@
 #include <fmt/format.h>
 
 #include <cassert>
+#include <chrono>
 #include <sstream>
 #include <string>
 
@@ -53,6 +55,37 @@ std::string formatParserExceptions(const std::vector<std::tuple<Model::MapFormat
     }
     return result.str();
 }
+
+std::string formatMapFormats(const std::vector<Model::MapFormat> &mapFormats) {
+    return kdl::str_join(kdl::vec_transform(mapFormats, [](const auto mapFormat) { return Model::formatName(mapFormat); }), ", ");
+}
+
+/**
+ * Returns the given formats, reordered so that the formats which are consistent with the beginning
+ * of the given map source come first. No format is dropped, so if the detection is wrong, the full
+ * parse still falls back to the remaining formats.
+ */
+std::vector<Model::MapFormat> orderMapFormatsByDetection(std::string_view str, const std::vector<Model::MapFormat> &mapFormatsToTry, ParserStatus &status) {
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    auto detectedFormats = detectMapFormats(str, mapFormatsToTry);
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    const auto duration = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+    if (detectedFormats.size() == 1) {
+        status.info(fmt::format("Detected map format {} in {:.2f}ms", Model::formatName(detectedFormats.front()), duration));
+    } else if (!detectedFormats.empty()) {
+        status.info(fmt::format("Map format is one of {} (detection took {:.2f}ms)", formatMapFormats(detectedFormats), duration));
+    } else {
+        status.info(fmt::format("Could not detect map format in {:.2f}ms, trying {}", duration, formatMapFormats(mapFormatsToTry)));
+    }
+
+    for (const auto mapFormat : mapFormatsToTry) {
+        if (!kdl::vec_contains(detectedFormats, mapFormat)) {
+            detectedFormats.push_back(mapFormat);
+        }
+    }
+    return detectedFormats;
+}
 } // namespace
 
 WorldReaderException::WorldReaderException() = default;
@@ -71,7 +104,7 @@ WorldReader::WorldReader(std::string_view str, const Model::MapFormat sourceAndT
 std::unique_ptr<Model::WorldNode> WorldReader::tryRead(std::string_view str, const std::vector<Model::MapFormat> &mapFormatsToTry, const vm::bbox3 &worldBounds, const Model::EntityPropertyConfig &entityPropertyConfig, ParserStatus &status) {
     auto parserExceptions = std::vector<std::tuple<Model::MapFormat, std::string>>{};
 
-    for (const auto mapFormat : mapFormatsToTry) {
+    for (const auto mapFormat : orderMapFormatsByDetection(str, mapFormatsToTry, status)) {
         if (mapFormat == Model::MapFormat::Unknown) {
             continue;
         }
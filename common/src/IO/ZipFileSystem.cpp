@@ -22,9 +22,13 @@
 #include "Error.h"
 #include "IO/DiskFileSystem.h"
 #include "IO/File.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
 
 #include "kdl/result.h"
 
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -51,6 +55,89 @@ std::string filename(mz_zip_archive &archive, const mz_uint fileIndex) {
 
     return result;
 }
+
+namespace ZipLayout {
+constexpr uint32_t LocalHeaderSignature = 0x04034b50;
+constexpr size_t LocalHeaderNameLengthOffset = 26;
+constexpr uint16_t MethodStored = 0;
+constexpr uint16_t MethodDeflated = MZ_DEFLATED;
+} // namespace ZipLayout
+
+/**
+ * The information required to extract an entry without going through miniz.
+ */
+struct ZipEntry {
+  size_t localHeaderOffset;
+  size_t compressedSize;
+  size_t uncompressedSize;
+  mz_uint32 crc32;
+  uint16_t method;
+};
+
+/**
+ * Reads the archive data for miniz. Going through the file's reader instead of handing
+ * the underlying FILE pointer to miniz ensures that all reads from the file are
+ * serialized by the file itself, including reads for entries that are extracted directly.
+ */
+size_t readArchive(void *opaque, const mz_uint64 offset, void *buffer, const size_t size) {
+    const auto &file = *static_cast<const CFile *>(opaque);
+    try {
+        auto reader = file.reader().subReaderFromBegin(static_cast<size_t>(offset), size);
+        reader.read(static_cast<char *>(buffer), size);
+        return size;
+    } catch (const ReaderException &) {
+        return 0;
+    }
+}
+
+bool canExtractDirectly(const mz_zip_archive_file_stat &stat) {
+    return !stat.m_is_encrypted && (stat.m_method == ZipLayout::MethodStored || stat.m_method == ZipLayout::MethodDeflated);
+}
+
+/**
+ * Extracts the given entry by inflating its data directly from the given file. This does
+ * not modify any shared state, so it can be called from several threads at once.
+ */
+Result<std::shared_ptr<File>> extractEntry(const CFile &file, const ZipEntry &entry, const std::filesystem::path &path) {
+    try {
+        auto reader = file.reader();
+        reader.seekFromBegin(entry.localHeaderOffset);
+        if (reader.readUnsignedInt<uint32_t>() != ZipLayout::LocalHeaderSignature) {
+            return Error{"Invalid local header for " + path.string()};
+        }
+
+        // the lengths of the name and extra field in the local header may differ from the
+        // lengths in the central directory
+        reader.seekFromBegin(entry.localHeaderOffset + ZipLayout::LocalHeaderNameLengthOffset);
+        const auto nameLength = reader.readSize<uint16_t>();
+        const auto extraLength = reader.readSize<uint16_t>();
+        reader.seekForward(nameLength + extraLength);
+
+        // does not copy the data if the archive is mapped into memory
+        const auto compressedData = reader.subReaderFromCurrent(entry.compressedSize).buffer();
+
+        auto data = std::make_unique<char[]>(entry.uncompressedSize);
+        if (entry.method == ZipLayout::MethodStored) {
+            if (entry.compressedSize != entry.uncompressedSize) {
+                return Error{"Invalid size of stored entry " + path.string()};
+            }
+            std::memcpy(data.get(), compressedData.begin(), entry.uncompressedSize);
+        } else {
+            const auto size = tinfl_decompress_mem_to_mem(data.get(), entry.uncompressedSize, compressedData.begin(), entry.compressedSize, 0);
+            if (size != entry.uncompressedSize) {
+                return Error{"Failed to inflate " + path.string()};
+            }
+        }
+
+        if (mz_crc32(MZ_CRC32_INIT, reinterpret_cast<const unsigned char *>(data.get()), entry.uncompressedSize) != entry.crc32) {
+            return Error{"CRC mismatch for " + path.string()};
+        }
+
+        return std::static_pointer_cast<File>(std::make_shared<OwningBufferFile>(std::move(data), entry.uncompressedSize));
+    } catch (const ReaderException &e) {
+        return Error{e.what()};
+    }
+}
 } // namespace
 
 ZipFileSystem::~ZipFileSystem() {
@@ -59,33 +146,47 @@ ZipFileSystem::~ZipFileSystem() {
 
 Result<void> ZipFileSystem::doReadDirectory() {
     mz_zip_zero_struct(&m_archive);
+    m_archive.m_pRead = readArchive;
+    m_archive.m_pIO_opaque = const_cast<CFile *>(m_file.get());
 
-    if (mz_zip_reader_init_cfile(&m_archive, m_file->file(), m_file->size(), 0) != MZ_TRUE) {
-        return Error{"Error calling mz_zip_reader_init_cfile"};
+    if (mz_zip_reader_init(&m_archive, m_file->size(), 0) != MZ_TRUE) {
+        return Error{"Error calling mz_zip_reader_init"};
     }
 
     const auto numFiles = mz_zip_reader_get_num_files(&m_archive);
     for (mz_uint i = 0; i < numFiles; ++i) {
         if (!mz_zip_reader_is_file_a_directory(&m_archive, i)) {
             const auto path = std::filesystem::path{filename(m_archive, i)};
-            addFile(path, [=]() -> Result<std::shared_ptr<File>> {
-                auto loadFileGoard = std::lock_guard{m_mutex};
-
-                auto stat = mz_zip_archive_file_stat{};
-                if (!mz_zip_reader_file_stat(&m_archive, i, &stat)) {
-                    return Error{"mz_zip_reader_file_stat failed for " + path.string()};
-                }
 
+            auto stat = mz_zip_archive_file_stat{};
+            if (!mz_zip_reader_file_stat(&m_archive, i, &stat)) {
+                return Error{"mz_zip_reader_file_stat failed for " + path.string()};
+            }
+
+            if (canExtractDirectly(stat)) {
+                const auto entry = ZipEntry{
+                    static_cast<size_t>(stat.m_local_header_ofs),
+                    static_cast<size_t>(stat.m_comp_size),
+                    static_cast<size_t>(stat.m_uncomp_size),
+                    stat.m_crc32,
+                    stat.m_method,
+                };
+                addFile(path, [file = m_file, entry, path]() { return extractEntry(*file, entry, path); });
+            } else {
                 const auto uncompressedSize = static_cast<size_t>(stat.m_uncomp_size);
-                auto data = std::make_unique<char[]>(uncompressedSize);
-                auto *begin = data.get();
+                addFile(path, [=]() -> Result<std::shared_ptr<File>> {
+                    auto loadFileGoard = std::lock_guard{m_mutex};
+
+                    auto data = std::make_unique<char[]>(uncompressedSize);
+                    auto *begin = data.get();
 
-                if (!mz_zip_reader_extract_to_mem(&m_archive, i, begin, uncompressedSize, 0)) {
-                    return Error{"mz_zip_reader_extract_to_mem failed for " + path.string()};
-                }
+                    if (!mz_zip_reader_extract_to_mem(&m_archive, i, begin, uncompressedSize, 0)) {
+                        return Error{"mz_zip_reader_extract_to_mem failed for " + path.string()};
+                    }
 
-                return std::static_pointer_cast<File>(std::make_shared<OwningBufferFile>(std::move(data), uncompressedSize));
-            });
+                    return std::static_pointer_cast<File>(std::make_shared<OwningBufferFile>(std::move(data), uncompressedSize));
+                });
+            }
         }
     }
 
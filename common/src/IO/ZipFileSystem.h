@@ -29,6 +29,16 @@
 namespace TrenchBroom::IO {
 class CFile;
 
+/**
+ * A file system backed by a zip archive (e.g. a pk3 file).
+ *
+ * The central directory is read with miniz, but the entries are extracted by inflating
+ * their data directly from the archive file, so that several threads can extract
+ * entries at the same time. Only entries that use a compression method other than
+ * store or deflate are extracted by miniz, and these extractions are serialized because
+ * miniz's archive state is not thread safe. Miniz reads the archive through the file's
+ * reader, so all reads from the archive file are guarded by the file's own lock.
+ */
 class ZipFileSystem : public ImageFileSystem<CFile> {
   private:
     mz_zip_archive m_archive;
@@ -25,10 +25,12 @@
 #include "kdl/reflection_impl.h"
 
 #include "vm/bbox_io.h"
-#include "vm/bezier_surface.h"
 #include "vm/vec_io.h"
 
+#include <array>
 #include <cassert>
+#include <limits>
+#include <utility>
 
 namespace TrenchBroom::Model {
 
@@ -136,59 +138,38 @@ void BezierPatch::transform(const vm::mat4x4 &transformation) {
     m_bounds = builder.bounds();
 }
 
-using SurfaceControlPoints = std::array<std::array<BezierPatch::Point, 3u>, 3u>;
+using BernsteinWeights = std::array<FloatType, 3u>;
 
-static SurfaceControlPoints collectSurfaceControlPoints(const std::vector<BezierPatch::Point> &controlPoints, const size_t pointColumnCount, const size_t surfaceRow, const size_t surfaceCol) {
-    // at which column and row do we need to start collecting control points for the
-    // surface?
-    const size_t rowOffset = 2u * surfaceRow;
-    const size_t colOffset = 2u * surfaceCol;
-
-    // collect 3*3 control points
-    auto result = SurfaceControlPoints{};
-    for (size_t row = 0; row < 3u; ++row) {
-        for (size_t col = 0; col < 3u; ++col) {
-            result[row][col] = controlPoints[(row + rowOffset) * pointColumnCount + col + colOffset];
-        }
+/**
+ * Evaluates the Bernstein polynomials of degree 2 at the given number of evenly spaced
+ * parameter values from 0 to 1. These are the weights of the three control points of a
+ * quadratic Bezier curve.
+ */
+static std::vector<BernsteinWeights> computeBernsteinWeights(const size_t quadsPerSurfaceSide) {
+    auto result = std::vector<BernsteinWeights>{};
+    result.reserve(quadsPerSurfaceSide + 1u);
+
+    for (size_t i = 0u; i <= quadsPerSurfaceSide; ++i) {
+        const auto t = static_cast<FloatType>(i) / static_cast<FloatType>(quadsPerSurfaceSide);
+        result.push_back({
+            static_cast<FloatType>(1) - static_cast<FloatType>(2) * t + (t * t),
+            static_cast<FloatType>(2) * (t - (t * t)),
+            t * t,
+        });
     }
     return result;
 }
 
-static std::vector<SurfaceControlPoints> collectAllSurfaceControlPoints(const std::vector<BezierPatch::Point> &controlPoints, const size_t pointRowCount, const size_t pointColumnCount) {
-    // determine how many 3*3 surfaces the patch has in each direction
-    const size_t surfaceRowCount = (pointRowCount - 1u) / 2u;
-    const size_t surfaceColumnCount = (pointColumnCount - 1u) / 2u;
-
-    // collect the control points for each surface
-    auto result = std::vector<SurfaceControlPoints>{};
-    result.reserve(surfaceRowCount * surfaceColumnCount);
-
-    for (size_t surfaceRow = 0u; surfaceRow < surfaceRowCount; ++surfaceRow) {
-        for (size_t surfaceCol = 0u; surfaceCol < surfaceColumnCount; ++surfaceCol) {
-            result.push_back(collectSurfaceControlPoints(controlPoints, pointColumnCount, surfaceRow, surfaceCol));
-        }
-    }
+static BezierPatch::Point interpolate(const BernsteinWeights &weights, const BezierPatch::Point &p0, const BezierPatch::Point &p1, const BezierPatch::Point &p2) {
+    auto result = BezierPatch::Point{};
+    result = result + weights[0] * p0;
+    result = result + weights[1] * p1;
+    result = result + weights[2] * p2;
     return result;
 }
 
-template<typename O> void evaluateSurface(const SurfaceControlPoints &surfaceControlPoints, const size_t subdivisionsPerSurface, const bool isLastCol, const bool isLastRow, O out) {
-    const auto maxRow = isLastRow ? subdivisionsPerSurface + 1u : subdivisionsPerSurface;
-    const auto maxCol = isLastCol ? subdivisionsPerSurface + 1u : subdivisionsPerSurface;
-
-    for (size_t row = 0u; row < maxRow; ++row) {
-        const auto v = static_cast<FloatType>(row) / static_cast<FloatType>(subdivisionsPerSurface);
-        for (size_t col = 0u; col < maxCol; ++col) {
-            const auto u = static_cast<FloatType>(col) / static_cast<FloatType>(subdivisionsPerSurface);
-            out = vm::evaluate_quadratic_bezier_surface(surfaceControlPoints, u, v);
-        }
-    }
-}
-
 std::vector<BezierPatch::Point> BezierPatch::evaluate(const size_t subdivisionsPerSurface) const {
-    // collect the control points for each surface in this patch
-    const auto allSurfaceControlPoints = collectAllSurfaceControlPoints(m_controlPoints, m_pointRowCount, m_pointColumnCount);
-
-    const auto quadsPerSurfaceSide = (1u << subdivisionsPerSurface);
+    const auto quadsPerSurfaceSide = (size_t(1) << subdivisionsPerSurface);
 
     // determine dimensions of the resulting point grid
     const size_t gridPointRowCount = surfaceRowCount() * quadsPerSurfaceSide + 1u;
@@ -245,17 +226,49 @@ std::vector<BezierPatch::Point> BezierPatch::evaluate(const size_t subdivisionsP
   value of v
   */
 
+    // every surface is sampled at the same values of u and v, so the weights of the control
+    // points only need to be computed once
+    const auto weights = computeBernsteinWeights(quadsPerSurfaceSide);
+
+    // for each grid column, the surface column to sample and the index of the weights for u
+    auto gridColumns = std::vector<std::pair<size_t, size_t>>{};
+    gridColumns.reserve(gridPointColumnCount);
+    for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol) {
+        const size_t surfaceCol = (gridCol > 0u ? gridCol - 1u : gridCol) / quadsPerSurfaceSide;
+        gridColumns.emplace_back(surfaceCol, gridCol - surfaceCol * quadsPerSurfaceSide);
+    }
+
+    /*
+  A point on a surface is computed by interpolating along each of the surface's three rows
+  of control points using u, and then interpolating between the three resulting points
+  using v. The former only depends on the grid column, so we compute it once per surface
+  row and reuse it for all grid rows which sample that surface row.
+  */
+    auto rowPoints = std::array<std::vector<BezierPatch::Point>, 3u>{};
+    for (auto &points : rowPoints) {
+        points.resize(gridPointColumnCount);
+    }
+
+    auto rowPointsSurfaceRow = std::numeric_limits<size_t>::max();
+
     for (size_t gridRow = 0u; gridRow < gridPointRowCount; ++gridRow) {
         const size_t surfaceRow = (gridRow > 0u ? gridRow - 1u : gridRow) / quadsPerSurfaceSide;
-        const FloatType v = static_cast<FloatType>(gridRow - surfaceRow * quadsPerSurfaceSide) / static_cast<FloatType>(quadsPerSurfaceSide);
+        const size_t v = gridRow - surfaceRow * quadsPerSurfaceSide;
+
+        if (surfaceRow != rowPointsSurfaceRow) {
+            rowPointsSurfaceRow = surfaceRow;
+            for (size_t i = 0u; i < 3u; ++i) {
+                const auto *controlPointRow = &m_controlPoints[(2u * surfaceRow + i) * m_pointColumnCount];
+                for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol) {
+                    const auto [surfaceCol, u] = gridColumns[gridCol];
+                    const auto *p = controlPointRow + 2u * surfaceCol;
+                    rowPoints[i][gridCol] = interpolate(weights[u], p[0], p[1], p[2]);
+                }
+            }
+        }
 
         for (size_t gridCol = 0u; gridCol < gridPointColumnCount; ++gridCol) {
-            const size_t surfaceCol = (gridCol > 0u ? gridCol - 1u : gridCol) / quadsPerSurfaceSide;
-            const FloatType u = static_cast<FloatType>(gridCol - surfaceCol * quadsPerSurfaceSide) / static_cast<FloatType>(quadsPerSurfaceSide);
-
-            const auto &surfaceControlPoints = allSurfaceControlPoints[surfaceRow * surfaceColumnCount() + surfaceCol];
-            auto point = vm::evaluate_quadratic_bezier_surface(surfaceControlPoints, u, v);
-            grid.push_back(std::move(point));
+            grid.push_back(interpolate(weights[v], rowPoints[0][gridCol], rowPoints[1][gridCol], rowPoints[2][gridCol]));
         }
     }
 
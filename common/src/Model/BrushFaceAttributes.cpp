@@ -65,6 +65,10 @@ void swap(BrushFaceAttributes &lhs, BrushFaceAttributes &rhs) {
 }
 
 const std::string &BrushFaceAttributes::textureName() const {
+    return m_textureName.name();
+}
+
+const Assets::TextureName &BrushFaceAttributes::internedTextureName() const {
     return m_textureName;
 }
 
@@ -129,6 +133,10 @@ bool BrushFaceAttributes::valid() const {
 }
 
 bool BrushFaceAttributes::setTextureName(const std::string &textureName) {
+    return setTextureName(Assets::TextureName{textureName});
+}
+
+bool BrushFaceAttributes::setTextureName(const Assets::TextureName &textureName) {
     if (textureName == m_textureName) {
         return false;
     } else {
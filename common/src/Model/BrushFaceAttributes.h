@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Assets/TextureName.h"
 #include "Color.h"
 
 #include "kdl/reflection_decl.h"
@@ -41,7 +42,7 @@ class BrushFaceAttributes {
     static const std::string NoTextureName;
 
   private:
-    std::string m_textureName;
+    Assets::TextureName m_textureName;
 
     vm::vec2f m_offset;
     vm::vec2f m_scale;
@@ -68,6 +69,8 @@ class BrushFaceAttributes {
 
     const std::string &textureName() const;
 
+    const Assets::TextureName &internedTextureName() const;
+
     const vm::vec2f &offset() const;
 
     float xOffset() const;
@@ -100,6 +103,8 @@ class BrushFaceAttributes {
 
     bool setTextureName(const std::string &textureName);
 
+    bool setTextureName(const Assets::TextureName &textureName);
+
     bool setOffset(const vm::vec2f &offset);
 
     bool setXOffset(float xOffset);
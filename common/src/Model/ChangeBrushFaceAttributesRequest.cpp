@@ -76,7 +76,7 @@ ChangeBrushFaceAttributesRequest::ChangeBrushFaceAttributesRequest()
 }
 
 void ChangeBrushFaceAttributesRequest::clear() {
-    m_textureName = "";
+    m_textureName = Assets::TextureName{};
     m_xOffset = m_yOffset = 0.0f;
     m_rotation = 0.0f;
     m_xScale = m_yScale = 1.0f;
@@ -150,6 +150,10 @@ void ChangeBrushFaceAttributesRequest::resetAllToParaxial(const BrushFaceAttribu
 }
 
 void ChangeBrushFaceAttributesRequest::setTextureName(const std::string &textureName) {
+    setTextureName(Assets::TextureName{textureName});
+}
+
+void ChangeBrushFaceAttributesRequest::setTextureName(const Assets::TextureName &textureName) {
     m_textureName = textureName;
     m_textureOp = TextureOp_Set;
 }
@@ -335,7 +339,7 @@ void ChangeBrushFaceAttributesRequest::setAll(const Model::BrushFaceAttributes &
 }
 
 void ChangeBrushFaceAttributesRequest::setAllExceptContentFlags(const Model::BrushFaceAttributes &attributes) {
-    setTextureName(attributes.textureName());
+    setTextureName(attributes.internedTextureName());
     setXOffset(attributes.xOffset());
     setYOffset(attributes.yOffset());
     setRotation(attributes.rotation());
@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "Assets/TextureName.h"
 #include "Color.h"
 
 #include "vm/forward.h"
@@ -59,7 +60,7 @@ class ChangeBrushFaceAttributesRequest {
     } TextureOp;
 
   private:
-    std::string m_textureName;
+    Assets::TextureName m_textureName;
     float m_xOffset;
     float m_yOffset;
     float m_rotation;
@@ -97,6 +98,8 @@ class ChangeBrushFaceAttributesRequest {
 
     void setTextureName(const std::string &textureName);
 
+    void setTextureName(const Assets::TextureName &textureName);
+
     void resetTextureAxes();
 
     void resetTextureAxesToParaxial();
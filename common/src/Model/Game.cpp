@@ -89,6 +89,14 @@ Result<void> Game::writeMap(WorldNode &world, const std::filesystem::path &path)
     return doWriteMap(world, path);
 }
 
+void Game::writeMapToStream(WorldNode &world, std::ostream &stream) const {
+    doWriteMapToStream(world, stream);
+}
+
+std::function<void(std::ostream &)> Game::deferWriteMapToStream(const WorldNode &world) const {
+    return doDeferWriteMapToStream(world);
+}
+
 Result<void> Game::exportMap(WorldNode &world, const IO::ExportOptions &options) const {
     return doExportMap(world, options);
 }
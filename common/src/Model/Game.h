@@ -31,6 +31,7 @@
 #include "vm/forward.h"
 
 #include <filesystem>
+#include <functional>
 #include <map>
 #include <memory>
 #include <optional>
@@ -118,6 +119,22 @@ class Game : public IO::EntityDefinitionLoader, public IO::EntityModelLoader {
 
     Result<void> writeMap(WorldNode &world, const std::filesystem::path &path) const;
 
+    /**
+     * Writes the given world to the given stream in the same way as writeMap writes it to
+     * a file.
+     */
+    void writeMapToStream(WorldNode &world, std::ostream &stream) const;
+
+    /**
+     * Prepares writing the given world in the same way as writeMapToStream. Only the cheap
+     * parts of serializing the world happen here, the brush faces and patches are copied
+     * and formatted later.
+     *
+     * The returned function writes the map to the given stream. It does not access the
+     * world, so it can be called on another thread, but only once.
+     */
+    std::function<void(std::ostream &)> deferWriteMapToStream(const WorldNode &world) const;
+
     Result<void> exportMap(WorldNode &world, const IO::ExportOptions &options) const;
 
   public: // parsing and serializing objects
@@ -191,6 +208,10 @@ class Game : public IO::EntityDefinitionLoader, public IO::EntityModelLoader {
 
     virtual Result<void> doWriteMap(WorldNode &world, const std::filesystem::path &path) const = 0;
 
+    virtual void doWriteMapToStream(WorldNode &world, std::ostream &stream) const = 0;
+
+    virtual std::function<void(std::ostream &)> doDeferWriteMapToStream(const WorldNode &world) const = 0;
+
     virtual Result<void> doExportMap(WorldNode &world, const IO::ExportOptions &options) const = 0;
 
     virtual std::vector<Node *> doParseNodes(const std::string &str, MapFormat mapFormat, const vm::bbox3 &worldBounds, Logger &logger) const = 0;
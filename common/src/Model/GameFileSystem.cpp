@@ -55,7 +55,13 @@ void GameFileSystem::initialize(const GameConfig &config, const std::filesystem:
 }
 
 Result<void> GameFileSystem::reloadShaders() {
-    return m_shaderFS ? m_shaderFS->reload() : Result<void>{};
+    if (!m_shaderFS) {
+        return Result<void>{};
+    }
+
+    auto result = m_shaderFS->reload();
+    updateIndex();
+    return result;
 }
 
 void GameFileSystem::reloadWads(const std::filesystem::path &rootPath, const std::vector<std::filesystem::path> &wadSearchPaths, const std::vector<std::filesystem::path> &wadPaths, Logger &logger) {
@@ -42,6 +42,7 @@
 #include "IO/GameConfigParser.h"
 #include "IO/ImageSpriteParser.h"
 #include "IO/LoadTextureCollection.h"
+#include "IO/MapFileSerializer.h"
 #include "IO/Md2Parser.h"
 #include "IO/Md3Parser.h"
 #include "IO/MdlParser.h"
@@ -76,16 +77,17 @@
 #include "vm/vec_io.h"
 
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom::Model {
-GameImpl::GameImpl(GameConfig &config, std::filesystem::path gamePath, Logger &logger) : m_config{config}, m_gamePath{std::move(gamePath)} {
+GameImpl::GameImpl(GameConfig &config, std::filesystem::path gamePath, Logger &logger) : m_config{config}, m_fs{std::make_shared<GameFileSystem>()}, m_gamePath{std::move(gamePath)} {
     initializeFileSystem(logger);
 }
 
 void GameImpl::initializeFileSystem(Logger &logger) {
-    m_fs.initialize(m_config, m_gamePath, m_additionalSearchPaths, logger);
+    m_fs->initialize(m_config, m_gamePath, m_additionalSearchPaths, logger);
 }
 
 const std::string &GameImpl::doGameName() const {
@@ -174,7 +176,7 @@ Result<std::unique_ptr<WorldNode>> GameImpl::doNewMap(const MapFormat format, co
 
 Result<std::unique_ptr<WorldNode>> GameImpl::doLoadMap(const MapFormat format, const vm::bbox3 &worldBounds, const std::filesystem::path &path, Logger &logger) const {
     auto parserStatus = IO::SimpleParserStatus{logger};
-    return IO::Disk::openFile(path).transform([&](auto file) {
+    return IO::Disk::openMappedFile(path).transform([&](auto file) {
         auto fileReader = file->reader().buffer();
         if (format == MapFormat::Unknown) {
             // Try all formats listed in the game config
@@ -189,20 +191,40 @@ Result<std::unique_ptr<WorldNode>> GameImpl::doLoadMap(const MapFormat format, c
 }
 
 Result<void> GameImpl::doWriteMap(WorldNode &world, const std::filesystem::path &path, const bool exporting) const {
-    return IO::Disk::withOutputStream(path, [&](auto &stream) {
-        const auto mapFormatName = formatName(world.mapFormat());
-        stream << "// Game: " << gameName() << "\n" << "// Format: " << mapFormatName << "\n";
-
-        auto writer = IO::NodeWriter{world, stream};
-        writer.setExporting(exporting);
-        writer.writeMap();
-    });
+    return IO::Disk::withOutputStream(path, [&](auto &stream) { doWriteMapToStream(world, stream, exporting); });
 }
 
 Result<void> GameImpl::doWriteMap(WorldNode &world, const std::filesystem::path &path) const {
     return doWriteMap(world, path, false);
 }
 
+void GameImpl::doWriteMapToStream(WorldNode &world, std::ostream &stream, const bool exporting) const {
+    writeMapHeader(world, stream);
+
+    auto writer = IO::NodeWriter{world, stream};
+    writer.setExporting(exporting);
+    writer.writeMap();
+}
+
+void GameImpl::doWriteMapToStream(WorldNode &world, std::ostream &stream) const {
+    doWriteMapToStream(world, stream, false);
+}
+
+std::function<void(std::ostream &)> GameImpl::doDeferWriteMapToStream(const WorldNode &world) const {
+    auto stream = std::ostringstream{};
+    writeMapHeader(world, stream);
+
+    auto [serializer, writeDeferred] = IO::MapFileSerializer::createDeferred(world.mapFormat(), stream);
+    IO::NodeWriter{world, std::move(serializer)}.writeMap();
+
+    return [text = stream.str(), writeDeferred = std::move(writeDeferred)](std::ostream &out) { writeDeferred(text, out); };
+}
+
+void GameImpl::writeMapHeader(const WorldNode &world, std::ostream &stream) const {
+    const auto mapFormatName = formatName(world.mapFormat());
+    stream << "// Game: " << gameName() << "\n" << "// Format: " << mapFormatName << "\n";
+}
+
 Result<void> GameImpl::doExportMap(WorldNode &world, const IO::ExportOptions &options) const {
     return std::visit(kdl::overload([&](const IO::ObjExportOptions &objOptions) {
         return IO::Disk::withOutputStream(objOptions.exportPath, [&](auto &objStream) {
@@ -255,11 +277,11 @@ void GameImpl::doReloadWads(const std::filesystem::path &documentPath, const std
         m_gamePath,                 // Search for assets relative to the location of the game.
         IO::SystemPaths::appDirectory(), // Search for assets relative to the application.
     };
-    m_fs.reloadWads(m_config.textureConfig.root, searchPaths, wadPaths, logger);
+    m_fs->reloadWads(m_config.textureConfig.root, searchPaths, wadPaths, logger);
 }
 
 Result<void> GameImpl::doReloadShaders() {
-    return m_fs.reloadShaders();
+    return m_fs->reloadShaders();
 }
 
 bool GameImpl::doIsEntityDefinitionFile(const std::filesystem::path &path) const {
@@ -342,7 +364,7 @@ std::unique_ptr<Assets::EntityModel> GameImpl::doInitializeModel(const std::file
     using result_type = Result<std::unique_ptr<Assets::EntityModel>>;
 
     try {
-        return m_fs.openFile(path).and_then([&](auto file) -> result_type {
+        return m_fs->openFile(path).and_then([&](auto file) -> result_type {
             const auto modelName = path.filename().string();
             auto reader = file->reader().buffer();
 
@@ -354,13 +376,13 @@ std::unique_ptr<Assets::EntityModel> GameImpl::doInitializeModel(const std::file
             }
             if (IO::Md2Parser::canParse(path, reader)) {
                 return loadTexturePalette().transform([&](auto palette) {
-                    auto parser = IO::Md2Parser{modelName, reader, palette, m_fs};
+                    auto parser = IO::Md2Parser{modelName, reader, palette, *m_fs};
                     return parser.initializeModel(logger);
                 });
             }
             if (IO::Bsp29Parser::canParse(path, reader)) {
                 return loadTexturePalette().transform([&](auto palette) {
-                    auto parser = IO::Bsp29Parser{modelName, reader, palette, m_fs};
+                    auto parser = IO::Bsp29Parser{modelName, reader, palette, *m_fs};
                     return parser.initializeModel(logger);
                 });
             }
@@ -371,27 +393,27 @@ std::unique_ptr<Assets::EntityModel> GameImpl::doInitializeModel(const std::file
                 });
             }
             if (IO::Md3Parser::canParse(path, reader)) {
-                auto parser = IO::Md3Parser{modelName, reader, m_fs};
+                auto parser = IO::Md3Parser{modelName, reader, *m_fs};
                 return parser.initializeModel(logger);
             }
             if (IO::MdxParser::canParse(path, reader)) {
-                auto parser = IO::MdxParser{modelName, reader, m_fs};
+                auto parser = IO::MdxParser{modelName, reader, *m_fs};
                 return parser.initializeModel(logger);
             }
             if (IO::DkmParser::canParse(path, reader)) {
-                auto parser = IO::DkmParser{modelName, reader, m_fs};
+                auto parser = IO::DkmParser{modelName, reader, *m_fs};
                 return parser.initializeModel(logger);
             }
             if (IO::AseParser::canParse(path)) {
-                auto parser = IO::AseParser{modelName, reader.stringView(), m_fs};
+                auto parser = IO::AseParser{modelName, reader.stringView(), *m_fs};
                 return parser.initializeModel(logger);
             }
             if (IO::ImageSpriteParser::canParse(path)) {
-                auto parser = IO::ImageSpriteParser{modelName, file, m_fs};
+                auto parser = IO::ImageSpriteParser{modelName, file, *m_fs};
                 return parser.initializeModel(logger);
             }
             if (IO::AssimpParser::canParse(path)) {
-                auto parser = IO::AssimpParser{path, m_fs};
+                auto parser = IO::AssimpParser{path, *m_fs};
                 return parser.initializeModel(logger);
             }
             return Error{"Unknown model format: '" + path.string() + "'"};
@@ -411,7 +433,7 @@ void GameImpl::doLoadFrame(const std::filesystem::path &path, size_t frameIndex,
         ensure(model.frame(frameIndex) != nullptr, "invalid frame index");
         ensure(!model.frame(frameIndex)->loaded(), "frame already loaded");
 
-        m_fs.openFile(path).and_then([&](auto file) -> result_type {
+        m_fs->openFile(path).and_then([&](auto file) -> result_type {
             const auto modelName = path.filename().string();
             auto reader = file->reader().buffer();
 
@@ -423,13 +445,13 @@ void GameImpl::doLoadFrame(const std::filesystem::path &path, size_t frameIndex,
             }
             if (IO::Md2Parser::canParse(path, reader)) {
                 return loadTexturePalette().transform([&](auto palette) {
-                    auto parser = IO::Md2Parser{modelName, reader, palette, m_fs};
+                    auto parser = IO::Md2Parser{modelName, reader, palette, *m_fs};
                     parser.loadFrame(frameIndex, model, logger);
                 });
             }
             if (IO::Bsp29Parser::canParse(path, reader)) {
                 return loadTexturePalette().transform([&](auto palette) {
-                    auto parser = IO::Bsp29Parser{modelName, reader, palette, m_fs};
+                    auto parser = IO::Bsp29Parser{modelName, reader, palette, *m_fs};
                     parser.loadFrame(frameIndex, model, logger);
                 });
             }
@@ -440,32 +462,32 @@ void GameImpl::doLoadFrame(const std::filesystem::path &path, size_t frameIndex,
                 });
             }
             if (IO::Md3Parser::canParse(path, reader)) {
-                auto parser = IO::Md3Parser{modelName, reader, m_fs};
+                auto parser = IO::Md3Parser{modelName, reader, *m_fs};
                 parser.loadFrame(frameIndex, model, logger);
                 return kdl::void_success;
             }
             if (IO::MdxParser::canParse(path, reader)) {
-                auto parser = IO::MdxParser{modelName, reader, m_fs};
+                auto parser = IO::MdxParser{modelName, reader, *m_fs};
                 parser.loadFrame(frameIndex, model, logger);
                 return kdl::void_success;
             }
             if (IO::DkmParser::canParse(path, reader)) {
-                auto parser = IO::DkmParser{modelName, reader, m_fs};
+                auto parser = IO::DkmParser{modelName, reader, *m_fs};
                 parser.loadFrame(frameIndex, model, logger);
                 return kdl::void_success;
             }
             if (IO::AseParser::canParse(path)) {
-                auto parser = IO::AseParser{modelName, reader.stringView(), m_fs};
+                auto parser = IO::AseParser{modelName, reader.stringView(), *m_fs};
                 parser.loadFrame(frameIndex, model, logger);
                 return kdl::void_success;
             }
             if (IO::ImageSpriteParser::canParse(path)) {
-                auto parser = IO::ImageSpriteParser{modelName, file, m_fs};
+                auto parser = IO::ImageSpriteParser{modelName, file, *m_fs};
                 parser.loadFrame(frameIndex, model, logger);
                 return kdl::void_success;
             }
             if (IO::AssimpParser::canParse(path)) {
-                auto parser = IO::AssimpParser{path, m_fs};
+                auto parser = IO::AssimpParser{path, *m_fs};
                 parser.loadFrame(frameIndex, model, logger);
                 return kdl::void_success;
             }
@@ -481,7 +503,7 @@ void GameImpl::doLoadFrame(const std::filesystem::path &path, size_t frameIndex,
 
 Result<Assets::Palette> GameImpl::loadTexturePalette() const {
     const auto &path = m_config.textureConfig.palette;
-    return m_fs.openFile(path).and_then([&](auto file) { return Assets::loadPalette(*file, path); });;
+    return m_fs->openFile(path).and_then([&](auto file) { return Assets::loadPalette(*file, path); });;
 }
 
 Result<std::vector<std::string>> GameImpl::doAvailableMods() const {
@@ -44,7 +44,7 @@ struct EntityPropertyConfig;
 class GameImpl : public Game {
   private:
     GameConfig &m_config;
-    GameFileSystem m_fs;
+    std::shared_ptr<GameFileSystem> m_fs;
     std::filesystem::path m_gamePath;
     std::vector<std::filesystem::path> m_additionalSearchPaths;
 
@@ -83,6 +83,14 @@ class GameImpl : public Game {
 
     Result<void> doWriteMap(WorldNode &world, const std::filesystem::path &path) const override;
 
+    void doWriteMapToStream(WorldNode &world, std::ostream &stream, bool exporting) const;
+
+    void doWriteMapToStream(WorldNode &world, std::ostream &stream) const override;
+
+    std::function<void(std::ostream &)> doDeferWriteMapToStream(const WorldNode &world) const override;
+
+    void writeMapHeader(const WorldNode &world, std::ostream &stream) const;
+
     Result<void> doExportMap(WorldNode &world, const IO::ExportOptions &options) const override;
 
     std::vector<Node *> doParseNodes(const std::string &str, MapFormat mapFormat, const vm::bbox3 &worldBounds, Logger &logger) const override;
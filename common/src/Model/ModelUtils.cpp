@@ -29,6 +29,8 @@
 
 #include "kdl/vector_utils.h"
 
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace TrenchBroom::Model {
@@ -126,13 +128,27 @@ std::map<Node *, std::vector<Node *>> parentChildrenMap(const std::vector<Node *
  * brush in the given vector of brushes such that the predicate evaluates to true for that
  * pair of node and brush.
  *
+ * If candidates are given, a node other than a group is only tested against the brushes
+ * that are mapped to it. Nodes that are not mapped to any brush are not tested at all.
+ *
  * The given predicate must be a function that maps a node and a brush to true or false.
  */
-template<typename P> static std::vector<Node *> collectMatchingNodes(const std::vector<Node *> &nodes, const std::vector<BrushNode *> &brushes, const P &predicate) {
+template<typename P> static std::vector<Node *> collectMatchingNodes(const std::vector<Node *> &nodes, const std::vector<BrushNode *> &brushes, const std::unordered_map<const Node *, std::vector<BrushNode *>> *candidates, const P &predicate) {
     auto result = std::vector<Node *>{};
 
-    const auto collectIfMatching = [&](auto *node) {
-        for (const auto *brush : brushes) {
+    const auto brushSet = std::unordered_set<const BrushNode *>{brushes.begin(), brushes.end()};
+    const auto noBrushes = std::vector<BrushNode *>{};
+
+    const auto candidateBrushes = [&](const Node *node) -> const std::vector<BrushNode *> & {
+        if (candidates == nullptr) {
+            return brushes;
+        }
+        const auto it = candidates->find(node);
+        return it != candidates->end() ? it->second : noBrushes;
+    };
+
+    const auto collectIfMatching = [&](auto *node, const std::vector<BrushNode *> &brushesToTest) {
+        for (const auto *brush : brushesToTest) {
             if (predicate(node, brush)) {
                 result.push_back(node);
                 return;
@@ -145,38 +161,67 @@ template<typename P> static std::vector<Node *> collectMatchingNodes(const std::
             if (group->opened() || group->hasOpenedDescendant()) {
                 group->visitChildren(thisLambda);
             } else {
-                collectIfMatching(group);
+                // groups are not stored in the node tree
+                collectIfMatching(group, brushes);
             }
         }, [&](auto &&thisLambda, EntityNode *entity) {
             if (entity->hasChildren()) {
                 entity->visitChildren(thisLambda);
             } else {
-                collectIfMatching(entity);
+                collectIfMatching(entity, candidateBrushes(entity));
             }
         }, [&](BrushNode *brush) {
             // if `brush` is one of the search query nodes, don't count it as touching
-            if (!kdl::vec_contains(brushes, brush)) {
-                collectIfMatching(brush);
+            if (brushSet.count(brush) == 0) {
+                collectIfMatching(brush, candidateBrushes(brush));
             }
         }, [&](PatchNode *patch) {
             // if `patch` is one of the search query nodes, don't count it as touching
-            collectIfMatching(patch);
+            collectIfMatching(patch, candidateBrushes(patch));
         }));
     }
 
     return result;
 }
 
+/**
+ * Maps each node in the given world's node tree to the given brushes whose bounds
+ * intersect with the node's bounds.
+ */
+static std::unordered_map<const Node *, std::vector<BrushNode *>> findCandidates(const WorldNode &world, const std::vector<BrushNode *> &brushes) {
+    auto result = std::unordered_map<const Node *, std::vector<BrushNode *>>{};
+    for (auto *brush : brushes) {
+        for (const auto *node : world.findNodesIntersecting(brush->logicalBounds())) {
+            result[node].push_back(brush);
+        }
+    }
+    return result;
+}
+
+static bool touches(const Node *node, const BrushNode *brush) {
+    return brush->intersects(node);
+}
+
+static bool contains(const Node *node, const BrushNode *brush) {
+    return brush->contains(node);
+}
+
 std::vector<Node *> collectTouchingNodes(const std::vector<Node *> &nodes, const std::vector<BrushNode *> &brushes) {
-    return collectMatchingNodes(nodes, brushes, [](const auto *node, const auto *brush) {
-        return brush->intersects(node);
-    });
+    return collectMatchingNodes(nodes, brushes, nullptr, touches);
 }
 
 std::vector<Node *> collectContainedNodes(const std::vector<Node *> &nodes, const std::vector<BrushNode *> &brushes) {
-    return collectMatchingNodes(nodes, brushes, [](const auto *node, const auto *brush) {
-        return brush->contains(node);
-    });
+    return collectMatchingNodes(nodes, brushes, nullptr, contains);
+}
+
+std::vector<Node *> collectTouchingNodes(WorldNode &world, const std::vector<BrushNode *> &brushes) {
+    const auto candidates = findCandidates(world, brushes);
+    return collectMatchingNodes({&world}, brushes, &candidates, touches);
+}
+
+std::vector<Node *> collectContainedNodes(WorldNode &world, const std::vector<BrushNode *> &brushes) {
+    const auto candidates = findCandidates(world, brushes);
+    return collectMatchingNodes({&world}, brushes, &candidates, contains);
 }
 
 std::vector<Node *> collectSelectedNodes(const std::vector<Node *> &nodes) {
@@ -44,6 +44,8 @@ class LayerNode;
 
 class EditorContext;
 
+class WorldNode;
+
 HitType::Type nodeHitType();
 
 LayerNode *findContainingLayer(Node *node);
@@ -70,6 +72,20 @@ std::vector<Node *> collectTouchingNodes(const std::vector<Node *> &nodes, const
 
 std::vector<Node *> collectContainedNodes(const std::vector<Node *> &nodes, const std::vector<BrushNode *> &brushes);
 
+/**
+ * Returns the same nodes as collectTouchingNodes({&world}, brushes), but only tests the
+ * nodes against those brushes whose bounds intersect with the nodes' bounds, as found in
+ * the world's node tree.
+ */
+std::vector<Node *> collectTouchingNodes(WorldNode &world, const std::vector<BrushNode *> &brushes);
+
+/**
+ * Returns the same nodes as collectContainedNodes({&world}, brushes), but only tests the
+ * nodes against those brushes whose bounds intersect with the nodes' bounds, as found in
+ * the world's node tree.
+ */
+std::vector<Node *> collectContainedNodes(WorldNode &world, const std::vector<BrushNode *> &brushes);
+
 std::vector<Node *> collectSelectedNodes(const std::vector<Node *> &nodes);
 
 std::vector<Node *> collectSelectableNodes(const std::vector<Node *> &nodes, const EditorContext &editorContext);
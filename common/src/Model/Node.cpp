@@ -31,6 +31,8 @@
 #include "vm/bbox.h"
 
 #include <cassert>
+#include <chrono>
+#include <functional>
 #include <iterator>
 #include <ostream>
 #include <string>
@@ -655,6 +657,10 @@ std::vector<const Issue *> Node::issues(const std::vector<const Validator *> &va
     return kdl::vec_transform(m_issues, [](const auto &issue) { return const_cast<const Issue *>(issue.get()); });
 }
 
+bool Node::issuesValid() const {
+    return m_issuesValid;
+}
+
 bool Node::issueHidden(const IssueType type) const {
     return (type & m_hiddenIssues) != 0;
 }
@@ -668,9 +674,15 @@ void Node::setIssueHidden(const IssueType type, const bool hidden) {
 }
 
 void Node::validateIssues(const std::vector<const Validator *> &validators) {
+    validateIssues(validators, [](const auto, const auto) {});
+}
+
+void Node::validateIssues(const std::vector<const Validator *> &validators, const std::function<void(size_t, std::chrono::nanoseconds)> &recordDuration) {
     if (!m_issuesValid) {
-        for (const auto *validator : validators) {
-            validator->validate(*this, m_issues);
+        for (size_t i = 0; i < validators.size(); ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            validators[i]->validate(*this, m_issues);
+            recordDuration(i, std::chrono::steady_clock::now() - start);
         }
         m_issuesValid = true;
     }
@@ -33,6 +33,8 @@
 #include "vm/util.h"
 
 #include <algorithm>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -403,6 +405,17 @@ class Node : public Taggable {
   public: // issue management
     std::vector<const Issue *> issues(const std::vector<const Validator *> &validators);
 
+    bool issuesValid() const;
+
+    /**
+     * Validates the issues of this node if they are invalid, and passes the index of each
+     * validator and the time it took to the given function.
+     *
+     * Different nodes can be validated on different threads at the same time as long as no
+     * node is modified and the bounds of the nodes are cached.
+     */
+    void validateIssues(const std::vector<const Validator *> &validators, const std::function<void(size_t, std::chrono::nanoseconds)> &recordDuration);
+
     bool issueHidden(IssueType type) const;
 
     void setIssueHidden(IssueType type, bool hidden);
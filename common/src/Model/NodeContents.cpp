@@ -19,9 +19,16 @@
 
 #include "NodeContents.h"
 
+#include "Error.h"
 #include "Model/BrushFace.h"
+#include "Model/ParallelTexCoordSystem.h"
+#include "Model/ParaxialTexCoordSystem.h"
+#include "Model/Polyhedron.h"
 
 #include "kdl/overload.h"
+#include "kdl/result.h"
+
+#include <algorithm>
 
 namespace TrenchBroom {
 namespace Model {
@@ -40,5 +47,96 @@ const std::variant<Layer, Group, Entity, Brush, BezierPatch> &NodeContents::get(
 std::variant<Layer, Group, Entity, Brush, BezierPatch> &NodeContents::get() {
     return m_contents;
 }
+
+namespace {
+bool hasSameFacesAndVertices(const Brush &lhs, const Brush &rhs) {
+    if (lhs.faceCount() != rhs.faceCount() || lhs.edgeCount() != rhs.edgeCount() || lhs.vertexCount() != rhs.vertexCount()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < lhs.faceCount(); ++i) {
+        const auto &lhsFace = lhs.face(i);
+        const auto &rhsFace = rhs.face(i);
+        if (lhsFace != rhsFace || lhsFace.vertexPositions() != rhsFace.vertexPositions()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+void NodeContents::compact(const vm::bbox3 &worldBounds) {
+    if (auto *brush = std::get_if<Brush>(&m_contents); brush && !m_brushFaces) {
+        Brush::create(worldBounds, brush->faces()).transform([&](Brush rebuiltBrush) {
+            if (hasSameFacesAndVertices(*brush, rebuiltBrush)) {
+                auto faces = std::move(rebuiltBrush.faces());
+                for (auto &face : faces) {
+                    face.setGeometry(nullptr);
+                }
+                m_brushFaces = std::move(faces);
+                m_contents = Brush{};
+            }
+        }).transform_error([](auto) {
+            // keep the geometry
+        });
+    }
+}
+
+bool NodeContents::compacted() const {
+    return m_brushFaces.has_value();
+}
+
+Result<void> NodeContents::expand(const vm::bbox3 &worldBounds) {
+    if (!m_brushFaces) {
+        return kdl::void_success;
+    }
+
+    // keep the faces until the geometry was rebuilt so that these contents remain
+    // compacted if rebuilding fails
+    return Brush::create(worldBounds, *m_brushFaces).transform([&](Brush brush) {
+        m_contents = std::move(brush);
+        m_brushFaces = std::nullopt;
+    });
+}
+
+namespace {
+size_t memoryUsage(const std::string &str) {
+    // short strings are stored inline
+    static const auto inlineCapacity = std::string{}.capacity();
+    return str.capacity() > inlineCapacity ? str.capacity() + 1 : 0;
+}
+
+size_t memoryUsage(const std::vector<BrushFace> &faces) {
+    constexpr auto TexCoordSystemSize = std::max(sizeof(ParallelTexCoordSystem), sizeof(ParaxialTexCoordSystem));
+    return faces.capacity() * sizeof(BrushFace) + faces.size() * TexCoordSystemSize;
+}
+
+size_t memoryUsage(const Brush &brush) {
+    return memoryUsage(brush.faces()) + sizeof(BrushGeometry) + brush.vertexCount() * sizeof(BrushVertex) + brush.edgeCount() * (sizeof(BrushEdge) + 2 * sizeof(BrushHalfEdge)) + brush.faceCount() * sizeof(BrushFaceGeometry);
+}
+} // namespace
+
+size_t NodeContents::memoryUsage() const {
+    if (m_brushFaces) {
+        return sizeof(NodeContents) + Model::memoryUsage(*m_brushFaces);
+    }
+
+    return sizeof(NodeContents) + std::visit(kdl::overload([](const Layer &layer) {
+        return Model::memoryUsage(layer.name());
+    }, [](const Group &group) {
+        return Model::memoryUsage(group.name());
+    }, [](const Entity &entity) {
+        auto result = entity.properties().capacity() * sizeof(EntityProperty);
+        for (const auto &property : entity.properties()) {
+            result += Model::memoryUsage(property.key()) + Model::memoryUsage(property.value());
+        }
+        return result;
+    }, [](const Brush &brush) {
+        return Model::memoryUsage(brush);
+    }, [](const BezierPatch &patch) {
+        return patch.controlPoints().capacity() * sizeof(BezierPatch::Point) + Model::memoryUsage(patch.textureName());
+    }), m_contents);
+}
 } // namespace Model
 } // namespace TrenchBroom
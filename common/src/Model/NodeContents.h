@@ -19,19 +19,30 @@
 
 #pragma once
 
+#include "FloatType.h"
 #include "Model/BezierPatch.h"
 #include "Model/Brush.h"
+#include "Model/BrushFace.h"
 #include "Model/Entity.h"
 #include "Model/Group.h"
 #include "Model/Layer.h"
+#include "Result.h"
 
+#include "vm/bbox.h"
+
+#include <optional>
 #include <variant>
+#include <vector>
 
 namespace TrenchBroom {
 namespace Model {
 class NodeContents {
   private:
     std::variant<Layer, Group, Entity, Brush, BezierPatch> m_contents;
+    /**
+     * The faces of a compacted brush. If set, m_contents holds an empty brush.
+     */
+    std::optional<std::vector<BrushFace>> m_brushFaces;
 
   public:
     /** Unsets cached and derived information of the given objects, i.e.
@@ -43,6 +54,35 @@ class NodeContents {
     const std::variant<Layer, Group, Entity, Brush, BezierPatch> &get() const;
 
     std::variant<Layer, Group, Entity, Brush, BezierPatch> &get();
+
+    /**
+     * Reduces the memory used by these contents while they are stored, e.g. in the undo
+     * history. A brush only keeps its faces and discards its geometry, which is more than
+     * half of its memory. Other contents are not changed.
+     *
+     * A brush is only compacted if rebuilding its geometry from its faces reproduces the
+     * same faces and exactly the same vertices. This is not the case for some brushes whose
+     * vertices were edited, and these brushes keep their geometry.
+     *
+     * Compacted contents must be expanded before they are accessed.
+     */
+    void compact(const vm::bbox3 &worldBounds);
+
+    bool compacted() const;
+
+    /**
+     * Rebuilds the geometry of a compacted brush from its faces, in the same way as when a
+     * brush is read from a map file. Does nothing if these contents are not compacted.
+     *
+     * If the geometry cannot be rebuilt, an error is returned and these contents remain
+     * compacted.
+     */
+    Result<void> expand(const vm::bbox3 &worldBounds);
+
+    /**
+     * Returns an estimate of the memory used by these contents, in bytes.
+     */
+    size_t memoryUsage() const;
 };
 } // namespace Model
 } // namespace TrenchBroom
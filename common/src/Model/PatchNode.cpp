@@ -33,6 +33,7 @@
 #include "Model/WorldNode.h"
 
 #include "kdl/overload.h"
+#include "kdl/parallel.h"
 #include "kdl/reflection_impl.h"
 #include "kdl/zip_iterator.h"
 
@@ -43,6 +44,7 @@
 #include <cassert>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace TrenchBroom {
 namespace Model {
@@ -84,7 +86,7 @@ kdl_reflect_impl(PatchGrid);
  * quadrants (e.g. the corner points have only one). If the grid points of two opposing
  * sides of the grid coincide, we treat them as one grid point and average their normals.
  */
-std::vector<vm::vec3> computeGridNormals(const std::vector<BezierPatch::Point> patchGrid, const size_t pointRowCount, const size_t pointColumnCount) {
+std::vector<vm::vec3> computeGridNormals(const std::vector<BezierPatch::Point> &patchGrid, const size_t pointRowCount, const size_t pointColumnCount) {
     /* Returns the index of a grid point with the given coordinates. */
     const auto index = [&](const size_t row, const size_t col) {
         return row * pointColumnCount + col;
@@ -225,6 +227,8 @@ PatchGrid makePatchGrid(const BezierPatch &patch, const size_t subdivisionsPerSu
     assert(patchGrid.size() == normals.size());
 
     auto points = std::vector<PatchGrid::Point>{};
+    points.reserve(patchGrid.size());
+
     auto boundsBuilder = vm::bbox3::builder{};
     for (const auto [point, normal] : kdl::make_zip_range(patchGrid, normals)) {
         const auto position = vm::slice<3>(point, 0);
@@ -238,11 +242,22 @@ PatchGrid makePatchGrid(const BezierPatch &patch, const size_t subdivisionsPerSu
     };
 }
 
+std::vector<PatchGrid> makePatchGrids(const std::vector<const BezierPatch *> &patches) {
+    auto result = std::vector<PatchGrid>(patches.size());
+    kdl::parallel_for(patches.size(), [&](const size_t i) {
+        result[i] = makePatchGrid(*patches[i], DefaultSubdivisionsPerSurface);
+    });
+    return result;
+}
+
 const HitType::Type PatchNode::PatchHitType = HitType::freeType();
 
 PatchNode::PatchNode(BezierPatch patch) : m_patch{std::move(patch)}, m_grid{makePatchGrid(m_patch, DefaultSubdivisionsPerSurface)} {
 }
 
+PatchNode::PatchNode(BezierPatch patch, PatchGrid grid) : m_patch{std::move(patch)}, m_grid{std::move(grid)} {
+}
+
 const EntityNodeBase *PatchNode::entity() const {
     return visitParent(kdl::overload([](const WorldNode *world) -> const EntityNodeBase * { return world; }, [](const EntityNode *entity) -> const EntityNodeBase * { return entity; }, [](auto &&thisLambda, const LayerNode *layer) -> const EntityNodeBase * {
         return layer->visitParent(thisLambda).value_or(nullptr);
@@ -267,11 +282,27 @@ BezierPatch PatchNode::setPatch(BezierPatch patch) {
     const auto nodeChange = NotifyNodeChange{*this};
     const auto boundsChange = NotifyPhysicalBoundsChange{*this};
 
+    const auto keepGrid = hasGridOf(patch);
     auto previousPatch = std::exchange(m_patch, std::move(patch));
-    m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+    if (!keepGrid) {
+        m_grid = makePatchGrid(m_patch, DefaultSubdivisionsPerSurface);
+    }
     return previousPatch;
 }
 
+BezierPatch PatchNode::setPatch(BezierPatch patch, PatchGrid grid) {
+    const auto nodeChange = NotifyNodeChange{*this};
+    const auto boundsChange = NotifyPhysicalBoundsChange{*this};
+
+    auto previousPatch = std::exchange(m_patch, std::move(patch));
+    m_grid = std::move(grid);
+    return previousPatch;
+}
+
+bool PatchNode::hasGridOf(const BezierPatch &patch) const {
+    return patch.pointRowCount() == m_patch.pointRowCount() && patch.pointColumnCount() == m_patch.pointColumnCount() && patch.controlPoints() == m_patch.controlPoints();
+}
+
 void PatchNode::setTexture(Assets::Texture *texture) {
     m_patch.setTexture(texture);
 }
@@ -305,7 +336,7 @@ FloatType PatchNode::doGetProjectedArea(const vm::axis::type axis) const {
 }
 
 Node *PatchNode::doClone(const vm::bbox3 &, const SetLinkId setLinkIds) const {
-    auto result = std::make_unique<PatchNode>(m_patch);
+    auto result = std::make_unique<PatchNode>(m_patch, m_grid);
     result->cloneLinkId(*this, setLinkIds);
     return result.release();
 }
@@ -30,6 +30,7 @@
 #include "vm/vec.h"
 
 #include <optional>
+#include <vector>
 
 namespace TrenchBroom {
 namespace Assets {
@@ -63,11 +64,17 @@ struct PatchGrid {
 };
 
 // public for testing
-std::vector<vm::vec3> computeGridNormals(std::vector<BezierPatch::Point> patchGrid, size_t pointRowCount, size_t pointColumnCount);
+std::vector<vm::vec3> computeGridNormals(const std::vector<BezierPatch::Point> &patchGrid, size_t pointRowCount, size_t pointColumnCount);
 
 // public for testing
 PatchGrid makePatchGrid(const BezierPatch &patch, size_t subdivisionsPerSurface);
 
+/**
+ * Computes the grids of the given patches in parallel, using the same subdivisions as
+ * patch nodes. The grids are returned in the order of the given patches.
+ */
+std::vector<PatchGrid> makePatchGrids(const std::vector<const BezierPatch *> &patches);
+
 class PatchNode : public Node, public Object {
   public:
     static const HitType::Type PatchHitType;
@@ -79,14 +86,35 @@ class PatchNode : public Node, public Object {
   public:
     explicit PatchNode(BezierPatch patch);
 
+    /**
+     * Creates a patch node with a grid that was already computed for the given patch.
+     */
+    PatchNode(BezierPatch patch, PatchGrid grid);
+
     EntityNodeBase *entity();
 
     const EntityNodeBase *entity() const;
 
     const BezierPatch &patch() const;
 
+    /**
+     * Sets the patch of this node and returns the previous patch. The grid is only
+     * recomputed if the given patch cannot use the current grid.
+     */
     BezierPatch setPatch(BezierPatch patch);
 
+    /**
+     * Sets the patch of this node together with a grid that was already computed for it,
+     * see makePatchGrids.
+     */
+    BezierPatch setPatch(BezierPatch patch, PatchGrid grid);
+
+    /**
+     * Indicates whether the grid of this node is also the grid of the given patch, which
+     * is the case if both patches have the same control points.
+     */
+    bool hasGridOf(const BezierPatch &patch) const;
+
     void setTexture(Assets::Texture *texture);
 
     const PatchGrid &grid() const;
@@ -31,6 +31,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
+#include <utility>
 
 namespace TrenchBroom {
 namespace Model {
@@ -47,10 +49,10 @@ class PickResult::CompareWrapper {
     }
 };
 
-PickResult::PickResult(std::shared_ptr<CompareHits> compare) : m_compare(std::move(compare)) {
+PickResult::PickResult(std::shared_ptr<CompareHits> compare) : m_compare(std::move(compare)), m_deferredDistance(std::numeric_limits<FloatType>::max()) {
 }
 
-PickResult::PickResult() : m_compare(std::make_shared<CompareHitsByDistance>()) {
+PickResult::PickResult() : m_compare(std::make_shared<CompareHitsByDistance>()), m_deferredDistance(std::numeric_limits<FloatType>::max()) {
 }
 
 PickResult::~PickResult() = default;
@@ -64,10 +66,12 @@ PickResult PickResult::bySize(const vm::axis::type axis) {
 }
 
 bool PickResult::empty() const {
+    pickDeferredHits();
     return m_hits.empty();
 }
 
 size_t PickResult::size() const {
+    pickDeferredHits();
     return m_hits.size();
 }
 
@@ -82,11 +86,46 @@ void PickResult::addHit(const Hit &hit) {
     m_hits.insert(pos, hit);
 }
 
+void PickResult::deferHitsAfter(const FloatType distance, std::function<void(PickResult &)> pickHits) {
+    pickDeferredHits();
+
+    m_hits.erase(std::remove_if(std::begin(m_hits), std::end(m_hits), [&](const auto &hit) { return hit.distance() > distance; }), std::end(m_hits));
+
+    m_deferredDistance = distance;
+    m_pickDeferredHits = std::move(pickHits);
+}
+
 const std::vector<Hit> &PickResult::all() const {
+    pickDeferredHits();
     return m_hits;
 }
 
 const Hit &PickResult::first(const HitFilter &filter) const {
+    const auto &hit = findFirst(filter);
+
+    // a deferred hit can only take precedence over a match with no error that is not
+    // further along the ray
+    if (!m_pickDeferredHits || (hit.isMatch() && hit.error() <= 0.0 && hit.distance() <= m_deferredDistance)) {
+        return hit;
+    }
+
+    pickDeferredHits();
+    return findFirst(filter);
+}
+
+std::vector<Hit> PickResult::all(const HitFilter &filter) const {
+    pickDeferredHits();
+    return kdl::vec_filter(m_hits, filter);
+}
+
+void PickResult::clear() {
+    m_hits.clear();
+    m_deferredDistance = std::numeric_limits<FloatType>::max();
+    m_pickDeferredHits = nullptr;
+    m_hitsBeforeDeferredHits.clear();
+}
+
+const Hit &PickResult::findFirst(const HitFilter &filter) const {
     const auto occluder = HitFilters::type(HitType::AnyType);
 
     if (!m_hits.empty()) {
@@ -123,12 +162,23 @@ const Hit &PickResult::first(const HitFilter &filter) const {
     return Hit::NoHit;
 }
 
-std::vector<Hit> PickResult::all(const HitFilter &filter) const {
-    return kdl::vec_filter(m_hits, filter);
-}
+void PickResult::pickDeferredHits() const {
+    if (m_pickDeferredHits) {
+        const auto pickHits = std::exchange(m_pickDeferredHits, nullptr);
+        const auto distance = std::exchange(m_deferredDistance, std::numeric_limits<FloatType>::max());
 
-void PickResult::clear() {
-    m_hits.clear();
+        auto deferredHits = PickResult{m_compare};
+        pickHits(deferredHits);
+
+        auto hits = m_hits;
+        for (const auto &hit : deferredHits.m_hits) {
+            if (hit.distance() > distance) {
+                auto pos = std::upper_bound(std::begin(hits), std::end(hits), hit, CompareWrapper(m_compare.get()));
+                hits.insert(pos, hit);
+            }
+        }
+        m_hitsBeforeDeferredHits = std::exchange(m_hits, std::move(hits));
+    }
 }
 } // namespace Model
 } // namespace TrenchBroom
@@ -19,12 +19,14 @@
 
 #pragma once
 
+#include "FloatType.h"
 #include "Macros.h"
 #include "Model/Hit.h"
 #include "Model/HitFilter.h"
 
 #include "vm/util.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -36,9 +38,22 @@ class HitQuery;
 
 class PickResult {
   private:
-    std::vector<Hit> m_hits;
+    mutable std::vector<Hit> m_hits;
     std::shared_ptr<CompareHits> m_compare;
 
+    /**
+     * The hits further along the pick ray than m_deferredDistance are missing until
+     * m_pickDeferredHits is called. See deferHitsAfter.
+     */
+    mutable FloatType m_deferredDistance;
+    mutable std::function<void(PickResult &)> m_pickDeferredHits;
+
+    /**
+     * The hits before the deferred hits were picked. They are kept so that the hits that
+     * were returned by earlier queries remain valid.
+     */
+    mutable std::vector<Hit> m_hitsBeforeDeferredHits;
+
     class CompareWrapper;
 
   public:
@@ -60,6 +75,16 @@ class PickResult {
 
     void addHit(const Hit &hit);
 
+    /**
+     * Removes the hits further along the pick ray than the given distance and defers
+     * picking them until a query could depend on them. Then the given function is called
+     * to pick all hits again, and the ones further than the given distance are added back.
+     *
+     * Hits that are added after this call are kept. This pick result must order its hits
+     * by distance.
+     */
+    void deferHitsAfter(FloatType distance, std::function<void(PickResult &)> pickHits);
+
     const std::vector<Hit> &all() const;
 
     const Hit &first(const HitFilter &filter) const;
@@ -67,6 +92,11 @@ class PickResult {
     std::vector<Hit> all(const HitFilter &filter) const;
 
     void clear();
+
+  private:
+    const Hit &findFirst(const HitFilter &filter) const;
+
+    void pickDeferredHits() const;
 };
 } // namespace Model
 } // namespace TrenchBroom
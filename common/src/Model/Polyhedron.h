@@ -22,6 +22,7 @@
 #include "Polyhedron_Forward.h"
 
 #include "kdl/intrusive_circular_list.h"
+#include "kdl/object_pool.h"
 
 #include "vm/bbox.h"
 #include "vm/forward.h"
@@ -29,6 +30,7 @@
 #include "vm/segment.h"
 #include "vm/util.h"
 #include "vm/vec.h"
+#include "vm/vec_soa.h"
 
 #include <initializer_list>
 #include <limits>
@@ -63,7 +65,7 @@ template<typename T, typename FP, typename VP> struct Polyhedron_GetVertexLink {
  *
  * The payload of a vertex can be used to store user data.
  */
-template<typename T, typename FP, typename VP> class Polyhedron_Vertex {
+template<typename T, typename FP, typename VP> class Polyhedron_Vertex : public kdl::pool_allocated<Polyhedron_Vertex<T, FP, VP>> {
   private:
     friend class Polyhedron<T, FP, VP>;
 
@@ -211,7 +213,7 @@ template<typename T, typename FP, typename VP> struct Polyhedron_GetEdgeLink {
  * Furthermore, an edge has a link to its previous and next neighbours in the containing
  * intrusive circular list.
  */
-template<typename T, typename FP, typename VP> class Polyhedron_Edge {
+template<typename T, typename FP, typename VP> class Polyhedron_Edge : public kdl::pool_allocated<Polyhedron_Edge<T, FP, VP>> {
   private:
     friend class Polyhedron<T, FP, VP>;
 
@@ -519,7 +521,7 @@ template<typename T, typename FP, typename VP> struct Polyhedron_GetHalfEdgeLink
  * A half edge is stored in an intrusive circular list that belongs to the face whose
  * boundary the half edge belongs to.
  */
-template<typename T, typename FP, typename VP> class Polyhedron_HalfEdge {
+template<typename T, typename FP, typename VP> class Polyhedron_HalfEdge : public kdl::pool_allocated<Polyhedron_HalfEdge<T, FP, VP>> {
   private:
     friend class Polyhedron<T, FP, VP>;
 
@@ -736,7 +738,7 @@ template<typename T, typename FP, typename VP> struct Polyhedron_GetFaceLink {
  * Furthermore, a face has a link to its previous and next neighbours in the containing
  * intrusive circular list.
  */
-template<typename T, typename FP, typename VP> class Polyhedron_Face {
+template<typename T, typename FP, typename VP> class Polyhedron_Face : public kdl::pool_allocated<Polyhedron_Face<T, FP, VP>> {
   private:
     friend class Polyhedron<T, FP, VP>;
 
@@ -1079,6 +1081,13 @@ template<typename T, typename FP, typename VP> class Polyhedron_Face {
     RayIntersection intersectWithRay(const vm::ray<T, 3> &ray) const;
 };
 
+/**
+ * A convex polyhedron.
+ *
+ * The vertices, edges, half edges and faces of all polyhedra are allocated from memory
+ * pools (see kdl::pool_allocated) because rebuilding a polyhedron creates and destroys
+ * a large number of these small objects.
+ */
 template<typename T, typename FP, typename VP> class Polyhedron {
   public:
     using FloatType = T;
@@ -2294,16 +2303,25 @@ template<typename T, typename FP, typename VP> class Polyhedron {
 
     static bool polyhedronIntersectsPolyhedron(const Polyhedron &lhs, const Polyhedron &rhs);
 
+    /**
+     * Returns the positions of the given vertices as a structure of arrays, so that they
+     * can be classified against many planes using the batch functions in vm/vec_soa.h.
+     *
+     * @param vertices the vertices
+     * @return the vertex positions
+     */
+    static vm::vec_soa<T, 3> vertexPositions(const VertexList &vertices);
+
     /**
      * Checks whether there is a face among the given faces such that all of the given
-     * vertices are above that face's plane.
+     * points are above that face's plane.
      *
      * @param faces the faces to check
-     * @param vertices the vertices to check against each face plane
-     * @return true if a face was found such that all of the given vertices have their
-     * position above the face plane and false otherwise
+     * @param positions the points to check against each face plane
+     * @return true if a face was found such that all of the given points are above the
+     * face plane and false otherwise
      */
-    static bool separate(const FaceList &faces, const VertexList &vertices);
+    static bool separate(const FaceList &faces, const vm::vec_soa<T, 3> &positions);
 
     /**
      * Checks the relative positions of the given points to the given plane. Returns
@@ -2313,10 +2331,10 @@ template<typename T, typename FP, typename VP> class Polyhedron {
      * - vm::plane_status::inside otherwise
      *
      * @param plane the plane
-     * @param vertices the vertices to check
+     * @param positions the points to check
      * @return the relative position of the given points to the given plane
      */
-    static vm::plane_status pointStatus(const vm::plane<T, 3> &plane, const VertexList &vertices);
+    static vm::plane_status pointStatus(const vm::plane<T, 3> &plane, const vm::vec_soa<T, 3> &positions);
 
     /* ====================== Implementation in Polyhedron_Checks.h ======================
      */
@@ -131,6 +131,11 @@ template<typename T, typename FP, typename VP> std::optional<typename Polyhedron
             break;
             switchDefault();
         }
+
+        if (above > 0u && below > 0u) {
+            // the plane separates some vertices from others, so it must intersect the polyhedron
+            return std::nullopt;
+        }
     }
 
     assert(above + below + inside == m_vertices.size());
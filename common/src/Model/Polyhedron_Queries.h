@@ -28,6 +28,10 @@
 #include "vm/ray.h"
 #include "vm/segment.h"
 #include "vm/util.h"
+#include "vm/vec_soa.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace TrenchBroom {
 namespace Model {
@@ -340,27 +344,36 @@ template<typename T, typename FP, typename VP> bool Polyhedron<T, FP, VP>::polyh
     // separating axis theorem
     // http://www.geometrictools.com/Documentation/MethodOfSeparatingAxes.pdf
 
-    if (separate(lhs.m_faces, rhs.vertices())) {
+    // the vertices are classified against many planes, so we gather their positions once
+    const auto lhsPositions = vertexPositions(lhs.m_vertices);
+    const auto rhsPositions = vertexPositions(rhs.m_vertices);
+
+    if (separate(lhs.m_faces, rhsPositions)) {
         return false;
     }
-    if (separate(rhs.faces(), lhs.m_vertices)) {
+    if (separate(rhs.faces(), lhsPositions)) {
         return false;
     }
 
+    auto rhsEdgeVecs = std::vector<vm::vec<T, 3>>{};
+    rhsEdgeVecs.reserve(rhs.edgeCount());
+    for (const auto *rhsEdge : rhs.edges()) {
+        rhsEdgeVecs.push_back(rhsEdge->vector());
+    }
+
     for (const auto *lhsEdge : lhs.edges()) {
         const auto lhsEdgeVec = lhsEdge->vector();
         const auto &lhsEdgeOrigin = lhsEdge->firstVertex()->position();
 
-        for (const auto *rhsEdge : rhs.edges()) {
-            const auto rhsEdgeVec = rhsEdge->vector();
+        for (const auto &rhsEdgeVec : rhsEdgeVecs) {
             const auto direction = vm::cross(lhsEdgeVec, rhsEdgeVec);
 
             if (!vm::is_zero(direction, vm::constants<T>::almost_zero())) {
                 const auto plane = vm::plane<T, 3>(lhsEdgeOrigin, direction);
 
-                const auto lhsStatus = pointStatus(plane, lhs.vertices());
+                const auto lhsStatus = pointStatus(plane, lhsPositions);
                 if (lhsStatus != vm::plane_status::inside) {
-                    const auto rhsStatus = pointStatus(plane, rhs.vertices());
+                    const auto rhsStatus = pointStatus(plane, rhsPositions);
                     if (rhsStatus != vm::plane_status::inside) {
                         if (lhsStatus != rhsStatus) {
                             return false;
@@ -374,10 +387,19 @@ template<typename T, typename FP, typename VP> bool Polyhedron<T, FP, VP>::polyh
     return true;
 }
 
-template<typename T, typename FP, typename VP> bool Polyhedron<T, FP, VP>::separate(const FaceList &faces, const VertexList &vertices) {
+template<typename T, typename FP, typename VP> vm::vec_soa<T, 3> Polyhedron<T, FP, VP>::vertexPositions(const VertexList &vertices) {
+    auto result = vm::vec_soa<T, 3>{};
+    result.reserve(vertices.size());
+    for (const auto *vertex : vertices) {
+        result.push_back(vertex->position());
+    }
+    return result;
+}
+
+template<typename T, typename FP, typename VP> bool Polyhedron<T, FP, VP>::separate(const FaceList &faces, const vm::vec_soa<T, 3> &positions) {
     for (const auto *face : faces) {
         const auto &plane = face->plane();
-        if (pointStatus(plane, vertices) == vm::plane_status::above) {
+        if (pointStatus(plane, positions) == vm::plane_status::above) {
             return true;
         }
     }
@@ -385,17 +407,19 @@ template<typename T, typename FP, typename VP> bool Polyhedron<T, FP, VP>::separ
     return false;
 }
 
-template<typename T, typename FP, typename VP> vm::plane_status Polyhedron<T, FP, VP>::pointStatus(const vm::plane<T, 3> &plane, const VertexList &vertices) {
+template<typename T, typename FP, typename VP> vm::plane_status Polyhedron<T, FP, VP>::pointStatus(const vm::plane<T, 3> &plane, const vm::vec_soa<T, 3> &positions) {
+    // Usually the plane intersects the points, which we can detect after looking at just a
+    // few of them, so we classify the points in small batches.
+    constexpr auto BatchSize = std::size_t(8);
+
     std::size_t above = 0u;
     std::size_t below = 0u;
 
-    for (const auto *vertex : vertices) {
-        const auto status = plane.point_status(vertex->position());
-        if (status == vm::plane_status::above) {
-            ++above;
-        } else if (status == vm::plane_status::below) {
-            ++below;
-        }
+    for (std::size_t first = 0u; first < positions.size(); first += BatchSize) {
+        const auto last = std::min(first + BatchSize, positions.size());
+        const auto count = vm::count_point_status(plane, positions, first, last);
+        above += count.above;
+        below += count.below;
         if (above > 0u && below > 0u) {
             return vm::plane_status::inside;
         }
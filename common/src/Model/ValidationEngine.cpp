@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ValidationEngine.h"
+
+#include "Model/BrushNode.h"
+#include "Model/EntityNode.h"
+#include "Model/GroupNode.h"
+#include "Model/LayerNode.h"
+#include "Model/Node.h"
+#include "Model/PatchNode.h"
+#include "Model/Validator.h"
+#include "Model/WorldNode.h"
+
+#include "kdl/overload.h"
+#include "kdl/parallel.h"
+#include "kdl/vector_utils.h"
+
+#include <algorithm>
+
+namespace TrenchBroom {
+namespace Model {
+void ValidationEngine::start(WorldNode &worldNode) {
+    cancel();
+
+    m_validators = worldNode.registeredValidators();
+    m_statistics = kdl::vec_transform(m_validators, [](const auto *validator) {
+        return ValidatorStatistics{validator, 0, std::chrono::nanoseconds{0}};
+    });
+
+    worldNode.accept(kdl::overload([&](auto &&thisLambda, WorldNode *world) {
+        m_nodes.push_back(world);
+        world->visitChildren(thisLambda);
+    }, [&](auto &&thisLambda, LayerNode *layer) {
+        m_nodes.push_back(layer);
+        layer->visitChildren(thisLambda);
+    }, [&](auto &&thisLambda, GroupNode *group) {
+        m_nodes.push_back(group);
+        group->visitChildren(thisLambda);
+    }, [&](auto &&thisLambda, EntityNode *entity) {
+        m_nodes.push_back(entity);
+        entity->visitChildren(thisLambda);
+    }, [&](BrushNode *brush) { m_nodes.push_back(brush); }, [&](PatchNode *patch) { m_nodes.push_back(patch); }));
+}
+
+void ValidationEngine::cancel() {
+    m_nodes.clear();
+    m_nextNode = 0;
+}
+
+bool ValidationEngine::running() const {
+    return m_nextNode < m_nodes.size();
+}
+
+std::vector<const Issue *> ValidationEngine::validateNext(const size_t maxInvalidNodes) {
+    const auto firstNode = m_nextNode;
+
+    auto invalidNodes = std::vector<Node *>{};
+    while (m_nextNode < m_nodes.size() && invalidNodes.size() < std::max(maxInvalidNodes, size_t(1))) {
+        auto *node = m_nodes[m_nextNode++];
+        if (!node->issuesValid()) {
+            // Some nodes compute their bounds lazily, and validators read the bounds of other
+            // nodes, so the bounds must be cached before the nodes are validated in parallel.
+            node->logicalBounds();
+            node->physicalBounds();
+            invalidNodes.push_back(node);
+        }
+    }
+
+    const auto validatorCount = m_validators.size();
+    auto durations = std::vector<std::chrono::nanoseconds>(invalidNodes.size() * validatorCount);
+    kdl::parallel_for(invalidNodes.size(), [&](const size_t i) {
+        invalidNodes[i]->validateIssues(m_validators, [&](const size_t validatorIndex, const std::chrono::nanoseconds duration) {
+            durations[i * validatorCount + validatorIndex] = duration;
+        });
+    });
+
+    for (size_t i = 0; i < invalidNodes.size(); ++i) {
+        for (size_t j = 0; j < validatorCount; ++j) {
+            m_statistics[j].duration += durations[i * validatorCount + j];
+        }
+    }
+    for (auto &statistics : m_statistics) {
+        statistics.nodeCount += invalidNodes.size();
+    }
+
+    auto result = std::vector<const Issue *>{};
+    for (size_t i = firstNode; i < m_nextNode; ++i) {
+        const auto issues = m_nodes[i]->issues(m_validators);
+        result.insert(result.end(), issues.begin(), issues.end());
+    }
+
+    if (!running()) {
+        cancel();
+    }
+
+    return result;
+}
+
+const std::vector<ValidatorStatistics> &ValidationEngine::statistics() const {
+    return m_statistics;
+}
+} // namespace Model
+} // namespace TrenchBroom
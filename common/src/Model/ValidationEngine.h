@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace TrenchBroom {
+namespace Model {
+class Issue;
+
+class Node;
+
+class Validator;
+
+class WorldNode;
+
+struct ValidatorStatistics {
+    const Validator *validator;
+    /**
+     * The number of nodes validated by the validator.
+     */
+    size_t nodeCount;
+    /**
+     * The total time the validator took, summed over all threads.
+     */
+    std::chrono::nanoseconds duration;
+};
+
+/**
+ * Validates the issues of all nodes of a world in batches.
+ *
+ * A validation run is started by calling start(), which collects the nodes of the world.
+ * Every call to validateNext() then validates the next batch of nodes whose issues are
+ * invalid on the worker threads of the global thread pool, and returns the issues of all
+ * nodes that were visited, so that the caller can show them while the remaining nodes are
+ * validated in later batches.
+ *
+ * The nodes must not be modified while validateNext() is running. Between batches, the
+ * caller is free to modify the nodes, but it must cancel the run and start a new one
+ * afterwards since the run may refer to nodes that were removed.
+ */
+class ValidationEngine {
+  private:
+    std::vector<const Validator *> m_validators;
+    std::vector<Node *> m_nodes;
+    size_t m_nextNode = 0;
+    std::vector<ValidatorStatistics> m_statistics;
+
+  public:
+    /**
+     * Starts a new validation run for the given world and cancels the current run, if any.
+     * Resets the statistics.
+     */
+    void start(WorldNode &worldNode);
+
+    void cancel();
+
+    bool running() const;
+
+    /**
+     * Validates up to the given number of nodes with invalid issues and returns the issues
+     * of these nodes and of all nodes with valid issues that precede them. Finishes the
+     * run once all nodes have been visited.
+     */
+    std::vector<const Issue *> validateNext(size_t maxInvalidNodes);
+
+    /**
+     * Returns the time spent in each validator during the current or the last run.
+     */
+    const std::vector<ValidatorStatistics> &statistics() const;
+};
+} // namespace Model
+} // namespace TrenchBroom
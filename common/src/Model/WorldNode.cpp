@@ -25,8 +25,10 @@
 #include "Model/EntityNode.h"
 #include "Model/EntityNodeIndex.h"
 #include "Model/GroupNode.h"
+#include "Model/Hit.h"
 #include "Model/LayerNode.h"
 #include "Model/PatchNode.h"
+#include "Model/PickResult.h"
 #include "Model/TagVisitor.h"
 #include "Model/Validator.h"
 #include "Model/ValidatorRegistry.h"
@@ -38,6 +40,7 @@
 
 #include "vm/bbox_io.h"
 
+#include <limits>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -71,6 +74,13 @@ const WorldNode::NodeTree &WorldNode::nodeTree() const {
     return *m_nodeTree;
 }
 
+std::vector<Node *> WorldNode::findNodesIntersecting(const vm::bbox3 &bounds) const {
+    // the tree only tests the bounds of the cells that contain the nodes
+    return kdl::vec_filter(m_nodeTree->find_intersectors(bounds), [&](const auto *node) {
+        return bounds.intersects(node->physicalBounds());
+    });
+}
+
 LayerNode *WorldNode::defaultLayer() {
     ensure(m_defaultLayer != nullptr, "defaultLayer is null");
     return m_defaultLayer;
@@ -190,6 +200,13 @@ void WorldNode::rebuildNodeTree() {
     }
 }
 
+void WorldNode::pickFirst(const EditorContext &editorContext, const vm::ray3 &ray, const HitFilter &filter, PickResult &pickResult) {
+    m_nodeTree->visit_intersectors_front_to_back(ray, [&](auto *node) { node->pick(editorContext, ray, pickResult); }, [&]() {
+        const auto &hit = pickResult.first(filter);
+        return hit.isMatch() ? hit.distance() : std::numeric_limits<FloatType>::max();
+    });
+}
+
 void WorldNode::invalidateAllIssues() {
     accept([](auto &&thisLambda, Node *node) {
         node->invalidateIssues();
@@ -23,6 +23,7 @@
 #include "Macros.h"
 #include "Model/EntityNodeBase.h"
 #include "Model/EntityProperties.h"
+#include "Model/HitFilter.h"
 #include "Model/IdType.h"
 #include "Model/MapFormat.h"
 #include "Model/Node.h"
@@ -78,6 +79,15 @@ class WorldNode : public EntityNodeBase {
 
     const NodeTree &nodeTree() const;
 
+    /**
+     * Returns the nodes in the node tree whose physical bounds intersect with the given
+     * bounds. Only entities, brushes and patches are stored in the node tree.
+     *
+     * This is meant as a broad phase for spatial queries. Callers that need exact results
+     * must still test the returned nodes themselves.
+     */
+    std::vector<Node *> findNodesIntersecting(const vm::bbox3 &bounds) const;
+
   public: // layer management
     LayerNode *defaultLayer();
 
@@ -147,6 +157,17 @@ class WorldNode : public EntityNodeBase {
 
     void rebuildNodeTree();
 
+  public: // picking
+    /**
+     * Picks the nodes that the given ray hits like pick, but visits the nodes front to back
+     * and stops once no remaining node can be hit before the first hit that matches the
+     * given filter. Afterwards, the pick result yields the same first hit for the filter as
+     * if pick had been called, but it may lack hits further along the ray.
+     *
+     * The given pick result must order its hits by distance.
+     */
+    void pickFirst(const EditorContext &editorContext, const vm::ray3 &ray, const HitFilter &filter, PickResult &pickResult);
+
   private:
     void invalidateAllIssues();
 
@@ -48,6 +48,7 @@ enum LengthUnitDisplay {
 extern Preference<int> MapViewLayout;
 extern Preference<LogLevel> AppLogLevel;
 extern Preference<int> AutoSaveInterval;
+extern Preference<int> UndoMemoryBudget;
 
 /* --- VIEW ------------------------------------------ */
 extern Preference<bool> ShowFocusIndicator;
@@ -181,6 +182,7 @@ extern Preference<Color> GridColor2D;
 
 extern Preference<int> TextureMinFilter;
 extern Preference<int> TextureMagFilter;
+extern Preference<bool> LazyTextureLoading;
 extern Preference<bool> EnableMSAA;
 extern Preference<bool> EnableAnisotropicFilter;
 extern Preference<float> AnisotropicFilterValue;
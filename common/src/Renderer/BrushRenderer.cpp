@@ -31,6 +31,8 @@
 #include "Renderer/BrushRendererBrushCache.h"
 #include "Renderer/RenderContext.h"
 
+#include "kdl/parallel.h"
+
 #include <cassert>
 #include <cstring>
 #include <vector>
@@ -119,7 +121,7 @@ BrushRenderer::Filter::RenderSettings BrushRenderer::NoFilter::markFaces(const M
 // BrushRenderer
 
 BrushRenderer::BrushRenderer()
-    : m_filter{std::make_unique<NoFilter>()}, m_showEdges{false}, m_grayscale{false}, m_tint{false}, m_showOccludedEdges{false}, m_forceTransparent{false}, m_transparencyAlpha{1.0f}, m_showHiddenBrushes{false} {
+    : m_filter{std::make_unique<NoFilter>()}, m_showEdges{false}, m_grayscale{false}, m_tint{false}, m_showOccludedEdges{false}, m_forceTransparent{false}, m_transparencyAlpha{1.0f}, m_showHiddenBrushes{false}, m_visibleBrushes{nullptr}, m_renderRangesValid{false} {
     clear();
 }
 
@@ -166,6 +168,7 @@ void BrushRenderer::clear() {
     m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
     m_transparentFaceRenderer = FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
     m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+    invalidateRenderRanges();
 }
 
 void BrushRenderer::setFaceColor(const Color &faceColor) {
@@ -221,6 +224,14 @@ void BrushRenderer::setShowHiddenBrushes(const bool showHiddenBrushes) {
     }
 }
 
+void BrushRenderer::setVisibleBrushes(const VisibleBrushes *visibleBrushes) {
+    // the contents of the set may have changed even if the pointer is the same
+    if (visibleBrushes != nullptr || m_visibleBrushes != nullptr) {
+        m_visibleBrushes = visibleBrushes;
+        m_renderRangesValid = false;
+    }
+}
+
 void BrushRenderer::render(RenderContext &renderContext, RenderBatch &renderBatch) {
     renderOpaque(renderContext, renderBatch);
     renderTransparent(renderContext, renderBatch);
@@ -231,6 +242,9 @@ void BrushRenderer::renderOpaque(RenderContext &renderContext, RenderBatch &rend
         if (!valid()) {
             validate();
         }
+        if (!m_renderRangesValid) {
+            updateRenderRanges();
+        }
         if (renderContext.showFaces()) {
             renderOpaqueFaces(renderBatch);
         }
@@ -245,12 +259,139 @@ void BrushRenderer::renderTransparent(RenderContext &renderContext, RenderBatch
         if (!valid()) {
             validate();
         }
+        if (!m_renderRangesValid) {
+            updateRenderRanges();
+        }
         if (renderContext.showFaces()) {
             renderTransparentFaces(renderBatch);
         }
     }
 }
 
+void BrushRenderer::updateRenderRanges() {
+    const RenderRanges *ranges = nullptr;
+    if (m_visibleBrushes != nullptr) {
+        auto it = m_renderRanges.find(m_visibleBrushes);
+        if (it == std::end(m_renderRanges) || it->second.version != m_visibleBrushes->version) {
+            it = m_renderRanges.insert_or_assign(m_visibleBrushes, makeRenderRanges(*m_visibleBrushes)).first;
+        }
+        ranges = &it->second;
+    }
+
+    if (ranges == nullptr || ranges->renderAll) {
+        m_edgeIndices->resetRenderRanges();
+        for (const auto &[texture, indexArray] : *m_opaqueFaces) {
+            indexArray->resetRenderRanges();
+        }
+        for (const auto &[texture, indexArray] : *m_transparentFaces) {
+            indexArray->resetRenderRanges();
+        }
+    } else {
+        m_edgeIndices->setRenderRanges(ranges->edgeRanges);
+        for (const auto &[indexArray, faceRanges] : ranges->faceRanges) {
+            indexArray->setRenderRanges(faceRanges);
+        }
+    }
+
+    m_renderRangesValid = true;
+}
+
+/**
+ * The overhead of a draw call, expressed as the number of indices that could be drawn
+ * instead. This is a rough estimate, it only serves to avoid splitting a draw call into
+ * many small ones to save just a few indices.
+ */
+static constexpr size_t DrawCallCost = 1024u;
+
+/**
+ * Returns the merged given ranges, or null if drawing all indices of the given array is
+ * cheaper than drawing just the ranges.
+ */
+static BrushIndexArray::RenderRanges chooseRenderRanges(const BrushIndexArray &indexArray, std::vector<BrushIndexArray::IndexRange> ranges) {
+    auto result = BrushIndexArray::makeRenderRanges(std::move(ranges));
+
+    auto rangesCost = result->size() * DrawCallCost;
+    for (const auto &[offset, count] : *result) {
+        rangesCost += count;
+    }
+    return rangesCost < DrawCallCost + indexArray.indexCount() ? result : nullptr;
+}
+
+BrushRenderer::RenderRanges BrushRenderer::makeRenderRanges(const VisibleBrushes &visibleBrushes) const {
+    auto result = RenderRanges{visibleBrushes.version, false, nullptr, {}};
+
+    // look up the smaller set in the larger one
+    auto visibleInfos = std::vector<const BrushInfo *>{};
+    if (visibleBrushes.brushes.size() < m_brushInfo.size()) {
+        for (const auto *brushNode : visibleBrushes.brushes) {
+            if (const auto it = m_brushInfo.find(brushNode); it != std::end(m_brushInfo)) {
+                visibleInfos.push_back(&it->second);
+            }
+        }
+    } else {
+        for (const auto &[brushNode, info] : m_brushInfo) {
+            if (visibleBrushes.brushes.count(brushNode) > 0u) {
+                visibleInfos.push_back(&info);
+            }
+        }
+    }
+
+    // If most brushes are visible, restricting the ranges hardly reduces the number of
+    // indices drawn, but it can split the single draw call per texture into many.
+    if (visibleInfos.size() * 4u >= m_brushInfo.size() * 3u) {
+        result.renderAll = true;
+        return result;
+    }
+
+    using IndexRange = BrushIndexArray::IndexRange;
+
+    // every index array gets an entry so that arrays without visible brushes draw nothing
+    auto edgeRanges = std::vector<IndexRange>{};
+    auto opaqueFaceRanges = std::unordered_map<const Assets::Texture *, std::vector<IndexRange>>{};
+    auto transparentFaceRanges = std::unordered_map<const Assets::Texture *, std::vector<IndexRange>>{};
+
+    for (const auto *info : visibleInfos) {
+        if (info->edgeIndicesKey != nullptr) {
+            edgeRanges.emplace_back(info->edgeIndicesKey->pos, info->edgeIndicesKey->size);
+        }
+        for (const auto &[texture, key] : info->opaqueFaceIndicesKeys) {
+            opaqueFaceRanges[texture].emplace_back(key->pos, key->size);
+        }
+        for (const auto &[texture, key] : info->transparentFaceIndicesKeys) {
+            transparentFaceRanges[texture].emplace_back(key->pos, key->size);
+        }
+    }
+
+    result.edgeRanges = chooseRenderRanges(*m_edgeIndices, std::move(edgeRanges));
+
+    const auto addFaceRanges = [&](const TextureToBrushIndicesMap &indexArrays, auto &rangesByTexture) {
+        for (const auto &[texture, indexArray] : indexArrays) {
+            auto it = rangesByTexture.find(texture);
+            auto ranges = it != std::end(rangesByTexture) ? std::move(it->second) : std::vector<IndexRange>{};
+            result.faceRanges.emplace_back(indexArray.get(), chooseRenderRanges(*indexArray, std::move(ranges)));
+        }
+    };
+    addFaceRanges(*m_opaqueFaces, opaqueFaceRanges);
+    addFaceRanges(*m_transparentFaces, transparentFaceRanges);
+
+    return result;
+}
+
+BrushIndexArray::RenderRanges BrushRenderer::edgeRenderRanges() {
+    if (!valid()) {
+        validate();
+    }
+    if (!m_renderRangesValid) {
+        updateRenderRanges();
+    }
+    return m_edgeIndices->renderRanges();
+}
+
+void BrushRenderer::invalidateRenderRanges() {
+    m_renderRanges.clear();
+    m_renderRangesValid = false;
+}
+
 void BrushRenderer::renderOpaqueFaces(RenderBatch &renderBatch) {
     m_opaqueFaceRenderer.setGrayscale(m_grayscale);
     m_opaqueFaceRenderer.setTint(m_tint);
@@ -296,11 +437,44 @@ class BrushRenderer::FilterWrapper : public BrushRenderer::Filter {
     }
 };
 
+static bool rendersAnything(const BrushRenderer::Filter::RenderSettings &settings) {
+    const auto [facePolicy, edgePolicy] = settings;
+    return facePolicy != BrushRenderer::Filter::FaceRenderPolicy::RenderNone || edgePolicy != BrushRenderer::Filter::EdgeRenderPolicy::RenderNone;
+}
+
 void BrushRenderer::validate() {
     assert(!valid());
 
-    for (auto *brushNode : m_invalidBrushes) {
-        validateBrush(*brushNode);
+    static constexpr auto BrushesPerTask = size_t(128);
+
+    const auto invalidBrushes = std::vector<const Model::BrushNode *>{m_invalidBrushes.begin(), m_invalidBrushes.end()};
+    const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
+
+    // Evaluating the filter reads preferences through the editor context, which is only
+    // allowed on the main thread, so the faces are marked here.
+    auto settings = std::vector<Filter::RenderSettings>{};
+    settings.reserve(invalidBrushes.size());
+
+    auto renderedBrushes = std::vector<const Model::BrushNode *>{};
+    renderedBrushes.reserve(invalidBrushes.size());
+
+    for (const auto *brushNode : invalidBrushes) {
+        settings.push_back(wrapper.markFaces(*brushNode));
+        if (rendersAnything(settings.back())) {
+            renderedBrushes.push_back(brushNode);
+        }
+    }
+
+    // Rebuilding a vertex cache only reads the brush's geometry and the dimensions of its
+    // textures, which are known before the textures are decoded, so the caches can be
+    // rebuilt in parallel. Inserting the brushes into the vertex and index arrays modifies
+    // shared state and must happen on this thread.
+    kdl::parallel_for(renderedBrushes.size(), BrushesPerTask, [&](const size_t i) {
+        renderedBrushes[i]->brushRendererBrushCache().validateVertexCache(*renderedBrushes[i]);
+    });
+
+    for (size_t i = 0; i < invalidBrushes.size(); ++i) {
+        validateBrush(*invalidBrushes[i], settings[i]);
     }
     m_invalidBrushes.clear();
     assert(valid());
@@ -308,6 +482,7 @@ void BrushRenderer::validate() {
     m_opaqueFaceRenderer = FaceRenderer{m_vertexArray, m_opaqueFaces, m_faceColor};
     m_transparentFaceRenderer = FaceRenderer{m_vertexArray, m_transparentFaces, m_faceColor};
     m_edgeRenderer = IndexedEdgeRenderer{m_vertexArray, m_edgeIndices};
+    invalidateRenderRanges();
 }
 
 static size_t triIndicesCountForPolygon(const size_t vertexCount) {
@@ -388,15 +563,11 @@ bool BrushRenderer::shouldDrawFaceInTransparentPass(const Model::BrushNode &brus
     return false;
 }
 
-void BrushRenderer::validateBrush(const Model::BrushNode &brushNode) {
+void BrushRenderer::validateBrush(const Model::BrushNode &brushNode, const Filter::RenderSettings &settings) {
     assert(m_allBrushes.find(&brushNode) != std::end(m_allBrushes));
     assert(m_invalidBrushes.find(&brushNode) != std::end(m_invalidBrushes));
     assert(m_brushInfo.find(&brushNode) == std::end(m_brushInfo));
 
-    const auto wrapper = FilterWrapper{*m_filter, m_showHiddenBrushes};
-
-    // evaluate filter. only evaluate the filter once per brush.
-    const auto settings = wrapper.markFaces(brushNode);
     const auto [facePolicy, edgePolicy] = settings;
 
     if (facePolicy == Filter::FaceRenderPolicy::RenderNone && edgePolicy == Filter::EdgeRenderPolicy::RenderNone) {
@@ -407,8 +578,7 @@ void BrushRenderer::validateBrush(const Model::BrushNode &brushNode) {
     BrushInfo &info = m_brushInfo[&brushNode];
 
     // collect vertices
-    auto &brushCache = brushNode.brushRendererBrushCache();
-    brushCache.validateVertexCache(brushNode);
+    const auto &brushCache = brushNode.brushRendererBrushCache();
     const auto &cachedVertices = brushCache.cachedVertices();
     ensure(!cachedVertices.empty(), "Brush must have cached vertices");
 
@@ -576,6 +746,7 @@ void BrushRenderer::removeBrushFromVbo(const Model::BrushNode &brushNode) {
     }
 
     m_brushInfo.erase(it);
+    invalidateRenderRanges();
 }
 } // namespace Renderer
 } // namespace TrenchBroom
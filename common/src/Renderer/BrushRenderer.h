@@ -23,6 +23,7 @@
 #include "Macros.h"
 #include "Model/BrushGeometry.h"
 #include "Renderer/AllocationTracker.h"
+#include "Renderer/BrushRendererArrays.h"
 #include "Renderer/EdgeRenderer.h"
 #include "Renderer/FaceRenderer.h"
 
@@ -42,6 +43,16 @@ class EditorContext;
 } // namespace Model
 
 namespace Renderer {
+/**
+ * A set of brushes to restrict rendering to, e.g. the brushes that intersect with a view
+ * frustum. The version must change whenever the set's contents change so that renderers
+ * can tell whether the render ranges they computed for it are still up to date.
+ */
+struct VisibleBrushes {
+  std::unordered_set<const Model::BrushNode *> brushes;
+  size_t version = 0;
+};
+
 class BrushRenderer {
   public:
     class Filter {
@@ -165,9 +176,28 @@ class BrushRenderer {
 
     bool m_showHiddenBrushes;
 
+    /**
+     * If not null, only the brushes in this set are rendered. Not owned.
+     */
+    const VisibleBrushes *m_visibleBrushes;
+
+    struct RenderRanges {
+      size_t version;
+      bool renderAll;
+      BrushIndexArray::RenderRanges edgeRanges;
+      std::vector<std::pair<BrushIndexArray *, BrushIndexArray::RenderRanges>> faceRanges;
+    };
+    /**
+     * The render ranges computed for each set of visible brushes, so that views that use
+     * different sets can switch between them without recomputing the ranges. Cleared
+     * whenever the index arrays change.
+     */
+    std::unordered_map<const VisibleBrushes *, RenderRanges> m_renderRanges;
+    bool m_renderRangesValid;
+
   public:
     template<typename FilterT> explicit BrushRenderer(const FilterT &filter)
-        : m_filter{std::make_unique<FilterT>(filter)}, m_showEdges{false}, m_grayscale{false}, m_tint{false}, m_showOccludedEdges{false}, m_forceTransparent{false}, m_transparencyAlpha{1.0f}, m_showHiddenBrushes{false} {
+        : m_filter{std::make_unique<FilterT>(filter)}, m_showEdges{false}, m_grayscale{false}, m_tint{false}, m_showOccludedEdges{false}, m_forceTransparent{false}, m_transparencyAlpha{1.0f}, m_showHiddenBrushes{false}, m_visibleBrushes{nullptr}, m_renderRangesValid{false} {
         clear();
     }
 
@@ -265,6 +295,17 @@ class BrushRenderer {
      */
     void setShowHiddenBrushes(bool showHiddenBrushes);
 
+    /**
+     * Restricts rendering to the given brushes, e.g. the brushes that intersect with the
+     * view frustum. Passing null renders all brushes again.
+     *
+     * Only the index ranges of the given brushes are drawn; the VBOs are not touched. If
+     * most of this renderer's brushes are visible, all brushes are drawn instead because
+     * that takes fewer draw calls. The given set is read by the next calls to the render
+     * methods and must remain valid until then.
+     */
+    void setVisibleBrushes(const VisibleBrushes *visibleBrushes);
+
   public: // rendering
     void render(RenderContext &renderContext, RenderBatch &renderBatch);
 
@@ -273,6 +314,12 @@ class BrushRenderer {
     void renderTransparent(RenderContext &renderContext, RenderBatch &renderBatch);
 
   private:
+    void updateRenderRanges();
+
+    RenderRanges makeRenderRanges(const VisibleBrushes &visibleBrushes) const;
+
+    void invalidateRenderRanges();
+
     void renderOpaqueFaces(RenderBatch &renderBatch);
 
     void renderTransparentFaces(RenderBatch &renderBatch);
@@ -285,10 +332,21 @@ class BrushRenderer {
      */
     void validate();
 
+    /**
+     * Returns the ranges of edge indices that the next render call draws, or null if it
+     * draws all edge indices. Only exposed for testing.
+     */
+    BrushIndexArray::RenderRanges edgeRenderRanges();
+
   private:
     bool shouldDrawFaceInTransparentPass(const Model::BrushNode &brushNode, const Model::BrushFace &face) const;
 
-    void validateBrush(const Model::BrushNode &brushNode);
+    /**
+     * Inserts the given brush into the vertex and index arrays. The filter must have been
+     * evaluated for the brush already, yielding the given settings, and the brush's vertex
+     * cache must be valid unless the settings say that nothing is rendered.
+     */
+    void validateBrush(const Model::BrushNode &brushNode, const Filter::RenderSettings &settings);
 
   public:
     /**
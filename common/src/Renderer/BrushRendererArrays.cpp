@@ -131,9 +131,52 @@ void BrushIndexArray::zeroElementsWithKey(AllocationTracker::Block *key) {
     m_indexHolder.zeroRange(pos, size);
 }
 
+bool BrushIndexArray::hasIndicesToRender() const {
+    return hasValidIndices() && (!m_renderRanges || !m_renderRanges->empty());
+}
+
+size_t BrushIndexArray::indexCount() const {
+    return m_indexHolder.size();
+}
+
+BrushIndexArray::RenderRanges BrushIndexArray::makeRenderRanges(std::vector<IndexRange> ranges) {
+    std::sort(ranges.begin(), ranges.end());
+
+    auto merged = std::vector<IndexRange>{};
+    merged.reserve(ranges.size());
+    for (const auto &[offset, count] : ranges) {
+        if (!merged.empty() && merged.back().first + merged.back().second >= offset) {
+            auto &last = merged.back();
+            last.second = std::max(last.first + last.second, offset + count) - last.first;
+        } else {
+            merged.emplace_back(offset, count);
+        }
+    }
+
+    return std::make_shared<const std::vector<IndexRange>>(std::move(merged));
+}
+
+void BrushIndexArray::setRenderRanges(RenderRanges ranges) {
+    m_renderRanges = std::move(ranges);
+}
+
+void BrushIndexArray::resetRenderRanges() {
+    m_renderRanges = nullptr;
+}
+
+const BrushIndexArray::RenderRanges &BrushIndexArray::renderRanges() const {
+    return m_renderRanges;
+}
+
 void BrushIndexArray::render(const PrimType primType) const {
     assert(m_indexHolder.prepared());
-    m_indexHolder.render(primType, 0, m_indexHolder.size());
+    if (m_renderRanges) {
+        for (const auto &[offset, count] : *m_renderRanges) {
+            m_indexHolder.render(primType, offset, count);
+        }
+    } else {
+        m_indexHolder.render(primType, 0, m_indexHolder.size());
+    }
 }
 
 bool BrushIndexArray::prepared() const {
@@ -33,6 +33,7 @@
 #include <cassert>
 #include <memory>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace TrenchBroom {
@@ -222,9 +223,22 @@ class IndexHolder : public VboHolder<GLuint> {
  * they become degenerate primitives.
  */
 class BrushIndexArray {
+  public:
+    /**
+     * A range of indices, given as its offset and its number of indices.
+     */
+    using IndexRange = std::pair<size_t, size_t>;
+
+    /**
+     * Sorted and merged index ranges to render. Shared so that a set of ranges computed
+     * once can be applied to the array again without copying it.
+     */
+    using RenderRanges = std::shared_ptr<const std::vector<IndexRange>>;
+
   private:
     IndexHolder m_indexHolder;
     AllocationTracker m_allocationTracker;
+    RenderRanges m_renderRanges;
 
   public:
     BrushIndexArray();
@@ -235,6 +249,40 @@ class BrushIndexArray {
      */
     bool hasValidIndices() const;
 
+    /**
+     * Returns true if there are any valid indices and the render ranges, if any are set,
+     * are not empty.
+     */
+    bool hasIndicesToRender() const;
+
+    /**
+     * Returns the number of indices drawn when no render ranges are set, including the
+     * ranges zeroed by zeroElementsWithKey().
+     */
+    size_t indexCount() const;
+
+    /**
+     * Sorts the given ranges and merges adjacent ranges so that each of the remaining
+     * ranges can be rendered with a single draw call.
+     */
+    static RenderRanges makeRenderRanges(std::vector<IndexRange> ranges);
+
+    /**
+     * Restricts rendering to the given ranges until resetRenderRanges() is called. Passing
+     * null renders all indices.
+     */
+    void setRenderRanges(RenderRanges ranges);
+
+    /**
+     * Removes any restriction set by setRenderRanges(), so that all indices are rendered.
+     */
+    void resetRenderRanges();
+
+    /**
+     * Returns the ranges set by setRenderRanges(), or null if all indices are rendered.
+     */
+    const RenderRanges &renderRanges() const;
+
     /**
      * Call this to request writing the given number of indices.
      *
@@ -216,7 +216,7 @@ void FaceRenderer::doRender(RenderContext &context) {
         }
 
         for (const auto &[texture, brushIndexHolderPtr] : *m_indexArrayMap) {
-            if (!brushIndexHolderPtr->hasValidIndices()) {
+            if (!brushIndexHolderPtr->hasIndicesToRender()) {
                 continue;
             }
 
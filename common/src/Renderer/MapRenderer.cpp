@@ -33,6 +33,7 @@
 #include "PreferenceManager.h"
 #include "Preferences.h"
 #include "Renderer/BrushRenderer.h"
+#include "Renderer/Camera.h"
 #include "Renderer/EntityDecalRenderer.h"
 #include "Renderer/EntityLinkRenderer.h"
 #include "Renderer/GroupLinkRenderer.h"
@@ -42,12 +43,17 @@
 #include "Renderer/RenderUtils.h"
 #include "View/MapDocument.h"
 #include "View/Selection.h"
+#include "octree.h"
 
 #include <kdl/memory_utils.h>
 #include <kdl/overload.h>
 #include <kdl/path_utils.h>
 #include <kdl/vector_set.h>
 
+#include <vm/bbox.h>
+#include <vm/plane.h>
+
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -132,7 +138,7 @@ class UnselectedBrushRendererFilter : public BrushRenderer::DefaultFilter {
 } // namespace
 
 MapRenderer::MapRenderer(std::weak_ptr<View::MapDocument> document)
-    : m_document{std::move(document)}, m_defaultRenderer{createDefaultRenderer(m_document)}, m_selectionRenderer{createSelectionRenderer(m_document)}, m_lockedRenderer{createLockRenderer(m_document)}, m_entityDecalRenderer{createEntityDecalRenderer(m_document)}, m_entityLinkRenderer{std::make_unique<EntityLinkRenderer>(m_document)}, m_groupLinkRenderer{std::make_unique<GroupLinkRenderer>(m_document)} {
+    : m_document{std::move(document)}, m_defaultRenderer{createDefaultRenderer(m_document)}, m_selectionRenderer{createSelectionRenderer(m_document)}, m_lockedRenderer{createLockRenderer(m_document)}, m_entityDecalRenderer{createEntityDecalRenderer(m_document)}, m_entityLinkRenderer{std::make_unique<EntityLinkRenderer>(m_document)}, m_groupLinkRenderer{std::make_unique<GroupLinkRenderer>(m_document)}, m_nodeTreeVersion{1}, m_nextVisibleBrushesVersion{1} {
     connectObservers();
     setupRenderers();
 }
@@ -165,6 +171,7 @@ void MapRenderer::clear() {
     m_entityLinkRenderer->invalidate();
     m_groupLinkRenderer->invalidate();
     m_trackedNodes.clear();
+    invalidateCulling();
 }
 
 void MapRenderer::overrideSelectionColors(const Color &color, const float mix) {
@@ -184,6 +191,7 @@ void MapRenderer::restoreSelectionColors() {
 
 void MapRenderer::render(RenderContext &renderContext, RenderBatch &renderBatch) {
     commitPendingChanges();
+    cullNodes(renderContext);
     setupGL(renderBatch);
     renderDefaultOpaque(renderContext, renderBatch);
     renderLockedOpaque(renderContext, renderBatch);
@@ -203,6 +211,80 @@ void MapRenderer::commitPendingChanges() {
     document->commitPendingAssets();
 }
 
+const MapRenderer::CullingStats &MapRenderer::cullingStats() const {
+    return m_cullingStats;
+}
+
+void MapRenderer::removeView(const Camera &camera) {
+    if (m_viewCulling.erase(&camera) > 0u) {
+        // the renderers may still refer to the visible brushes of the removed view
+        m_defaultRenderer->setVisibleBrushes(nullptr);
+        m_selectionRenderer->setVisibleBrushes(nullptr);
+        m_lockedRenderer->setVisibleBrushes(nullptr);
+    }
+}
+
+static bool isOutsideFrustum(const vm::bbox3 &bounds, const std::vector<vm::plane3> &frustum) {
+    return std::any_of(std::begin(frustum), std::end(frustum), [&](const auto &plane) {
+        // the corner of the bounds that is furthest below the plane
+        auto corner = vm::vec3{};
+        for (size_t i = 0; i < 3; ++i) {
+            corner[i] = plane.normal[i] >= 0.0 ? bounds.min[i] : bounds.max[i];
+        }
+        return plane.point_distance(corner) > 0.0;
+    });
+}
+
+void MapRenderer::cullNodes(RenderContext &renderContext) {
+    auto document = kdl::mem_lock(m_document);
+    const auto *world = document->world();
+    if (world == nullptr) {
+        m_cullingStats = CullingStats{};
+        return;
+    }
+
+    auto top = vm::plane3f{}, right = vm::plane3f{}, bottom = vm::plane3f{}, left = vm::plane3f{};
+    renderContext.camera().frustumPlanes(top, right, bottom, left);
+    auto frustum = std::vector<vm::plane3>{vm::plane3{top}, vm::plane3{right}, vm::plane3{bottom}, vm::plane3{left}};
+
+    auto &culling = m_viewCulling[&renderContext.camera()];
+    if (culling.nodeTreeVersion != m_nodeTreeVersion || culling.frustum != frustum) {
+        const auto &nodeTree = world->nodeTree();
+
+        auto visibleNodes = nodeTree.find_volume_intersectors(frustum);
+        // the tree only tests the bounds of the cells that contain the nodes
+        visibleNodes.erase(std::remove_if(std::begin(visibleNodes), std::end(visibleNodes), [&](const auto *node) {
+            return isOutsideFrustum(node->logicalBounds(), frustum);
+        }), std::end(visibleNodes));
+
+        culling.frustum = std::move(frustum);
+        culling.nodeTreeVersion = m_nodeTreeVersion;
+        culling.stats = CullingStats{visibleNodes.size(), nodeTree.size() - visibleNodes.size()};
+        culling.allVisible = visibleNodes.size() == nodeTree.size();
+        culling.visibleBrushes.brushes.clear();
+        culling.visibleBrushes.version = m_nextVisibleBrushesVersion++;
+
+        if (!culling.allVisible) {
+            for (auto *node : visibleNodes) {
+                node->accept(kdl::overload([](const Model::WorldNode *) {}, [](const Model::LayerNode *) {}, [](const Model::GroupNode *) {}, [](const Model::EntityNode *) {}, [&](const Model::BrushNode *brush) {
+                    culling.visibleBrushes.brushes.insert(brush);
+                }, [](const Model::PatchNode *) {}));
+            }
+        }
+    }
+
+    m_cullingStats = culling.stats;
+
+    const auto *visibleBrushes = culling.allVisible ? nullptr : &culling.visibleBrushes;
+    m_defaultRenderer->setVisibleBrushes(visibleBrushes);
+    m_selectionRenderer->setVisibleBrushes(visibleBrushes);
+    m_lockedRenderer->setVisibleBrushes(visibleBrushes);
+}
+
+void MapRenderer::invalidateCulling() {
+    ++m_nodeTreeVersion;
+}
+
 class SetupGL : public Renderable {
   private:
     void doRender(RenderContext &) override {
@@ -546,6 +628,7 @@ void MapRenderer::nodesWereAdded(const std::vector<Model::Node *> &nodes) {
     }
     invalidateGroupLinkRenderer();
     invalidateEntityLinkRenderer();
+    invalidateCulling();
 }
 
 void MapRenderer::nodesWereRemoved(const std::vector<Model::Node *> &nodes) {
@@ -556,6 +639,7 @@ void MapRenderer::nodesWereRemoved(const std::vector<Model::Node *> &nodes) {
     }
     invalidateGroupLinkRenderer();
     invalidateEntityLinkRenderer();
+    invalidateCulling();
 }
 
 void MapRenderer::nodesDidChange(const std::vector<Model::Node *> &nodes) {
@@ -567,6 +651,7 @@ void MapRenderer::nodesDidChange(const std::vector<Model::Node *> &nodes) {
     }
     invalidateEntityLinkRenderer();
     invalidateGroupLinkRenderer();
+    invalidateCulling();
 }
 
 void MapRenderer::nodeVisibilityDidChange(const std::vector<Model::Node *> &nodes) {
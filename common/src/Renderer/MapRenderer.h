@@ -18,8 +18,12 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "FloatType.h"
 #include "Macros.h"
 #include "NotifierConnection.h"
+#include "Renderer/BrushRenderer.h"
+
+#include <vm/plane.h>
 
 #include <filesystem>
 #include <memory>
@@ -49,6 +53,8 @@ class Node;
 } // namespace Model
 
 namespace Renderer {
+class Camera;
+
 class EntityDecalRenderer;
 
 class EntityLinkRenderer;
@@ -62,6 +68,16 @@ class RenderBatch;
 class RenderContext;
 
 class MapRenderer {
+  public:
+    /**
+     * Counts the nodes of the world's node tree that passed or failed the view frustum
+     * test of the last rendered frame.
+     */
+    struct CullingStats {
+      size_t drawnNodes = 0;
+      size_t culledNodes = 0;
+    };
+
   private:
     std::weak_ptr<View::MapDocument> m_document;
 
@@ -78,6 +94,23 @@ class MapRenderer {
 
     std::unordered_map<Model::Node *, int> m_trackedNodes;
 
+    struct ViewCulling {
+      std::vector<vm::plane3> frustum;
+      size_t nodeTreeVersion = 0;
+      bool allVisible = false;
+      VisibleBrushes visibleBrushes;
+      CullingStats stats;
+    };
+    /**
+     * The result of the last frustum culling for each view, keyed by the view's camera.
+     * The 2D and 3D views share this renderer, so each of them keeps its own result and
+     * reuses it for as long as its camera and the node tree don't change.
+     */
+    std::unordered_map<const Camera *, ViewCulling> m_viewCulling;
+    size_t m_nodeTreeVersion;
+    size_t m_nextVisibleBrushesVersion;
+    CullingStats m_cullingStats;
+
     NotifierConnection m_notifierConnection;
 
   public:
@@ -106,9 +139,32 @@ class MapRenderer {
   public: // rendering
     void render(RenderContext &renderContext, RenderBatch &renderBatch);
 
+    /**
+     * Returns the culling stats of the view that was rendered last.
+     */
+    const CullingStats &cullingStats() const;
+
+    /**
+     * Discards the culling result of the view with the given camera. Must be called before
+     * the camera is destroyed.
+     */
+    void removeView(const Camera &camera);
+
   private:
     void commitPendingChanges();
 
+    /**
+     * Collects the brushes whose bounds intersect with the view frustum of the given
+     * context's camera and restricts the brush renderers to them. Brushes outside of the
+     * frustum keep their VBO data, but no draw calls are issued for them.
+     *
+     * The brushes are only collected again if the frustum or the node tree changed since
+     * the last time this view was rendered.
+     */
+    void cullNodes(RenderContext &renderContext);
+
+    void invalidateCulling();
+
     void setupGL(RenderBatch &renderBatch);
 
     void renderDefaultOpaque(RenderContext &renderContext, RenderBatch &renderBatch);
@@ -150,6 +150,10 @@ void ObjectRenderer::setShowHiddenObjects(const bool showHiddenObjects) {
     m_brushRenderer.setShowHiddenBrushes(showHiddenObjects);
 }
 
+void ObjectRenderer::setVisibleBrushes(const VisibleBrushes *visibleBrushes) {
+    m_brushRenderer.setVisibleBrushes(visibleBrushes);
+}
+
 void ObjectRenderer::renderOpaque(RenderContext &renderContext, RenderBatch &renderBatch) {
     m_brushRenderer.renderOpaque(renderContext, renderBatch);
     m_patchRenderer.render(renderContext, renderBatch);
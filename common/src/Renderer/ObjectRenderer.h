@@ -119,6 +119,8 @@ class ObjectRenderer {
 
     void setShowHiddenObjects(bool showHiddenObjects);
 
+    void setVisibleBrushes(const VisibleBrushes *visibleBrushes);
+
   public: // rendering
     void renderOpaque(RenderContext &renderContext, RenderBatch &renderBatch);
 
@@ -38,8 +38,6 @@
 #include "Renderer/TexturedIndexArrayRenderer.h"
 #include "Renderer/VertexArray.h"
 
-#include <kdl/vector_utils.h>
-
 #include <vm/forward.h>
 #include <vm/vec.h>
 
@@ -153,10 +151,9 @@ static TexturedIndexArrayRenderer buildMeshRenderer(const std::vector<const Mode
             const auto vertexOffset = vertices.size();
 
             const auto &grid = patchNode->grid();
-            auto gridVertices = kdl::vec_transform(grid.points, [](const auto &p) {
-                return Vertex{vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.texCoords}};
-            });
-            vertices = kdl::vec_concat(std::move(vertices), std::move(gridVertices));
+            for (const auto &p : grid.points) {
+                vertices.emplace_back(vm::vec3f{p.position}, vm::vec3f{p.normal}, vm::vec2f{p.texCoords});
+            }
 
             const auto *texture = patchNode->patch().texture();
 
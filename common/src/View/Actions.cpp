@@ -939,6 +939,14 @@ void ActionManager::createDebugMenu() {
       0,
       [](ActionExecutionContext& context) { context.frame()->debugPrintVertices(); },
       [](ActionExecutionContext& context) { return context.hasDocument(); }));
+    debugMenu.addItem(createMenuAction(
+      std::filesystem::path{"Menu/Debug/Print Undo History Memory Usage"},
+      QObject::tr("Print Undo History Memory Usage to Console"),
+      0,
+      [](ActionExecutionContext& context) {
+        context.frame()->debugPrintCommandHistoryMemoryUsage();
+      },
+      [](ActionExecutionContext& context) { return context.hasDocument(); }));
     debugMenu.addItem(createMenuAction(
       std::filesystem::path{"Menu/Debug/Create Brush..."},
       QObject::tr("Create Brush..."),
@@ -24,6 +24,8 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 #include "IO/FileSystem.h"
 #include "IO/PathInfo.h"
 #include "IO/TraversalMode.h"
+#include "Model/Game.h"
+#include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 
 #include "kdl/memory_utils.h"
@@ -33,10 +35,13 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 #include "kdl/string_compare.h"
 #include "kdl/string_format.h"
 #include "kdl/string_utils.h"
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
 #include <algorithm> // for std::sort
 #include <cassert>
+#include <sstream>
+#include <string>
 
 namespace TrenchBroom::View {
 IO::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename) {
@@ -50,11 +55,16 @@ IO::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename) {
     };
 }
 
-Autosaver::Autosaver(std::weak_ptr<MapDocument> document, const std::chrono::milliseconds saveInterval, const size_t maxBackups)
-    : m_document{std::move(document)}, m_saveInterval{saveInterval}, m_maxBackups{maxBackups}, m_lastSaveTime{Clock::now()}, m_lastModificationCount{kdl::mem_lock(m_document)->modificationCount()} {
+Autosaver::Autosaver(std::weak_ptr<MapDocument> document, const std::chrono::milliseconds saveInterval, const size_t maxBackups, const AutosaveMode mode)
+    : m_document{std::move(document)}, m_saveInterval{saveInterval}, m_maxBackups{maxBackups}, m_lastSaveTime{Clock::now()}, m_lastModificationCount{kdl::mem_lock(m_document)->modificationCount()}, m_mode{mode}, m_pendingModificationCount{m_lastModificationCount} {
 }
 
 void Autosaver::triggerAutosave(Logger &logger) {
+    pollAutosave(logger);
+    if (m_pendingAutosave.valid()) {
+        return;
+    }
+
     if (!kdl::mem_expired(m_document)) {
         auto document = kdl::mem_lock(m_document);
         if (document->modified() && document->modificationCount() != m_lastModificationCount && Clock::now() - m_lastSaveTime >= m_saveInterval && document->persistent()) {
@@ -78,7 +88,7 @@ Result<std::vector<std::filesystem::path>> collectBackups(const IO::FileSystem &
     return fs.find({}, IO::TraversalMode::Flat, makeBackupPathMatcher(mapBasename)).transform([](auto backupPaths) { return kdl::vec_sort(std::move(backupPaths)); });
 }
 
-Result<std::vector<std::filesystem::path>> thinBackups(Logger &logger, IO::WritableDiskFileSystem &fs, const std::vector<std::filesystem::path> &backups, const size_t maxBackups) {
+Result<std::vector<std::filesystem::path>> thinBackups(IO::WritableDiskFileSystem &fs, const std::vector<std::filesystem::path> &backups, const size_t maxBackups, std::vector<std::filesystem::path> &deletedBackups) {
     if (backups.size() < maxBackups) {
         return backups;
     }
@@ -87,7 +97,7 @@ Result<std::vector<std::filesystem::path>> thinBackups(Logger &logger, IO::Writa
     return kdl::fold_results(kdl::vec_transform(toDelete, [&](auto filename) {
         return fs.deleteFile(filename).transform([&](const auto deleted) {
             if (deleted) {
-                logger.debug() << "Deleted autosave backup " << filename;
+                deletedBackups.push_back(filename);
             }
         });
     })).transform([&]() { return kdl::vec_slice_suffix(backups, backups.size() - 1); });
@@ -106,29 +116,100 @@ Result<void> cleanBackups(IO::WritableDiskFileSystem &fs, std::vector<std::files
     }));
 }
 
+/**
+ * Writes the given map file contents to a new backup. This does not access the document,
+ * so it can be called on a worker thread.
+ *
+ * The contents are written to a temporary file before the existing backups are touched.
+ * The temporary file does not match the backup name pattern, so it is ignored if the
+ * application crashes while it is being written.
+ */
+Result<AutosaveBackup> writeBackup(const std::filesystem::path &mapPath, const size_t maxBackups, const std::string &contents) {
+    const auto mapBasename = mapPath.stem();
+    const auto tempName = kdl::path_add_extension(mapBasename, ".tmp");
+
+    return createBackupFileSystem(mapPath).and_then([&](auto fs) {
+        auto deletedBackups = std::vector<std::filesystem::path>{};
+        return fs.createFile(tempName, contents).and_then([&]() {
+            return collectBackups(fs, mapBasename);
+        }).and_then([&](auto backups) {
+            return thinBackups(fs, backups, maxBackups, deletedBackups);
+        }).and_then([&](auto remainingBackups) {
+            return cleanBackups(fs, remainingBackups, mapBasename).and_then([&]() {
+                assert(remainingBackups.size() < maxBackups);
+                const auto backupName = makeBackupName(mapBasename, remainingBackups.size() + 1);
+                return fs.moveFile(tempName, backupName).and_then([&]() { return fs.makeAbsolute(backupName); });
+            });
+        }).transform([&](auto backupPath) {
+            return AutosaveBackup{std::move(backupPath), std::move(deletedBackups)};
+        }).or_else([&](auto e) {
+            fs.deleteFile(tempName).transform([](auto) {}).transform_error([](auto) {
+                // the next autosave overwrites the temporary file
+            });
+            return Result<AutosaveBackup>{std::move(e)};
+        });
+    });
+}
+
 } // namespace
 
+bool Autosaver::autosaveInProgress() const {
+    using namespace std::chrono_literals;
+    return m_pendingAutosave.valid() && m_pendingAutosave.wait_for(0s) != std::future_status::ready;
+}
+
+void Autosaver::finishAutosave(Logger &logger) {
+    if (m_pendingAutosave.valid()) {
+        reportAutosave(logger, m_pendingAutosave.get());
+    }
+}
+
 void Autosaver::autosave(Logger &logger, std::shared_ptr<MapDocument> document) {
     const auto &mapPath = document->path();
     assert(IO::Disk::pathInfo(mapPath) == IO::PathInfo::File);
 
-    const auto mapFilename = mapPath.filename();
-    const auto mapBasename = mapPath.stem();
+    m_pendingModificationCount = document->modificationCount();
+
+    if (m_mode == AutosaveMode::Synchronous) {
+        auto stream = std::ostringstream{};
+        document->game()->writeMapToStream(*document->world(), stream);
+        reportAutosave(logger, writeBackup(mapPath, m_maxBackups, stream.str()));
+        return;
+    }
+
+    // the brush faces and patches are copied here and formatted by the worker while the
+    // document is being edited
+    auto task = std::make_shared<std::packaged_task<Result<AutosaveBackup>()>>([mapPath, maxBackups = m_maxBackups, writeMap = document->game()->deferWriteMapToStream(*document->world())]() {
+        auto stream = std::ostringstream{};
+        writeMap(stream);
+        return writeBackup(mapPath, maxBackups, stream.str());
+    });
+    m_pendingAutosave = task->get_future();
+
+    auto &threadPool = kdl::thread_pool::global();
+    if (threadPool.thread_count() > 0) {
+        threadPool.submit([task = std::move(task)]() { (*task)(); });
+    } else {
+        (*task)();
+    }
+}
+
+void Autosaver::pollAutosave(Logger &logger) {
+    if (m_pendingAutosave.valid() && !autosaveInProgress()) {
+        finishAutosave(logger);
+    }
+}
+
+void Autosaver::reportAutosave(Logger &logger, Result<AutosaveBackup> result) {
+    std::move(result).transform([&](const auto &backup) {
+        for (const auto &deletedBackup : backup.deletedBackups) {
+            logger.debug() << "Deleted autosave backup " << deletedBackup;
+        }
 
-    createBackupFileSystem(mapPath).and_then([&](auto fs) {
-        return collectBackups(fs, mapBasename).and_then([&](auto backups) { return thinBackups(logger, fs, backups, m_maxBackups); }).and_then([&](auto remainingBackups) {
-            return cleanBackups(fs, remainingBackups, mapBasename).and_then([&]() {
-                assert(remainingBackups.size() < m_maxBackups);
-                const auto backupNo = remainingBackups.size() + 1;
-                return fs.makeAbsolute(makeBackupName(mapBasename, backupNo));
-            });
-        });
-    }).transform([&](const auto &backupFilePath) {
         m_lastSaveTime = Clock::now();
-        m_lastModificationCount = document->modificationCount();
-        document->saveDocumentTo(backupFilePath);
+        m_lastModificationCount = m_pendingModificationCount;
 
-        logger.info() << "Created autosave backup at " << backupFilePath;
+        logger.info() << "Created autosave backup at " << backup.path;
     }).transform_error([&](auto e) { logger.error() << "Aborting autosave: " << e.msg; });
 }
 
@@ -18,11 +18,17 @@ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
 
 #pragma once
 
+#include "Error.h"
 #include "IO/PathMatcher.h"
+#include "Result.h"
+
+#include <kdl/result.h>
 
 #include <chrono>
 #include <filesystem>
+#include <future>
 #include <memory>
+#include <vector>
 
 namespace TrenchBroom {
 class Logger;
@@ -35,6 +41,37 @@ class MapDocument;
 
 IO::PathMatcher makeBackupPathMatcher(std::filesystem::path mapBasename);
 
+enum class AutosaveMode {
+    /**
+     * Backups are written on the thread that triggers the autosave.
+     */
+    Synchronous,
+    /**
+     * The document is serialized on the thread that triggers the autosave, except for the
+     * brush faces and patches, which are copied and then formatted and written on a worker
+     * thread.
+     */
+    Asynchronous
+};
+
+/**
+ * A backup that was written by the autosaver, and the old backups that were deleted to
+ * make room for it.
+ */
+struct AutosaveBackup {
+    std::filesystem::path path;
+    std::vector<std::filesystem::path> deletedBackups;
+};
+
+/**
+ * Periodically writes backups of a document to the autosave directory next to the map
+ * file.
+ *
+ * A backup is first written to a temporary file, and it only replaces the oldest backup
+ * once it is complete. Since existing backups are only ever renamed or deleted, a failed
+ * or interrupted autosave never leaves a corrupted backup behind. In asynchronous mode,
+ * no new autosave is started while the previous one is still running.
+ */
 class Autosaver {
   private:
     using Clock = std::chrono::system_clock;
@@ -62,12 +99,42 @@ class Autosaver {
      */
     size_t m_lastModificationCount;
 
+    AutosaveMode m_mode;
+
+    /**
+     * The modification count of the document when the pending autosave was started.
+     */
+    size_t m_pendingModificationCount;
+
+    /**
+     * The autosave that is being written on a worker thread, if any.
+     */
+    std::future<Result<AutosaveBackup>> m_pendingAutosave;
+
   public:
-    explicit Autosaver(std::weak_ptr<MapDocument> document, std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000), size_t maxBackups = 50);
+    explicit Autosaver(std::weak_ptr<MapDocument> document, std::chrono::milliseconds saveInterval = std::chrono::milliseconds(10 * 60 * 1000), size_t maxBackups = 50, AutosaveMode mode = AutosaveMode::Synchronous);
 
+    /**
+     * Reports the result of a finished asynchronous autosave and starts a new autosave if
+     * the document was modified and the save interval has elapsed.
+     */
     void triggerAutosave(Logger &logger);
 
+    /**
+     * Indicates whether an asynchronous autosave is still being written.
+     */
+    bool autosaveInProgress() const;
+
+    /**
+     * Waits until a pending asynchronous autosave is written and reports its result.
+     */
+    void finishAutosave(Logger &logger);
+
   private:
     void autosave(Logger &logger, std::shared_ptr<View::MapDocument> document);
+
+    void pollAutosave(Logger &logger);
+
+    void reportAutosave(Logger &logger, Result<AutosaveBackup> result);
 };
 } // namespace TrenchBroom::View
@@ -32,6 +32,8 @@
 #include <kdl/vector_utils.h>
 
 #include <algorithm>
+#include <cstddef>
+#include <limits>
 
 namespace TrenchBroom {
 namespace View {
@@ -97,6 +99,20 @@ class CommandProcessor::TransactionCommand : public UndoableCommand {
         return std::make_unique<CommandResult>(true);
     }
 
+    size_t doGetMemoryUsage() const override {
+        auto result = sizeof(TransactionCommand) + name().capacity();
+        for (const auto &command : m_commands) {
+            result += command->memoryUsage();
+        }
+        return result;
+    }
+
+    void doCompact(MapDocumentCommandFacade *document) override {
+        for (auto &command : m_commands) {
+            command->compact(document);
+        }
+    }
+
     bool doCollateWith(UndoableCommand &other) override {
         if (auto *transactionCommand = dynamic_cast<TransactionCommand *>(&other)) {
             if (m_commands.empty()) {
@@ -118,8 +134,8 @@ class CommandProcessor::TransactionCommand : public UndoableCommand {
     }
 };
 
-CommandProcessor::CommandProcessor(MapDocumentCommandFacade *document, const std::chrono::milliseconds collationInterval)
-    : m_document{document}, m_collationInterval{collationInterval}, m_lastCommandTimestamp{std::chrono::time_point<std::chrono::system_clock>{}} {
+CommandProcessor::CommandProcessor(MapDocumentCommandFacade *document, const std::chrono::milliseconds collationInterval, const size_t uncompactedCommandCount)
+    : m_document{document}, m_collationInterval{collationInterval}, m_undoMemoryBudget{std::numeric_limits<size_t>::max()}, m_uncompactedCommandCount{uncompactedCommandCount}, m_lastCommandTimestamp{std::chrono::time_point<std::chrono::system_clock>{}} {
 }
 
 CommandProcessor::~CommandProcessor() = default;
@@ -148,6 +164,19 @@ const std::string &CommandProcessor::redoCommandName() const {
     }
 }
 
+void CommandProcessor::setUndoMemoryBudget(const size_t undoMemoryBudget) {
+    m_undoMemoryBudget = undoMemoryBudget;
+    trimUndoStack();
+}
+
+size_t CommandProcessor::undoStackMemoryUsage() const {
+    return m_undoStackMemoryUsage;
+}
+
+size_t CommandProcessor::redoStackMemoryUsage() const {
+    return m_redoStackMemoryUsage;
+}
+
 void CommandProcessor::startTransaction(std::string name, const TransactionScope scope) {
     m_transactionStack.emplace_back(std::move(name), scope);
 }
@@ -180,7 +209,8 @@ std::unique_ptr<CommandResult> CommandProcessor::execute(std::unique_ptr<Command
     auto result = executeCommand(*command);
     if (result->success()) {
         m_undoStack.clear();
-        m_redoStack.clear();
+        m_undoStackMemoryUsage = 0;
+        clearRedoStack();
     }
     return result;
 }
@@ -225,7 +255,8 @@ void CommandProcessor::clear() {
     assert(m_transactionStack.empty());
 
     m_undoStack.clear();
-    m_redoStack.clear();
+    m_undoStackMemoryUsage = 0;
+    clearRedoStack();
     m_lastCommandTimestamp = std::chrono::time_point<std::chrono::system_clock>();
 }
 
@@ -236,7 +267,7 @@ CommandProcessor::SubmitAndStoreResult CommandProcessor::executeAndStoreCommand(
     }
 
     const auto commandStored = storeCommand(std::move(command), collate);
-    m_redoStack.clear();
+    clearRedoStack();
     return SubmitAndStoreResult(std::move(commandResult), commandStored);
 }
 
@@ -318,12 +349,18 @@ bool CommandProcessor::pushToUndoStack(std::unique_ptr<UndoableCommand> command,
 
     if (collatable(collate, timestamp)) {
         auto &lastCommand = m_undoStack.back();
+        const auto lastCommandMemoryUsage = lastCommand->memoryUsage();
         if (lastCommand->collateWith(*command)) {
+            m_undoStackMemoryUsage = m_undoStackMemoryUsage - lastCommandMemoryUsage + lastCommand->memoryUsage();
+            trimUndoStack();
             return false;
         }
     }
 
+    m_undoStackMemoryUsage += command->memoryUsage();
     m_undoStack.push_back(std::move(command));
+    compactUndoStack();
+    trimUndoStack();
     return true;
 }
 
@@ -331,15 +368,35 @@ std::unique_ptr<UndoableCommand> CommandProcessor::popFromUndoStack() {
     assert(m_transactionStack.empty());
     assert(!m_undoStack.empty());
 
+    m_undoStackMemoryUsage -= m_undoStack.back()->memoryUsage();
     return kdl::vec_pop_back(m_undoStack);
 }
 
+void CommandProcessor::trimUndoStack() {
+    auto count = size_t(0);
+    while (m_undoStackMemoryUsage > m_undoMemoryBudget && m_undoStack.size() - count > 1) {
+        m_undoStackMemoryUsage -= m_undoStack[count]->memoryUsage();
+        ++count;
+    }
+    m_undoStack.erase(m_undoStack.begin(), m_undoStack.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+void CommandProcessor::compactUndoStack() {
+    if (m_undoStack.size() > m_uncompactedCommandCount) {
+        auto &command = m_undoStack[m_undoStack.size() - m_uncompactedCommandCount - 1];
+        const auto memoryUsage = command->memoryUsage();
+        command->compact(m_document);
+        m_undoStackMemoryUsage = m_undoStackMemoryUsage - memoryUsage + command->memoryUsage();
+    }
+}
+
 bool CommandProcessor::collatable(const bool collate, const std::chrono::system_clock::time_point timestamp) const {
     return collate && !m_undoStack.empty() && timestamp - m_lastCommandTimestamp <= m_collationInterval;
 }
 
 void CommandProcessor::pushToRedoStack(std::unique_ptr<UndoableCommand> command) {
     assert(m_transactionStack.empty());
+    m_redoStackMemoryUsage += command->memoryUsage();
     m_redoStack.push_back(std::move(command));
 }
 
@@ -347,7 +404,13 @@ std::unique_ptr<UndoableCommand> CommandProcessor::popFromRedoStack() {
     assert(m_transactionStack.empty());
     assert(!m_redoStack.empty());
 
+    m_redoStackMemoryUsage -= m_redoStack.back()->memoryUsage();
     return kdl::vec_pop_back(m_redoStack);
 }
+
+void CommandProcessor::clearRedoStack() {
+    m_redoStack.clear();
+    m_redoStackMemoryUsage = 0;
+}
 } // namespace View
 } // namespace TrenchBroom
@@ -80,6 +80,22 @@ class CommandProcessor {
      */
     std::vector<std::unique_ptr<UndoableCommand>> m_redoStack;
 
+    /**
+     * The maximum estimated memory used by the commands on the undo stack. If the commands
+     * use more memory, the oldest commands are removed from the undo stack.
+     */
+    size_t m_undoMemoryBudget;
+
+    /**
+     * The number of most recent commands on the undo stack that are not compacted. Undoing
+     * and redoing these commands does not need to expand their stored contents again.
+     */
+    size_t m_uncompactedCommandCount;
+    /**
+     * The estimated memory used by the commands on the undo and redo stacks.
+     */
+    size_t m_undoStackMemoryUsage = 0;
+    size_t m_redoStackMemoryUsage = 0;
     /**
      * The time stamp of when the last command was executed.
      */
@@ -102,8 +118,11 @@ class CommandProcessor {
      * they are executed or undone.
      *
      * @param document the document to pass to commands, may be null
+     * @param collationInterval the maximum time between two commands that can be collated
+     * @param uncompactedCommandCount the number of most recent commands on the undo stack
+     * that are not compacted
      */
-    explicit CommandProcessor(MapDocumentCommandFacade *document, std::chrono::milliseconds collationInterval = std::chrono::milliseconds{1000});
+    explicit CommandProcessor(MapDocumentCommandFacade *document, std::chrono::milliseconds collationInterval = std::chrono::milliseconds{1000}, size_t uncompactedCommandCount = 8);
 
     ~CommandProcessor();
 
@@ -168,6 +187,23 @@ class CommandProcessor {
      */
     const std::string &redoCommandName() const;
 
+    /**
+     * Sets the maximum estimated memory used by the commands on the undo stack, in bytes.
+     * If this is exceeded, the oldest commands are removed from the undo stack until the
+     * commands fit into the budget again. The most recent command is never removed.
+     */
+    void setUndoMemoryBudget(size_t undoMemoryBudget);
+
+    /**
+     * Returns the estimated memory used by the commands on the undo stack, in bytes.
+     */
+    size_t undoStackMemoryUsage() const;
+
+    /**
+     * Returns the estimated memory used by the commands on the redo stack, in bytes.
+     */
+    size_t redoStackMemoryUsage() const;
+
     /**
      * Starts a new transaction. If a transaction is currently executing, then the newly
      * started transaction becomes a nested transaction and will be added as a command to
@@ -371,6 +407,18 @@ class CommandProcessor {
      */
     std::unique_ptr<UndoableCommand> popFromUndoStack();
 
+    /**
+     * Removes the oldest commands from the undo stack until the remaining commands fit into
+     * the undo memory budget, but keeps at least the most recent command.
+     */
+    void trimUndoStack();
+
+    /**
+     * Compacts the command that has just dropped out of the most recent commands on the
+     * undo stack.
+     */
+    void compactUndoStack();
+
     bool collatable(bool collate, std::chrono::system_clock::time_point timestamp) const;
 
     /**
@@ -388,6 +436,8 @@ class CommandProcessor {
      * @return the topmost command of the redo stack
      */
     std::unique_ptr<UndoableCommand> popFromRedoStack();
+
+    void clearRedoStack();
 };
 } // namespace View
 } // namespace TrenchBroom
@@ -22,19 +22,37 @@
 #include <QApplication>
 
 #include "Exceptions.h"
+#include "IO/SystemPaths.h"
+#include "IO/TextureCache.h"
 #include "TrenchBroomApp.h"
 #include "View/AboutDialog.h"
 #include "View/MapDocument.h"
 #include "View/MapDocumentCommandFacade.h"
 #include "View/MapFrame.h"
 
+#include "kdl/thread_pool.h"
+
 #include <cassert>
 #include <memory>
 
 namespace TrenchBroom {
 namespace View {
-FrameManager::FrameManager(const bool singleFrame) : QObject(), m_singleFrame(singleFrame) {
+namespace {
+// the texture cache is pruned to this size once per session
+constexpr uint64_t MaxTextureCacheSize = uint64_t(512) * 1024u * 1024u;
+} // namespace
+
+FrameManager::FrameManager(const bool singleFrame)
+    : QObject(), m_singleFrame(singleFrame), m_textureCache(std::make_shared<IO::TextureCache>(IO::SystemPaths::userDataDirectory() / "TextureCache")) {
     connect(qApp, &QApplication::focusChanged, this, &FrameManager::onFocusChange);
+
+    auto prune = [textureCache = m_textureCache]() { textureCache->prune(MaxTextureCacheSize); };
+    auto &threadPool = kdl::thread_pool::global();
+    if (threadPool.thread_count() > 0) {
+        threadPool.submit(std::move(prune));
+    } else {
+        prune();
+    }
 }
 
 FrameManager::~FrameManager() = default;
@@ -94,7 +112,7 @@ void FrameManager::onFocusChange(QWidget * /* old */, QWidget *now) {
 MapFrame *FrameManager::createOrReuseFrame() {
     assert(!m_singleFrame || m_frames.size() <= 1);
     if (!m_singleFrame || m_frames.empty()) {
-        auto document = MapDocumentCommandFacade::newMapDocument();
+        auto document = MapDocumentCommandFacade::newMapDocument(m_textureCache);
         createFrame(document);
     }
     return topFrame();
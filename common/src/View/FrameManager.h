@@ -25,6 +25,10 @@
 #include <vector>
 
 namespace TrenchBroom {
+namespace IO {
+class TextureCache;
+}
+
 namespace View {
 class MapDocument;
 
@@ -34,6 +38,7 @@ class FrameManager : public QObject {
   Q_OBJECT
   private:
     bool m_singleFrame;
+    std::shared_ptr<IO::TextureCache> m_textureCache;
     std::vector<MapFrame *> m_frames;
 
   public:
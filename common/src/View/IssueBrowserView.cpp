@@ -26,22 +26,20 @@
 #include <QTableView>
 
 #include "Ensure.h"
-#include "Model/BrushNode.h"
-#include "Model/EntityNode.h"
-#include "Model/GroupNode.h"
+#include "Logger.h"
 #include "Model/Issue.h"
 #include "Model/IssueQuickFix.h"
-#include "Model/LayerNode.h"
-#include "Model/PatchNode.h"
+#include "Model/Validator.h"
 #include "Model/WorldNode.h"
 #include "View/MapDocument.h"
 #include "View/QtUtils.h"
 
 #include <kdl/memory_utils.h>
-#include <kdl/overload.h>
 #include <kdl/vector_set.h>
 #include <kdl/vector_utils.h>
 
+#include <algorithm>
+#include <chrono>
 #include <vector>
 
 namespace TrenchBroom {
@@ -113,39 +111,11 @@ void IssueBrowserView::updateSelection() {
     document->selectNodes(nodes);
 }
 
-void IssueBrowserView::updateIssues() {
-    auto document = kdl::mem_lock(m_document);
-    if (document->world() != nullptr) {
-        const auto validators = document->world()->registeredValidators();
-
-        auto issues = std::vector<const Model::Issue *>{};
-        const auto collectIssues = [&](auto *node) {
-            for (auto *issue : node->issues(validators)) {
-                if (m_showHiddenIssues || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0)) {
-                    issues.push_back(issue);
-                }
-            }
-        };
-
-        document->world()->accept(kdl::overload([&](auto &&thisLambda, Model::WorldNode *world) {
-            collectIssues(world);
-            world->visitChildren(thisLambda);
-        }, [&](auto &&thisLambda, Model::LayerNode *layer) {
-            collectIssues(layer);
-            layer->visitChildren(thisLambda);
-        }, [&](auto &&thisLambda, Model::GroupNode *group) {
-            collectIssues(group);
-            group->visitChildren(thisLambda);
-        }, [&](auto &&thisLambda, Model::EntityNode *entity) {
-            collectIssues(entity);
-            entity->visitChildren(thisLambda);
-        }, [&](Model::BrushNode *brush) { collectIssues(brush); }, [&](Model::PatchNode *patch) { collectIssues(patch); }));
-
-        issues = kdl::vec_sort(std::move(issues), [](const auto *lhs, const auto *rhs) {
-            return lhs->seqId() > rhs->seqId();
-        });
-        m_tableModel->setIssues(std::move(issues));
-    }
+void IssueBrowserView::updateIssues(std::vector<const Model::Issue *> issues) {
+    issues = kdl::vec_filter(std::move(issues), [&](const auto *issue) {
+        return m_showHiddenIssues || (!issue->hidden() && (issue->type() & m_hiddenIssueTypes) == 0);
+    });
+    m_tableModel->addIssues(std::move(issues));
 }
 
 void IssueBrowserView::applyQuickFix(const Model::IssueQuickFix &quickFix) {
@@ -264,14 +234,57 @@ void IssueBrowserView::hideIssues() {
 
 void IssueBrowserView::invalidate() {
     m_valid = false;
+    m_validationEngine.cancel();
     m_tableModel->setIssues({});
 
     QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
 }
 
+namespace {
+// The number of nodes with invalid issues that are validated before the event loop gets
+// to run again.
+constexpr auto InvalidNodesPerBatch = size_t(2048);
+
+void logStatistics(Logger &logger, const std::vector<Model::ValidatorStatistics> &statistics) {
+    if (statistics.empty() || statistics.front().nodeCount == 0) {
+        return;
+    }
+
+    logger.debug() << "Validated " << statistics.front().nodeCount << " nodes";
+    for (const auto &[validator, nodeCount, duration] : statistics) {
+        logger.debug() << "  " << validator->description() << ": " << std::chrono::duration<double, std::milli>(duration).count() << "ms";
+    }
+}
+} // namespace
+
+/**
+ * Validates the next batch of nodes and adds their issues to the table. Schedules itself
+ * again until all nodes have been validated, so that the application stays responsive and
+ * the issues are shown as they become available. Any change to the document invalidates
+ * this view, which cancels the current run and starts a new one.
+ */
 void IssueBrowserView::validate() {
-    if (!m_valid) {
-        updateIssues();
+    if (m_valid) {
+        return;
+    }
+
+    auto document = kdl::mem_lock(m_document);
+    auto *world = document->world();
+    if (world == nullptr) {
+        m_valid = true;
+        return;
+    }
+
+    if (!m_validationEngine.running()) {
+        m_validationEngine.start(*world);
+    }
+
+    updateIssues(m_validationEngine.validateNext(InvalidNodesPerBatch));
+
+    if (m_validationEngine.running()) {
+        QMetaObject::invokeMethod(this, "validate", Qt::QueuedConnection);
+    } else {
+        logStatistics(*document, m_validationEngine.statistics());
         m_valid = true;
     }
 }
@@ -287,6 +300,28 @@ void IssueBrowserModel::setIssues(std::vector<const Model::Issue *> issues) {
     endResetModel();
 }
 
+void IssueBrowserModel::addIssues(std::vector<const Model::Issue *> issues) {
+    const auto compareIssues = [](const auto *lhs, const auto *rhs) {
+        return lhs->seqId() > rhs->seqId();
+    };
+    issues = kdl::vec_sort(std::move(issues), compareIssues);
+
+    // insert the new issues in runs of consecutive rows
+    auto row = m_issues.begin();
+    auto first = issues.begin();
+    while (first != issues.end()) {
+        row = std::upper_bound(row, m_issues.end(), *first, compareIssues);
+        const auto last = row != m_issues.end() ? std::upper_bound(first, issues.end(), *row, compareIssues) : issues.end();
+
+        const auto firstRow = static_cast<int>(row - m_issues.begin());
+        beginInsertRows(QModelIndex{}, firstRow, firstRow + static_cast<int>(last - first) - 1);
+        row = m_issues.insert(row, first, last) + (last - first);
+        endInsertRows();
+
+        first = last;
+    }
+}
+
 const std::vector<const Model::Issue *> &IssueBrowserModel::issues() {
     return m_issues;
 }
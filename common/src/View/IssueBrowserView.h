@@ -23,6 +23,7 @@
 #include <QWidget>
 
 #include "Model/IssueType.h"
+#include "Model/ValidationEngine.h"
 
 #include <memory>
 #include <vector>
@@ -52,6 +53,7 @@ class IssueBrowserView : public QWidget {
     bool m_showHiddenIssues;
 
     bool m_valid;
+    Model::ValidationEngine m_validationEngine;
 
     QTableView *m_tableView;
     IssueBrowserModel *m_tableModel;
@@ -74,7 +76,7 @@ class IssueBrowserView : public QWidget {
     void deselectAll();
 
   private:
-    void updateIssues();
+    void updateIssues(std::vector<const Model::Issue *> issues);
 
     std::vector<const Model::Issue *> collectIssues(const QList<QModelIndex> &indices) const;
 
@@ -109,8 +111,9 @@ class IssueBrowserView : public QWidget {
 };
 
 /**
- * Trivial QAbstractTableModel subclass, when the issues list changes,
- * it just refreshes the entire list with beginResetModel()/endResetModel().
+ * Trivial QAbstractTableModel subclass. Setting the issues refreshes the entire list with
+ * beginResetModel()/endResetModel(), while adding issues inserts them as new rows so that
+ * the selection is kept while the issues are validated.
  */
 class IssueBrowserModel : public QAbstractTableModel {
   Q_OBJECT
@@ -122,6 +125,11 @@ class IssueBrowserModel : public QAbstractTableModel {
 
     void setIssues(std::vector<const Model::Issue *> issues);
 
+    /**
+     * Inserts the given issues, keeping the issues sorted by descending sequence id.
+     */
+    void addIssues(std::vector<const Model::Issue *> issues);
+
     const std::vector<const Model::Issue *> &issues();
 
   public: // QAbstractTableModel overrides
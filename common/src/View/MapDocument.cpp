@@ -34,6 +34,7 @@
 #include "IO/DiskIO.h"
 #include "IO/ExportOptions.h"
 #include "IO/GameConfigParser.h"
+#include "IO/LoadTextureCollection.h"
 #include "IO/PathInfo.h"
 #include "IO/SimpleParserStatus.h"
 #include "IO/SystemPaths.h"
@@ -311,8 +312,10 @@ template<typename L> bool applyAndSwap(MapDocument &document, const std::string
 const vm::bbox3 MapDocument::DefaultWorldBounds(-32768.0, 32768.0);
 const std::string MapDocument::DefaultDocumentName("unnamed.map");
 
-MapDocument::MapDocument()
+MapDocument::MapDocument(std::shared_ptr<IO::TextureCache> textureCache)
     : m_worldBounds(DefaultWorldBounds), m_world(nullptr), m_entityDefinitionManager(std::make_unique<Assets::EntityDefinitionManager>()), m_entityModelManager(std::make_unique<Assets::EntityModelManager>(pref(Preferences::TextureMagFilter), pref(Preferences::TextureMinFilter), logger())), m_textureManager(std::make_unique<Assets::TextureManager>(pref(Preferences::TextureMagFilter), pref(Preferences::TextureMinFilter), logger())), m_tagManager(std::make_unique<Model::TagManager>()), m_editorContext(std::make_unique<Model::EditorContext>()), m_grid(std::make_unique<Grid>(4)), m_path(DefaultDocumentName), m_lastSaveModificationCount(0), m_modificationCount(0), m_currentLayer(nullptr), m_currentTextureName(Model::BrushFaceAttributes::NoTextureName), m_lastSelectionBounds(0.0, 32.0), m_selectionBoundsValid(true), m_viewEffectsService(nullptr), m_repeatStack(std::make_unique<RepeatStack>()) {
+    m_textureManager->setTextureCache(std::move(textureCache));
+    m_textureManager->setTextureLoadingMode(pref(Preferences::LazyTextureLoading) ? IO::TextureLoadingMode::Lazy : IO::TextureLoadingMode::Eager);
     connectObservers();
 }
 
@@ -982,8 +985,7 @@ void MapDocument::selectSiblings() {
 }
 
 void MapDocument::selectTouching(const bool del) {
-    const auto nodes = kdl::vec_filter(Model::collectTouchingNodes(std::vector<Model::Node *>{
-        m_world.get()}, m_selectedNodes.brushes()), [&](Model::Node *node) { return m_editorContext->selectable(node); });
+    const auto nodes = kdl::vec_filter(Model::collectTouchingNodes(*m_world, m_selectedNodes.brushes()), [&](Model::Node *node) { return m_editorContext->selectable(node); });
 
     auto transaction = Transaction{*this, "Select Touching"};
     if (del) {
@@ -996,8 +998,7 @@ void MapDocument::selectTouching(const bool del) {
 }
 
 void MapDocument::selectInside(const bool del) {
-    const auto nodes = kdl::vec_filter(Model::collectContainedNodes(std::vector<Model::Node *>{
-        m_world.get()}, m_selectedNodes.brushes()), [&](Model::Node *node) { return m_editorContext->selectable(node); });
+    const auto nodes = kdl::vec_filter(Model::collectContainedNodes(*m_world, m_selectedNodes.brushes()), [&](Model::Node *node) { return m_editorContext->selectable(node); });
 
     auto transaction = Transaction{*this, "Select Inside"};
     if (del) {
@@ -1150,7 +1151,7 @@ void MapDocument::selectTall(const vm::axis::type cameraAxis) {
         auto transaction = Transaction{*this, "Select Tall"};
         deleteObjects();
 
-        const auto nodesToSelect = kdl::vec_filter(Model::collectContainedNodes({world()}, kdl::vec_transform(tallBrushes, [](const auto &b) { return b.get(); })), [&](const auto *node) { return editorContext().selectable(node); });
+        const auto nodesToSelect = kdl::vec_filter(Model::collectContainedNodes(*world(), kdl::vec_transform(tallBrushes, [](const auto &b) { return b.get(); })), [&](const auto *node) { return editorContext().selectable(node); });
         selectNodes(nodesToSelect);
 
         transaction.commit();
@@ -3010,6 +3011,13 @@ void MapDocument::printVertices() {
     }
 }
 
+void MapDocument::printCommandHistoryMemoryUsage() {
+    std::stringstream str;
+    str.precision(2);
+    str << std::fixed << "Undo history uses " << double(commandHistoryMemoryUsage()) / (1024.0 * 1024.0) << " MiB";
+    info(str.str());
+}
+
 class ThrowExceptionCommand : public UndoableCommand {
   public:
     using Ptr = std::shared_ptr<ThrowExceptionCommand>;
@@ -3067,6 +3075,10 @@ void MapDocument::redoCommand() {
     m_repeatStack->clear();
 }
 
+size_t MapDocument::commandHistoryMemoryUsage() const {
+    return doGetCommandHistoryMemoryUsage();
+}
+
 bool MapDocument::canRepeatCommands() const {
     return m_repeatStack->size() > 0u;
 }
@@ -3130,6 +3142,12 @@ void MapDocument::pick(const vm::ray3 &pickRay, Model::PickResult &pickResult) c
     }
 }
 
+void MapDocument::pickFirst(const vm::ray3 &pickRay, const Model::HitFilter &filter, Model::PickResult &pickResult) const {
+    if (m_world) {
+        m_world->pickFirst(*m_editorContext, pickRay, filter, pickResult);
+    }
+}
+
 std::vector<Model::Node *> MapDocument::findNodesContaining(const vm::vec3 &point) const {
     auto result = std::vector<Model::Node *>{};
     if (m_world) {
@@ -3334,7 +3352,7 @@ static auto makeSetTexturesVisitor(Assets::TextureManager &manager) {
         const Model::Brush &brush = brushNode->brush();
         for (size_t i = 0u; i < brush.faceCount(); ++i) {
             const Model::BrushFace &face = brush.face(i);
-            Assets::Texture *texture = manager.texture(face.attributes().textureName());
+            Assets::Texture *texture = manager.texture(face.attributes().internedTextureName());
             brushNode->setFaceTexture(i, texture);
         }
     }, [&](Model::PatchNode *patchNode) {
@@ -3356,6 +3374,7 @@ static auto makeUnsetTexturesVisitor() {
 
 void MapDocument::setTextures() {
     m_world->accept(makeSetTexturesVisitor(*m_textureManager));
+    m_textureManager->prefetchUsedTextures();
     textureUsageCountsDidChangeNotifier();
 }
 
@@ -3368,7 +3387,7 @@ void MapDocument::setTextures(const std::vector<Model::BrushFaceHandle> &faceHan
     for (const auto &faceHandle : faceHandles) {
         Model::BrushNode *node = faceHandle.node();
         const Model::BrushFace &face = faceHandle.face();
-        Assets::Texture *texture = m_textureManager->texture(face.attributes().textureName());
+        Assets::Texture *texture = m_textureManager->texture(face.attributes().internedTextureName());
         node->setFaceTexture(faceHandle.faceIndex(), texture);
     }
     textureUsageCountsDidChangeNotifier();
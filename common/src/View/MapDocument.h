@@ -21,6 +21,7 @@
 
 #include "FloatType.h"
 #include "Model/Game.h"
+#include "Model/HitFilter.h"
 #include "Model/MapFacade.h"
 #include "Model/NodeCollection.h"
 #include "Model/NodeContents.h"
@@ -61,6 +62,10 @@ class Texture;
 class TextureManager;
 } // namespace TrenchBroom::Assets
 
+namespace TrenchBroom::IO {
+class TextureCache;
+} // namespace TrenchBroom::IO
+
 namespace TrenchBroom::Model {
 class Brush;
 
@@ -238,7 +243,11 @@ class MapDocument : public Model::MapFacade, public Logger {
     Logger *m_logger = nullptr;
 
   protected:
-    MapDocument();
+    /**
+     * Creates a document that stores decoded textures in the given cache. Pass null to
+     * disable caching.
+     */
+    explicit MapDocument(std::shared_ptr<IO::TextureCache> textureCache);
 
   public:
     ~MapDocument() override;
@@ -718,6 +727,8 @@ class MapDocument : public Model::MapFacade, public Logger {
   public: // debug commands
     void printVertices();
 
+    void printCommandHistoryMemoryUsage();
+
     bool throwExceptionDuringCommand();
 
   public: // command processing
@@ -733,6 +744,11 @@ class MapDocument : public Model::MapFacade, public Logger {
 
     void redoCommand();
 
+    /**
+     * Returns the estimated memory used by the undo and redo history, in bytes.
+     */
+    size_t commandHistoryMemoryUsage() const;
+
     bool canRepeatCommands() const;
 
     void repeatCommands();
@@ -768,6 +784,8 @@ class MapDocument : public Model::MapFacade, public Logger {
 
     virtual void doRedoCommand() = 0;
 
+    virtual size_t doGetCommandHistoryMemoryUsage() const = 0;
+
     virtual void doClearCommandProcessor() = 0;
 
     virtual void doStartTransaction(std::string name, TransactionScope scope) = 0;
@@ -786,6 +804,15 @@ class MapDocument : public Model::MapFacade, public Logger {
   public: // picking
     void pick(const vm::ray3 &pickRay, Model::PickResult &pickResult) const;
 
+    /**
+     * Like pick, but only guarantees that the pick result contains the first hit that
+     * matches the given filter. This is faster if no other hits are needed, e.g. when
+     * computing the paste offset or the spike guides for the selection bounds. The 3D
+     * views also use it for the tool box pick, and defer picking the remaining hits until
+     * a tool needs them, see PickResult::deferHitsAfter.
+     */
+    void pickFirst(const vm::ray3 &pickRay, const Model::HitFilter &filter, Model::PickResult &pickResult) const;
+
     std::vector<Model::Node *> findNodesContaining(const vm::vec3 &point) const;
 
   private: // world management
@@ -56,19 +56,23 @@
 #include "vm/polygon.h"
 #include "vm/segment.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace TrenchBroom {
 namespace View {
-std::shared_ptr<MapDocument> MapDocumentCommandFacade::newMapDocument() {
+std::shared_ptr<MapDocument> MapDocumentCommandFacade::newMapDocument(std::shared_ptr<IO::TextureCache> textureCache) {
     // can't use std::make_shared here because the constructor is private
-    return std::shared_ptr<MapDocument>(new MapDocumentCommandFacade());
+    return std::shared_ptr<MapDocument>(new MapDocumentCommandFacade(std::move(textureCache)));
 }
 
-MapDocumentCommandFacade::MapDocumentCommandFacade() : m_commandProcessor(std::make_unique<CommandProcessor>(this)) {
+MapDocumentCommandFacade::MapDocumentCommandFacade(std::shared_ptr<IO::TextureCache> textureCache) : MapDocument(std::move(textureCache)), m_commandProcessor(std::make_unique<CommandProcessor>(this)) {
+    const auto undoMemoryBudgetMiB = static_cast<size_t>(std::max(pref(Preferences::UndoMemoryBudget), 1));
+    m_commandProcessor->setUndoMemoryBudget(undoMemoryBudgetMiB * 1024u * 1024u);
     connectObservers();
 }
 
@@ -336,6 +340,34 @@ static auto notifySpecialWorldProperties(const Model::Game &game, const std::vec
     return std::tuple{false, false, false};
 }
 
+/**
+ * Computes the grids of the patches which are swapped into patch nodes, unless a node can
+ * keep its current grid. Since tessellating many patches is expensive, this is done in
+ * parallel. The result contains an optional grid for each of the given nodes.
+ */
+static std::vector<std::optional<Model::PatchGrid>> makeSwappedPatchGrids(const std::vector<std::pair<Model::Node *, Model::NodeContents>> &nodesToSwap) {
+    auto indices = std::vector<size_t>{};
+    auto patches = std::vector<const Model::BezierPatch *>{};
+    for (size_t i = 0u; i < nodesToSwap.size(); ++i) {
+        const auto &[node, contents] = nodesToSwap[i];
+        if (const auto *patchNode = dynamic_cast<const Model::PatchNode *>(node)) {
+            const auto &patch = std::get<Model::BezierPatch>(contents.get());
+            if (!patchNode->hasGridOf(patch)) {
+                indices.push_back(i);
+                patches.push_back(&patch);
+            }
+        }
+    }
+
+    auto grids = Model::makePatchGrids(patches);
+
+    auto result = std::vector<std::optional<Model::PatchGrid>>(nodesToSwap.size());
+    for (size_t i = 0u; i < indices.size(); ++i) {
+        result[indices[i]] = std::move(grids[i]);
+    }
+    return result;
+}
+
 void MapDocumentCommandFacade::performSwapNodeContents(std::vector<std::pair<Model::Node *, Model::NodeContents>> &nodesToSwap) {
     const auto nodes = kdl::vec_transform(nodesToSwap, [](const auto &pair) { return pair.first; });
     const auto parents = collectAncestors(nodes);
@@ -350,7 +382,10 @@ void MapDocumentCommandFacade::performSwapNodeContents(std::vector<std::pair<Mod
     NotifyBeforeAndAfter notifyEntityDefinitions(notifyEntityDefinitionsChange, entityDefinitionsWillChangeNotifier, entityDefinitionsDidChangeNotifier);
     NotifyBeforeAndAfter notifyMods(notifyModsChange, modsWillChangeNotifier, modsDidChangeNotifier);
 
-    for (auto &pair : nodesToSwap) {
+    auto patchGrids = makeSwappedPatchGrids(nodesToSwap);
+
+    for (size_t i = 0u; i < nodesToSwap.size(); ++i) {
+        auto &pair = nodesToSwap[i];
         auto *node = pair.first;
         auto &contents = pair.second.get();
 
@@ -365,7 +400,11 @@ void MapDocumentCommandFacade::performSwapNodeContents(std::vector<std::pair<Mod
         }, [&](Model::BrushNode *brushNode) -> Model::NodeContents {
             return Model::NodeContents(brushNode->setBrush(std::get<Model::Brush>(std::move(contents))));
         }, [&](Model::PatchNode *patchNode) -> Model::NodeContents {
-            return Model::NodeContents(patchNode->setPatch(std::get<Model::BezierPatch>(std::move(contents))));
+            auto patch = std::get<Model::BezierPatch>(std::move(contents));
+            if (auto &grid = patchGrids[i]) {
+                return Model::NodeContents(patchNode->setPatch(std::move(patch), std::move(*grid)));
+            }
+            return Model::NodeContents(patchNode->setPatch(std::move(patch)));
         }));
     }
 
@@ -528,6 +567,10 @@ void MapDocumentCommandFacade::doRedoCommand() {
     m_commandProcessor->redo();
 }
 
+size_t MapDocumentCommandFacade::doGetCommandHistoryMemoryUsage() const {
+    return m_commandProcessor->undoStackMemoryUsage() + m_commandProcessor->redoStackMemoryUsage();
+}
+
 void MapDocumentCommandFacade::doClearCommandProcessor() {
     m_commandProcessor->clear();
 }
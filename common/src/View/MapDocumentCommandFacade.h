@@ -54,10 +54,14 @@ class MapDocumentCommandFacade : public MapDocument {
     NotifierConnection m_notifierConnection;
 
   public:
-    static std::shared_ptr<MapDocument> newMapDocument();
+    /**
+     * Creates a new document. Decoded textures are stored in the given cache unless it is
+     * null.
+     */
+    static std::shared_ptr<MapDocument> newMapDocument(std::shared_ptr<IO::TextureCache> textureCache = nullptr);
 
   private:
-    MapDocumentCommandFacade();
+    explicit MapDocumentCommandFacade(std::shared_ptr<IO::TextureCache> textureCache);
 
   public:
     ~MapDocumentCommandFacade() override;
@@ -138,6 +142,8 @@ class MapDocumentCommandFacade : public MapDocument {
 
     void doRedoCommand() override;
 
+    size_t doGetCommandHistoryMemoryUsage() const override;
+
     void doClearCommandProcessor() override;
 
     void doStartTransaction(std::string name, TransactionScope scope) override;
@@ -113,7 +113,7 @@
 namespace TrenchBroom {
 namespace View {
 MapFrame::MapFrame(FrameManager *frameManager, std::shared_ptr<MapDocument> document)
-    : QMainWindow(), m_frameManager(frameManager), m_document(std::move(document)), m_lastInputTime(std::chrono::system_clock::now()), m_autosaver(std::make_unique<Autosaver>(m_document)), m_autosaveTimer(nullptr), m_toolBar(nullptr), m_hSplitter(nullptr), m_vSplitter(nullptr), m_contextManager(std::make_unique<GLContextManager>()), m_mapView(nullptr), m_currentMapView(nullptr), m_infoPanel(nullptr), m_console(nullptr), m_inspector(nullptr), m_gridChoice(nullptr), m_statusBarLabel(nullptr), m_compilationDialog(nullptr), m_recentDocumentsMenu(nullptr), m_undoAction(nullptr), m_redoAction(nullptr), m_updateTitleSignalDelayer{new SignalDelayer{this}}, m_updateActionStateSignalDelayer{new SignalDelayer{this}}, m_updateStatusBarSignalDelayer{new SignalDelayer{this}} {
+    : QMainWindow(), m_frameManager(frameManager), m_document(std::move(document)), m_lastInputTime(std::chrono::system_clock::now()), m_autosaver(std::make_unique<Autosaver>(m_document, std::chrono::milliseconds(10 * 60 * 1000), 50, AutosaveMode::Asynchronous)), m_autosaveTimer(nullptr), m_toolBar(nullptr), m_hSplitter(nullptr), m_vSplitter(nullptr), m_contextManager(std::make_unique<GLContextManager>()), m_mapView(nullptr), m_currentMapView(nullptr), m_infoPanel(nullptr), m_console(nullptr), m_inspector(nullptr), m_gridChoice(nullptr), m_statusBarLabel(nullptr), m_autosaveLabel(nullptr), m_compilationDialog(nullptr), m_recentDocumentsMenu(nullptr), m_undoAction(nullptr), m_redoAction(nullptr), m_updateTitleSignalDelayer{new SignalDelayer{this}}, m_updateActionStateSignalDelayer{new SignalDelayer{this}}, m_updateStatusBarSignalDelayer{new SignalDelayer{this}} {
     ensure(m_frameManager != nullptr, "frameManager is null");
     ensure(m_document != nullptr, "document is null");
 
@@ -168,7 +168,10 @@ MapFrame::~MapFrame() {
     const auto children = this->children();
     qDeleteAll(std::rbegin(children), std::rend(children));
 
+    // wait for a pending autosave so that the final autosave is not skipped
+    m_autosaver->finishAutosave(defaultQtLogger);
     m_autosaver->triggerAutosave(defaultQtLogger);
+    m_autosaver->finishAutosave(defaultQtLogger);
 
     m_document->setViewEffectsService(nullptr);
     m_document.reset();
@@ -441,6 +444,10 @@ void MapFrame::updateToolBarWidgets() {
 void MapFrame::createStatusBar() {
     m_statusBarLabel = new QLabel();
     statusBar()->addWidget(m_statusBarLabel);
+
+    m_autosaveLabel = new QLabel(tr("Autosaving..."));
+    m_autosaveLabel->setVisible(false);
+    statusBar()->addPermanentWidget(m_autosaveLabel);
 }
 
 template<typename T> static Model::EntityNodeBase *commonEntityForNodeList(const std::vector<T *> &list) {
@@ -1751,6 +1758,10 @@ void MapFrame::debugPrintVertices() {
     m_document->printVertices();
 }
 
+void MapFrame::debugPrintCommandHistoryMemoryUsage() {
+    m_document->printCommandHistoryMemoryUsage();
+}
+
 void MapFrame::debugCreateBrush() {
     bool ok = false;
     const QString str = QInputDialog::getText(this, "Create Brush", "Enter a list of at least 4 points (x y z) (x y z) ...", QLineEdit::Normal, "", &ok);
@@ -1962,6 +1973,7 @@ void MapFrame::triggerAutosave() {
     if (QGuiApplication::mouseButtons() == Qt::NoButton && std::chrono::system_clock::now() - m_lastInputTime > 2s) {
         m_autosaver->triggerAutosave(logger());
     }
+    m_autosaveLabel->setVisible(m_autosaver->autosaveInProgress());
 }
 
 // DebugPaletteWindow
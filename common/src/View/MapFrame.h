@@ -127,6 +127,7 @@ class MapFrame : public QMainWindow {
 
     QComboBox *m_gridChoice;
     QLabel *m_statusBarLabel;
+    QLabel *m_autosaveLabel;
 
     QPointer<QDialog> m_compilationDialog;
     QPointer<ObjExportDialog> m_objExportDialog;
@@ -533,6 +534,8 @@ class MapFrame : public QMainWindow {
 
     void debugPrintVertices();
 
+    void debugPrintCommandHistoryMemoryUsage();
+
     void debugCreateBrush();
 
     void debugCreateCube();
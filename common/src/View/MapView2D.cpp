@@ -92,6 +92,10 @@ MapView2D::MapView2D(std::weak_ptr<MapDocument> document, MapViewToolBox &toolBo
     mapViewBaseVirtualInit();
 }
 
+MapView2D::~MapView2D() {
+    mapViewBaseVirtualDestroy();
+}
+
 void MapView2D::initializeCamera(const ViewPlane viewPlane) {
     auto document = kdl::mem_lock(m_document);
     const auto worldBounds = vm::bbox3f(document->worldBounds());
@@ -61,6 +61,8 @@ class MapView2D : public MapViewBase {
   public:
     MapView2D(std::weak_ptr<MapDocument> document, MapViewToolBox &toolBox, Renderer::MapRenderer &renderer, GLContextManager &contextManager, ViewPlane viewPlane, Logger *logger);
 
+    ~MapView2D() override;
+
   private:
     void initializeCamera(ViewPlane viewPlane);
 
@@ -32,6 +32,7 @@
 #include "Model/HitAdapter.h"
 #include "Model/HitFilter.h"
 #include "Model/LayerNode.h"
+#include "Model/ModelUtils.h"
 #include "Model/PatchNode.h"
 #include "Model/PickResult.h"
 #include "Model/PointTrace.h"
@@ -90,7 +91,9 @@ MapView3D::MapView3D(std::weak_ptr<MapDocument> document, MapViewToolBox &toolBo
     mapViewBaseVirtualInit();
 }
 
-MapView3D::~MapView3D() = default;
+MapView3D::~MapView3D() {
+    mapViewBaseVirtualDestroy();
+}
 
 void MapView3D::initializeCamera() {
     m_camera->moveTo(vm::vec3f(-180.0f, -128.0f, 196.0f));
@@ -231,10 +234,22 @@ PickRequest MapView3D::doGetPickRequest(const float x, const float y) const {
 }
 
 Model::PickResult MapView3D::doPick(const vm::ray3 &pickRay) const {
+    using namespace Model::HitFilters;
+
     auto document = kdl::mem_lock(m_document);
     Model::PickResult pickResult = Model::PickResult::byDistance();
 
-    document->pick(pickRay, pickResult);
+    // Most queries of the tools, e.g. when hovering over the map, only need the closest
+    // node hit. The nodes further along the ray are only picked if a query needs them.
+    const auto filter = type(Model::nodeHitType());
+    document->pickFirst(pickRay, filter, pickResult);
+
+    const auto &hit = pickResult.first(filter);
+    if (hit.isMatch()) {
+        pickResult.deferHitsAfter(hit.distance(), [weakDocument = m_document, pickRay](auto &deferredPickResult) {
+            kdl::mem_lock(weakDocument)->pick(pickRay, deferredPickResult);
+        });
+    }
     return pickResult;
 }
 
@@ -253,10 +268,11 @@ vm::vec3 MapView3D::doGetPasteObjectsDelta(const vm::bbox3 &bounds, const vm::bb
         const auto pickRay = vm::ray3(m_camera->pickRay(static_cast<float>(clientCoords.x()), static_cast<float>(clientCoords.y())));
         auto pickResult = Model::PickResult::byDistance();
 
-        document->pick(pickRay, pickResult);
-
         using namespace Model::HitFilters;
-        const auto &hit = pickResult.first(type(Model::BrushNode::BrushHitType));
+        const auto filter = type(Model::BrushNode::BrushHitType);
+        document->pickFirst(pickRay, filter, pickResult);
+
+        const auto &hit = pickResult.first(filter);
         if (const auto faceHandle = Model::hitToFaceHandle(hit)) {
             const auto &face = faceHandle->face();
             return grid.moveDeltaForBounds(face.boundary(), bounds, document->worldBounds(), pickRay);
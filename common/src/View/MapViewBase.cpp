@@ -82,6 +82,7 @@
 #include "vm/util.h"
 
 #include <sstream>
+#include <string>
 #include <vector>
 
 namespace TrenchBroom {
@@ -105,6 +106,10 @@ void MapViewBase::mapViewBaseVirtualInit() {
     createActionsAndUpdatePicking();
 }
 
+void MapViewBase::mapViewBaseVirtualDestroy() {
+    m_renderer.removeView(camera());
+}
+
 MapViewBase::~MapViewBase() {
     // Deleting m_compass will access the VBO so we need to be current
     // see: http://doc.qt.io/qt-5/qopenglwidget.html#resource-initialization-and-cleanup
@@ -931,7 +936,8 @@ void MapViewBase::renderFPS(Renderer::RenderContext &renderContext, Renderer::Re
     if (pref(Preferences::ShowFPS)) {
         auto renderService = Renderer::RenderService{renderContext, renderBatch};
         renderService.setBackgroundColor(Color(0.f, 0.f, 0.f, 0.25f));
-        renderService.renderLeftScreen(m_currentFPS);
+        const auto &cullingStats = m_renderer.cullingStats();
+        renderService.renderLeftScreen(m_currentFPS + "\nnodes: " + std::to_string(cullingStats.drawnNodes) + " drawn, " + std::to_string(cullingStats.culledNodes) + " culled");
     }
 }
 
@@ -145,6 +145,13 @@ class MapViewBase : public RenderView, public MapView, public ToolBoxConnector,
      */
     void mapViewBaseVirtualInit();
 
+    /**
+     * Discards the state that the map renderer keeps for this view.
+     *
+     * This must be called in the destructors of subclasses, while the camera still exists.
+     */
+    void mapViewBaseVirtualDestroy();
+
   public:
     ~MapViewBase() override;
 
@@ -19,6 +19,7 @@
 
 #include "SwapNodeContentsCommand.h"
 
+#include "Error.h"
 #include "Model/Brush.h"
 #include "Model/Entity.h"
 #include "Model/Node.h"
@@ -36,15 +37,32 @@ SwapNodeContentsCommand::SwapNodeContentsCommand(const std::string &name, std::v
 SwapNodeContentsCommand::~SwapNodeContentsCommand() = default;
 
 std::unique_ptr<CommandResult> SwapNodeContentsCommand::doPerformDo(MapDocumentCommandFacade *document) {
-    document->performSwapNodeContents(m_nodes);
-    return std::make_unique<CommandResult>(true);
+    return swapNodeContents(document);
 }
 
 std::unique_ptr<CommandResult> SwapNodeContentsCommand::doPerformUndo(MapDocumentCommandFacade *document) {
+    return swapNodeContents(document);
+}
+
+std::unique_ptr<CommandResult> SwapNodeContentsCommand::swapNodeContents(MapDocumentCommandFacade *document) {
+    for (auto &[node, contents] : m_nodes) {
+        if (!contents.expand(document->worldBounds()).is_success()) {
+            return std::make_unique<CommandResult>(false);
+        }
+    }
+
     document->performSwapNodeContents(m_nodes);
     return std::make_unique<CommandResult>(true);
 }
 
+void SwapNodeContentsCommand::doCompact(MapDocumentCommandFacade *document) {
+    if (document) {
+        for (auto &[node, contents] : m_nodes) {
+            contents.compact(document->worldBounds());
+        }
+    }
+}
+
 bool SwapNodeContentsCommand::doCollateWith(UndoableCommand &command) {
     if (auto *other = dynamic_cast<SwapNodeContentsCommand *>(&command)) {
         auto myNodes = kdl::vec_transform(m_nodes, [](const auto &pair) { return pair.first; });
@@ -58,5 +76,13 @@ bool SwapNodeContentsCommand::doCollateWith(UndoableCommand &command) {
 
     return false;
 }
+
+size_t SwapNodeContentsCommand::doGetMemoryUsage() const {
+    auto result = sizeof(SwapNodeContentsCommand) + name().capacity();
+    for (const auto &[node, contents] : m_nodes) {
+        result += sizeof(Model::Node *) + contents.memoryUsage();
+    }
+    return result;
+}
 } // namespace View
 } // namespace TrenchBroom
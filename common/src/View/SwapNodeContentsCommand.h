@@ -39,6 +39,11 @@ class Node;
 } // namespace Model
 
 namespace View {
+/**
+ * Swaps the contents of the given nodes with the given contents. The contents that are
+ * swapped out are compacted once the command is no longer among the most recent commands
+ * in the undo history, and they are expanded again when the command is undone or redone.
+ */
 class SwapNodeContentsCommand : public UpdateLinkedGroupsCommandBase {
   protected:
     std::vector<std::pair<Model::Node *, Model::NodeContents>> m_nodes;
@@ -54,6 +59,13 @@ class SwapNodeContentsCommand : public UpdateLinkedGroupsCommandBase {
 
     bool doCollateWith(UndoableCommand &command) override;
 
+    size_t doGetMemoryUsage() const override;
+
+    void doCompact(MapDocumentCommandFacade *document) override;
+
+  private:
+    std::unique_ptr<CommandResult> swapNodeContents(MapDocumentCommandFacade *document);
+
   deleteCopyAndMove(SwapNodeContentsCommand);
 };
 } // namespace View
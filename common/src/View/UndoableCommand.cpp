@@ -61,10 +61,25 @@ bool UndoableCommand::collateWith(UndoableCommand &command) {
     return false;
 }
 
+size_t UndoableCommand::memoryUsage() const {
+    return doGetMemoryUsage();
+}
+
+void UndoableCommand::compact(MapDocumentCommandFacade *document) {
+    doCompact(document);
+}
+
 bool UndoableCommand::doCollateWith(UndoableCommand &) {
     return false;
 }
 
+size_t UndoableCommand::doGetMemoryUsage() const {
+    return sizeof(UndoableCommand) + name().capacity();
+}
+
+void UndoableCommand::doCompact(MapDocumentCommandFacade *) {
+}
+
 void UndoableCommand::setModificationCount(MapDocumentCommandFacade *document) {
     if (document && m_modificationCount) {
         document->incModificationCount(m_modificationCount);
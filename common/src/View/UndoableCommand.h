@@ -45,11 +45,34 @@ class UndoableCommand : public Command {
 
     virtual bool collateWith(UndoableCommand &command);
 
+    /**
+     * Returns an estimate of the memory used by this command while it is stored in the
+     * undo or redo history, in bytes.
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * Reduces the memory used by this command once it is no longer among the most recently
+     * executed commands. A compacted command can still be undone and redone, but doing so
+     * may take longer.
+     */
+    void compact(MapDocumentCommandFacade *document);
+
   protected:
     virtual std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade *document) = 0;
 
     virtual bool doCollateWith(UndoableCommand &command);
 
+    /**
+     * The default implementation only accounts for the command object itself.
+     */
+    virtual size_t doGetMemoryUsage() const;
+
+    /**
+     * The default implementation does nothing.
+     */
+    virtual void doCompact(MapDocumentCommandFacade *document);
+
     void setModificationCount(MapDocumentCommandFacade *document);
 
     void resetModificationCount(MapDocumentCommandFacade *document);
@@ -0,0 +1,609 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "Exceptions.h"
+#include "octree.h"
+
+#include "vm/bbox.h"
+#include "vm/intersection.h"
+#include "vm/plane.h"
+#include "vm/ray.h"
+#include "vm/scalar.h"
+#include "vm/vec.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace TrenchBroom {
+
+/**
+ * An octree with the same interface and node addressing scheme as octree, but with a flat
+ * memory layout.
+ *
+ * The nodes are stored in contiguous arrays and refer to each other by index. The eight
+ * children of an inner node are allocated as one consecutive block, and freed blocks are
+ * reused. The bounds of the nodes are computed once and stored in arrays of their own so
+ * that the queries only touch the memory that they need. Every node stores up to N data
+ * items inline; further items are kept in an overflow list.
+ *
+ * Unlike octree, this tree is not path compressed. A data item is always stored in the
+ * node whose address is the container address of the item's bounds, and all nodes on the
+ * path from the root to that node exist. This makes the tree deeper, but an update that
+ * does not change the container address of an item does not touch the tree at all.
+ *
+ * In addition to the queries of octree, this tree offers batched queries that process
+ * many rays or boxes in a single traversal.
+ *
+ * @tparam T the floating point type
+ * @tparam U the node data to store in the nodes, must be default constructible
+ * @tparam N the number of data items stored inline in every node
+ */
+template<typename T, typename U, size_t N = 2> class flat_octree {
+  private:
+    using index_type = uint32_t;
+    static constexpr auto no_index = std::numeric_limits<index_type>::max();
+
+    struct bucket {
+      std::array<U, N> items{};
+      index_type size = 0;
+      index_type overflow = no_index;
+    };
+
+    struct location {
+      detail::node_address address;
+      index_type node;
+    };
+
+    T m_min_size;
+
+    // the node arrays, the root is always at index 0
+    std::vector<detail::node_address> m_addresses;
+    std::vector<vm::vec<T, 3>> m_mins;
+    std::vector<vm::vec<T, 3>> m_maxs;
+    std::vector<index_type> m_parents;
+    std::vector<index_type> m_first_children;
+    std::vector<bucket> m_buckets;
+
+    std::vector<std::vector<U>> m_overflow;
+    std::vector<index_type> m_free_overflow;
+    std::vector<index_type> m_free_blocks;
+
+    std::unordered_map<U, location> m_location_for_data;
+
+  public:
+    explicit flat_octree(const T min_size) : m_min_size{min_size} {
+    }
+
+    /**
+     * Indicates whether a node with the given data exists in this tree.
+     *
+     * @param data the data to find
+     * @return true if a node with the given data exists and false otherwise
+     */
+    bool contains(const U &data) const { return m_location_for_data.count(data) > 0; }
+
+    /**
+     * Inserts the given data with the given bounds.
+     *
+     * @throws NodeTreeException if the bounds are invalid or the data is already in this
+     * tree
+     */
+    void insert(const vm::bbox<T, 3> &bounds, U data) {
+        check(bounds);
+
+        if (contains(data)) {
+            throw NodeTreeException("Data already in tree");
+        }
+
+        insert_at(detail::get_container(bounds, m_min_size), std::move(data));
+    }
+
+    /**
+     * Removes the node with the given data from this tree.
+     *
+     * @param data the data to remove
+     * @return true if a node with the given data was removed, and false otherwise
+     */
+    bool remove(const U &data) {
+        const auto i_location = m_location_for_data.find(data);
+        if (i_location == m_location_for_data.end()) {
+            return false;
+        }
+
+        const auto node = i_location->second.node;
+        m_location_for_data.erase(i_location);
+
+        if (m_location_for_data.empty()) {
+            clear();
+        } else {
+            remove_from_bucket(node, data);
+            prune(node);
+        }
+
+        return true;
+    }
+
+    /**
+     * Updates the node with the given data with the given new bounds.
+     *
+     * @param newBounds the new bounds of the node
+     * @param data the node data of the node to update
+     *
+     * @throws NodeTreeException if no node with the given data can be found in this tree
+     */
+    void update(const vm::bbox<T, 3> &newBounds, const U &data) {
+        check(newBounds);
+
+        const auto i_location = m_location_for_data.find(data);
+        if (i_location == m_location_for_data.end()) {
+            throw NodeTreeException("node not found");
+        }
+
+        const auto address = detail::get_container(newBounds, m_min_size);
+        if (address == i_location->second.address) {
+            return;
+        }
+
+        remove(data);
+        insert_at(address, data);
+    }
+
+    /**
+     * Clears this node tree.
+     */
+    void clear() {
+        m_addresses.clear();
+        m_mins.clear();
+        m_maxs.clear();
+        m_parents.clear();
+        m_first_children.clear();
+        m_buckets.clear();
+        m_overflow.clear();
+        m_free_overflow.clear();
+        m_free_blocks.clear();
+        m_location_for_data.clear();
+    }
+
+    /**
+     * Indicates whether this tree is empty.
+     *
+     * @return true if this tree is empty and false otherwise
+     */
+    bool empty() const { return m_location_for_data.empty(); }
+
+    /**
+     * Returns the number of data items in this tree.
+     */
+    size_t size() const { return m_location_for_data.size(); }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the given ray
+     * and returns a list of those items.
+     */
+    std::vector<U> find_intersectors(const vm::ray<T, 3> &ray) const {
+        auto result = std::vector<U>{};
+        find_intersectors(ray, std::back_inserter(result));
+        return result;
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the given ray
+     * and appends it to the given output iterator.
+     */
+    template<typename O> void find_intersectors(const vm::ray<T, 3> &ray, O out) const {
+        find_if([&](const auto &min, const auto &max) { return intersects(ray, min, max); }, out);
+    }
+
+    /**
+     * Visits the data items whose tree nodes intersect with the given ray in the order in
+     * which the ray enters the tree nodes, and stops once the ray enters a tree node
+     * beyond the distance returned by the given function. See
+     * octree::visit_intersectors_front_to_back.
+     */
+    template<typename V, typename D> void visit_intersectors_front_to_back(const vm::ray<T, 3> &ray, const V &visitor, const D &get_max_distance) const {
+        if (empty()) {
+            return;
+        }
+
+        using entry = std::pair<T, index_type>;
+        const auto compare = [](const entry &lhs, const entry &rhs) { return lhs.first > rhs.first; };
+        auto queue = std::priority_queue<entry, std::vector<entry>, decltype(compare)>{compare};
+
+        const auto enqueue = [&](const index_type node) {
+            if (m_buckets[node].size == 0 && m_first_children[node] == no_index) {
+                return;
+            }
+
+            const auto bounds = vm::bbox<T, 3>{m_mins[node], m_maxs[node]};
+            const auto distance = bounds.contains(ray.origin) ? T(0) : vm::intersect_ray_bbox(ray, bounds);
+            if (!vm::is_nan(distance)) {
+                queue.emplace(distance, node);
+            }
+        };
+
+        enqueue(0);
+        while (!queue.empty()) {
+            const auto [distance, node] = queue.top();
+            queue.pop();
+
+            if (distance > get_max_distance()) {
+                return;
+            }
+
+            visit_bucket(node, visitor);
+
+            if (const auto first_child = m_first_children[node]; first_child != no_index) {
+                for (index_type i = 0; i < 8; ++i) {
+                    enqueue(first_child + i);
+                }
+            }
+        }
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the given bbox
+     * and returns a list of those items.
+     */
+    std::vector<U> find_intersectors(const vm::bbox<T, 3> &bbox) const {
+        auto result = std::vector<U>{};
+        find_intersectors(bbox, std::back_inserter(result));
+        return result;
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the given bbox
+     * and appends it to the given output iterator.
+     */
+    template<typename O> void find_intersectors(const vm::bbox<T, 3> &bbox, O out) const {
+        find_if([&](const auto &min, const auto &max) { return intersects(bbox, min, max); }, out);
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the convex
+     * volume bounded by the given planes and returns a list of those items. The plane
+     * normals must point out of the volume.
+     */
+    std::vector<U> find_volume_intersectors(const std::vector<vm::plane<T, 3>> &planes) const {
+        auto result = std::vector<U>{};
+        find_volume_intersectors(planes, std::back_inserter(result));
+        return result;
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the convex
+     * volume bounded by the given planes and appends it to the given output iterator.
+     */
+    template<typename O> void find_volume_intersectors(const std::vector<vm::plane<T, 3>> &planes, O out) const {
+        find_if([&](const auto &min, const auto &max) {
+            return std::none_of(planes.begin(), planes.end(), [&](const auto &plane) {
+                return is_above(min, max, plane);
+            });
+        }, out);
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box contains the given point and
+     * returns a list of those items.
+     */
+    std::vector<U> find_containers(const vm::vec<T, 3> &point) const {
+        auto result = std::vector<U>{};
+        find_containers(point, std::back_inserter(result));
+        return result;
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box contains the given point and
+     * appends it to the given output iterator.
+     */
+    template<typename O> void find_containers(const vm::vec<T, 3> &point, O out) const {
+        find_if([&](const auto &min, const auto &max) { return vm::bbox<T, 3>{min, max}.contains(point); }, out);
+    }
+
+    /**
+     * Performs find_intersectors for each of the given rays in a single traversal of this
+     * tree. Every node is visited at most once, and only the rays that hit the node are
+     * tested against its children.
+     *
+     * @return a list containing the found items for each ray, in the order of the rays
+     */
+    std::vector<std::vector<U>> batch_find_intersectors(const std::vector<vm::ray<T, 3>> &rays) const {
+        return batch_find_if(rays, [](const auto &ray, const auto &min, const auto &max) { return intersects(ray, min, max); });
+    }
+
+    /**
+     * Performs find_intersectors for each of the given boxes in a single traversal of this
+     * tree.
+     *
+     * @return a list containing the found items for each box, in the order of the boxes
+     */
+    std::vector<std::vector<U>> batch_find_intersectors(const std::vector<vm::bbox<T, 3>> &bboxes) const {
+        return batch_find_if(bboxes, [](const auto &bbox, const auto &min, const auto &max) { return intersects(bbox, min, max); });
+    }
+
+  private:
+    static bool intersects(const vm::ray<T, 3> &ray, const vm::vec<T, 3> &min, const vm::vec<T, 3> &max) {
+        const auto bounds = vm::bbox<T, 3>{min, max};
+        return bounds.contains(ray.origin) || !vm::is_nan(vm::intersect_ray_bbox(ray, bounds));
+    }
+
+    static bool intersects(const vm::bbox<T, 3> &bbox, const vm::vec<T, 3> &min, const vm::vec<T, 3> &max) {
+        return bbox.intersects(vm::bbox<T, 3>{min, max});
+    }
+
+    static bool is_above(const vm::vec<T, 3> &min, const vm::vec<T, 3> &max, const vm::plane<T, 3> &plane) {
+        auto corner = vm::vec<T, 3>{};
+        for (size_t i = 0; i < 3; ++i) {
+            corner[i] = plane.normal[i] >= T(0) ? min[i] : max[i];
+        }
+        return plane.point_distance(corner) > T(0);
+    }
+
+    template<typename F> void visit_bucket(const index_type node, const F &f) const {
+        const auto &b = m_buckets[node];
+        const auto inline_count = std::min(size_t(b.size), N);
+        for (size_t i = 0; i < inline_count; ++i) {
+            f(b.items[i]);
+        }
+        if (b.overflow != no_index) {
+            for (const auto &d : m_overflow[b.overflow]) {
+                f(d);
+            }
+        }
+    }
+
+    template<typename P, typename O> void find_if(const P &predicate, O out) const {
+        if (empty()) {
+            return;
+        }
+
+        auto stack = std::vector<index_type>{0};
+        while (!stack.empty()) {
+            const auto node = stack.back();
+            stack.pop_back();
+
+            if (predicate(m_mins[node], m_maxs[node])) {
+                visit_bucket(node, [&](const auto &d) { *out++ = d; });
+
+                if (const auto first_child = m_first_children[node]; first_child != no_index) {
+                    for (index_type i = 0; i < 8; ++i) {
+                        stack.push_back(first_child + i);
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename Q, typename P> std::vector<std::vector<U>> batch_find_if(const std::vector<Q> &queries, const P &predicate) const {
+        auto result = std::vector<std::vector<U>>(queries.size());
+        if (empty() || queries.empty()) {
+            return result;
+        }
+
+        // the active queries of every node on the current path, stored one after another
+        auto active = std::vector<index_type>{};
+        active.reserve(queries.size() * 4);
+        for (size_t i = 0; i < queries.size(); ++i) {
+            active.push_back(index_type(i));
+        }
+
+        batch_visit(0, 0, queries.size(), active, queries, predicate, result);
+        return result;
+    }
+
+    template<typename Q, typename P> void batch_visit(const index_type node, const size_t begin, const size_t end, std::vector<index_type> &active, const std::vector<Q> &queries, const P &predicate, std::vector<std::vector<U>> &result) const {
+        const auto node_begin = active.size();
+        for (size_t i = begin; i < end; ++i) {
+            const auto query = active[i];
+            if (predicate(queries[query], m_mins[node], m_maxs[node])) {
+                active.push_back(query);
+            }
+        }
+        const auto node_end = active.size();
+
+        if (node_begin < node_end) {
+            if (m_buckets[node].size > 0) {
+                for (size_t i = node_begin; i < node_end; ++i) {
+                    auto &query_result = result[active[i]];
+                    visit_bucket(node, [&](const auto &d) { query_result.push_back(d); });
+                }
+            }
+
+            if (const auto first_child = m_first_children[node]; first_child != no_index) {
+                for (index_type i = 0; i < 8; ++i) {
+                    batch_visit(first_child + i, node_begin, node_end, active, queries, predicate, result);
+                }
+            }
+        }
+
+        active.resize(node_begin);
+    }
+
+    index_type create_node(const detail::node_address &address, const index_type parent) {
+        const auto bounds = address.to_bounds(m_min_size);
+        m_addresses.push_back(address);
+        m_mins.push_back(bounds.min);
+        m_maxs.push_back(bounds.max);
+        m_parents.push_back(parent);
+        m_first_children.push_back(no_index);
+        m_buckets.emplace_back();
+        return index_type(m_addresses.size() - 1);
+    }
+
+    void split(const index_type node) {
+        assert(m_first_children[node] == no_index);
+
+        const auto &address = m_addresses[node];
+        if (!m_free_blocks.empty()) {
+            const auto first_child = m_free_blocks.back();
+            m_free_blocks.pop_back();
+
+            for (index_type i = 0; i < 8; ++i) {
+                const auto child = first_child + i;
+                const auto child_address = detail::get_child(address, i);
+                const auto bounds = child_address.to_bounds(m_min_size);
+                m_addresses[child] = child_address;
+                m_mins[child] = bounds.min;
+                m_maxs[child] = bounds.max;
+                m_parents[child] = node;
+                assert(m_first_children[child] == no_index);
+                assert(m_buckets[child].size == 0);
+            }
+            m_first_children[node] = first_child;
+        } else {
+            const auto first_child = index_type(m_addresses.size());
+            for (index_type i = 0; i < 8; ++i) {
+                // the address must be copied because create_node may reallocate m_addresses
+                create_node(detail::get_child(m_addresses[node], i), node);
+            }
+            m_first_children[node] = first_child;
+        }
+    }
+
+    void insert_at(const detail::node_address &address, U data) {
+        const auto root_address = detail::is_root(address) ? address : detail::get_root(address);
+        if (m_addresses.empty()) {
+            create_node(root_address, no_index);
+        } else if (!m_addresses[0].contains(address)) {
+            grow(root_address.size > m_addresses[0].size ? root_address : m_addresses[0]);
+        }
+
+        assert(m_addresses[0].contains(address));
+
+        auto node = index_type(0);
+        while (const auto quadrant = detail::get_quadrant(m_addresses[node], address)) {
+            if (m_first_children[node] == no_index) {
+                split(node);
+            }
+            node = m_first_children[node] + index_type(*quadrant);
+        }
+
+        push_to_bucket(node, data);
+        m_location_for_data.emplace(std::move(data), location{address, node});
+    }
+
+    /**
+     * Replaces the root with one that has the given address and reinserts all data items.
+     */
+    void grow(const detail::node_address &root_address) {
+        auto items = std::vector<std::pair<detail::node_address, U>>{};
+        items.reserve(m_location_for_data.size());
+        for (const auto &[data, loc] : m_location_for_data) {
+            items.emplace_back(loc.address, data);
+        }
+
+        clear();
+        create_node(root_address, no_index);
+
+        for (auto &[address, data] : items) {
+            insert_at(address, std::move(data));
+        }
+    }
+
+    void push_to_bucket(const index_type node, const U &data) {
+        auto &b = m_buckets[node];
+        if (b.size < N) {
+            b.items[b.size] = data;
+        } else {
+            if (b.overflow == no_index) {
+                if (!m_free_overflow.empty()) {
+                    b.overflow = m_free_overflow.back();
+                    m_free_overflow.pop_back();
+                } else {
+                    b.overflow = index_type(m_overflow.size());
+                    m_overflow.emplace_back();
+                }
+            }
+            m_overflow[b.overflow].push_back(data);
+        }
+        ++b.size;
+    }
+
+    U &bucket_item(bucket &b, const size_t i) {
+        return i < N ? b.items[i] : m_overflow[b.overflow][i - N];
+    }
+
+    void remove_from_bucket(const index_type node, const U &data) {
+        auto &b = m_buckets[node];
+
+        auto i = size_t(0);
+        while (i < b.size && bucket_item(b, i) != data) {
+            ++i;
+        }
+        assert(i < b.size);
+
+        const auto last = size_t(b.size - 1);
+        if (i != last) {
+            bucket_item(b, i) = std::move(bucket_item(b, last));
+        }
+
+        if (last >= N) {
+            auto &overflow = m_overflow[b.overflow];
+            overflow.pop_back();
+            if (overflow.empty()) {
+                m_free_overflow.push_back(b.overflow);
+                b.overflow = no_index;
+            }
+        } else {
+            b.items[last] = U{};
+        }
+        --b.size;
+    }
+
+    bool is_empty_leaf(const index_type node) const {
+        return m_first_children[node] == no_index && m_buckets[node].size == 0;
+    }
+
+    /**
+     * Frees the children of the ancestors of the given node as long as all of the children
+     * are empty leafs.
+     */
+    void prune(index_type node) {
+        while (node != 0) {
+            const auto parent = m_parents[node];
+            const auto first_child = m_first_children[parent];
+            for (index_type i = 0; i < 8; ++i) {
+                if (!is_empty_leaf(first_child + i)) {
+                    return;
+                }
+            }
+
+            m_free_blocks.push_back(first_child);
+            m_first_children[parent] = no_index;
+            node = parent;
+        }
+    }
+
+    void check(const vm::bbox<T, 3> &bounds) const {
+        if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max)) {
+            throw NodeTreeException("Cannot add node to octree with invalid bounds");
+        }
+    }
+};
+
+} // namespace TrenchBroom
@@ -30,6 +30,7 @@
 #include "vm/bbox.h"
 #include "vm/bbox_io.h"
 #include "vm/intersection.h"
+#include "vm/plane.h"
 #include "vm/ray.h"
 #include "vm/scalar.h"
 
@@ -38,6 +39,7 @@
 #include <cmath>
 #include <optional>
 #include <ostream>
+#include <queue>
 #include <unordered_map>
 #include <variant>
 #include <vector>
@@ -395,6 +397,11 @@ template<typename T, typename U> class octree {
      */
     bool empty() const { return m_root == std::nullopt; }
 
+    /**
+     * Returns the number of data items in this tree.
+     */
+    size_t size() const { return m_node_address_for_data.size(); }
+
     /**
      * Finds every data item in this tree whose bounding box intersects with the given ray
      * and returns a list of those items.
@@ -428,6 +435,65 @@ template<typename T, typename U> class octree {
         }
     }
 
+    /**
+     * Visits the data items whose tree nodes intersect with the given ray in the order in
+     * which the ray enters the tree nodes. Before a tree node is entered, the given
+     * function is called to determine the maximum distance of interest, and the traversal
+     * stops if the ray enters the tree node beyond that distance.
+     *
+     * Since the bounding box of every data item is contained in the bounds of its tree
+     * node, every data item whose bounding box the ray enters within the maximum distance
+     * is visited. This allows callers that are only interested in the nearest hit to stop
+     * once no remaining data item can be hit before it.
+     *
+     * @tparam V the type of the visitor
+     * @tparam D the type of the function that returns the maximum distance
+     * @param ray the ray to test
+     * @param visitor the visitor to call for each data item
+     * @param get_max_distance returns the maximum distance of interest
+     */
+    template<typename V, typename D> void visit_intersectors_front_to_back(const vm::ray<T, 3> &ray, const V &visitor, const D &get_max_distance) const {
+        if (!m_root) {
+            return;
+        }
+
+        using entry = std::pair<T, const node *>;
+        const auto compare = [](const entry &lhs, const entry &rhs) { return lhs.first > rhs.first; };
+        auto queue = std::priority_queue<entry, std::vector<entry>, decltype(compare)>{compare};
+
+        const auto enqueue = [&](const node &node_) {
+            if (is_leaf_node(node_) && get_data(node_).empty()) {
+                return;
+            }
+
+            const auto bounds = get_address(node_).to_bounds(m_min_size);
+            const auto distance = bounds.contains(ray.origin) ? T(0) : vm::intersect_ray_bbox(ray, bounds);
+            if (!vm::is_nan(distance)) {
+                queue.emplace(distance, &node_);
+            }
+        };
+
+        enqueue(*m_root);
+        while (!queue.empty()) {
+            const auto [distance, node_] = queue.top();
+            queue.pop();
+
+            if (distance > get_max_distance()) {
+                return;
+            }
+
+            for (const auto &data : get_data(*node_)) {
+                visitor(data);
+            }
+
+            if (const auto *inner = std::get_if<inner_node>(node_)) {
+                for (const auto &child : inner->children) {
+                    enqueue(child);
+                }
+            }
+        }
+    }
+
     /**
      * Finds every data item in this tree whose bounding box intersects with the given bbox
      * and returns a list of those items.
@@ -461,6 +527,45 @@ template<typename T, typename U> class octree {
         }
     }
 
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the convex
+     * volume bounded by the given planes and returns a list of those items. The plane
+     * normals must point out of the volume, e.g. the frustum planes of a camera.
+     *
+     * The test is conservative: an item is found if the bounds of the tree node that
+     * stores it intersect with the volume.
+     *
+     * @param planes the planes bounding the volume to test
+     * @return a list containing all found data items
+     */
+    std::vector<U> find_volume_intersectors(const std::vector<vm::plane<T, 3>> &planes) const {
+        auto result = std::vector<U>{};
+        find_volume_intersectors(planes, std::back_inserter(result));
+        return result;
+    }
+
+    /**
+     * Finds every data item in this tree whose bounding box intersects with the convex
+     * volume bounded by the given planes and appends it to the given output iterator.
+     *
+     * @tparam O the output iterator type
+     * @param planes the planes bounding the volume to test
+     * @param out the output iterator to append to
+     */
+    template<typename O> void find_volume_intersectors(const std::vector<vm::plane<T, 3>> &planes, O out) const {
+        if (m_root) {
+            visit_node_if(*m_root, [&](const auto &node) {
+                const auto &data = get_data(node);
+                std::copy(data.begin(), data.end(), out);
+            }, [&](const auto &node) {
+                const auto bounds = get_address(node).to_bounds(m_min_size);
+                return std::none_of(planes.begin(), planes.end(), [&](const auto &plane) {
+                    return is_above(bounds, plane);
+                });
+            });
+        }
+    }
+
     /**
      * Finds every data item in this tree whose bounding box contains the given point and
      * returns a list of those items.
@@ -496,6 +601,18 @@ template<typename T, typename U> class octree {
     kdl_reflect_inline(octree, m_root, m_min_size, m_node_address_for_data);
 
   private:
+    /**
+     * Indicates whether the given bounds are entirely above the given plane, that is,
+     * whether the corner of the bounds that is furthest below the plane is above it.
+     */
+    static bool is_above(const vm::bbox<T, 3> &bounds, const vm::plane<T, 3> &plane) {
+        auto corner = vm::vec<T, 3>{};
+        for (size_t i = 0; i < 3; ++i) {
+            corner[i] = plane.normal[i] >= T(0) ? bounds.min[i] : bounds.max[i];
+        }
+        return plane.point_distance(corner) > T(0);
+    }
+
     void check(const vm::bbox<T, 3> &bounds) const {
         if (vm::is_nan(bounds.min) || vm::is_nan(bounds.max)) {
             throw NodeTreeException("Cannot add node to octree with invalid bounds");
@@ -18,13 +18,21 @@
  */
 
 #include "Assets/Palette.h"
+#include "Assets/PaletteKernels.h"
+#include "Assets/TextureBuffer.h"
 #include "Error.h"
 #include "IO/DiskIO.h"
 #include "IO/File.h"
+#include "IO/Reader.h"
+#include "IO/ReaderException.h"
 #include "Result.h"
 
 #include "kdl/result.h"
 
+#include <cstring>
+#include <random>
+#include <vector>
+
 #include "Catch2.h"
 
 namespace TrenchBroom::Assets {
@@ -77,4 +85,126 @@ const auto expectedPalette = makePalette(expectedPaletteData, PaletteColorFormat
 
 CHECK(loadPalette(*file, filePath)
 == expectedPalette);
-}} // namespace TrenchBroom::Assets
+}
+
+TEST_CASE("Palette.indexedToRgba") {
+    auto paletteData = std::vector<unsigned char>(768);
+    for (size_t i = 0; i < paletteData.size(); ++i) {
+        paletteData[i] = static_cast<unsigned char>(i * 7 + 3);
+    }
+    const auto palette = makePalette(paletteData, PaletteColorFormat::Rgb).value();
+
+    // cover the remainders of all kernels
+    const auto pixelCount = GENERATE(size_t(1), size_t(7), size_t(8), size_t(13), size_t(64), size_t(67));
+    const auto transparency = GENERATE(PaletteTransparency::Opaque, PaletteTransparency::Index255Transparent);
+    const auto containsIndex255 = GENERATE(false, true);
+
+    CAPTURE(pixelCount, containsIndex255);
+
+    auto indices = std::vector<char>(pixelCount);
+    for (size_t i = 0; i < pixelCount; ++i) {
+        indices[i] = static_cast<char>((i * 31) % 255);
+    }
+    if (containsIndex255) {
+        indices[pixelCount / 2] = static_cast<char>(255);
+    }
+
+    const auto &expectedColors = transparency == PaletteTransparency::Opaque ? palette.data().opaqueData : palette.data().index255TransparentData;
+
+    auto expectedImage = std::vector<unsigned char>(4 * pixelCount);
+    double colorSum[3] = {0.0, 0.0, 0.0};
+    for (size_t i = 0; i < pixelCount; ++i) {
+        const auto index = size_t(static_cast<unsigned char>(indices[i]));
+        for (size_t c = 0; c < 4; ++c) {
+            expectedImage[4 * i + c] = expectedColors[4 * index + c];
+        }
+        for (size_t c = 0; c < 3; ++c) {
+            colorSum[c] += double(expectedColors[4 * index + c]);
+        }
+    }
+
+    auto reader = IO::Reader::from(indices.data(), indices.data() + indices.size());
+    auto rgbaImage = TextureBuffer{4 * pixelCount};
+    auto averageColor = Color{};
+
+    const auto transparent = palette.indexedToRgba(reader, pixelCount, rgbaImage, transparency, averageColor);
+
+    CHECK(transparent == (transparency == PaletteTransparency::Index255Transparent && containsIndex255));
+    CHECK(reader.eof());
+    CHECK(std::memcmp(rgbaImage.data(), expectedImage.data(), expectedImage.size()) == 0);
+    for (size_t c = 0; c < 3; ++c) {
+        CHECK(double(averageColor[c]) == Approx(colorSum[c] / (255.0 * double(pixelCount))));
+    }
+    CHECK(averageColor[3] == 1.0f);
+}
+
+TEST_CASE("Palette.indexedToRgbaPadsShortPalettesWithOpaqueColors") {
+    const auto palette = makePalette({0x10, 0x20, 0x30, 0x40, 0x50, 0x60}, PaletteColorFormat::Rgb).value();
+
+    const auto indices = std::vector<char>{0, 1, 2, static_cast<char>(255)};
+    auto reader = IO::Reader::from(indices.data(), indices.data() + indices.size());
+    auto rgbaImage = TextureBuffer{4 * indices.size()};
+    auto averageColor = Color{};
+
+    CHECK_FALSE(palette.indexedToRgba(reader, indices.size(), rgbaImage, PaletteTransparency::Opaque, averageColor));
+
+    const auto expectedImage = std::vector<unsigned char>{
+        0x10, 0x20, 0x30, 0xFF, 0x40, 0x50, 0x60, 0xFF, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x00, 0x00, 0xFF,
+    };
+    CHECK(std::memcmp(rgbaImage.data(), expectedImage.data(), expectedImage.size()) == 0);
+}
+
+TEST_CASE("PaletteConversionKernels") {
+    const auto kernels = supportedPaletteConversionKernels();
+    REQUIRE(!kernels.empty());
+    CHECK(kernels.back().kernel == &convertIndexedToRgbaScalar);
+
+    // random colors with random alpha values so that every channel is checked
+    auto random = std::mt19937{42};
+    auto byte = std::uniform_int_distribution<int>{0, 255};
+    auto paletteData = std::vector<unsigned char>(1024);
+    for (auto &value : paletteData) {
+        value = static_cast<unsigned char>(byte(random));
+    }
+    const auto opaque = GENERATE(false, true);
+    if (opaque) {
+        for (size_t i = 3; i < paletteData.size(); i += 4) {
+            paletteData[i] = 0xFF;
+        }
+    }
+
+    // cover the remainders of all kernels
+    const auto pixelCount = GENERATE(size_t(0), size_t(1), size_t(3), size_t(4), size_t(7), size_t(8), size_t(9), size_t(31), size_t(64), size_t(1027));
+    auto indices = std::vector<unsigned char>(pixelCount);
+    for (auto &index : indices) {
+        index = static_cast<unsigned char>(byte(random));
+    }
+
+    auto expectedImage = std::vector<unsigned char>(4 * pixelCount);
+    const auto expected = convertIndexedToRgbaScalar(indices.data(), pixelCount, paletteData.data(), expectedImage.data());
+
+    for (const auto &[name, kernel] : kernels) {
+        CAPTURE(name, opaque, pixelCount);
+
+        auto image = std::vector<unsigned char>(4 * pixelCount);
+        const auto actual = kernel(indices.data(), pixelCount, paletteData.data(), image.data());
+
+        CHECK(image == expectedImage);
+        CHECK(actual.colorSum[0] == expected.colorSum[0]);
+        CHECK(actual.colorSum[1] == expected.colorSum[1]);
+        CHECK(actual.colorSum[2] == expected.colorSum[2]);
+        CHECK(actual.andAlpha == expected.andAlpha);
+    }
+}
+
+TEST_CASE("Palette.indexedToRgbaWithTooFewIndices") {
+    const auto palette = makePalette(std::vector<unsigned char>(768), PaletteColorFormat::Rgb).value();
+
+    const auto indices = std::vector<char>(3);
+    auto reader = IO::Reader::from(indices.data(), indices.data() + indices.size());
+    auto rgbaImage = TextureBuffer{4 * 4};
+    auto averageColor = Color{};
+
+    CHECK_THROWS_AS(palette.indexedToRgba(reader, 4, rgbaImage, PaletteTransparency::Opaque, averageColor), IO::ReaderException);
+}
+} // namespace TrenchBroom::Assets
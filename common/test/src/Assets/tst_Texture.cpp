@@ -0,0 +1,152 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Color.h"
+
+#include <atomic>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Assets {
+namespace {
+Texture makeTexture(const std::string &name, const size_t width, const size_t height) {
+    auto buffer = TextureBuffer{width * height * 4};
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        buffer.data()[i] = static_cast<unsigned char>(i);
+    }
+    return Texture{name, width, height, Color{0.25f, 0.5f, 0.75f, 1.0f}, std::move(buffer), GL_RGBA, TextureType::Masked};
+}
+} // namespace
+
+TEST_CASE("Texture.lazy") {
+    auto loaderCalls = size_t(0);
+
+    SECTION("The loader is called when the texture data is accessed for the first time") {
+        auto texture = Texture{"some_texture", 4, 2, [&]() -> std::optional<Texture> {
+            ++loaderCalls;
+            return makeTexture("some_texture", 4, 2);
+        }};
+
+        CHECK_FALSE(texture.loaded());
+        CHECK(texture.name() == "some_texture");
+        CHECK(texture.width() == 4);
+        CHECK(texture.height() == 2);
+        CHECK(loaderCalls == 0);
+
+        CHECK(texture.masked());
+        CHECK(texture.loaded());
+        CHECK(loaderCalls == 1);
+
+        CHECK(texture.averageColor() == Color{0.25f, 0.5f, 0.75f, 1.0f});
+        CHECK(texture.format() == GL_RGBA);
+        REQUIRE(texture.buffersIfUnprepared().size() == 1);
+        CHECK(texture.buffersIfUnprepared()[0].size() == 4 * 2 * 4);
+        CHECK(loaderCalls == 1);
+    }
+
+    SECTION("Prefetching decodes the texture without adopting the data") {
+        auto texture = Texture{"some_texture", 4, 2, [&]() -> std::optional<Texture> {
+            ++loaderCalls;
+            return makeTexture("some_texture", 4, 2);
+        }};
+
+        const auto task = texture.prefetchTask();
+        REQUIRE(task);
+        task();
+        CHECK(loaderCalls == 1);
+        CHECK_FALSE(texture.loaded());
+
+        CHECK(texture.masked());
+        CHECK(texture.loaded());
+        CHECK(loaderCalls == 1);
+        CHECK_FALSE(texture.prefetchTask());
+    }
+
+    SECTION("A moved texture keeps its loader") {
+        auto texture = Texture{"some_texture", 4, 2, [&]() -> std::optional<Texture> {
+            ++loaderCalls;
+            return makeTexture("some_texture", 4, 2);
+        }};
+
+        const auto movedTexture = std::move(texture);
+        CHECK_FALSE(movedTexture.loaded());
+        CHECK(movedTexture.masked());
+        CHECK(loaderCalls == 1);
+    }
+
+    SECTION("A texture that cannot be decoded has no data") {
+        const auto texture = Texture{"some_texture", 4, 2, [&]() -> std::optional<Texture> {
+            ++loaderCalls;
+            return std::nullopt;
+        }};
+
+        CHECK(texture.buffersIfUnprepared().empty());
+        CHECK(texture.loaded());
+        CHECK(texture.width() == 4);
+        CHECK(texture.height() == 2);
+    }
+
+    SECTION("A texture whose dimensions changed has no data") {
+        const auto texture = Texture{"some_texture", 4, 2, [&]() -> std::optional<Texture> {
+            ++loaderCalls;
+            return makeTexture("some_texture", 2, 2);
+        }};
+
+        CHECK(texture.buffersIfUnprepared().empty());
+        CHECK(texture.width() == 4);
+        CHECK(texture.height() == 2);
+    }
+
+    SECTION("Concurrent accesses load the texture once") {
+        auto concurrentLoaderCalls = std::atomic<size_t>{0};
+        const auto texture = Texture{"some_texture", 4, 2, [&]() -> std::optional<Texture> {
+            ++concurrentLoaderCalls;
+            return makeTexture("some_texture", 4, 2);
+        }};
+        const auto prefetch = texture.prefetchTask();
+
+        auto masked = std::vector<char>(4, false);
+        auto threads = std::vector<std::thread>{};
+        threads.emplace_back(prefetch);
+        for (size_t i = 0; i < masked.size(); ++i) {
+            threads.emplace_back([&, i]() { masked[i] = texture.masked() && texture.format() == GL_RGBA; });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        CHECK(masked == std::vector<char>(4, true));
+        CHECK(concurrentLoaderCalls == 1);
+        REQUIRE(texture.buffersIfUnprepared().size() == 1);
+        CHECK(texture.buffersIfUnprepared()[0].size() == 4 * 2 * 4);
+    }
+
+    SECTION("Textures that are not loaded lazily are loaded") {
+        const auto texture = makeTexture("some_texture", 4, 2);
+        CHECK(texture.loaded());
+        CHECK_FALSE(texture.prefetchTask());
+    }
+}
+} // namespace TrenchBroom::Assets
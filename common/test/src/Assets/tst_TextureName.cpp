@@ -0,0 +1,74 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/TextureName.h"
+
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Assets {
+TEST_CASE("TextureName.intern") {
+    CHECK(TextureName{}.name() == "");
+    CHECK(TextureName{}.empty());
+    CHECK(TextureName{} == TextureName{""});
+
+    const auto name = TextureName{"some_texture"};
+    CHECK(name.name() == "some_texture");
+    CHECK_FALSE(name.empty());
+
+    // equal names refer to the same entry
+    CHECK(TextureName{std::string{"some_texture"}} == name);
+    CHECK(&TextureName{"some_texture"}.name() == &name.name());
+    CHECK(std::hash<TextureName>{}(TextureName{"some_texture"}) == std::hash<TextureName>{}(name));
+
+    CHECK(TextureName{"other_texture"} != name);
+    CHECK(TextureName{"Some_Texture"} != name);
+}
+
+TEST_CASE("TextureName.lowerCase") {
+    CHECK(TextureName{"some_texture"}.lowerCase() == TextureName{"some_texture"});
+    CHECK(TextureName{"Some_Texture"}.lowerCase() == TextureName{"some_texture"});
+    CHECK(TextureName{"SOME_TEXTURE"}.lowerCase() == TextureName{"some_texture"});
+    CHECK(TextureName{"SOME_TEXTURE"}.name() == "SOME_TEXTURE");
+}
+
+TEST_CASE("TextureName.concurrentIntern") {
+    const auto makeNames = []() {
+        auto result = std::vector<TextureName>{};
+        for (size_t i = 0; i < 1000; ++i) {
+            result.emplace_back("concurrent_" + std::to_string(i % 100));
+        }
+        return result;
+    };
+
+    auto futures = std::vector<std::future<std::vector<TextureName>>>{};
+    for (size_t i = 0; i < 4; ++i) {
+        futures.push_back(std::async(std::launch::async, makeNames));
+    }
+
+    const auto expected = makeNames();
+    for (auto &future : futures) {
+        CHECK(future.get() == expected);
+    }
+}
+} // namespace TrenchBroom::Assets
@@ -307,5 +307,25 @@ CHECK(
 optimize()
 
 == expectedExpression);
-}} // namespace EL
+}
+
+TEST_CASE("ExpressionTest.testVariableNames") {
+    using T = std::tuple<std::string, std::vector<std::string>>;
+
+    // clang-format off
+    const auto [expression, expectedVariableNames] = GENERATE(values<T>({
+        {"3 + 7", {}},
+        {"x", {"x"}},
+        {"y + x * x", {"x", "y"}},
+        {"[a, { k: b }, -c]", {"a", "b", "c"}},
+        {"{{ x == 1 -> y, z }}", {"x", "y", "z"}},
+        {"a[b]", {"a", "b"}},
+    }));
+    // clang-format on
+
+    CAPTURE(expression);
+
+    CHECK(IO::ELParser::parseStrict(expression).variableNames() == expectedVariableNames);
+}
+} // namespace EL
 } // namespace TrenchBroom
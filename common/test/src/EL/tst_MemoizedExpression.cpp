@@ -0,0 +1,106 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "EL/ELExceptions.h"
+#include "EL/MemoizedExpression.h"
+#include "EL/Value.h"
+#include "EL/VariableStore.h"
+#include "IO/ELParser.h"
+
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+namespace EL {
+namespace {
+/**
+ * Counts how often the value of a variable is requested.
+ */
+class CountingVariableStore : public VariableTable {
+  private:
+    mutable size_t m_lookups = 0;
+
+  public:
+    using VariableTable::VariableTable;
+
+    VariableStore *clone() const override {
+        return new CountingVariableStore{*this};
+    }
+
+    Value value(const std::string &name) const override {
+        ++m_lookups;
+        return VariableTable::value(name);
+    }
+
+    size_t lookups() const {
+        return m_lookups;
+    }
+};
+} // namespace
+
+TEST_CASE("MemoizedExpressionTest.evaluate") {
+    const auto expression = MemoizedExpression{IO::ELParser::parseStrict(R"({{ x == 1 -> "one", y }})")};
+    CHECK(expression.variableNames() == std::vector<std::string>{"x", "y"});
+
+    CHECK(expression.evaluate(VariableTable{{{"x", Value{1}}, {"y", Value{"other"}}}}) == Value{"one"});
+    CHECK(expression.evaluate(VariableTable{{{"x", Value{2}}, {"y", Value{"other"}}}}) == Value{"other"});
+    CHECK(expression.evaluate(VariableTable{{{"x", Value{2}}, {"y", Value{"another"}}}}) == Value{"another"});
+    CHECK(expression.evaluate(VariableTable{{{"x", Value{1}}, {"y", Value{"another"}}}}) == Value{"one"});
+
+    // variables that the expression doesn't read don't matter
+    CHECK(expression.evaluate(VariableTable{{{"x", Value{2}}, {"y", Value{"other"}}, {"z", Value{3}}}}) == Value{"other"});
+}
+
+TEST_CASE("MemoizedExpressionTest.memoizesResults") {
+    const auto expression = MemoizedExpression{IO::ELParser::parseStrict(R"(x + 1)")};
+
+    // the expression itself is evaluated with a copy of the store, so only the lookups of
+    // the memoized variable values are counted
+    const auto store = CountingVariableStore{{{"x", Value{1}}}};
+    CHECK(expression.evaluate(store) == Value{2});
+    CHECK(store.lookups() == 1);
+
+    CHECK(expression.evaluate(store) == Value{2});
+    CHECK(store.lookups() == 2);
+
+    SECTION("Copies share memoized results") {
+        const auto copy = expression;
+        CHECK(copy.evaluate(store) == Value{2});
+        CHECK(store.lookups() == 3);
+    }
+
+    SECTION("Different values are evaluated") {
+        const auto otherStore = CountingVariableStore{{{"x", Value{2}}}};
+        CHECK(expression.evaluate(otherStore) == Value{3});
+        CHECK(expression.evaluate(store) == Value{2});
+    }
+}
+
+TEST_CASE("MemoizedExpressionTest.evaluationErrorsAreNotMemoized") {
+    const auto expression = MemoizedExpression{IO::ELParser::parseStrict(R"(x[1])")};
+
+    const auto store = VariableTable{{{"x", Value{true}}}};
+    CHECK_THROWS_AS(expression.evaluate(store), EvaluationError);
+    CHECK_THROWS_AS(expression.evaluate(store), EvaluationError);
+
+    CHECK(expression.evaluate(VariableTable{{{"x", Value{ArrayType{Value{1}, Value{2}}}}}}) == Value{2});
+}
+} // namespace EL
+} // namespace TrenchBroom
@@ -54,8 +54,8 @@ const Entry *getChild(const Entry &entry, const std::string &name) {
 }
 } // namespace
 
-TestFileSystem::TestFileSystem(Entry root, std::filesystem::path absolutePathPrefix)
-    : m_root{std::move(root)}, m_absolutePathPrefix{std::move(absolutePathPrefix)} {
+TestFileSystem::TestFileSystem(Entry root, std::filesystem::path absolutePathPrefix, const bool hasStaticContents)
+    : m_root{std::move(root)}, m_absolutePathPrefix{std::move(absolutePathPrefix)}, m_hasStaticContents{hasStaticContents} {
 }
 
 const Entry *TestFileSystem::findEntry(std::filesystem::path path) const {
@@ -72,6 +72,10 @@ PathInfo TestFileSystem::pathInfo(const std::filesystem::path &path) const {
     return entry ? getEntryType(*entry) : PathInfo::Unknown;
 }
 
+bool TestFileSystem::hasStaticContents() const {
+    return m_hasStaticContents;
+}
+
 Result<std::filesystem::path> TestFileSystem::makeAbsolute(const std::filesystem::path &path) const {
     return m_absolutePathPrefix / path;
 }
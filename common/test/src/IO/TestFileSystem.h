@@ -60,14 +60,17 @@ class TestFileSystem : public FileSystem {
   private:
     Entry m_root;
     std::filesystem::path m_absolutePathPrefix;
+    bool m_hasStaticContents;
 
   public:
-    explicit TestFileSystem(Entry root, std::filesystem::path absolutePathPrefix = {"/"});
+    explicit TestFileSystem(Entry root, std::filesystem::path absolutePathPrefix = {"/"}, bool hasStaticContents = true);
 
     Result<std::filesystem::path> makeAbsolute(const std::filesystem::path &path) const override;
 
     PathInfo pathInfo(const std::filesystem::path &path) const override;
 
+    bool hasStaticContents() const override;
+
   private:
     const Entry *findEntry(std::filesystem::path path) const;
 
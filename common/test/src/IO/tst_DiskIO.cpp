@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <string>
 
 #include "Catch2.h"
 
@@ -831,4 +832,53 @@ CHECK(Disk::resolvePath(rootPaths, "/asfd/blah")
 == "");
 CHECK(Disk::resolvePath(rootPaths, "adk3kdk/bhb")
 == "");
-}}} // namespace TrenchBroom::IO
+}}
+
+TEST_CASE("DiskIO.openMappedFile") {
+    const auto largeContents = std::string(256 * 1024, 'x') + "end";
+    const auto env = TestEnvironment{[&](TestEnvironment &e) {
+        e.createFile("small.txt", "some content");
+        e.createFile("large.txt", largeContents);
+    }};
+
+    SECTION("Files opened with openFile are not mapped") {
+        auto file = Disk::openFile(env.dir() / "large.txt").value();
+        CHECK_FALSE(file->isMapped());
+        CHECK(file->reader().buffer().stringView() == largeContents);
+    }
+
+    SECTION("Small files are not mapped") {
+        auto file = Disk::openMappedFile(env.dir() / "small.txt").value();
+        CHECK_FALSE(file->isMapped());
+        CHECK(file->reader().buffer().stringView() == "some content");
+    }
+
+    SECTION("Large files are mapped") {
+        auto file = Disk::openMappedFile(env.dir() / "large.txt").value();
+        CHECK(file->isMapped());
+        CHECK(file->size() == largeContents.size());
+
+        auto reader = file->reader();
+        reader.seekFromEnd(3);
+        CHECK(reader.readString(3) == "end");
+
+        const auto bufferedReader = file->reader().buffer();
+        CHECK(bufferedReader.stringView() == largeContents);
+
+        const auto subReader = file->reader().subReaderFromBegin(largeContents.size() - 5, 5).buffer();
+        CHECK(subReader.stringView() == "xxend");
+
+        const auto ownedBuffer = file->buffer();
+        CHECK(ownedBuffer->reader().buffer().stringView() == largeContents);
+
+        auto outOfBounds = file->reader();
+        outOfBounds.seekFromEnd(3);
+        CHECK_THROWS_AS(outOfBounds.readString(4), ReaderException);
+    }
+
+    SECTION("Buffers outlive the file") {
+        auto bufferedReader = Disk::openMappedFile(env.dir() / "large.txt").transform([](auto file) { return file->reader().buffer(); }).value();
+        CHECK(bufferedReader.stringView() == largeContents);
+    }
+}
+} // namespace TrenchBroom::IO
@@ -29,6 +29,9 @@
 #include "Matchers.h"
 #include "TestUtils.h"
 
+#include <kdl/parallel.h>
+#include <kdl/vector_utils.h>
+
 #include <filesystem>
 
 #include "Catch2.h"
@@ -79,6 +82,15 @@ MatchesPathsResult({
 "pics/tag1.pcx",
 }));
 
+// the stored paths are returned regardless of the case of the search path
+CHECK_THAT(
+    fs
+->find("PICS", TraversalMode::Flat),
+MatchesPathsResult({
+"pics/tag2.pcx",
+"pics/tag1.pcx",
+}));
+
 CHECK_THAT(
     fs
 ->find("", TraversalMode::Recursive),
@@ -205,5 +217,23 @@ size()
 );
 CHECK(contents
 == cr8_czg_03_contents);
-}}} // namespace IO
+}}
+
+TEST_CASE("ZipFileSystem.openFileConcurrently") {
+    const auto fs = std::shared_ptr<FileSystem>{openFS<ZipFileSystem>(std::filesystem::current_path() / "fixture/test/IO/Zip/zip.zip")};
+
+    auto paths = fs->find("", TraversalMode::Recursive).value();
+    paths = kdl::vec_filter(std::move(paths), [&](const auto &path) { return fs->pathInfo(path) == PathInfo::File; });
+    REQUIRE(!paths.empty());
+
+    const auto readContents = [&](const std::filesystem::path &path) {
+        const auto file = fs->openFile(path).value();
+        auto reader = file->reader();
+        return reader.readString(reader.size());
+    };
+
+    const auto expected = kdl::vec_transform(paths, readContents);
+    CHECK(kdl::vec_parallel_transform(paths, readContents) == expected);
+}
+} // namespace IO
 } // namespace TrenchBroom
@@ -36,6 +36,7 @@
 #include <kdl/vector_utils.h>
 
 #include <filesystem>
+#include <memory>
 #include <string>
 
 #include "Catch2.h"
@@ -74,8 +75,8 @@ std::optional<TextureCollectionInfo> makeInfo(const Result<Assets::TextureCollec
 } // namespace
 
 TEST_CASE("loadTextureCollection") {
-auto fs = VirtualFileSystem{};
-fs.mount(
+auto fs = std::make_shared<VirtualFileSystem>();
+fs->mount(
 "",
 
 std::make_unique<DiskFileSystem> (std::filesystem::current_path())
@@ -83,7 +84,7 @@ std::make_unique<DiskFileSystem> (std::filesystem::current_path())
 );
 
 const auto wadPath = std::filesystem::current_path() / "fixture/test/IO/Wad/cr8_czg.wad";
-fs.mount(
+fs->mount(
 "textures"
 / wadPath.
 
@@ -0,0 +1,185 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IO/MapEntityChunks.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+namespace IO {
+namespace {
+std::string join(const std::vector<MapEntityChunk> &chunks) {
+    auto result = std::string{};
+    for (const auto &chunk : chunks) {
+        result += chunk.str;
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("MapEntityChunksTest.splitEmptySource") {
+    CHECK(splitIntoEntityChunks("", 1u).empty());
+}
+
+TEST_CASE("MapEntityChunksTest.splitAtEntityBoundaries") {
+    const auto data = std::string{R"({
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) none 0 0 0 1 1
+}
+}
+{
+"classname" "info_player_start"
+}
+{
+"classname" "light"
+})"};
+
+    const auto chunks = splitIntoEntityChunks(data, 1u);
+    REQUIRE(chunks.size() == 3u);
+    CHECK(join(chunks) == data);
+
+    CHECK(chunks[0].line == 1u);
+    CHECK(chunks[0].column == 1u);
+    CHECK(chunks[0].entityCount == 1u);
+
+    CHECK(chunks[1].str.find("info_player_start") != std::string_view::npos);
+    CHECK(chunks[1].line == 6u);
+    CHECK(chunks[1].column == 2u);
+    CHECK(chunks[1].entityCount == 1u);
+
+    CHECK(chunks[2].str.find("light") != std::string_view::npos);
+    CHECK(chunks[2].line == 9u);
+    CHECK(chunks[2].column == 2u);
+    CHECK(chunks[2].entityCount == 1u);
+}
+
+TEST_CASE("MapEntityChunksTest.mergeEntitiesUntilMinChunkSize") {
+    const auto data = std::string{R"({
+"classname" "worldspawn"
+}
+{
+"classname" "info_player_start"
+}
+{
+"classname" "light"
+}
+)"};
+
+    SECTION("All entities fit into one chunk") {
+        const auto chunks = splitIntoEntityChunks(data, data.size());
+        REQUIRE(chunks.size() == 1u);
+        CHECK(chunks[0].str == data);
+        CHECK(chunks[0].entityCount == 3u);
+    }
+
+    SECTION("Chunks are closed after the first entity that exceeds the minimum size") {
+        const auto chunks = splitIntoEntityChunks(data, 30u);
+        REQUIRE(chunks.size() == 2u);
+        CHECK(join(chunks) == data);
+        CHECK(chunks[0].entityCount == 2u);
+        CHECK(chunks[1].entityCount == 1u);
+    }
+}
+
+TEST_CASE("MapEntityChunksTest.appendTrailingTextToLastChunk") {
+    const auto data = std::string{R"({
+"classname" "worldspawn"
+}
+{
+"classname" "light"
+}
+// trailing comment
+)"};
+
+    const auto chunks = splitIntoEntityChunks(data, 1u);
+    REQUIRE(chunks.size() == 2u);
+    CHECK(join(chunks) == data);
+    CHECK(chunks[1].entityCount == 1u);
+}
+
+TEST_CASE("MapEntityChunksTest.ignoreBracesInStringsAndComments") {
+    const auto data = std::string{R"({
+"classname" "worldspawn"
+"message" "}{ \" } \" }"
+// }
+; }
+"path" "c:\maps\"
+}
+{
+"classname" "light"
+})"};
+
+    const auto chunks = splitIntoEntityChunks(data, 1u);
+    REQUIRE(chunks.size() == 2u);
+    CHECK(chunks[0].entityCount == 1u);
+    CHECK(chunks[1].line == 7u);
+}
+
+TEST_CASE("MapEntityChunksTest.ignoreBracesInTextureNames") {
+    const auto data = std::string{R"({
+"classname" "worldspawn"
+{
+( -0 -0 -16 ) ( -0 -0  -0 ) ( 64 -0 -16 ) {none 0 0 0 1 1
+( -0 -0 -16 ) ( -0 64 -16 ) ( -0 -0  -0 ) }none 0 0 0 1 1
+}
+}
+{
+"classname" "func_wall"
+{
+patchDef2
+{
+common/caulk
+( 3 3 0 0 0 )
+(
+( ( -64 -64 4 0 0 ) ( -64 0 4 0 -0.25 ) ( -64 64 4 0 -0.5 ) )
+( ( 0 -64 4 0.25 0 ) ( 0 0 4 0.25 -0.25 ) ( 0 64 4 0.25 -0.5 ) )
+( ( 64 -64 4 0.5 0 ) ( 64 0 4 0.5 -0.25 ) ( 64 64 4 0.5 -0.5 ) )
+)
+}
+}
+})"};
+
+    const auto chunks = splitIntoEntityChunks(data, 1u);
+    REQUIRE(chunks.size() == 2u);
+    CHECK(join(chunks) == data);
+    CHECK(chunks[1].line == 7u);
+    CHECK(chunks[1].str.find("func_wall") != std::string_view::npos);
+}
+
+TEST_CASE("MapEntityChunksTest.rejectMalformedSource") {
+    SECTION("Unbalanced closing brace") {
+        CHECK(splitIntoEntityChunks(R"({ "classname" "worldspawn" } })", 1u).empty());
+    }
+
+    SECTION("Unterminated entity") {
+        CHECK(splitIntoEntityChunks(R"({ "classname" "worldspawn" } { "classname" "light")", 1u).empty());
+    }
+
+    SECTION("Unterminated string") {
+        CHECK(splitIntoEntityChunks(R"({ "classname" "worldspawn })", 1u).empty());
+    }
+}
+} // namespace IO
+} // namespace TrenchBroom
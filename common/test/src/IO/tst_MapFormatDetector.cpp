@@ -0,0 +1,150 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "IO/MapFormatDetector.h"
+#include "Model/MapFormat.h"
+
+#include <string>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+namespace IO {
+namespace {
+const auto AllFormats = std::vector<Model::MapFormat>{
+  Model::MapFormat::Standard, Model::MapFormat::Quake2, Model::MapFormat::Quake2_Valve, Model::MapFormat::Valve, Model::MapFormat::Hexen2, Model::MapFormat::Daikatana, Model::MapFormat::Quake3_Legacy, Model::MapFormat::Quake3_Valve, Model::MapFormat::Quake3,
+};
+} // namespace
+
+TEST_CASE("MapFormatDetectorTest.detectStandardFace") {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty 0 0 0 1 1
+}
+})";
+
+    CHECK(detectMapFormats(data, AllFormats) == std::vector<Model::MapFormat>{Model::MapFormat::Standard, Model::MapFormat::Quake2, Model::MapFormat::Hexen2, Model::MapFormat::Daikatana, Model::MapFormat::Quake3_Legacy, Model::MapFormat::Quake3});
+}
+
+TEST_CASE("MapFormatDetectorTest.detectValveFace") {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+"mapversion" "220"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) {blue [ 0 -1 0 0 ] [ 0 0 -1 0 ] 0 1 1
+}
+})";
+
+    CHECK(detectMapFormats(data, AllFormats) == std::vector<Model::MapFormat>{Model::MapFormat::Quake2_Valve, Model::MapFormat::Valve, Model::MapFormat::Quake3_Valve});
+    CHECK(detectMapFormats(data, {Model::MapFormat::Standard, Model::MapFormat::Valve}) == std::vector<Model::MapFormat>{Model::MapFormat::Valve});
+}
+
+TEST_CASE("MapFormatDetectorTest.detectQuake2Face") {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) e1u1/metal 0 0 0 1 1 0 0 0
+}
+})";
+
+    CHECK(detectMapFormats(data, AllFormats) == std::vector<Model::MapFormat>{Model::MapFormat::Quake2, Model::MapFormat::Daikatana, Model::MapFormat::Quake3_Legacy, Model::MapFormat::Quake3});
+}
+
+TEST_CASE("MapFormatDetectorTest.detectHexen2Face") {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) rtex 0 0 0 1 1 -1
+}
+})";
+
+    CHECK(detectMapFormats(data, AllFormats) == std::vector<Model::MapFormat>{Model::MapFormat::Hexen2});
+}
+
+TEST_CASE("MapFormatDetectorTest.detectPatch") {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+{
+patchDef2
+{
+common/caulk
+( 3 3 0 0 0 )
+(
+( ( -64 -64 4 0 0 ) ( -64 0 4 0 -0.25 ) ( -64 64 4 0 -0.5 ) )
+( ( 0 -64 4 0.25 0 ) ( 0 0 4 0.25 -0.25 ) ( 0 64 4 0.25 -0.5 ) )
+( ( 64 -64 4 0.5 0 ) ( 64 0 4 0.5 -0.25 ) ( 64 64 4 0.5 -0.5 ) )
+)
+}
+}
+})";
+
+    CHECK(detectMapFormats(data, AllFormats) == std::vector<Model::MapFormat>{Model::MapFormat::Quake3_Legacy, Model::MapFormat::Quake3_Valve, Model::MapFormat::Quake3});
+}
+
+TEST_CASE("MapFormatDetectorTest.detectBrushPrimitive") {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+{
+brushDef
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) ( ( 0.03125 0 0 ) ( 0 0.03125 0 ) ) common/caulk 0 0 0
+}
+}
+})";
+
+    CHECK(detectMapFormats(data, AllFormats) == std::vector<Model::MapFormat>{Model::MapFormat::Quake3});
+}
+
+TEST_CASE("MapFormatDetectorTest.inspectsOnlyFirstObjects") {
+    const auto data = R"(
+{
+"classname" "worldspawn"
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty 0 0 0 1 1
+}
+{
+( -64 -64 -16 ) ( -64 -63 -16 ) ( -64 -64 -15 ) __TB_empty 0 0 0 1 1 -1
+}
+})";
+
+    CHECK(detectMapFormats(data, AllFormats, 1).size() == 6u);
+    CHECK(detectMapFormats(data, AllFormats, 2) == std::vector<Model::MapFormat>{Model::MapFormat::Hexen2});
+}
+
+TEST_CASE("MapFormatDetectorTest.emptyMap") {
+    CHECK(detectMapFormats("", AllFormats) == AllFormats);
+    CHECK(detectMapFormats("{\n\"classname\" \"worldspawn\"\n}", AllFormats) == AllFormats);
+}
+
+TEST_CASE("MapFormatDetectorTest.invalidMap") {
+    CHECK(detectMapFormats("}", AllFormats).empty());
+    CHECK(detectMapFormats("{\n{\n( 1 2 ) ( 3 4 5 ) ( 6 7 8 ) tex 0 0 0 1 1\n}\n}", AllFormats).empty());
+    CHECK(detectMapFormats("{\n{\n( 1 2 3 ) ( 3 4 5 ) ( 6 7 8 ) tex 0 0 0 1 1 1 1\n}\n}", AllFormats).empty());
+}
+} // namespace IO
+} // namespace TrenchBroom
@@ -17,7 +17,9 @@
  along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "Assets/Texture.h"
 #include "Exceptions.h"
+#include "IO/MapFileSerializer.h"
 #include "IO/NodeWriter.h"
 #include "Model/BezierPatch.h"
 #include "Model/BrushBuilder.h"
@@ -1451,5 +1453,52 @@ common/caulk
 )";
 CHECK(actual
 == expected);
-}} // namespace IO
+}
+
+TEST_CASE("NodeWriterTest.writeDeferredMap") {
+    const auto worldBounds = vm::bbox3{8192.0};
+
+    auto texture = Assets::Texture{"e1u1/brlava", 64, 64, GL_RGB, Assets::TextureType::Opaque, Assets::Q2Data{9, 8, 700}};
+
+    auto map = Model::WorldNode{{}, {}, Model::MapFormat::Quake2};
+
+    auto builder = Model::BrushBuilder{map.mapFormat(), worldBounds};
+    auto brush = builder.createCube(64.0, "e1u1/alarm0").value();
+
+    // the -Z face takes its surface contents and value from its texture
+    {
+        const auto index = brush.findFace(vm::vec3::neg_z());
+        REQUIRE(index);
+
+        auto &face = brush.face(*index);
+        auto attributes = face.attributes();
+        attributes.setTextureName("e1u1/brlava");
+        attributes.setSurfaceFlags(9);
+        face.setAttributes(attributes);
+        face.setTexture(&texture);
+    }
+
+    auto patch = Model::BezierPatch{3, 3, {{0, 0, 0, 0, 0}, {0, 64, 0, 0, 0.5}, {0, 128, 0, 0, 1}, {64, 0, 0, 0.5, 0}, {64, 64, 0, 0.5, 0.5}, {64, 128, 0, 0.5, 1}, {128, 0, 0, 1, 0}, {128, 64, 0, 1, 0.5}, {128, 128, 0, 1, 1}}, "common/caulk"};
+
+    auto *entityNode = new Model::EntityNode{Model::Entity{{}, {{"classname", "func_door"}}}};
+    entityNode->addChild(new Model::BrushNode{std::move(brush)});
+    map.defaultLayer()->addChild(entityNode);
+    map.defaultLayer()->addChild(new Model::PatchNode{std::move(patch)});
+
+    auto expected = std::stringstream{};
+    NodeWriter{map, expected}.writeMap();
+    REQUIRE(expected.str().find("e1u1/brlava 0 0 0 1 1 8 9 700") != std::string::npos);
+
+    auto text = std::stringstream{};
+    auto [serializer, writeDeferred] = MapFileSerializer::createDeferred(map.mapFormat(), text);
+    NodeWriter{map, std::move(serializer)}.writeMap();
+
+    // the copied faces do not refer to the texture
+    CHECK(texture.usageCount() == 1u);
+
+    auto actual = std::stringstream{};
+    writeDeferred(text.str(), actual);
+    CHECK(actual.str() == expected.str());
+}
+} // namespace IO
 } // namespace TrenchBroom
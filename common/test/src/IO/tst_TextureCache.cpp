@@ -0,0 +1,217 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Assets/Texture.h"
+#include "Assets/TextureBuffer.h"
+#include "Color.h"
+#include "IO/File.h"
+#include "IO/TestEnvironment.h"
+#include "IO/TextureCache.h"
+
+#include <kdl/result.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+namespace IO {
+
+namespace {
+std::shared_ptr<File> makeFile(const std::string &contents) {
+    auto buffer = std::make_unique<char[]>(contents.size());
+    std::memcpy(buffer.get(), contents.data(), contents.size());
+    return std::make_shared<OwningBufferFile>(std::move(buffer), contents.size());
+}
+
+Assets::Texture makeTexture() {
+    auto buffers = Assets::TextureBufferList{};
+    buffers.emplace_back(4 * 4 * 4);
+    buffers.emplace_back(2 * 2 * 4);
+    buffers.emplace_back(1 * 1 * 4);
+    for (auto &buffer : buffers) {
+        for (size_t i = 0; i < buffer.size(); ++i) {
+            buffer.data()[i] = static_cast<unsigned char>(i);
+        }
+    }
+
+    return Assets::Texture{
+        "some_texture", 4, 4, Color{0.25f, 0.5f, 0.75f, 1.0f}, std::move(buffers), GL_RGBA, Assets::TextureType::Masked, Assets::Q2Data{1, 2, 3}
+    };
+}
+} // namespace
+
+TEST_CASE("TextureCache") {
+    auto env = TestEnvironment{};
+    auto cache = TextureCache{env.dir() / "cache"};
+
+    const auto file = makeFile("some texture data");
+    const auto key = makeTextureCacheKey("textures/some_texture.wal", 9, *file, std::nullopt);
+
+    SECTION("Loading a texture that was not stored is a miss") {
+        CHECK(cache.load(key) == std::nullopt);
+        CHECK(cache.hits() == 0);
+        CHECK(cache.misses() == 1);
+    }
+
+    SECTION("Loading a stored texture is a hit") {
+        const auto texture = makeTexture();
+        REQUIRE(cache.store(key, texture).is_success());
+
+        const auto cachedTexture = cache.load(key);
+        REQUIRE(cachedTexture != std::nullopt);
+        CHECK(cache.hits() == 1);
+        CHECK(cache.misses() == 0);
+
+        CHECK(cachedTexture->name() == texture.name());
+        CHECK(cachedTexture->width() == texture.width());
+        CHECK(cachedTexture->height() == texture.height());
+        CHECK(cachedTexture->averageColor() == texture.averageColor());
+        CHECK(cachedTexture->format() == texture.format());
+        CHECK(cachedTexture->type() == texture.type());
+        CHECK(cachedTexture->gameData() == texture.gameData());
+
+        const auto &buffers = cachedTexture->buffersIfUnprepared();
+        REQUIRE(buffers.size() == texture.buffersIfUnprepared().size());
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            const auto &expected = texture.buffersIfUnprepared()[i];
+            REQUIRE(buffers[i].size() == expected.size());
+            CHECK(std::memcmp(buffers[i].data(), expected.data(), expected.size()) == 0);
+        }
+
+        SECTION("The cache is persistent") {
+            auto otherCache = TextureCache{env.dir() / "cache"};
+            CHECK(otherCache.load(key) != std::nullopt);
+        }
+
+        SECTION("Changing the texture file is a miss") {
+            const auto otherFile = makeFile("other texture data");
+            CHECK(cache.load(makeTextureCacheKey("textures/some_texture.wal", 9, *otherFile, std::nullopt)) == std::nullopt);
+        }
+
+        SECTION("Changing the prefix length is a miss") {
+            CHECK(cache.load(makeTextureCacheKey("textures/some_texture.wal", 0, *file, std::nullopt)) == std::nullopt);
+        }
+
+        SECTION("Resetting the statistics") {
+            cache.resetStatistics();
+            CHECK(cache.hits() == 0);
+            CHECK(cache.misses() == 0);
+        }
+    }
+
+    SECTION("Loading a corrupt cache file is a miss") {
+        REQUIRE(cache.store(key, makeTexture()).is_success());
+
+        for (const auto &entry : std::filesystem::directory_iterator{env.dir() / "cache"}) {
+            std::filesystem::resize_file(entry.path(), 16);
+        }
+
+        CHECK(cache.load(key) == std::nullopt);
+        CHECK(cache.misses() == 1);
+    }
+
+    SECTION("Loading a cache file with an invalid buffer size is a miss") {
+        REQUIRE(cache.store(key, makeTexture()).is_success());
+
+        // the buffer count is followed by the size of the first buffer
+        auto pattern = std::string(12, '\0');
+        const auto bufferCount = uint32_t(3);
+        const auto bufferSize = uint64_t(4 * 4 * 4);
+        std::memcpy(pattern.data(), &bufferCount, sizeof(bufferCount));
+        std::memcpy(pattern.data() + sizeof(bufferCount), &bufferSize, sizeof(bufferSize));
+
+        for (const auto &entry : std::filesystem::directory_iterator{env.dir() / "cache"}) {
+            auto contents = env.loadFile(std::filesystem::relative(entry.path(), env.dir()));
+            const auto offset = contents.find(pattern);
+            REQUIRE(offset != std::string::npos);
+
+            const auto hugeSize = uint64_t(1) << 62;
+            std::memcpy(contents.data() + offset + sizeof(bufferCount), &hugeSize, sizeof(hugeSize));
+            env.createFile(std::filesystem::relative(entry.path(), env.dir()), contents);
+        }
+
+        CHECK(cache.load(key) == std::nullopt);
+        CHECK(cache.misses() == 1);
+    }
+
+    SECTION("Textures whose buffers do not match their mip levels are not stored") {
+        auto buffers = Assets::TextureBufferList{};
+        buffers.emplace_back(4 * 4 * 4);
+        buffers.emplace_back(4 * 4 * 4);
+        const auto texture = Assets::Texture{"some_texture", 4, 4, Color{}, std::move(buffers), GL_RGBA, Assets::TextureType::Opaque};
+
+        CHECK(cache.store(key, texture).is_error());
+        CHECK(cache.load(key) == std::nullopt);
+    }
+}
+
+TEST_CASE("TextureCache.prune") {
+    const auto env = TestEnvironment{};
+    auto cache = TextureCache{env.dir() / "cache"};
+
+    const auto makeKey = [](const std::string &contents) {
+        return makeTextureCacheKey("textures/some_texture.wal", 9, *makeFile(contents), std::nullopt);
+    };
+
+    const auto key1 = makeKey("texture 1");
+    const auto key2 = makeKey("texture 2");
+    const auto key3 = makeKey("texture 3");
+    for (const auto &key : {key1, key2, key3}) {
+        REQUIRE(cache.store(key, makeTexture()).is_success());
+    }
+
+    auto fileSize = uint64_t(0);
+    auto lastUsed = std::filesystem::file_time_type::clock::now() - std::chrono::hours{1};
+    for (const auto &entry : std::filesystem::directory_iterator{env.dir() / "cache"}) {
+        fileSize = entry.file_size();
+        std::filesystem::last_write_time(entry.path(), lastUsed);
+    }
+
+    // loading a texture marks its cache file as used
+    REQUIRE(cache.load(key2) != std::nullopt);
+    REQUIRE(cache.load(key3) != std::nullopt);
+
+    SECTION("Does not delete anything if the cache is small enough") {
+        cache.prune(3 * fileSize);
+        CHECK(cache.load(key1) != std::nullopt);
+        CHECK(cache.load(key2) != std::nullopt);
+        CHECK(cache.load(key3) != std::nullopt);
+    }
+
+    SECTION("Deletes the least recently used files") {
+        cache.prune(2 * fileSize);
+        CHECK(cache.load(key1) == std::nullopt);
+        CHECK(cache.load(key2) != std::nullopt);
+        CHECK(cache.load(key3) != std::nullopt);
+    }
+
+    SECTION("Pruning a cache without a directory does nothing") {
+        auto otherCache = TextureCache{env.dir() / "does_not_exist"};
+        otherCache.prune(0);
+        CHECK_FALSE(std::filesystem::exists(env.dir() / "does_not_exist"));
+    }
+}
+
+} // namespace IO
+} // namespace TrenchBroom
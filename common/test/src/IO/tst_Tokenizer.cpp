@@ -731,5 +731,26 @@ nextToken()
 type()
 
 == SimpleToken::Eof);
-}} // namespace IO
+}
+
+TEST_CASE("TokenizerTest.tokenToNumber") {
+    using Token = SimpleTokenizer::Token;
+    const auto makeToken = [](const std::string &str) { return Token(SimpleToken::Decimal, str.data(), str.data() + str.size(), 0, 1, 1); };
+
+    SECTION("toFloat") {
+        const auto str = GENERATE(as<std::string>(), "0", "-0", "+7", "-64", "0.5", ".5", "-.25", "1.", "-1216.00130208333", "3.14159265358979323846", "1e3", "-2.5E-2");
+
+        CAPTURE(str);
+        CHECK(makeToken(str).toFloat<double>() == std::stod(str));
+        CHECK(makeToken(str).toFloat<float>() == static_cast<float>(std::stod(str)));
+    }
+
+    SECTION("toInteger") {
+        const auto str = GENERATE(as<std::string>(), "0", "-0", "+7", "-64", "1024", "123456789012345678", "1234567890123456789");
+
+        CAPTURE(str);
+        CHECK(makeToken(str).toInteger<long long>() == std::stoll(str));
+    }
+}
+} // namespace IO
 } // namespace TrenchBroom
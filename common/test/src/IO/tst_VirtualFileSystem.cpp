@@ -678,5 +678,50 @@ Error{
 CHECK(vfs
 .openFile("foo/bar/g") == Result <std::shared_ptr<File>>{
 fs2_foo_bar_g});
-}}}} // namespace IO
+}}}
+
+TEST_CASE("VirtualFileSystem.index") {
+    auto fs1_foo = std::make_shared<ObjectFile<Object>>(Object{1});
+    auto fs2_foo = std::make_shared<ObjectFile<Object>>(Object{2});
+    auto fs3_foo = std::make_shared<ObjectFile<Object>>(Object{3});
+    auto fs3_bar = std::make_shared<ObjectFile<Object>>(Object{4});
+
+    auto vfs = VirtualFileSystem{};
+    vfs.mount("", std::make_unique<TestFileSystem>(Entry{DirectoryEntry{"", {DirectoryEntry{"dir", {FileEntry{"foo", fs1_foo}}}}}}, "/fs1", true));
+
+    SECTION("a file system without static contents overrides an indexed file system") {
+        vfs.mount("", std::make_unique<TestFileSystem>(Entry{DirectoryEntry{"", {DirectoryEntry{"dir", {FileEntry{"foo", fs2_foo}}}}}}, "/fs2", false));
+
+        CHECK(vfs.pathInfo("dir/foo") == PathInfo::File);
+        CHECK(vfs.openFile("dir/foo") == Result<std::shared_ptr<File>>{fs2_foo});
+    }
+
+    SECTION("an indexed file system overrides a file system without static contents") {
+        vfs.mount("", std::make_unique<TestFileSystem>(Entry{DirectoryEntry{"", {DirectoryEntry{"dir", {FileEntry{"foo", fs2_foo}}}}}}, "/fs2", false));
+        vfs.mount("", std::make_unique<TestFileSystem>(Entry{DirectoryEntry{"", {DirectoryEntry{"dir", {FileEntry{"foo", fs3_foo}}}}}}, "/fs3", true));
+
+        CHECK(vfs.openFile("dir/foo") == Result<std::shared_ptr<File>>{fs3_foo});
+    }
+
+    SECTION("the index is updated when a file system is mounted at a nested mount point") {
+        const auto id = vfs.mount("dir", std::make_unique<TestFileSystem>(Entry{DirectoryEntry{"", {FileEntry{"foo", fs3_foo}, FileEntry{"bar", fs3_bar}}}}, "/fs3", true));
+
+        CHECK(vfs.pathInfo("dir/bar") == PathInfo::File);
+        CHECK(vfs.openFile("dir/foo") == Result<std::shared_ptr<File>>{fs3_foo});
+        CHECK(vfs.openFile("dir/bar") == Result<std::shared_ptr<File>>{fs3_bar});
+
+        SECTION("and when it is unmounted again") {
+            CHECK(vfs.unmount(id));
+
+            CHECK(vfs.pathInfo("dir/bar") == PathInfo::Unknown);
+            CHECK(vfs.openFile("dir/foo") == Result<std::shared_ptr<File>>{fs1_foo});
+        }
+    }
+
+    SECTION("lookups are case insensitive") {
+        CHECK(vfs.pathInfo("DIR") == PathInfo::Directory);
+        CHECK(vfs.pathInfo("Dir/Foo") == PathInfo::File);
+    }
+}
+} // namespace IO
 } // namespace TrenchBroom
@@ -41,6 +41,8 @@
 
 #include <filesystem>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include "Catch2.h"
 
@@ -3626,5 +3628,70 @@ CHECK(
 mapFormat()
 
 == Model::MapFormat::Standard);
+}
+
+TEST_CASE("WorldReaderTest.parseLargeMapInParallel") {
+    // large enough to be split into several chunks of entities
+    constexpr size_t EntityCount = 500;
+
+    const auto brush = [](const int x) {
+        return fmt::format(R"({{
+( {0} 0 0 ) ( {0} 1 0 ) ( {0} 0 1 ) none 0 0 0 1 1
+( {1} 0 0 ) ( {1} 0 1 ) ( {1} 1 0 ) none 0 0 0 1 1
+( {0} 0 0 ) ( {0} 0 1 ) ( {1} 0 0 ) none 0 0 0 1 1
+( {0} 16 0 ) ( {1} 16 0 ) ( {0} 16 1 ) none 0 0 0 1 1
+( {0} 0 0 ) ( {1} 0 0 ) ( {0} 1 0 ) none 0 0 0 1 1
+( {0} 0 16 ) ( {0} 1 16 ) ( {1} 0 16 ) none 0 0 0 1 1
+}}
+)", x, x + 16);
+    };
+
+    auto data = std::string{"{\n\"classname\" \"worldspawn\"\n"} + brush(0) + "}\n";
+    data += "{\n\"classname\" \"func_group\"\n\"_tb_type\" \"_tb_group\"\n\"_tb_name\" \"Group\"\n\"_tb_id\" \"1\"\n}\n";
+    for (size_t i = 0; i < EntityCount; ++i) {
+        data += "{\n\"classname\" \"func_wall\"\n";
+        if (i % 50 == 0) {
+            data += "\"_tb_group\" \"1\"\n";
+        }
+        if (i % 100 == 0) {
+            data += "\"message\" \"a\"\n\"message\" \"b\"\n";
+        }
+        data += brush(static_cast<int>(i % 256) * 16);
+        data += "}\n";
+    }
+
+    const auto worldBounds = vm::bbox3{8192.0};
+
+    const auto read = [&](const size_t maxThreadCount, TestParserStatus &status) {
+        auto reader = WorldReader{data, Model::MapFormat::Standard, {}};
+        reader.setMaxThreadCount(maxThreadCount);
+        return reader.read(worldBounds, status);
+    };
+
+    const auto describe = [](const Model::Node &root) {
+        auto result = std::vector<std::tuple<std::string, size_t, size_t>>{};
+        const auto visit = [&](const auto &self, const Model::Node &node) -> void {
+            result.emplace_back(node.name(), node.lineNumber(), node.childCount());
+            for (const auto *child : node.children()) {
+                self(self, *child);
+            }
+        };
+        visit(visit, root);
+        return result;
+    };
+
+    auto sequentialStatus = TestParserStatus{};
+    const auto sequentialWorld = read(1, sequentialStatus);
+
+    auto parallelStatus = TestParserStatus{};
+    const auto parallelWorld = read(4, parallelStatus);
+
+    REQUIRE(sequentialWorld != nullptr);
+    REQUIRE(parallelWorld != nullptr);
+
+    CHECK(sequentialWorld->defaultLayer()->childCount() == EntityCount - EntityCount / 50 + 2);
+    CHECK(describe(*parallelWorld) == describe(*sequentialWorld));
+    CHECK(parallelStatus.messages(LogLevel::Warn) == sequentialStatus.messages(LogLevel::Warn));
+    CHECK(parallelStatus.countStatus(LogLevel::Warn) == EntityCount / 100);
 }} // namespace IO
 } // namespace TrenchBroom
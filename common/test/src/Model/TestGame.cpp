@@ -29,6 +29,7 @@
 #include "IO/DiskIO.h"
 #include "IO/ExportOptions.h"
 #include "IO/LoadTextureCollection.h"
+#include "IO/MapFileSerializer.h"
 #include "IO/NodeReader.h"
 #include "IO/NodeWriter.h"
 #include "IO/TestParserStatus.h"
@@ -45,13 +46,14 @@
 
 #include <fstream>
 #include <memory>
+#include <sstream>
 #include <vector>
 
 #include "Catch2.h"
 
 namespace TrenchBroom::Model {
 TestGame::TestGame() : m_defaultFaceAttributes{Model::BrushFaceAttributes::NoTextureName}, m_fs{
-    std::make_unique<IO::VirtualFileSystem>()
+    std::make_shared<IO::VirtualFileSystem>()
 } {
     m_fs->mount("", std::make_unique<IO::DiskFileSystem>(std::filesystem::current_path()));
 }
@@ -123,10 +125,20 @@ Result<std::unique_ptr<WorldNode>> TestGame::doLoadMap(const MapFormat format, c
 }
 
 Result<void> TestGame::doWriteMap(WorldNode &world, const std::filesystem::path &path) const {
-    return IO::Disk::withOutputStream(path, [&](auto &stream) {
-        IO::NodeWriter writer(world, stream);
-        writer.writeMap();
-    });
+    return IO::Disk::withOutputStream(path, [&](auto &stream) { doWriteMapToStream(world, stream); });
+}
+
+void TestGame::doWriteMapToStream(WorldNode &world, std::ostream &stream) const {
+    IO::NodeWriter writer(world, stream);
+    writer.writeMap();
+}
+
+std::function<void(std::ostream &)> TestGame::doDeferWriteMapToStream(const WorldNode &world) const {
+    auto stream = std::ostringstream{};
+    auto [serializer, writeDeferred] = IO::MapFileSerializer::createDeferred(world.mapFormat(), stream);
+    IO::NodeWriter{world, std::move(serializer)}.writeMap();
+
+    return [text = stream.str(), writeDeferred = std::move(writeDeferred)](std::ostream &out) { writeDeferred(text, out); };
 }
 
 Result<void> TestGame::doExportMap(WorldNode & /* world */, const IO::ExportOptions & /* options */) const {
@@ -157,7 +169,7 @@ void TestGame::doWriteBrushFacesToStream(WorldNode &world, const std::vector<Bru
 void TestGame::doLoadTextureCollections(Assets::TextureManager &textureManager) const {
     const Model::TextureConfig textureConfig{"textures", {".D"}, "fixture/test/palette.lmp", "wad", "", {},};
 
-    textureManager.reload(*m_fs, textureConfig);
+    textureManager.reload(m_fs, textureConfig);
 }
 
 void TestGame::doReloadWads(const std::filesystem::path &, const std::vector<std::filesystem::path> &wadPaths, Logger &) {
@@ -25,6 +25,7 @@
 #include "Result.h"
 
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,7 +47,7 @@ class TestGame : public Game {
     std::vector<SmartTag> m_smartTags;
     Model::BrushFaceAttributes m_defaultFaceAttributes;
     std::vector<CompilationTool> m_compilationTools;
-    std::unique_ptr<IO::VirtualFileSystem> m_fs;
+    std::shared_ptr<IO::VirtualFileSystem> m_fs;
 
   public:
     TestGame();
@@ -87,6 +88,10 @@ class TestGame : public Game {
 
     Result<void> doWriteMap(WorldNode &world, const std::filesystem::path &path) const override;
 
+    void doWriteMapToStream(WorldNode &world, std::ostream &stream) const override;
+
+    std::function<void(std::ostream &)> doDeferWriteMapToStream(const WorldNode &world) const override;
+
     Result<void> doExportMap(WorldNode &world, const IO::ExportOptions &options) const override;
 
     std::vector<Node *> doParseNodes(const std::string &str, MapFormat mapFormat, const vm::bbox3 &worldBounds, const std::vector<std::string> &linkedGroupsToKeep, Logger &logger) const override;
@@ -585,6 +585,49 @@ CHECK_THAT(collectTouchingNodes(allNodes, {
 );
 }
 
+TEST_CASE("ModelUtils.collectMatchingNodesInWorld")
+{
+constexpr auto worldBounds = vm::bbox3d{8192.0};
+constexpr auto mapFormat = MapFormat::Quake3;
+
+auto worldNode = WorldNode{{}, {}, mapFormat};
+const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+auto *brushNode = new BrushNode{builder.createCube(64.0, "texture").value()};
+auto *otherBrushNode = new BrushNode{builder.createCuboid(vm::bbox3d{{128, 0, 0}, {192, 64, 64}}, "texture").value()};
+auto *entityNode = new EntityNode{Entity{}};
+auto *groupNode = new GroupNode{Group{"group"}};
+groupNode->addChild(new BrushNode{builder.createCuboid(vm::bbox3d{{-192, -32, -32}, {-128, 32, 32}}, "texture").value()});
+
+worldNode.defaultLayer()->addChildren({brushNode, otherBrushNode, entityNode, groupNode});
+
+// touches both brushes, but not the entity
+auto touchesBrushes = BrushNode{builder.createCuboid(vm::bbox3d{{16, -8, -8}, {144, 8, 8}}, "texture").value()};
+
+// contains the first brush and the entity
+auto containsBrushAndEntity = BrushNode{builder.createCube(96.0, "texture").value()};
+
+// touches the group
+auto touchesGroup = BrushNode{builder.createCuboid(vm::bbox3d{{-144, -8, -8}, {-112, 8, 8}}, "texture").value()};
+
+// touches nothing
+auto touchesNothing = BrushNode{builder.createCube(16.0, "texture").value()};
+transformNode(touchesNothing, vm::translation_matrix(vm::vec3d{0, 512, 0}), worldBounds);
+
+CHECK_THAT(collectTouchingNodes(worldNode, {&touchesBrushes}), Catch::Matchers::Equals(std::vector<Node *>{brushNode, otherBrushNode}));
+CHECK_THAT(collectTouchingNodes(worldNode, {&touchesGroup}), Catch::Matchers::Equals(std::vector<Node *>{groupNode}));
+CHECK_THAT(collectTouchingNodes(worldNode, {&touchesNothing}), Catch::Matchers::Equals(std::vector<Node *>{}));
+CHECK_THAT(collectContainedNodes(worldNode, {&containsBrushAndEntity}), Catch::Matchers::Equals(std::vector<Node *>{brushNode, entityNode}));
+CHECK_THAT(collectContainedNodes(worldNode, {&touchesBrushes}), Catch::Matchers::Equals(std::vector<Node *>{}));
+
+// a query brush that is part of the world is not reported as touching itself
+CHECK_THAT(collectTouchingNodes(worldNode, {brushNode}), Catch::Matchers::Equals(std::vector<Node *>{entityNode}));
+
+const auto allQueries = std::vector<BrushNode *>{&touchesBrushes, &containsBrushAndEntity, &touchesGroup, &touchesNothing};
+CHECK_THAT(collectTouchingNodes(worldNode, allQueries), Catch::Matchers::Equals(collectTouchingNodes(std::vector<Node *>{&worldNode}, allQueries)));
+CHECK_THAT(collectContainedNodes(worldNode, allQueries), Catch::Matchers::Equals(collectContainedNodes(std::vector<Node *>{&worldNode}, allQueries)));
+}
+
 TEST_CASE("ModelUtils.collectContainedNodes")
 {
 constexpr auto worldBounds = vm::bbox3d{8192.0};
@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "Model/Brush.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/Entity.h"
+#include "Model/MapFormat.h"
+#include "Model/NodeContents.h"
+
+#include <kdl/result.h>
+
+#include <vecmath/bbox.h>
+#include <vecmath/mat.h>
+#include <vecmath/mat_ext.h>
+#include <vecmath/vec.h>
+#include <vecmath/vec_io.h>
+
+#include <variant>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+namespace Model {
+namespace {
+std::vector<std::vector<vm::vec3>> faceVertexPositions(const Brush &brush) {
+    auto result = std::vector<std::vector<vm::vec3>>{};
+    for (const auto &face : brush.faces()) {
+        result.push_back(face.vertexPositions());
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("NodeContentsTest.compactBrush") {
+    const auto worldBounds = vm::bbox3{8192.0};
+    const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+    auto brush = builder.createCube(64.0, "texture").value();
+
+    SECTION("A cuboid is restored exactly") {
+    }
+
+    SECTION("A brush with edited vertices is restored exactly") {
+        REQUIRE(brush.moveVertices(worldBounds, {vm::vec3{32, 32, 32}}, vm::vec3{-3.71, 5.33, 1.1}).is_success());
+        REQUIRE(brush.moveVertices(worldBounds, {vm::vec3{-32, -32, 32}}, vm::vec3{1.13, -2.77, -7.9}).is_success());
+    }
+
+    auto contents = NodeContents{brush};
+    const auto memoryUsage = contents.memoryUsage();
+
+    contents.compact(worldBounds);
+    REQUIRE(contents.compacted());
+    CHECK(contents.memoryUsage() < memoryUsage);
+
+    REQUIRE(contents.expand(worldBounds).is_success());
+    CHECK_FALSE(contents.compacted());
+
+    const auto &expandedBrush = std::get<Brush>(contents.get());
+    CHECK(expandedBrush == brush);
+    CHECK(expandedBrush.vertexPositions() == brush.vertexPositions());
+    CHECK(faceVertexPositions(expandedBrush) == faceVertexPositions(brush));
+}
+
+TEST_CASE("NodeContentsTest.compactKeepsIrreproducibleBrush") {
+    const auto worldBounds = vm::bbox3{8192.0};
+    const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+    auto brush = builder.createCube(64.0, "texture").value();
+
+    // move the points of a face without updating the geometry, so that rebuilding the
+    // geometry from the faces yields different vertices
+    auto &face = brush.face(0);
+    REQUIRE(face.transform(vm::translation_matrix(face.boundary().normal * 8.0), false).is_success());
+    const auto vertexPositions = brush.vertexPositions();
+
+    auto contents = NodeContents{brush};
+    contents.compact(worldBounds);
+    CHECK_FALSE(contents.compacted());
+
+    const auto &keptBrush = std::get<Brush>(contents.get());
+    CHECK(keptBrush == brush);
+    CHECK(keptBrush.vertexPositions() == vertexPositions);
+}
+
+TEST_CASE("NodeContentsTest.expandKeepsFacesIfRebuildFails") {
+    const auto worldBounds = vm::bbox3{8192.0};
+    const auto builder = BrushBuilder{MapFormat::Standard, worldBounds};
+
+    const auto brush = builder.createCube(64.0, "texture").value();
+
+    auto contents = NodeContents{brush};
+    contents.compact(worldBounds);
+    REQUIRE(contents.compacted());
+
+    // the brush is outside of these world bounds, so its geometry cannot be rebuilt
+    CHECK(contents.expand(vm::bbox3{vm::vec3{1024, 1024, 1024}, vm::vec3{2048, 2048, 2048}}).is_error());
+    CHECK(contents.compacted());
+
+    REQUIRE(contents.expand(worldBounds).is_success());
+    CHECK(std::get<Brush>(contents.get()) == brush);
+}
+
+TEST_CASE("NodeContentsTest.compactIgnoresOtherContents") {
+    auto contents = NodeContents{Entity{}};
+    contents.compact(vm::bbox3{8192.0});
+    CHECK_FALSE(contents.compacted());
+    CHECK(std::holds_alternative<Entity>(contents.get()));
+}
+} // namespace Model
+} // namespace TrenchBroom
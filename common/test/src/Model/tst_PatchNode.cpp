@@ -26,11 +26,14 @@
 #include <kdl/vector_utils.h>
 
 #include <vecmath/approx.h>
+#include <vecmath/bbox.h>
 #include <vecmath/ray.h>
 #include <vecmath/ray_io.h>
 #include <vecmath/vec.h>
 #include <vecmath/vec_io.h>
 
+#include <memory>
+
 #include "Catch2.h"
 
 namespace vm {
@@ -278,6 +281,90 @@ p
 ));
 }
 
+TEST_CASE("PatchNode.makePatchGrids") {
+    using P = BezierPatch::Point;
+
+    // clang-format off
+    const auto flatPatch = BezierPatch{3, 3, {
+        P{0, 2, 0}, P{1, 2, 0}, P{2, 2, 0},
+        P{0, 1, 0}, P{1, 1, 0}, P{2, 1, 0},
+        P{0, 0, 0}, P{1, 0, 0}, P{2, 0, 0}}, "texture"};
+    const auto hillPatch = BezierPatch{3, 5, {
+        P{0, 2, 0}, P{1, 2, 0}, P{2, 2, 0}, P{3, 2, 0}, P{4, 2, 0},
+        P{0, 1, 0}, P{1, 1, 1}, P{2, 1, 2}, P{3, 1, 1}, P{4, 1, 0},
+        P{0, 0, 0}, P{1, 0, 0}, P{2, 0, 0}, P{3, 0, 0}, P{4, 0, 0}}, "texture"};
+    // clang-format on
+
+    const auto grids = makePatchGrids({&flatPatch, &hillPatch});
+    REQUIRE(grids.size() == 2u);
+
+    CHECK(grids[0] == PatchNode{flatPatch}.grid());
+    CHECK(grids[1] == PatchNode{hillPatch}.grid());
+}
+
+TEST_CASE("PatchNode.setPatch") {
+    using P = BezierPatch::Point;
+
+    // clang-format off
+    const auto patch = BezierPatch{3, 3, {
+        P{0, 2, 0}, P{1, 2, 0}, P{2, 2, 0},
+        P{0, 1, 0}, P{1, 1, 1}, P{2, 1, 0},
+        P{0, 0, 0}, P{1, 0, 0}, P{2, 0, 0}}, "texture"};
+    // clang-format on
+
+    auto patchNode = PatchNode{patch};
+    const auto originalGrid = patchNode.grid();
+
+    SECTION("Changing only the texture keeps the grid") {
+        auto retexturedPatch = patch;
+        retexturedPatch.setTextureName("other");
+        CHECK(patchNode.hasGridOf(retexturedPatch));
+
+        patchNode.setPatch(retexturedPatch);
+        CHECK(patchNode.patch().textureName() == "other");
+        CHECK(patchNode.grid() == originalGrid);
+    }
+
+    SECTION("Moving a control point recomputes the grid") {
+        auto movedPatch = patch;
+        movedPatch.setControlPoint(1, 1, P{1, 1, 2});
+        CHECK_FALSE(patchNode.hasGridOf(movedPatch));
+
+        patchNode.setPatch(movedPatch);
+        CHECK(patchNode.hasGridOf(movedPatch));
+        CHECK(patchNode.grid() == PatchNode{movedPatch}.grid());
+        CHECK(patchNode.grid() != originalGrid);
+    }
+
+    SECTION("Setting a precomputed grid") {
+        auto movedPatch = patch;
+        movedPatch.setControlPoint(1, 1, P{1, 1, 2});
+
+        auto grids = makePatchGrids({&movedPatch});
+        const auto expectedGrid = grids.front();
+
+        const auto oldPatch = patchNode.setPatch(movedPatch, std::move(grids.front()));
+        CHECK(oldPatch == patch);
+        CHECK(patchNode.grid() == expectedGrid);
+    }
+}
+
+TEST_CASE("PatchNode.cloneKeepsGrid") {
+    using P = BezierPatch::Point;
+
+    // clang-format off
+    const auto patchNode = PatchNode{BezierPatch{3, 3, {
+        P{0, 2, 0}, P{1, 2, 0}, P{2, 2, 0},
+        P{0, 1, 0}, P{1, 1, 1}, P{2, 1, 0},
+        P{0, 0, 0}, P{1, 0, 0}, P{2, 0, 0}}, "texture"}};
+    // clang-format on
+
+    const auto worldBounds = vm::bbox3{8192.0};
+    auto clone = std::unique_ptr<PatchNode>{static_cast<PatchNode *>(patchNode.clone(worldBounds, SetLinkId::keep))};
+    CHECK(clone->patch() == patchNode.patch());
+    CHECK(clone->grid() == patchNode.grid());
+}
+
 TEST_CASE("PatchNode.pickFlatPatch")
 {
 using P = BezierPatch::Point;
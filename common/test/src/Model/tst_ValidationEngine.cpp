@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Model/EmptyPropertyKeyValidator.h"
+#include "Model/Entity.h"
+#include "Model/EntityNode.h"
+#include "Model/Issue.h"
+#include "Model/LayerNode.h"
+#include "Model/MapFormat.h"
+#include "Model/ValidationEngine.h"
+#include "Model/WorldNode.h"
+
+#include <memory>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+namespace Model {
+namespace {
+std::vector<const Issue *> validateAll(ValidationEngine &engine, WorldNode &worldNode, const size_t maxInvalidNodes, size_t &batchCount) {
+    auto issues = std::vector<const Issue *>{};
+    batchCount = 0;
+
+    engine.start(worldNode);
+    while (engine.running()) {
+        const auto batch = engine.validateNext(maxInvalidNodes);
+        issues.insert(issues.end(), batch.begin(), batch.end());
+        ++batchCount;
+    }
+    return issues;
+}
+} // namespace
+
+TEST_CASE("ValidationEngineTest.validate") {
+    auto worldNode = WorldNode{{}, {}, MapFormat::Standard};
+    worldNode.registerValidator(std::make_unique<EmptyPropertyKeyValidator>());
+
+    auto entityNodes = std::vector<EntityNode *>{};
+    for (size_t i = 0; i < 10; ++i) {
+        auto entity = i % 2 == 0 ? Entity{{}, {{"", "value"}}} : Entity{{}, {{"key", "value"}}};
+        entityNodes.push_back(new EntityNode{std::move(entity)});
+    }
+    worldNode.defaultLayer()->addChildren({entityNodes.begin(), entityNodes.end()});
+
+    auto engine = ValidationEngine{};
+    auto batchCount = size_t(0);
+
+    SECTION("Validates all nodes in batches") {
+        // the world, the default layer and the entities
+        const auto issues = validateAll(engine, worldNode, 3, batchCount);
+        CHECK(issues.size() == 5u);
+        CHECK(batchCount == 4u);
+        CHECK_FALSE(engine.running());
+
+        for (const auto *entityNode : entityNodes) {
+            CHECK(entityNode->issuesValid());
+        }
+
+        const auto &statistics = engine.statistics();
+        REQUIRE(statistics.size() == 1u);
+        CHECK(statistics.front().validator == worldNode.registeredValidators().front());
+        CHECK(statistics.front().nodeCount == 12u);
+    }
+
+    SECTION("Only validates nodes with invalid issues") {
+        validateAll(engine, worldNode, 3, batchCount);
+        entityNodes[0]->invalidateIssues();
+
+        const auto issues = validateAll(engine, worldNode, 3, batchCount);
+        CHECK(issues.size() == 5u);
+        CHECK(batchCount == 1u);
+        CHECK(engine.statistics().front().nodeCount == 1u);
+    }
+
+    SECTION("Cancelling a run") {
+        engine.start(worldNode);
+        engine.validateNext(1);
+        CHECK(engine.running());
+
+        engine.cancel();
+        CHECK_FALSE(engine.running());
+    }
+}
+} // namespace Model
+} // namespace TrenchBroom
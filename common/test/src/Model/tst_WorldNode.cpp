@@ -20,14 +20,20 @@
 #include "Model/BezierPatch.h"
 #include "Model/BrushBuilder.h"
 #include "Model/BrushNode.h"
+#include "Model/EditorContext.h"
 #include "Model/Entity.h"
 #include "Model/EntityNode.h"
 #include "Model/Group.h"
 #include "Model/GroupNode.h"
+#include "Model/Hit.h"
+#include "Model/HitAdapter.h"
+#include "Model/HitFilter.h"
+#include "Model/HitType.h"
 #include "Model/Layer.h"
 #include "Model/LayerNode.h"
 #include "Model/MapFormat.h"
 #include "Model/PatchNode.h"
+#include "Model/PickResult.h"
 #include "Model/WorldNode.h"
 #include "TestUtils.h"
 #include "octree.h"
@@ -35,6 +41,7 @@
 #include <kdl/result.h>
 #include <kdl/result_io.h>
 #include <kdl/string_utils.h>
+#include <kdl/vector_utils.h>
 
 #include <vecmath/mat.h>
 #include <vecmath/mat_ext.h>
@@ -488,6 +495,127 @@ contains(patchNode)
 );
 }
 
+TEST_CASE("WorldNodeTest.pickFirst") {
+    constexpr auto worldBounds = vm::bbox3d{8192.0};
+    constexpr auto mapFormat = MapFormat::Quake3;
+
+    auto worldNode = WorldNode{{}, {}, mapFormat};
+    const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+    // the brushes are placed in different leafs of the node tree
+    auto *brushNode1 = new BrushNode{builder.createCuboid(vm::bbox3{{32, 32, 32}, {64, 64, 64}}, "texture").value()};
+    auto *brushNode2 = new BrushNode{builder.createCuboid(vm::bbox3{{288, 32, 32}, {320, 64, 64}}, "texture").value()};
+    auto *brushNode3 = new BrushNode{builder.createCuboid(vm::bbox3{{544, 32, 32}, {576, 64, 64}}, "texture").value()};
+    worldNode.defaultLayer()->addChildren({brushNode1, brushNode2, brushNode3});
+
+    const auto editorContext = EditorContext{};
+    const auto ray = vm::ray3{{0, 48, 48}, {1, 0, 0}};
+
+    auto allHits = PickResult::byDistance();
+    worldNode.pick(editorContext, ray, allHits);
+    REQUIRE(allHits.size() == 3u);
+
+    using namespace HitFilters;
+
+    SECTION("Stops after the first hit") {
+        const auto filter = type(BrushNode::BrushHitType);
+
+        auto pickResult = PickResult::byDistance();
+        worldNode.pickFirst(editorContext, ray, filter, pickResult);
+
+        CHECK(pickResult.size() == 1u);
+        CHECK(hitToNode(pickResult.first(filter)) == brushNode1);
+    }
+
+    SECTION("Continues until a hit matches the filter") {
+        const auto filter = HitFilter{[&](const Hit &hit) { return hitToNode(hit) == brushNode2; }};
+
+        auto pickResult = PickResult::byDistance();
+        worldNode.pickFirst(editorContext, ray, filter, pickResult);
+
+        CHECK(pickResult.size() == 2u);
+        CHECK(hitToNode(pickResult.first(filter)) == brushNode2);
+    }
+
+    SECTION("Skips hits closer than the minimum distance") {
+        // like the spike guides, which start on the boundary of a brush
+        const auto rayFromBrush = vm::ray3{{64, 48, 48}, {1, 0, 0}};
+        const auto filter = type(BrushNode::BrushHitType) && minDistance(1.0);
+
+        auto pickResult = PickResult::byDistance();
+        worldNode.pickFirst(editorContext, rayFromBrush, filter, pickResult);
+
+        CHECK(hitToNode(pickResult.first(filter)) == brushNode2);
+    }
+
+    SECTION("Finds all hits if no hit matches the filter") {
+        const auto filter = none();
+
+        auto pickResult = PickResult::byDistance();
+        worldNode.pickFirst(editorContext, ray, filter, pickResult);
+
+        CHECK(pickResult.size() == 3u);
+        CHECK_FALSE(pickResult.first(filter).isMatch());
+    }
+}
+
+TEST_CASE("WorldNodeTest.pickDeferred") {
+    constexpr auto worldBounds = vm::bbox3d{8192.0};
+    constexpr auto mapFormat = MapFormat::Quake3;
+
+    auto worldNode = WorldNode{{}, {}, mapFormat};
+    const auto builder = BrushBuilder{mapFormat, worldBounds};
+
+    auto *brushNode1 = new BrushNode{builder.createCuboid(vm::bbox3{{32, 32, 32}, {64, 64, 64}}, "texture").value()};
+    auto *brushNode2 = new BrushNode{builder.createCuboid(vm::bbox3{{288, 32, 32}, {320, 64, 64}}, "texture").value()};
+    auto *brushNode3 = new BrushNode{builder.createCuboid(vm::bbox3{{544, 32, 32}, {576, 64, 64}}, "texture").value()};
+    worldNode.defaultLayer()->addChildren({brushNode1, brushNode2, brushNode3});
+
+    const auto editorContext = EditorContext{};
+    const auto ray = vm::ray3{{0, 48, 48}, {1, 0, 0}};
+
+    using namespace HitFilters;
+    const auto brushFilter = type(BrushNode::BrushHitType);
+
+    // like the tool box pick in the 3D views
+    auto pickCount = 0;
+    auto pickResult = PickResult::byDistance();
+    worldNode.pick(editorContext, ray, pickResult);
+    pickResult.deferHitsAfter(pickResult.first(brushFilter).distance(), [&](auto &deferredPickResult) {
+        ++pickCount;
+        worldNode.pick(editorContext, ray, deferredPickResult);
+    });
+
+    // a hit that a tool adds after the nodes were picked
+    const auto toolHitType = HitType::freeType();
+    pickResult.addHit(Hit{toolHitType, 16.0, vm::vec3{16, 48, 48}, 0});
+
+    SECTION("The closest hit does not pick the deferred hits") {
+        CHECK(hitToNode(pickResult.first(brushFilter)) == brushNode1);
+        CHECK(hitToNode(pickResult.first(brushFilter && minDistance(1.0))) == brushNode1);
+        CHECK(pickResult.first(type(toolHitType)).distance() == 16.0);
+        CHECK(pickCount == 0);
+    }
+
+    SECTION("Hits further along the ray are picked when needed") {
+        const auto &closestHit = pickResult.first(brushFilter);
+
+        const auto filter = HitFilter{[&](const Hit &hit) { return hitToNode(hit) == brushNode3; }};
+        CHECK(hitToNode(pickResult.first(filter)) == brushNode3);
+        CHECK(pickCount == 1);
+
+        // hits returned before remain valid
+        CHECK(hitToNode(closestHit) == brushNode1);
+    }
+
+    SECTION("Querying all hits picks the deferred hits once") {
+        const auto hits = pickResult.all(brushFilter);
+        CHECK(kdl::vec_transform(hits, [](const auto &hit) { return hitToNode(hit); }) == std::vector<Node *>{brushNode1, brushNode2, brushNode3});
+        CHECK(pickResult.size() == 4u);
+        CHECK(pickCount == 1);
+    }
+}
+
 TEST_CASE("WorldNodeTest.disableNodeTreeUpdates")
 {
 constexpr auto worldBounds = vm::bbox3d{8192.0};
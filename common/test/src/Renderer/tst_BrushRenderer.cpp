@@ -0,0 +1,231 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Error.h"
+#include "Model/BrushBuilder.h"
+#include "Model/BrushFace.h"
+#include "Model/BrushNode.h"
+#include "Model/EditorContext.h"
+#include "Model/MapFormat.h"
+#include "PreferenceManager.h"
+#include "Renderer/BrushRenderer.h"
+#include "TestPreferenceManager.h"
+
+#include <kdl/invoke.h>
+#include <kdl/result.h>
+#include <kdl/vector_utils.h>
+
+#include <vm/bbox.h>
+#include <vm/mat_ext.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom::Renderer {
+namespace {
+/**
+ * Marks the faces of unselected brushes like the map renderer does, which reads
+ * preferences through the editor context.
+ */
+class UnselectedBrushFilter : public BrushRenderer::DefaultFilter {
+  public:
+    explicit UnselectedBrushFilter(const Model::EditorContext &context) : DefaultFilter{context} {
+    }
+
+    RenderSettings markFaces(const Model::BrushNode &brushNode) const override {
+        if (!visible(brushNode) || selected(brushNode)) {
+            return renderNothing();
+        }
+
+        for (const auto &face : brushNode.brush().faces()) {
+            face.setMarked(visible(brushNode, face));
+        }
+        return {FaceRenderPolicy::RenderMarked, EdgeRenderPolicy::RenderAll};
+    }
+};
+
+/**
+ * Counts the preferences that are read, and those that are read on another thread than
+ * the one that created this preference manager.
+ */
+class ThreadCheckingPreferenceManager : public TestPreferenceManager {
+  private:
+    std::thread::id m_mainThreadId{std::this_thread::get_id()};
+    std::atomic<size_t> m_reads{0};
+    std::atomic<size_t> m_readsOffMainThread{0};
+
+  public:
+    size_t reads() const {
+        return m_reads;
+    }
+
+    size_t readsOffMainThread() const {
+        return m_readsOffMainThread;
+    }
+
+  private:
+    void validatePreference(PreferenceBase &preference) override {
+        ++m_reads;
+        if (std::this_thread::get_id() != m_mainThreadId) {
+            ++m_readsOffMainThread;
+        }
+        preference.setValid(true);
+    }
+};
+
+std::vector<Model::BrushNode *> makeBrushNodes(const size_t count) {
+    const auto worldBounds = vm::bbox3{8192.0};
+    auto builder = Model::BrushBuilder{Model::MapFormat::Standard, worldBounds};
+
+    auto brushNodes = std::vector<Model::BrushNode *>{};
+    for (size_t i = 0; i < count; ++i) {
+        auto brush = builder.createCube(32.0, "some_texture").value();
+        REQUIRE(brush.transform(worldBounds, vm::translation_matrix(vm::vec3{double(i % 32) * 64.0, double(i / 32) * 64.0, 0.0}), false).is_success());
+        brushNodes.push_back(new Model::BrushNode{std::move(brush)});
+    }
+    return brushNodes;
+}
+
+size_t countEdgeIndices(const std::vector<const Model::BrushNode *> &brushNodes) {
+    auto result = size_t(0);
+    for (const auto *brushNode : brushNodes) {
+        result += 2u * brushNode->brush().edgeCount();
+    }
+    return result;
+}
+
+size_t countIndices(const std::vector<BrushIndexArray::IndexRange> &ranges) {
+    auto result = size_t(0);
+    for (const auto &[offset, count] : ranges) {
+        result += count;
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("BrushRenderer.validateReadsPreferencesOnMainThread") {
+    // The application's preference manager must only be used on the main thread.
+    PreferenceManager::createInstance<ThreadCheckingPreferenceManager>();
+    auto restorePreferenceManager = kdl::invoke_later{[]() {
+        PreferenceManager::createInstance<TestPreferenceManager>();
+    }};
+    auto &preferenceManager = dynamic_cast<ThreadCheckingPreferenceManager &>(PreferenceManager::instance());
+
+    // enough brushes to validate their vertex caches on several threads
+    auto brushNodes = makeBrushNodes(1024);
+
+    auto editorContext = Model::EditorContext{};
+    auto renderer = BrushRenderer{UnselectedBrushFilter{editorContext}};
+    for (const auto *brushNode : brushNodes) {
+        renderer.addBrush(brushNode);
+    }
+
+    REQUIRE_FALSE(renderer.valid());
+    renderer.validate();
+    CHECK(renderer.valid());
+
+    CHECK(preferenceManager.reads() > 0u);
+    CHECK(preferenceManager.readsOffMainThread() == 0u);
+
+    for (const auto *brushNode : brushNodes) {
+        for (const auto &face : brushNode->brush().faces()) {
+            CHECK(face.isMarked());
+        }
+    }
+
+    renderer.clear();
+    kdl::vec_clear_and_delete(brushNodes);
+}
+
+TEST_CASE("BrushRenderer.setVisibleBrushes") {
+    auto brushNodes = makeBrushNodes(256);
+
+    auto renderer = BrushRenderer{};
+    for (const auto *brushNode : brushNodes) {
+        renderer.addBrush(brushNode);
+    }
+
+    SECTION("All edges are drawn if no visible brushes are set") {
+        renderer.setVisibleBrushes(nullptr);
+        CHECK(renderer.edgeRenderRanges() == nullptr);
+    }
+
+    SECTION("Only the edges of the visible brushes are drawn") {
+        auto visibleBrushes = VisibleBrushes{{brushNodes[0], brushNodes[2], brushNodes[100]}, 1};
+        renderer.setVisibleBrushes(&visibleBrushes);
+
+        const auto ranges = renderer.edgeRenderRanges();
+        REQUIRE(ranges != nullptr);
+        CHECK(countIndices(*ranges) == countEdgeIndices({brushNodes[0], brushNodes[2], brushNodes[100]}));
+
+        SECTION("The ranges are reused while the visible brushes do not change") {
+            renderer.setVisibleBrushes(&visibleBrushes);
+            CHECK(renderer.edgeRenderRanges() == ranges);
+        }
+
+        SECTION("The ranges are updated when the visible brushes change") {
+            visibleBrushes.brushes.insert(brushNodes[200]);
+            visibleBrushes.version = 2;
+            renderer.setVisibleBrushes(&visibleBrushes);
+
+            const auto updatedRanges = renderer.edgeRenderRanges();
+            REQUIRE(updatedRanges != nullptr);
+            CHECK(countIndices(*updatedRanges) == countEdgeIndices({brushNodes[0], brushNodes[2], brushNodes[100], brushNodes[200]}));
+        }
+
+        SECTION("The ranges are updated when a visible brush is removed") {
+            renderer.removeBrush(brushNodes[2]);
+
+            const auto updatedRanges = renderer.edgeRenderRanges();
+            REQUIRE(updatedRanges != nullptr);
+            CHECK(countIndices(*updatedRanges) == countEdgeIndices({brushNodes[0], brushNodes[100]}));
+        }
+
+        SECTION("All edges are drawn again if the visible brushes are unset") {
+            renderer.setVisibleBrushes(nullptr);
+            CHECK(renderer.edgeRenderRanges() == nullptr);
+        }
+    }
+
+    SECTION("No edges are drawn if no brush is visible") {
+        auto visibleBrushes = VisibleBrushes{{}, 1};
+        renderer.setVisibleBrushes(&visibleBrushes);
+
+        const auto ranges = renderer.edgeRenderRanges();
+        REQUIRE(ranges != nullptr);
+        CHECK(ranges->empty());
+    }
+
+    SECTION("All edges are drawn if most brushes are visible") {
+        auto visibleBrushes = VisibleBrushes{{}, 1};
+        for (size_t i = 0; i < 200; ++i) {
+            visibleBrushes.brushes.insert(brushNodes[i]);
+        }
+        renderer.setVisibleBrushes(&visibleBrushes);
+        CHECK(renderer.edgeRenderRanges() == nullptr);
+    }
+
+    renderer.clear();
+    kdl::vec_clear_and_delete(brushNodes);
+}
+
+} // namespace TrenchBroom::Renderer
@@ -23,13 +23,17 @@
 #include "IO/TestEnvironment.h"
 #include "Logger.h"
 #include "Model/BrushNode.h"
+#include "Model/Game.h"
 #include "Model/LayerNode.h"
+#include "Model/WorldNode.h"
 #include "TestUtils.h"
 #include "View/Autosaver.h"
 #include "View/MapDocumentTest.h"
 
 #include <chrono>
 #include <filesystem>
+#include <sstream>
+#include <string>
 #include <thread>
 
 #include "Catch2.h"
@@ -298,5 +302,91 @@ triggerAutosave(logger);
 
 CHECK(env
 .fileExists("autosave/test.2.map"));
-}} // namespace View
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverSavesAsynchronously") {
+    using namespace std::literals::chrono_literals;
+
+    IO::TestEnvironment env;
+    NullLogger logger;
+
+    document->saveDocumentAs(env.dir() / "test.map");
+    assert(env.fileExists("test.map"));
+
+    Autosaver autosaver(document, 0s, 50, AutosaveMode::Asynchronous);
+
+    // modify the map
+    document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
+
+    autosaver.triggerAutosave(logger);
+    autosaver.finishAutosave(logger);
+    CHECK_FALSE(autosaver.autosaveInProgress());
+
+    CHECK(env.fileExists("autosave/test.1.map"));
+    CHECK(env.loadFile("autosave/test.1.map").find("some_texture") != std::string::npos);
+    CHECK_FALSE(env.fileExists("autosave/test.tmp"));
+
+    // the map was not modified since the last autosave
+    autosaver.triggerAutosave(logger);
+    autosaver.finishAutosave(logger);
+    CHECK_FALSE(env.fileExists("autosave/test.2.map"));
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverWritesSnapshotAsynchronously") {
+    using namespace std::literals::chrono_literals;
+
+    IO::TestEnvironment env;
+    NullLogger logger;
+
+    document->saveDocumentAs(env.dir() / "test.map");
+    assert(env.fileExists("test.map"));
+
+    Autosaver autosaver(document, 0s, 50, AutosaveMode::Asynchronous);
+
+    // modify the map, and add a group so that the backup contains persistent IDs
+    auto *brushNode = createBrushNode("some_texture");
+    document->addNodes({{document->currentLayer(), {brushNode}}});
+    document->selectNodes({brushNode});
+    document->groupSelection("some_group");
+    document->deselectAll();
+
+    auto expectedContents = std::ostringstream{};
+    document->game()->writeMapToStream(*document->world(), expectedContents);
+
+    autosaver.triggerAutosave(logger);
+
+    // edits made while the backup is written do not end up in it
+    document->addNodes({{document->currentLayer(), {createBrushNode("other_texture")}}});
+
+    autosaver.finishAutosave(logger);
+
+    REQUIRE(env.fileExists("autosave/test.1.map"));
+    CHECK(env.loadFile("autosave/test.1.map") == expectedContents.str());
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "MapDocumentTest.autosaverIgnoresIncompleteBackup") {
+    using namespace std::literals::chrono_literals;
+
+    IO::TestEnvironment env;
+    env.createDirectory("autosave");
+    env.createFile("autosave/test.1.map", "some content");
+    env.createFile("autosave/test.tmp", "incomplete content");
+
+    NullLogger logger;
+
+    document->saveDocumentAs(env.dir() / "test.map");
+    assert(env.fileExists("test.map"));
+
+    Autosaver autosaver(document, 0s);
+
+    // modify the map
+    document->addNodes({{document->currentLayer(), {createBrushNode("some_texture")}}});
+
+    autosaver.triggerAutosave(logger);
+
+    CHECK(env.loadFile("autosave/test.1.map") == "some content");
+    CHECK(env.fileExists("autosave/test.2.map"));
+    CHECK_FALSE(env.fileExists("autosave/test.tmp"));
+}
+} // namespace View
 } // namespace TrenchBroom
@@ -234,6 +234,42 @@ public:
 };
 
 
+class SizedCommand : public UndoableCommand
+{
+private:
+  size_t m_memoryUsage;
+  bool m_compacted = false;
+
+public:
+  SizedCommand(std::string name, const size_t memoryUsage)
+    : UndoableCommand{std::move(name), false}
+    , m_memoryUsage{memoryUsage}
+  {
+  }
+
+  std::unique_ptr<CommandResult> doPerformDo(MapDocumentCommandFacade*) override
+  {
+    return std::make_unique<CommandResult>(true);
+  }
+
+  std::unique_ptr<CommandResult> doPerformUndo(MapDocumentCommandFacade*) override
+  {
+    return std::make_unique<CommandResult>(true);
+  }
+
+  size_t doGetMemoryUsage() const override { return m_memoryUsage; }
+
+  void doCompact(MapDocumentCommandFacade*) override
+  {
+    if (!m_compacted)
+    {
+      m_memoryUsage /= 2;
+      m_compacted = true;
+    }
+  }
+};
+
+
 class NullCommand : public UndoableCommand
 {
 public:
@@ -1320,5 +1356,85 @@ TEST_CASE("CommandProcessorTest.collateTransactions")
 
     undo();
 }
+
+TEST_CASE("CommandProcessorTest.undoMemoryBudget")
+{
+  auto commandProcessor = CommandProcessor{nullptr};
+  commandProcessor.setUndoMemoryBudget(250);
+
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 1", 100));
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 2", 100));
+  CHECK(commandProcessor.undoStackMemoryUsage() == 200);
+
+  // the oldest command is removed when the budget is exceeded
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 3", 100));
+  CHECK(commandProcessor.undoStackMemoryUsage() == 200);
+
+  CHECK(commandProcessor.undo()->success());
+  CHECK(commandProcessor.undoStackMemoryUsage() == 100);
+  CHECK(commandProcessor.redoStackMemoryUsage() == 100);
+
+  CHECK(commandProcessor.undo()->success());
+  CHECK_FALSE(commandProcessor.canUndo());
+  CHECK(commandProcessor.undoStackMemoryUsage() == 0);
+  CHECK(commandProcessor.redoStackMemoryUsage() == 200);
+
+  CHECK(commandProcessor.redo()->success());
+  CHECK(commandProcessor.redo()->success());
+  CHECK(commandProcessor.undoStackMemoryUsage() == 200);
+  CHECK(commandProcessor.redoStackMemoryUsage() == 0);
+
+  SECTION("The most recent command is kept even if it exceeds the budget")
+  {
+    commandProcessor.setUndoMemoryBudget(50);
+    CHECK(commandProcessor.undoStackMemoryUsage() == 100);
+    REQUIRE(commandProcessor.canUndo());
+    CHECK(commandProcessor.undoCommandName() == "command 3");
+  }
+
+  SECTION("Transactions count the memory of their commands")
+  {
+    commandProcessor.startTransaction("transaction", TransactionScope::Oneshot);
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 4", 10));
+    commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 5", 10));
+    commandProcessor.commitTransaction();
+
+    // command 2 is removed to make room for the transaction
+    CHECK(commandProcessor.undoStackMemoryUsage() > 120);
+    CHECK(commandProcessor.undoStackMemoryUsage() <= 250);
+    CHECK(commandProcessor.undoCommandName() == "transaction");
+
+    CHECK(commandProcessor.undo()->success());
+    CHECK(commandProcessor.undoCommandName() == "command 3");
+    CHECK(commandProcessor.undo()->success());
+    CHECK_FALSE(commandProcessor.canUndo());
+  }
+}
+
+TEST_CASE("CommandProcessorTest.compactOldCommands")
+{
+  auto commandProcessor =
+    CommandProcessor{nullptr, std::chrono::milliseconds{1000}, 2};
+
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 1", 100));
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 2", 100));
+  CHECK(commandProcessor.undoStackMemoryUsage() == 200);
+
+  // command 1 is no longer among the two most recent commands
+  commandProcessor.executeAndStore(std::make_unique<SizedCommand>("command 3", 100));
+  CHECK(commandProcessor.undoStackMemoryUsage() == 250);
+
+  // undoing and redoing the most recent commands does not compact them
+  CHECK(commandProcessor.undo()->success());
+  CHECK(commandProcessor.undo()->success());
+  CHECK(commandProcessor.undoStackMemoryUsage() == 50);
+  CHECK(commandProcessor.redoStackMemoryUsage() == 200);
+
+  CHECK(commandProcessor.redo()->success());
+  CHECK(commandProcessor.undoStackMemoryUsage() == 150);
+
+  CHECK(commandProcessor.redo()->success());
+  CHECK(commandProcessor.undoStackMemoryUsage() == 250);
+}
 } // namespace View
 } // namespace TrenchBroom
@@ -37,6 +37,7 @@
 
 #include <kdl/memory_utils.h>
 #include <kdl/result.h>
+#include <kdl/vector_utils.h>
 
 #include <vecmath/bbox.h>
 #include <vecmath/bbox_io.h>
@@ -491,5 +492,63 @@ group()
 transformation()
 
 ));
-}} // namespace View
+}
+
+TEST_CASE_METHOD(MapDocumentTest, "SwapNodeContentsTest.restoreCompactedBrushes") {
+    auto *brushNode = createBrushNode();
+    document->addNodes({{document->parentForNodes(), {brushNode}}});
+
+    SECTION("Cuboid") {
+    }
+
+    SECTION("Brush with edited vertices") {
+        document->selectNodes({brushNode});
+        REQUIRE(document->moveVertices({vm::vec3{16, 16, 16}}, vm::vec3{-3.71, 5.33, 1.1}).success);
+        REQUIRE(document->moveVertices({vm::vec3{-16, -16, 16}}, vm::vec3{1.13, -2.77, -7.9}).success);
+        document->deselectAll();
+    }
+
+    const auto faceVertexPositions = [](const Model::Brush &brush) {
+        return kdl::vec_transform(brush.faces(), [](const auto &face) { return face.vertexPositions(); });
+    };
+
+    const auto originalBrush = brushNode->brush();
+    const auto originalVertexPositions = faceVertexPositions(originalBrush);
+
+    auto modifiedBrush = originalBrush;
+    REQUIRE(modifiedBrush.transform(document->worldBounds(), vm::translation_matrix(vm::vec3{16, 0, 0}), false).is_success());
+    const auto modifiedVertexPositions = faceVertexPositions(modifiedBrush);
+
+    auto nodesToSwap = std::vector<std::pair<Model::Node *, Model::NodeContents>>{};
+    nodesToSwap.emplace_back(brushNode, modifiedBrush);
+    document->swapNodeContents("Swap Nodes", std::move(nodesToSwap), {});
+
+    // the swap command is compacted once enough commands were executed after it
+    const auto addBrushNode = [&]() {
+        const auto memoryUsage = document->commandHistoryMemoryUsage();
+        document->addNodes({{document->parentForNodes(), {createBrushNode()}}});
+        return document->commandHistoryMemoryUsage() - memoryUsage;
+    };
+
+    const auto addedMemoryUsage = addBrushNode();
+    for (size_t i = 0; i < 6; ++i) {
+        addBrushNode();
+    }
+    CHECK(addBrushNode() < addedMemoryUsage);
+
+    for (size_t i = 0; i < 8; ++i) {
+        document->undoCommand();
+    }
+
+    for (size_t i = 0; i < 2; ++i) {
+        document->undoCommand();
+        CHECK(brushNode->brush() == originalBrush);
+        CHECK(faceVertexPositions(brushNode->brush()) == originalVertexPositions);
+
+        document->redoCommand();
+        CHECK(brushNode->brush() == modifiedBrush);
+        CHECK(faceVertexPositions(brushNode->brush()) == modifiedVertexPositions);
+    }
+}
+} // namespace View
 } // namespace TrenchBroom
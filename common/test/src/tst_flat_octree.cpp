@@ -0,0 +1,240 @@
+/*
+ Copyright (C) 2023 Kristian Duske
+
+ This file is part of TrenchBroom.
+
+ TrenchBroom is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ TrenchBroom is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with TrenchBroom. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "flat_octree.h"
+#include "octree.h"
+
+#include <vecmath/bbox.h>
+#include <vecmath/forward.h>
+#include <vecmath/plane.h>
+#include <vecmath/ray.h>
+#include <vecmath/vec.h>
+
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "Catch2.h"
+
+namespace TrenchBroom {
+namespace {
+std::vector<vm::bbox3d> makeBounds(const size_t count, std::mt19937 &rng) {
+    auto coord = std::uniform_real_distribution<double>{-1024.0, 1024.0};
+    auto extent = std::uniform_real_distribution<double>{1.0, 128.0};
+
+    auto result = std::vector<vm::bbox3d>{};
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto min = vm::vec3d{coord(rng), coord(rng), coord(rng)};
+        result.emplace_back(min, min + vm::vec3d{extent(rng), extent(rng), extent(rng)});
+    }
+    return result;
+}
+
+std::vector<vm::ray3d> makeRays(const size_t count, std::mt19937 &rng) {
+    auto coord = std::uniform_real_distribution<double>{-1024.0, 1024.0};
+    auto direction = std::uniform_real_distribution<double>{-1.0, 1.0};
+
+    auto result = std::vector<vm::ray3d>{};
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.emplace_back(vm::vec3d{coord(rng), coord(rng), coord(rng)}, vm::normalize(vm::vec3d{direction(rng), direction(rng), direction(rng)}));
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("flat_octree.insert")
+{
+    auto tree = flat_octree<double, int>{32.0};
+    CHECK(tree.empty());
+
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+    CHECK(tree.contains(1));
+    CHECK(tree.size() == 1u);
+
+    // grows the root
+    tree.insert({{-512, -512, -512}, {-480, -480, -480}}, 2);
+    CHECK(tree.contains(1));
+    CHECK(tree.contains(2));
+    CHECK(tree.size() == 2u);
+
+    // more items than fit into a node's inline storage
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 3);
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 4);
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 5);
+    CHECK(tree.size() == 5u);
+
+    CHECK_THAT(tree.find_containers({48, 48, 48}), Catch::UnorderedEquals(std::vector<int>{1, 3, 4, 5}));
+    CHECK(tree.find_containers({-500, -500, -500}) == std::vector<int>{2});
+}
+
+TEST_CASE("flat_octree.insert_duplicate")
+{
+    auto tree = flat_octree<double, int>{32.0};
+
+    tree.insert(vm::bbox3d{{0, 0, 0}, {2, 1, 1}}, 1);
+    REQUIRE(tree.contains(1));
+
+    CHECK_THROWS_AS(tree.insert(vm::bbox3d{{0, 0, 0}, {2, 1, 1}}, 1), NodeTreeException);
+
+    CHECK(tree.contains(1));
+    CHECK(tree.size() == 1u);
+}
+
+TEST_CASE("flat_octree.remove")
+{
+    auto tree = flat_octree<double, int>{32.0};
+
+    CHECK_FALSE(tree.remove(1));
+
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 2);
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 3);
+    tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 4);
+
+    CHECK(tree.remove(2));
+    CHECK_FALSE(tree.contains(2));
+    CHECK_FALSE(tree.remove(2));
+    CHECK_THAT(tree.find_containers({48, 48, 48}), Catch::UnorderedEquals(std::vector<int>{1, 3}));
+
+    CHECK(tree.remove(4));
+    CHECK(tree.find_containers({-48, -48, -48}).empty());
+
+    CHECK(tree.remove(1));
+    CHECK(tree.remove(3));
+    CHECK(tree.empty());
+    CHECK(tree.find_containers({48, 48, 48}).empty());
+}
+
+TEST_CASE("flat_octree.update")
+{
+    auto tree = flat_octree<double, int>{32.0};
+
+    CHECK_THROWS_AS(tree.update({{0, 0, 0}, {1, 1, 1}}, 1), NodeTreeException);
+
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+    tree.update({{36, 36, 36}, {60, 60, 60}}, 1);
+    CHECK(tree.find_containers({48, 48, 48}) == std::vector<int>{1});
+
+    tree.update({{-64, -64, -64}, {-32, -32, -32}}, 1);
+    CHECK(tree.find_containers({48, 48, 48}).empty());
+    CHECK(tree.find_containers({-48, -48, -48}) == std::vector<int>{1});
+    CHECK(tree.size() == 1u);
+}
+
+TEST_CASE("flat_octree.find_intersectors")
+{
+    auto tree = flat_octree<double, int>{32.0};
+
+    SECTION("empty tree")
+    {
+        CHECK(tree.find_intersectors(vm::ray3d{{0, 0, 0}, {1, 0, 0}}).empty());
+        CHECK(tree.find_intersectors(vm::bbox3d{{0, 0, 0}, {1, 1, 1}}).empty());
+    }
+
+    SECTION("single node")
+    {
+        tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+
+        CHECK(tree.find_intersectors(vm::ray3d{{48, 48, 0}, {0, 0, -1}}).empty());
+        CHECK(tree.find_intersectors(vm::ray3d{{48, 48, 48}, {0, 0, -1}}) == std::vector<int>{1});
+        CHECK(tree.find_intersectors(vm::ray3d{{48, 48, 0}, {0, 0, 1}}) == std::vector<int>{1});
+
+        CHECK(tree.find_intersectors(vm::bbox3d{{0, 0, 0}, {16, 16, 16}}).empty());
+        CHECK(tree.find_intersectors(vm::bbox3d{{40, 40, 40}, {80, 80, 80}}) == std::vector<int>{1});
+    }
+}
+
+TEST_CASE("flat_octree.find_volume_intersectors")
+{
+    using plane = vm::plane<double, 3>;
+
+    auto tree = flat_octree<double, int>{32.0};
+    tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+    tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 2);
+
+    CHECK_THAT(tree.find_volume_intersectors(std::vector<plane>{}), Catch::UnorderedEquals(std::vector<int>{1, 2}));
+    CHECK(tree.find_volume_intersectors(std::vector<plane>{{0, {1, 0, 0}}}) == std::vector<int>{2});
+    CHECK(tree.find_volume_intersectors(std::vector<plane>{{0, {-1, 0, 0}}}) == std::vector<int>{1});
+    CHECK(tree.find_volume_intersectors(std::vector<plane>{{16, {1, 0, 0}}, {16, {-1, 0, 0}}}).empty());
+}
+
+TEST_CASE("flat_octree.matches_octree")
+{
+    auto rng = std::mt19937{42};
+    const auto bounds = makeBounds(500, rng);
+    const auto rays = makeRays(50, rng);
+    const auto boxes = makeBounds(50, rng);
+
+    auto reference = octree<double, int>{64.0};
+    auto tree = flat_octree<double, int>{64.0};
+
+    const auto visitFrontToBack = [](const auto &t, const vm::ray3d &ray) {
+        auto result = std::vector<int>{};
+        t.visit_intersectors_front_to_back(ray, [&](const int i) { result.push_back(i); }, []() {
+            return std::numeric_limits<double>::max();
+        });
+        return result;
+    };
+
+    const auto checkQueries = [&]() {
+        const auto batchedRayResults = tree.batch_find_intersectors(rays);
+        REQUIRE(batchedRayResults.size() == rays.size());
+        for (size_t i = 0; i < rays.size(); ++i) {
+            const auto expected = reference.find_intersectors(rays[i]);
+            CHECK_THAT(tree.find_intersectors(rays[i]), Catch::UnorderedEquals(expected));
+            CHECK_THAT(batchedRayResults[i], Catch::UnorderedEquals(expected));
+            CHECK_THAT(visitFrontToBack(reference, rays[i]), Catch::UnorderedEquals(expected));
+            CHECK_THAT(visitFrontToBack(tree, rays[i]), Catch::UnorderedEquals(expected));
+        }
+
+        const auto batchedBoxResults = tree.batch_find_intersectors(boxes);
+        REQUIRE(batchedBoxResults.size() == boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            const auto expected = reference.find_intersectors(boxes[i]);
+            CHECK_THAT(tree.find_intersectors(boxes[i]), Catch::UnorderedEquals(expected));
+            CHECK_THAT(batchedBoxResults[i], Catch::UnorderedEquals(expected));
+        }
+    };
+
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        reference.insert(bounds[i], int(i));
+        tree.insert(bounds[i], int(i));
+    }
+    CHECK(tree.size() == bounds.size());
+    checkQueries();
+
+    // move every other item
+    const auto newBounds = makeBounds(bounds.size(), rng);
+    for (size_t i = 0; i < bounds.size(); i += 2) {
+        reference.update(newBounds[i], int(i));
+        tree.update(newBounds[i], int(i));
+    }
+    checkQueries();
+
+    // remove every third item
+    for (size_t i = 0; i < bounds.size(); i += 3) {
+        CHECK(reference.remove(int(i)));
+        CHECK(tree.remove(int(i)));
+    }
+    checkQueries();
+}
+} // namespace TrenchBroom
@@ -21,8 +21,12 @@
 
 #include <kdl/string_utils.h>
 
+#include <limits>
+#include <vector>
+
 #include <vecmath/bbox.h>
 #include <vecmath/forward.h>
+#include <vecmath/plane.h>
 #include <vecmath/ray.h>
 #include <vecmath/vec.h>
 
@@ -542,6 +546,79 @@ TEST_CASE("octree.find_intersectors")
     }
 }
 
+TEST_CASE("octree.visit_intersectors_front_to_back")
+{
+    auto tree = octree<double, int>{32.0};
+
+    const auto visit = [&](const vm::ray3d &ray, const auto &getMaxDistance) {
+        auto result = std::vector<int>{};
+        tree.visit_intersectors_front_to_back(ray, [&](const int i) { result.push_back(i); }, [&]() { return getMaxDistance(result); });
+        return result;
+    };
+    const auto unlimited = [](const auto &) { return std::numeric_limits<double>::max(); };
+
+    SECTION("empty tree")
+    {
+        CHECK(visit({{0, 0, 0}, {1, 0, 0}}, unlimited).empty());
+    }
+
+    SECTION("three nodes along the x axis")
+    {
+        tree.insert({{160, 32, 32}, {192, 64, 64}}, 3);
+        tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+        tree.insert({{96, 32, 32}, {128, 64, 64}}, 2);
+
+        // the nodes are visited in the order in which the ray enters them
+        CHECK(visit({{0, 48, 48}, {1, 0, 0}}, unlimited) == std::vector<int>{1, 2, 3});
+        CHECK(visit({{256, 48, 48}, {-1, 0, 0}}, unlimited) == std::vector<int>{3, 2, 1});
+
+        // the ray misses all nodes
+        CHECK(visit({{0, 48, 48}, {-1, 0, 0}}, unlimited).empty());
+
+        // the traversal stops at the maximum distance
+        CHECK(visit({{0, 48, 48}, {1, 0, 0}}, [](const auto &) { return 100.0; }) == std::vector<int>{1, 2});
+
+        // the traversal stops after the first node
+        CHECK(visit({{0, 48, 48}, {1, 0, 0}}, [](const auto &result) {
+            return result.empty() ? std::numeric_limits<double>::max() : 0.0;
+        }) == std::vector<int>{1});
+    }
+}
+
+TEST_CASE("octree.find_volume_intersectors")
+{
+    using plane = vm::plane<double, 3>;
+
+    auto tree = octree<double, int>{32.0};
+
+    SECTION("empty tree")
+    {
+        CHECK(tree.find_volume_intersectors(std::vector<plane>{{0, {1, 0, 0}}}).empty());
+    }
+
+    SECTION("two nodes")
+    {
+        tree.insert({{32, 32, 32}, {64, 64, 64}}, 1);
+        tree.insert({{-64, -64, -64}, {-32, -32, -32}}, 2);
+        REQUIRE(tree.size() == 2u);
+
+        // no planes means an unbounded volume
+        CHECK_THAT(tree.find_volume_intersectors(std::vector<plane>{}), Catch::UnorderedEquals(std::vector<int>{1, 2}));
+
+        // the half space below x = 0
+        CHECK(tree.find_volume_intersectors(std::vector<plane>{{0, {1, 0, 0}}}) == std::vector<int>{2});
+
+        // the half space above x = 0
+        CHECK(tree.find_volume_intersectors(std::vector<plane>{{0, {-1, 0, 0}}}) == std::vector<int>{1});
+
+        // a slab between x = -16 and x = 16 touches neither leaf
+        CHECK(tree.find_volume_intersectors(std::vector<plane>{{16, {1, 0, 0}}, {16, {-1, 0, 0}}}).empty());
+
+        // a slab between x = 16 and x = 48 only contains the first leaf
+        CHECK(tree.find_volume_intersectors(std::vector<plane>{{48, {1, 0, 0}}, {-16, {-1, 0, 0}}}) == std::vector<int>{1});
+    }
+}
+
 TEST_CASE("octree.find_containers")
 {
     auto tree = octree<double, int>{32.0};
@@ -21,15 +21,15 @@
 #pragma once
 
 #include "kdl/string_compare.h"
-#include "kdl/string_format.h"
-#include "kdl/vector_utils.h"
 
+#include <algorithm>
 #include <cassert>
-#include <exception>
-#include <set>
+#include <limits>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace kdl
@@ -64,21 +64,159 @@ namespace kdl
  * - { key: "test, values: { "test value" } }
  *   - { key: "ing, values: { "testing testing" } }
  *
+ * All nodes are stored in a single vector and refer to each other by their index in that
+ * vector. The root node is always stored at index 0. Removed nodes are put on a free list
+ * and reused by later insertions. Each node stores its children in an array that is
+ * sorted by the first character of the children's keys, so that a child can be found by
+ * binary search without touching the other child nodes.
+ *
  * @tparam V the type of the values associated with each node
  */
 template <typename V>
 class compact_trie
 {
 private:
-  struct node_cmp;
-  class node;
+  using node_index = std::size_t;
+
+  static constexpr node_index no_node = std::numeric_limits<node_index>::max();
+  static constexpr node_index root_node = 0u;
+
+  /**
+   * The values stored in a node, each with the number of times it was stored. Most nodes
+   * only store a few distinct values, so these are kept in a vector that is searched
+   * linearly. Once a node stores more than `max_linear_values` distinct values, they are
+   * moved into a hash map.
+   */
+  class value_list
+  {
+  private:
+    static constexpr std::size_t max_linear_values = 8u;
+
+    std::vector<std::pair<V, std::size_t>> m_linear;
+    std::unordered_map<V, std::size_t> m_hashed;
+
+  public:
+    bool empty() const { return m_linear.empty() && m_hashed.empty(); }
+
+    void insert(const V& value)
+    {
+      if (!m_hashed.empty())
+      {
+        ++m_hashed[value];
+        return;
+      }
+
+      for (auto& [v, count] : m_linear)
+      {
+        if (v == value)
+        {
+          ++count;
+          return;
+        }
+      }
+
+      if (m_linear.size() < max_linear_values)
+      {
+        m_linear.emplace_back(value, 1u);
+        return;
+      }
+
+      m_hashed.reserve(m_linear.size() + 1u);
+      for (auto& [v, count] : m_linear)
+      {
+        m_hashed.emplace(std::move(v), count);
+      }
+      m_hashed.emplace(value, 1u);
+
+      m_linear.clear();
+      m_linear.shrink_to_fit();
+    }
+
+    bool remove(const V& value)
+    {
+      if (!m_hashed.empty())
+      {
+        auto it = m_hashed.find(value);
+        if (it == std::end(m_hashed))
+        {
+          return false;
+        }
+        if (--(it->second) == 0u)
+        {
+          m_hashed.erase(it);
+        }
+        return true;
+      }
+
+      for (auto it = std::begin(m_linear); it != std::end(m_linear); ++it)
+      {
+        if (it->first == value)
+        {
+          if (--(it->second) == 0u)
+          {
+            // the order of the values does not matter
+            *it = std::move(m_linear.back());
+            m_linear.pop_back();
+          }
+          return true;
+        }
+      }
+      return false;
+    }
+
+    template <typename O>
+    void get(O& out) const
+    {
+      for (const auto& [value, count] : m_linear)
+      {
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+          out++ = value;
+        }
+      }
+      for (const auto& [value, count] : m_hashed)
+      {
+        for (std::size_t i = 0u; i < count; ++i)
+        {
+          out++ = value;
+        }
+      }
+    }
+  };
+
+  /**
+   * A trie node. The children are stored as pairs of the first character of the child's
+   * key and the child's index, sorted by that character. Since the keys of siblings never
+   * share a non-empty prefix, the first character identifies a child uniquely.
+   */
+  struct node
+  {
+    /**
+     * The partial key of this node.
+     */
+    std::string key;
+
+    /**
+     * The index of this node's parent, or `no_node` for the root and for unused nodes.
+     */
+    node_index parent = no_node;
+
+    /**
+     * The children of this node.
+     */
+    std::vector<std::pair<char, node_index>> children;
+
+    /**
+     * The values stored in this node.
+     */
+    value_list values;
+  };
 
   /**
    * To avoid matching the same node multiple times using different partial patterns, we
-   * store tsome state for each node that is encountered during matching. For each node,
-   * we remember its parent node, whether or not the node was previously matched by a
-   * partial pattern, and whether or not all children of the node are already fully
-   * matched.
+   * store some state for each node that is encountered during matching. For each node,
+   * we remember whether or not the node was previously matched by a partial pattern, and
+   * whether or not all children of the node are already fully matched.
    *
    * A node is fully matched if the node itself was matched and each of its children is
    * fully matched.
@@ -88,50 +226,32 @@ private:
   private:
     struct node_match_state
     {
-      /**
-       * The parent of a node.
-       */
-      const node* parent;
-
       /**
        * Indicates whether a node was matched by a pattern.
        */
-      bool node_matched;
+      bool node_matched = false;
 
       /**
        * The number of fully matched children.
        */
-      std::size_t fully_matched_children;
-
-    public:
-      /**
-       * Creates a new state with the given parent. `node_matched` is initialized to
-       * `false` and `fully_matched_children` to 0.
-       *
-       * @param i_parent the parent, can be null
-       */
-      explicit node_match_state(const node* i_parent)
-        : parent(i_parent)
-        , node_matched(false)
-        , fully_matched_children(0u)
-      {
-      }
+      std::size_t fully_matched_children = 0u;
     };
 
-    std::unordered_map<const node*, node_match_state> m_state;
+    const std::vector<node>& m_nodes;
+    std::unordered_map<node_index, node_match_state> m_state;
 
   public:
+    explicit match_state(const std::vector<node>& nodes)
+      : m_nodes{nodes}
+    {
+    }
+
     /**
-     * Inserts a match state for the given node and its parent.
+     * Inserts a match state for the given node.
      *
-     * @param n the node, must not be null
-     * @param parent the parent, may be null
+     * @param n the node
      */
-    void insert(const node* n, const node* parent)
-    {
-      assert(n != nullptr);
-      m_state.try_emplace(n, parent);
-    }
+    void insert(const node_index n) { m_state.try_emplace(n); }
 
     /**
      * Indicates whether the given node is fully matched.
@@ -142,12 +262,13 @@ private:
      * @param n the node to check
      * @return true if the given node is fully matched and false otherwise
      */
-    bool is_fully_matched(const node* n)
+    bool is_fully_matched(const node_index n) const
     {
       auto it = m_state.find(n);
       assert(it != std::end(m_state));
       const auto& state = it->second;
-      return state.node_matched && state.fully_matched_children == n->m_children.size();
+      return state.node_matched
+             && state.fully_matched_children == m_nodes[n].children.size();
     }
 
     /**
@@ -160,15 +281,15 @@ private:
      *
      * @param n the node to set to fully matched
      */
-    void set_fully_matched(const node* n)
+    void set_fully_matched(const node_index n)
     {
       auto it = m_state.find(n);
       assert(it != std::end(m_state));
 
       auto& state = it->second;
       state.node_matched = true;
-      state.fully_matched_children = n->m_children.size();
-      update_parent_states(state.parent);
+      state.fully_matched_children = m_nodes[n].children.size();
+      update_parent_states(m_nodes[n].parent);
     }
 
     /**
@@ -184,7 +305,7 @@ private:
      * @param n the node to set to matched
      * @return `false` if the given node is already matched, and `true` otherwise
      */
-    bool set_matched(const node* n)
+    bool set_matched(const node_index n)
     {
       auto it = m_state.find(n);
       assert(it != std::end(m_state));
@@ -196,666 +317,698 @@ private:
       }
 
       state.node_matched = true;
-      if (state.fully_matched_children == n->m_children.size())
+      if (state.fully_matched_children == m_nodes[n].children.size())
       {
         // update the subtree match counts of all nodes on the path to the given node
-        update_parent_states(state.parent);
+        update_parent_states(m_nodes[n].parent);
       }
 
       return true;
     }
 
   private:
-    void update_parent_states(const node* n)
+    void update_parent_states(node_index n)
     {
-      while (n != nullptr)
+      while (n != no_node)
       {
         auto it = m_state.find(n);
         assert(it != std::end(m_state));
 
         auto& state = it->second;
         state.fully_matched_children += 1u;
-        if (!state.node_matched || state.fully_matched_children < n->m_children.size())
+        if (
+          !state.node_matched
+          || state.fully_matched_children < m_nodes[n].children.size())
         {
           // parent is not fully matched, so it cannot contribute to its parents' subtree
           // match count yet
           break;
         }
 
-        n = it->second.parent;
+        n = m_nodes[n].parent;
       }
     }
   };
 
+private:
+  std::vector<node> m_nodes;
+  std::vector<node_index> m_free_nodes;
+
+public:
   /**
-   * A trie node. Children are stored in a set ordered by `node_cmp`. Each node can store
-   * a given value multiple times.
-   *
-   * A trie node has only const methods and therefore appears to be immutable, but this is
-   * not the case. All of its members are actually declared as mutable and may be modified
-   * by the `insert` or `remove` member functions. The reason for this peculiar design
-   * choice is that trie nodes are stored by value in a `std::set`, and `std::set` does
-   * not allow its contents to be modified, since that might affect the position of the
-   * value in the set.
-   *
-   * But in this particular case, the position of a node in the containing set depends
-   * only on the node's key, and the node's key is changed only in ways that does not
-   * affect its position. The key can only become shorter or longer, that is, key "abc"
-   * might be changed to "ab" or "abcd", and neither of these changes affects how the key
-   * compares to other keys due to the order introduce by `node_cmp`, which consideres two
-   * keys equivalent if they share a non-empty prefix.
-   *
-   * This implies that the following two conditions hold for a node with key "abc":
-   * - There is no sibling node with a key that is a prefix of "abc".
-   * - There is no sibling node with a key that that has "abc" as a prefix.
-   *
-   * Therefore, shortening or extending a node's key does not affect its position in the
-   * containing set, and we can update a node's key without violating any invariants of
-   * the containing set.
+   * Creates a new empty trie.
    */
-  class node
+  compact_trie()
+    : m_nodes(1u)
   {
-  private:
-    friend struct node_cmp;
-    friend class match_state;
-
-    using value_container = std::unordered_map<V, std::size_t>;
-    using node_set = std::set<node, node_cmp>;
-
-    /**
-     * The partical key of this node.
-     */
-    mutable std::string m_key;
-
-    /**
-     * Maps a value to the number of times it was stored in this node.
-     */
-    mutable value_container m_values;
-
-    /**
-     * The children of this node.
-     */
-    mutable node_set m_children;
-
-  public:
-    /**
-     * Creates a new node with the given key.
-     *
-     * @param key the key
-     */
-    explicit node(std::string key)
-      : m_key(std::move(key))
-    {
-    }
+  }
 
-    /**
-     * Inserts the given value into this node's subtree. If this node's key is empty, then
-     * it is the root node.
-     *
-     * Precondition: Unless this node is the root node, the given key must share a
-     * non-empty prefix with this node's key.
-     *
-     * @param key the key to insert
-     * @param value the value to insert
-     */
-    void insert(const std::string_view key, const V& value) const
+  /**
+   * Inserts the given value under the given key.
+   *
+   * @param key the key to insert
+   * @param value the value to insert
+   */
+  void insert(std::string_view key, const V& value)
+  {
+    /*
+     Possible cases for insertion at a node n:
+      index: 01234567 |   | #n.key: 6
+      n.key: target   | ^ | #key | conditions              | todo
+     =================|===|======|=========================|======
+      case:  key:     |   |      |                         |
+         0:  blah     | 0 | 4    | ^ = 0                   | n is the root node, find or
+                      |   |      |                         | create child 'blah' and
+                      |   |      |                         | continue there
+         1:  targetli | 6 | 8    | ^ < #key AND ^ = #n.key | find or create child 'li'
+                      |   |      |                         | and continue there
+         2:  tarus    | 3 | 5    | ^ < #key AND ^ < #n.key | split n into 'tar' and 'get'
+                      |   |      |                         | and continue at n
+         3:  tar      | 3 | 3    | ^ = #key AND ^ < #n.key | split n into 'tar' and
+                      |   |      |                         | 'get', insert at n
+         4:  target   | 6 | 6    | ^ = #key AND ^ = #n.key | insert at n
+     ==================================================================================
+      ^ indicates where key and n.key first differ
+    */
+
+    auto n = root_node;
+    while (true)
     {
-      /*
- Possible cases for insertion:
-  index: 01234567 |   | #m_key: 6
-  m_key: target   | ^ | #key | conditions              | todo
- =================|===|======|=========================|======
-  case:  key:     |   |      |                         |
-     0:  blah     | 0 | 4    | ^ = 0                   | this is the root node, find
- or create child 'blah' and insert there; ^        |   |      | | 1:  targetli | 6 |
- 8    | ^ < #key AND ^ = #m_key | try insert in all children, if none match, create
- child 'li' and insert there; ^  |   |      |                         | 2:  tarus |
- 3 | 5    | ^ < #key AND ^ < #m_key | split this node in 'tar' and 'get'; create
- child 'us' and insert there; ^     |   |      |                         | 3:  tar
- | 3 | 3    | ^ = #key AND ^ < #m_key | split this node in 'tar' and 'get'; insert
- here; return true; ^     |   |      | | 4:  target   | 6 | 6    | ^ = #key AND ^ =
- #m_key | insert here; return true; ^  |   |      |                         |
- ==================================================================================
-  ^ indicates where key and m_key first differ
- */
-
       // find the index of the first character where the given key and this node's key
       // differ
-      const std::size_t mismatch = kdl::cs::str_mismatch(key, m_key);
-      assert(mismatch > 0u || m_key.empty());
+      const auto mismatch = kdl::cs::str_mismatch(key, m_nodes[n].key);
+      assert(mismatch > 0u || n == root_node);
 
       if (mismatch < key.size())
       {
-        // cases 0, 1, 2: key and m_key have a common prefix, or m_key is a prefix of key
-        if (mismatch == m_key.size())
+        if (mismatch == m_nodes[n].key.size())
         {
-          // case 0, 1: m_key is a prefix of key, find or create a child that has a common
-          // prefix with the remainder of key and insert there
-          const auto remainder = key.substr(mismatch);
-          const auto& child = *m_children.insert(node(std::string(remainder))).first;
-          child.insert(remainder, value);
+          // cases 0, 1: n's key is a prefix of key, find or create a child that has a
+          // common prefix with the remainder of key and continue there
+          key = key.substr(mismatch);
+          auto child = find_child(n, key.front());
+          if (child == no_node)
+          {
+            child = create_child(n, std::string{key});
+          }
+          n = child;
         }
         else
-        { // mismatch == m_key.size()
-          // case 2: key and m_key have a common prefix, split this node and insert again
-          split_node(mismatch);
-          insert(key, value);
+        {
+          // case 2: key and n's key have a common prefix, split n and try again
+          split_node(n, mismatch);
         }
       }
-      else if (mismatch == key.size())
+      else
       {
-        // cases 3, 4: key is a prefix of m_key, or key == m_key
-        if (mismatch < m_key.size())
+        // cases 3, 4: key is a prefix of n's key, or key == n's key
+        if (mismatch < m_nodes[n].key.size())
         {
-          // case 3: key is a prefix of m_key, split this node
-          split_node(mismatch);
+          // case 3: key is a prefix of n's key, split n
+          split_node(n, mismatch);
         }
-        insert_value(value);
+        m_nodes[n].values.insert(value);
+        return;
       }
     }
+  }
 
-    /**
-     * Removes the given value from this node's subtree.
-     *
-     * @param key the key to remove
-     * @param value the value to remove
-     * @return true if the given key and value were removed from this node's subtree
-     */
-    bool remove(const std::string_view key, const V& value) const
+  /**
+   * Removes the given value using the given key.
+   *
+   * @param key the key to remove
+   * @param value the value to remove
+   * @return `true` if the given value was found under the given key, and `false`
+   * otherwise
+   */
+  bool remove(const std::string_view key, const V& value)
+  {
+    auto n = find_node(key);
+    if (n == no_node || !m_nodes[n].values.remove(value))
     {
-      bool result = false;
+      return false;
+    }
 
-      const std::size_t mismatch = kdl::cs::str_mismatch(key, m_key);
-      if (m_key.size() <= key.length() && mismatch == m_key.length())
+    // remove empty leaves and merge nodes that have only one child and no values of their
+    // own into that child
+    while (n != root_node)
+    {
+      auto& current = m_nodes[n];
+      if (!current.values.empty())
       {
-        // m_key is a prefix of key or m_key == key
-        if (mismatch < key.length())
-        {
-          // m_key is a true prefix of key, continue at the corresponding child node
-          const auto remainder = key.substr(mismatch);
-          const auto it = m_children.find(remainder);
-          assert(it != std::end(m_children));
-
-          result = it->remove(remainder, value);
-          if (!it->m_key.empty() && it->m_values.empty() && it->m_children.empty())
-          {
-            m_children.erase(it);
-          }
-        }
-        else
-        {
-          // m_key == key
-          result = remove_value(value);
-        }
+        break;
+      }
 
-        if (!m_key.empty() && m_values.empty() && m_children.size() == 1u)
+      if (current.children.empty())
+      {
+        const auto parent = current.parent;
+        remove_child(parent, n);
+        n = parent;
+      }
+      else
+      {
+        if (current.children.size() == 1u)
         {
-          merge_node();
+          merge_node(n);
         }
+        break;
       }
+    }
+
+    return true;
+  }
 
-      return result;
+  /**
+   * Clears this trie.
+   */
+  void clear()
+  {
+    m_nodes.clear();
+    m_nodes.resize(1u);
+    m_free_nodes.clear();
+  }
+
+  /**
+   * Finds all values whose keys match the given glob pattern. See `kdl::str_matches_glob`
+   * for the definition and semantics of glob patterns and adds the values to the given
+   * output iterator.
+   *
+   * @tparam O the type of the output iterator
+   * @param pattern the pattern to match
+   * @param out the output iterator
+   *
+   * @throws std::invalid_argument if the given pattern contains an invalid escape
+   * sequence
+   */
+  template <typename O>
+  void find_matches(const std::string_view pattern, O out) const
+  {
+    const auto first_wildcard = pattern.find_first_of("*?%\\");
+    if (first_wildcard == std::string_view::npos)
+    {
+      // a pattern without wildcards matches at most one node
+      if (const auto n = find_node(pattern); n != no_node)
+      {
+        m_nodes[n].values.get(out);
+      }
+    }
+    else if (first_wildcard == pattern.size() - 1u && pattern.back() == '*')
+    {
+      // a prefix followed by '*' matches the subtree below the prefix
+      if (const auto n = find_prefix_node(pattern.substr(0u, first_wildcard));
+          n != no_node)
+      {
+        get_values_and_recurse(n, out);
+      }
     }
+    else
+    {
+      auto state = match_state{m_nodes};
+      find_matches(root_node, pattern, 0u, state, out);
+    }
+  }
 
-    /**
-     * Finds every node in this node's subtree whose keys match a pattern, and adds the
-     * values to the given output iterator.
-     *
-     * The keys are matched against a suffix of the given pattern starting at the given
-     * position. The matching algorithm uses an auxiliary `match_State` to prevent
-     * matching unnecessarily matching nodes. This state is updated in the following
-     * situations:
-     *
-     * - a node is visited for the first time
-     * - a node is matches the given pattern (this might also update the node's parent's
-     * states)
-     * - an entire subtree matches the given pattern (due to a trailing wildcard in the
-     * pattern)
-     *
-     * Using this information, the algorithm will stop matching a node if every node in
-     * its subtree was already matched against the pattern. Furthermore, it will not add a
-     * node's values multiple times if the node's key matches the pattern in more than one
-     * way. The latter situation can arise due to wildcards in the pattern.
-     *
-     * @tparam O the type of the given output iterator
-     * @param pattern the pattern to match
-     * @param pattern_position where to start matching the pattern
-     * @param parent this node's parent (used to update the match_state)
-     * @param match_state the match state
-     * @param out the output iterator to which the values of matched nodes are added
-     *
-     * @throws std::invalid_argument if the given pattern contains an invalid escape
-     * sequence
-     */
-    template <typename O>
-    void find_matches(
-      const std::string_view pattern,
-      const std::size_t pattern_position,
-      const node* parent,
-      match_state& match_state,
-      O out) const
+  /**
+   * Adds the keys of all nodes in this trie to the give output iterator.
+   *
+   * @tparam O the type of the output iterator
+   * @param out the output iterator
+   */
+  template <typename O>
+  void get_keys(O out) const
+  {
+    get_keys(root_node, "", out);
+  }
+
+private:
+  /**
+   * Returns the index of the child of the given node whose key starts with the given
+   * character, or `no_node` if there is no such child.
+   */
+  node_index find_child(const node_index n, const char c) const
+  {
+    const auto& children = m_nodes[n].children;
+    const auto it = std::lower_bound(
+      std::begin(children), std::end(children), c, [](const auto& child, const char x) {
+        return child.first < x;
+      });
+    return it != std::end(children) && it->first == c ? it->second : no_node;
+  }
+
+  /**
+   * Returns the index of the node whose full key is equal to the given key, or `no_node`
+   * if there is no such node.
+   */
+  node_index find_node(std::string_view key) const
+  {
+    auto n = root_node;
+    while (n != no_node)
     {
-      using match_task = std::pair<std::size_t, std::size_t>;
+      const auto& current = m_nodes[n];
+      if (kdl::cs::str_mismatch(key, current.key) < current.key.size())
+      {
+        return no_node;
+      }
+
+      key = key.substr(current.key.size());
+      if (key.empty())
+      {
+        return n;
+      }
 
-      match_state.insert(this, parent);
+      n = find_child(n, key.front());
+    }
+    return no_node;
+  }
 
-      std::vector<match_task> match_tasks({{0u, pattern_position}});
-      while (!match_tasks.empty())
+  /**
+   * Returns the index of the topmost node whose full key has the given prefix, or
+   * `no_node` if there is no such node.
+   */
+  node_index find_prefix_node(std::string_view prefix) const
+  {
+    auto n = root_node;
+    while (n != no_node)
+    {
+      const auto& current = m_nodes[n];
+      const auto mismatch = kdl::cs::str_mismatch(prefix, current.key);
+      if (mismatch == prefix.size())
       {
-        if (match_state.is_fully_matched(this))
-        {
-          // this node and all of its subtrees have been fully matched, so we are done
-          // here
-          return;
-        }
+        return n;
+      }
+      if (mismatch < current.key.size())
+      {
+        return no_node;
+      }
 
-        const auto [k_i, p_i] = match_tasks.back();
-        match_tasks.pop_back();
+      prefix = prefix.substr(mismatch);
+      n = find_child(n, prefix.front());
+    }
+    return no_node;
+  }
 
-        if (k_i == m_key.length() && p_i == pattern.length())
-        {
-          if (match_state.set_matched(this))
-          {
-            // this node was not matched yet, so fetch the results
-            get_values(out);
-          }
+  /**
+   * Creates a new node with the given key, reusing a previously removed node if possible.
+   * Note that this may invalidate all references to nodes.
+   */
+  node_index create_node(std::string key, const node_index parent)
+  {
+    auto n = no_node;
+    if (!m_free_nodes.empty())
+    {
+      n = m_free_nodes.back();
+      m_free_nodes.pop_back();
+    }
+    else
+    {
+      n = m_nodes.size();
+      m_nodes.emplace_back();
+    }
 
-          // there might still be children of this node that could be matched by a pending
-          // match task, so continue matching
-          continue;
-        }
+    auto& new_node = m_nodes[n];
+    new_node.key = std::move(key);
+    new_node.parent = parent;
+    return n;
+  }
+
+  /**
+   * Releases the given node so that it can be reused by `create_node`.
+   */
+  void release_node(const node_index n)
+  {
+    m_nodes[n] = node{};
+    m_free_nodes.push_back(n);
+  }
+
+  /**
+   * Creates a new child of the given node with the given key. No other child of the node
+   * must have a key that starts with the same character as the given key.
+   */
+  node_index create_child(const node_index n, std::string key)
+  {
+    assert(!key.empty());
+    assert(find_child(n, key.front()) == no_node);
+
+    const auto c = key.front();
+    const auto child = create_node(std::move(key), n);
+
+    auto& children = m_nodes[n].children;
+    const auto it = std::lower_bound(
+      std::begin(children), std::end(children), c, [](const auto& x, const char y) {
+        return x.first < y;
+      });
+    children.emplace(it, c, child);
+    return child;
+  }
+
+  /**
+   * Removes the given child from the given node and releases it.
+   */
+  void remove_child(const node_index n, const node_index child)
+  {
+    auto& children = m_nodes[n].children;
+    const auto it = std::find_if(
+      std::begin(children), std::end(children), [&](const auto& x) {
+        return x.second == child;
+      });
+    assert(it != std::end(children));
+    children.erase(it);
+    release_node(child);
+  }
+
+  /**
+   * Splits the given node into two nodes at the given index of its key. For example,
+   * given a node n with key "abcd" and index 2, the following will happen:
+   * - n's key will be shortened to "ab"
+   * - a new node c will be created with key "cd"
+   * - all of n's children and values will be moved to c
+   * - c will be added to n's children
+   *
+   * Precondition: The node's key has at least two characters, and the index is chosen in
+   * such a way that neither of the resulting keys is empty.
+   */
+  void split_node(const node_index n, const std::size_t index)
+  {
+    assert(m_nodes[n].key.length() > 1u);
+    assert(index > 0u && index < m_nodes[n].key.length());
+
+    const auto c = create_node(m_nodes[n].key.substr(index), n);
+
+    auto& current = m_nodes[n];
+    auto& new_child = m_nodes[c];
+
+    using std::swap;
+    swap(new_child.children, current.children);
+    swap(new_child.values, current.values);
+    for (const auto& [first, grandchild] : new_child.children)
+    {
+      m_nodes[grandchild].parent = c;
+    }
+
+    current.key.resize(index);
+    current.children.emplace_back(new_child.key.front(), c);
+  }
+
+  /**
+   * Merges the given node with its only child. Thereby, the child node's key is appended
+   * to the node's key, the child's children and values are moved to the node, and the
+   * child is released.
+   *
+   * Precondition: The node has only one child, and it has no values of its own.
+   */
+  void merge_node(const node_index n)
+  {
+    assert(m_nodes[n].children.size() == 1u);
+    assert(m_nodes[n].values.empty());
+
+    auto& current = m_nodes[n];
+    const auto c = current.children.front().second;
+    auto& child = m_nodes[c];
+
+    current.key += child.key;
+    current.children.clear();
+
+    using std::swap;
+    swap(current.children, child.children);
+    swap(current.values, child.values);
+    for (const auto& [first, grandchild] : current.children)
+    {
+      m_nodes[grandchild].parent = n;
+    }
+
+    release_node(c);
+  }
+
+  /**
+   * Finds every node in the given node's subtree whose keys match a pattern, and adds the
+   * values to the given output iterator.
+   *
+   * The keys are matched against a suffix of the given pattern starting at the given
+   * position. The matching algorithm uses an auxiliary `match_state` to prevent
+   * matching unnecessarily matching nodes. This state is updated in the following
+   * situations:
+   *
+   * - a node is visited for the first time
+   * - a node is matches the given pattern (this might also update the node's parent's
+   * states)
+   * - an entire subtree matches the given pattern (due to a trailing wildcard in the
+   * pattern)
+   *
+   * Using this information, the algorithm will stop matching a node if every node in
+   * its subtree was already matched against the pattern. Furthermore, it will not add a
+   * node's values multiple times if the node's key matches the pattern in more than one
+   * way. The latter situation can arise due to wildcards in the pattern.
+   *
+   * @tparam O the type of the given output iterator
+   * @param n the node to match
+   * @param pattern the pattern to match
+   * @param pattern_position where to start matching the pattern
+   * @param match_state the match state
+   * @param out the output iterator to which the values of matched nodes are added
+   *
+   * @throws std::invalid_argument if the given pattern contains an invalid escape
+   * sequence
+   */
+  template <typename O>
+  void find_matches(
+    const node_index n,
+    const std::string_view pattern,
+    const std::size_t pattern_position,
+    match_state& match_state,
+    O& out) const
+  {
+    using match_task = std::pair<std::size_t, std::size_t>;
+
+    const auto& current = m_nodes[n];
+    const auto& key = current.key;
+    match_state.insert(n);
+
+    std::vector<match_task> match_tasks({{0u, pattern_position}});
+    while (!match_tasks.empty())
+    {
+      if (match_state.is_fully_matched(n))
+      {
+        // this node and all of its subtrees have been fully matched, so we are done
+        // here
+        return;
+      }
+
+      const auto [k_i, p_i] = match_tasks.back();
+      match_tasks.pop_back();
 
-        if (p_i == pattern.length())
+      if (k_i == key.length() && p_i == pattern.length())
+      {
+        if (match_state.set_matched(n))
         {
-          // the pattern is consumed by the key isn't, we cannot have a match here
-          continue;
+          // this node was not matched yet, so fetch the results
+          current.values.get(out);
         }
 
-        // after this point, we can assume that the pattern is not consumed, but the key
-        // might be
-        if (pattern[p_i] == '\\' && p_i < pattern.length() - 1u)
-        {
-          // handle escaped characters in the pattern
-          const auto& n = pattern[p_i + 1u];
+        // there might still be children of this node that could be matched by a pending
+        // match task, so continue matching
+        continue;
+      }
+
+      if (p_i == pattern.length())
+      {
+        // the pattern is consumed by the key isn't, we cannot have a match here
+        continue;
+      }
+
+      // after this point, we can assume that the pattern is not consumed, but the key
+      // might be
+      if (pattern[p_i] == '\\' && p_i < pattern.length() - 1u)
+      {
+        // handle escaped characters in the pattern
+        const auto& e = pattern[p_i + 1u];
 
-          if (k_i < m_key.length())
+        if (k_i < key.length())
+        {
+          // check the next character in the pattern against the next character in the
+          // key
+          if (e == '*' || e == '?' || e == '%' || e == '\\')
           {
-            // check the next character in the pattern against the next character in the
-            // key
-            if (n == '*' || n == '?' || n == '%' || n == '\\')
-            {
-              if (m_key[k_i] == n)
-              {
-                // the key matches the escaped character, continue
-                match_tasks.emplace_back(k_i + 1u, p_i + 2u);
-              }
-            }
-            else
+            if (key[k_i] == e)
             {
-              throw std::invalid_argument("invalid escape sequence in pattern");
+              // the key matches the escaped character, continue
+              match_tasks.emplace_back(k_i + 1u, p_i + 2u);
             }
           }
           else
           {
-            // the key is consumed, so continue matching at the children
-            for (const auto& c : {"*", "?", "%", "\\"})
-            {
-              const auto it = m_children.find(c);
-              if (it != std::end(m_children))
-              {
-                it->find_matches(pattern, p_i, this, match_state, out);
-              }
-            }
+            throw std::invalid_argument("invalid escape sequence in pattern");
           }
         }
-        else if (pattern[p_i] == '*')
+        else
         {
-          // handle '*' in the pattern
-          if (p_i == pattern.length() - 1u)
-          {
-            // the pattern is consumed after the '*', so it matches all keys in this
-            // node's subtree
-            match_state.set_fully_matched(this);
-            get_values_and_recurse(out);
-            return;
-          }
-
-          if (k_i < m_key.length())
-          {
-            // '*' matches any character
-            // consume the '*' and continue matching at the current character of the key
-            match_tasks.emplace_back(k_i, p_i + 1u);
-            // consume the current character of the key and continue matching at '*'
-            match_tasks.emplace_back(k_i + 1u, p_i);
-          }
-          else
+          // the key is consumed, so continue matching at the children
+          for (const auto c : {'*', '?', '%', '\\'})
           {
-            // the key is consumed, so continue matching at the children
-            for (const auto& child : m_children)
+            if (const auto child = find_child(n, c); child != no_node)
             {
-              child.find_matches(pattern, p_i, this, match_state, out);
+              find_matches(child, pattern, p_i, match_state, out);
             }
           }
         }
-        else if (pattern[p_i] == '?')
+      }
+      else if (pattern[p_i] == '*')
+      {
+        // handle '*' in the pattern
+        if (p_i == pattern.length() - 1u)
+        {
+          // the pattern is consumed after the '*', so it matches all keys in this
+          // node's subtree
+          match_state.set_fully_matched(n);
+          get_values_and_recurse(n, out);
+          return;
+        }
+
+        if (k_i < key.length())
+        {
+          // '*' matches any character
+          // consume the '*' and continue matching at the current character of the key
+          match_tasks.emplace_back(k_i, p_i + 1u);
+          // consume the current character of the key and continue matching at '*'
+          match_tasks.emplace_back(k_i + 1u, p_i);
+        }
+        else
         {
-          // handle '?' in the pattern
-          if (k_i < m_key.length())
+          // the key is consumed, so continue matching at the children
+          for (const auto& [first, child] : current.children)
           {
-            // '?' matches any character, continue at the next chars in both the pattern
-            // and the key
-            match_tasks.emplace_back(k_i + 1u, p_i + 1u);
+            find_matches(child, pattern, p_i, match_state, out);
           }
-          else
+        }
+      }
+      else if (pattern[p_i] == '?')
+      {
+        // handle '?' in the pattern
+        if (k_i < key.length())
+        {
+          // '?' matches any character, continue at the next chars in both the pattern
+          // and the key
+          match_tasks.emplace_back(k_i + 1u, p_i + 1u);
+        }
+        else
+        {
+          // the key is consumed, so continue matching at the children
+          for (const auto& [first, child] : current.children)
           {
-            // the key is consumed, so continue matching at the children
-            for (const auto& child : m_children)
-            {
-              child.find_matches(pattern, p_i, this, match_state, out);
-            }
+            find_matches(child, pattern, p_i, match_state, out);
           }
         }
-        else if (pattern[p_i] == '%')
+      }
+      else if (pattern[p_i] == '%')
+      {
+        // handle '%' in the pattern
+        if (p_i < pattern.length() - 1u && pattern[p_i + 1u] == '*')
         {
-          // handle '%' in the pattern
-          if (p_i < pattern.length() - 1u && pattern[p_i + 1u] == '*')
+          // handle "%*" in the pattern
+          // try to continue matching after "%*"
+          match_tasks.emplace_back(k_i, p_i + 2u);
+          if (k_i < key.length())
           {
-            // handle "%*" in the pattern
-            // try to continue matching after "%*"
-            match_tasks.emplace_back(k_i, p_i + 2u);
-            if (k_i < m_key.length())
-            {
-              if (m_key[k_i] >= '0' && m_key[k_i] <= '9')
-              {
-                // try to match more digits
-                match_tasks.emplace_back(k_i + 1u, p_i);
-              }
-            }
-            else
+            if (key[k_i] >= '0' && key[k_i] <= '9')
             {
-              // the key is consumed, so continue matching at the children
-              for (auto it = m_children.lower_bound("0"),
-                        end = m_children.upper_bound("9");
-                   it != end;
-                   ++it)
-              {
-                it->find_matches(pattern, p_i, this, match_state, out);
-              }
+              // try to match more digits
+              match_tasks.emplace_back(k_i + 1u, p_i);
             }
           }
           else
           {
-            if (k_i < m_key.length())
-            {
-              // handle '%' in the pattern (not followed by '*')
-              if (m_key[k_i] >= '0' && m_key[k_i] <= '9')
-              {
-                // continue matching after the digit
-                match_tasks.emplace_back(k_i + 1u, p_i + 1u);
-              }
-            }
-            else
-            {
-              // the key is consumed, so continue matching at the children
-              for (auto it = m_children.lower_bound("0"),
-                        end = m_children.upper_bound("9");
-                   it != end;
-                   ++it)
-              {
-                it->find_matches(pattern, p_i, this, match_state, out);
-              }
-            }
+            // the key is consumed, so continue matching at the children
+            find_matches_at_digit_children(n, pattern, p_i, match_state, out);
           }
         }
         else
         {
-          if (k_i < m_key.length())
+          if (k_i < key.length())
           {
-            if (pattern[p_i] == m_key[k_i])
+            // handle '%' in the pattern (not followed by '*')
+            if (key[k_i] >= '0' && key[k_i] <= '9')
             {
-              // handle a regular character in the pattern
+              // continue matching after the digit
               match_tasks.emplace_back(k_i + 1u, p_i + 1u);
             }
           }
           else
           {
             // the key is consumed, so continue matching at the children
-            for (auto [it, end] = m_children.equal_range(pattern.substr(p_i, 1u));
-                 it != end;
-                 ++it)
-            {
-              it->find_matches(pattern, p_i, this, match_state, out);
-            }
+            find_matches_at_digit_children(n, pattern, p_i, match_state, out);
           }
         }
       }
-    }
-
-    /**
-     * Adds the keys of all nodes in this subtree to the given output iterator.
-     *
-     * @tparam O the type of the output iterator
-     * @param prefix the prefix of all keys in this subtree
-     * @param out the output iterator
-     */
-    template <typename O>
-    void get_keys(const std::string& prefix, O out) const
-    {
-      const auto key = prefix + m_key;
-      if (!m_values.empty())
-      {
-        out++ = key;
-      }
-
-      for (const auto& child : m_children)
-      {
-        child.get_keys(key, out);
-      }
-    }
-
-  private:
-    void insert_value(const V& value) const { m_values[value]++; }
-
-    bool remove_value(const V& value) const
-    {
-      auto it = m_values.find(value);
-      if (it == std::end(m_values))
-      {
-        return false;
-      }
       else
       {
-        if (--(it->second) == 0u)
+        if (k_i < key.length())
         {
-          m_values.erase(it);
+          if (pattern[p_i] == key[k_i])
+          {
+            // handle a regular character in the pattern
+            match_tasks.emplace_back(k_i + 1u, p_i + 1u);
+          }
         }
-        return true;
-      }
-    }
-
-    /**
-     * Splits this node into two nodes at the given index of its key. For example, given a
-     * node n with key "abcd" and index 2, the following will happen:
-     * - n's key will be shortened to "ab"
-     * - a new node c will be created to n with key "cd"
-     * - all of n's children and values will be moved to c
-     * - c will be added to n's children
-     *
-     * Precondition: This node's key has at least two characters, and the index is chosen
-     * in such a way that neither of the resulting keys is empty.
-     *
-     * @param index the index at which to split the node's key
-     */
-    void split_node(const std::size_t index) const
-    {
-      assert(m_key.length() > 1u);
-
-      auto new_key = m_key.substr(0u, index);
-      auto remainder = m_key.substr(index);
-
-      assert(!new_key.empty());
-      assert(!remainder.empty());
-
-      using std::swap;
-      node_set new_children;
-      swap(new_children, m_children);
-
-      const node& new_child = *m_children.insert(node(std::move(remainder))).first;
-      swap(new_child.m_children, new_children);
-      swap(new_child.m_values, m_values);
-
-      m_key = std::move(new_key);
-    }
-
-    /**
-     * Merges this node with its only child. Thereby, this child node's key is appended to
-     * this node's key, the child's children and values are moved to this node, and the
-     * child is removed.
-     *
-     * Precondition: This node has only one child, and this node has no values of its own.
-     */
-    void merge_node() const
-    {
-      assert(m_children.size() == 1u);
-      assert(m_values.empty());
-
-      using std::swap;
-      node_set old_children;
-      swap(old_children, m_children);
-
-      const node& child = *std::begin(old_children);
-      swap(m_children, child.m_children);
-      swap(m_values, child.m_values);
-
-      m_key += child.m_key;
-    }
-
-    template <typename O>
-    void get_values(O out) const
-    {
-      for (const auto& [value, count] : m_values)
-      {
-        for (std::size_t i = 0u; i < count; ++i)
+        else
         {
-          out++ = value;
+          // the key is consumed, so continue matching at the children
+          if (const auto child = find_child(n, pattern[p_i]); child != no_node)
+          {
+            find_matches(child, pattern, p_i, match_state, out);
+          }
         }
       }
     }
-
-    template <typename O>
-    void get_values_and_recurse(O out) const
-    {
-      get_values(out);
-      for (const auto& child : m_children)
-      {
-        child.get_values_and_recurse(out);
-      }
-    }
-  };
+  }
 
   /**
-   * Compares nodes against each other or nodes against strings.
-   *
-   * Two nodes are compared by their keys.
-   * A node is compared to a string by comparing its key to the string.
-   *
-   * Two strings are compared by their first character only, soif two nodes share a
-   * non-empty prefix, they are considered equivalent. Therefore, the keys "ab" and "abc"
-   * are equivalent. Conversely, the keys "ab" and "bc" are not equivalent because they do
-   * not share a prefix, more specifically, "ab" is considered less than "bc".
-   *
-   * Precondition: the strings to copmare are not empty.
+   * Continues matching at every child of the given node whose key starts with a digit.
    */
-  struct node_cmp
+  template <typename O>
+  void find_matches_at_digit_children(
+    const node_index n,
+    const std::string_view pattern,
+    const std::size_t pattern_position,
+    match_state& match_state,
+    O& out) const
   {
-    using is_transparent = void;
-
-    bool operator()(const node& lhs, const node& rhs) const
+    const auto& children = m_nodes[n].children;
+    for (auto it = std::lower_bound(
+           std::begin(children),
+           std::end(children),
+           '0',
+           [](const auto& child, const char c) { return child.first < c; });
+         it != std::end(children) && it->first <= '9';
+         ++it)
     {
-      return compare(lhs.m_key, rhs.m_key);
+      find_matches(it->second, pattern, pattern_position, match_state, out);
     }
+  }
 
-    bool operator()(const std::string_view lhs, const node& rhs) const
+  template <typename O>
+  void get_values_and_recurse(const node_index n, O& out) const
+  {
+    const auto& current = m_nodes[n];
+    current.values.get(out);
+    for (const auto& [first, child] : current.children)
     {
-      return compare(lhs, rhs.m_key);
+      get_values_and_recurse(child, out);
     }
+  }
 
-    bool operator()(const node& lhs, const std::string_view rhs) const
+  template <typename O>
+  void get_keys(const node_index n, const std::string& prefix, O& out) const
+  {
+    const auto& current = m_nodes[n];
+    const auto key = prefix + current.key;
+    if (!current.values.empty())
     {
-      return compare(lhs.m_key, rhs);
+      out++ = key;
     }
 
-    bool compare(const std::string_view lhs, const std::string_view& rhs) const
+    for (const auto& [first, child] : current.children)
     {
-      assert(!lhs.empty() && !rhs.empty());
-      return lhs[0] < rhs[0];
+      get_keys(child, key, out);
     }
-  };
-
-private:
-  node m_root;
-
-public:
-  /**
-   * Creates a new empty trie.
-   */
-  compact_trie()
-    : m_root(node(""))
-  {
-  }
-
-  /**
-   * Inserts the given value under the given key.
-   *
-   * @param key the key to insert
-   * @param value the value to insert
-   */
-  void insert(const std::string_view key, const V& value) { m_root.insert(key, value); }
-
-  /**
-   * Removes the given value using the given key.
-   *
-   * @param key the key to remove
-   * @param value the value to remove
-   * @return `true` if the given value was found under the given key, and `false`
-   * otherwise
-   */
-  bool remove(const std::string_view key, const V& value)
-  {
-    return m_root.remove(key, value);
-  }
-
-  /**
-   * Clears this trie.
-   */
-  void clear() { m_root = node(""); }
-
-  /**
-   * Finds all values whose keys match the given glob pattern. See `kdl::str_matches_glob`
-   * for the definition and semantics of glob patterns and adds the values to the given
-   * output iterator.
-   *
-   * @tparam O the type of the output iterator
-   * @param pattern the pattern to match
-   * @param out the output iterator
-   */
-  template <typename O>
-  void find_matches(const std::string_view pattern, O out) const
-  {
-    match_state match_state;
-    m_root.find_matches(pattern, {0u}, nullptr, match_state, out);
-  }
-
-  /**
-   * Adds the keys of all nodes in this trie to the give output iterator.
-   *
-   * @tparam O the type of the output iterator
-   * @param out the output iterator
-   */
-  template <typename O>
-  void get_keys(O out) const
-  {
-    m_root.get_keys("", out);
   }
 };
 } // namespace kdl
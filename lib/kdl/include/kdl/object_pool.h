@@ -0,0 +1,265 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace kdl
+{
+/**
+ * A pool of fixed size memory blocks.
+ *
+ * The blocks are carved out of large chunks, so that objects allocated one after another
+ * end up next to each other in memory. Freed blocks are kept in a free list and reused by
+ * later allocations. The chunks are never released, so the memory used by a pool does not
+ * shrink below its peak usage.
+ *
+ * There is only one pool for every combination of template arguments, see get_instance.
+ * Every thread has its own free list, so allocating and freeing blocks usually does not
+ * require any synchronization. Blocks may be freed by another thread than the one that
+ * allocated them. To keep a thread that only frees blocks from hoarding them, a thread's
+ * free list holds at most 2 * BlocksPerChunk blocks. When it grows beyond that, all but
+ * the BlocksPerChunk most recently freed blocks are handed back to the pool. When a
+ * thread's free list is empty, the thread takes up to BlocksPerChunk blocks from the pool,
+ * or allocates a new chunk if the pool has none. The blocks of a thread that exits are handed back to the pool as well.
+ *
+ * @tparam Size the size of the blocks in bytes
+ * @tparam Align the alignment of the blocks in bytes
+ * @tparam BlocksPerChunk the number of blocks in each chunk
+ */
+template <std::size_t Size, std::size_t Align, std::size_t BlocksPerChunk = 256>
+class object_pool
+{
+private:
+  union block
+  {
+    block* next;
+    alignas(Align) std::byte data[Size];
+  };
+
+  struct chunk
+  {
+    block blocks[BlocksPerChunk];
+  };
+
+  /**
+   * A null terminated list of free blocks and its length.
+   */
+  struct batch
+  {
+    block* head = nullptr;
+    std::size_t count = 0;
+  };
+
+  /**
+   * The free list of a thread. When the thread exits, its free blocks are handed back
+   * to the pool.
+   */
+  struct free_list
+  {
+    object_pool& pool;
+    batch blocks;
+
+    explicit free_list(object_pool& i_pool)
+      : pool{i_pool}
+    {
+    }
+
+    ~free_list() { pool.return_blocks(blocks); }
+  };
+
+  static constexpr std::size_t MaxThreadBlocks = 2 * BlocksPerChunk;
+
+  std::mutex m_mutex;
+  std::vector<std::unique_ptr<chunk>> m_chunks;
+  batch m_free_blocks;
+
+  object_pool() = default;
+
+public:
+  object_pool(const object_pool&) = delete;
+  object_pool& operator=(const object_pool&) = delete;
+
+  /**
+   * Returns the pool shared by all users of this combination of template arguments.
+   *
+   * The pool is never destroyed so that blocks can still be freed while other static
+   * objects are destroyed at program exit.
+   */
+  static object_pool& get_instance()
+  {
+    static auto* instance = new object_pool{};
+    return *instance;
+  }
+
+  /**
+   * Returns a block of Size bytes, aligned to Align bytes.
+   *
+   * @throws std::bad_alloc if a new chunk is required and cannot be allocated
+   */
+  void* allocate()
+  {
+    auto& list = get_free_list();
+    if (!list.blocks.head)
+    {
+      list.blocks = take_blocks();
+    }
+
+    auto* result = list.blocks.head;
+    list.blocks.head = result->next;
+    --list.blocks.count;
+    return result;
+  }
+
+  /**
+   * Returns the given block to this pool. The block must have been allocated by this
+   * pool.
+   */
+  void deallocate(void* ptr) noexcept
+  {
+    if (ptr)
+    {
+      auto& list = get_free_list();
+      auto* b = static_cast<block*>(ptr);
+      b->next = list.blocks.head;
+      list.blocks.head = b;
+      if (++list.blocks.count > MaxThreadBlocks)
+      {
+        // keep the most recently freed blocks and hand the older ones back to the pool
+        auto* last_kept = list.blocks.head;
+        for (std::size_t i = 1; i < BlocksPerChunk; ++i)
+        {
+          last_kept = last_kept->next;
+        }
+
+        const auto returned = batch{last_kept->next, list.blocks.count - BlocksPerChunk};
+        last_kept->next = nullptr;
+        return_blocks(returned);
+        list.blocks.count = BlocksPerChunk;
+      }
+    }
+  }
+
+  /**
+   * Returns the number of chunks allocated by this pool.
+   */
+  std::size_t chunk_count()
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    return m_chunks.size();
+  }
+
+private:
+  free_list& get_free_list()
+  {
+    thread_local auto list = free_list{*this};
+    return list;
+  }
+
+  batch take_blocks()
+  {
+    const auto lock = std::lock_guard{m_mutex};
+    if (m_free_blocks.head)
+    {
+      auto result = m_free_blocks;
+      if (result.count > BlocksPerChunk)
+      {
+        auto* last_taken = result.head;
+        for (std::size_t i = 1; i < BlocksPerChunk; ++i)
+        {
+          last_taken = last_taken->next;
+        }
+
+        m_free_blocks = {last_taken->next, result.count - BlocksPerChunk};
+        last_taken->next = nullptr;
+        result.count = BlocksPerChunk;
+      }
+      else
+      {
+        m_free_blocks = {};
+      }
+      return result;
+    }
+
+    auto& c = m_chunks.emplace_back(new chunk);
+    for (std::size_t i = 0; i < BlocksPerChunk - 1; ++i)
+    {
+      c->blocks[i].next = &c->blocks[i + 1];
+    }
+    c->blocks[BlocksPerChunk - 1].next = nullptr;
+    return {&c->blocks[0], BlocksPerChunk};
+  }
+
+  void return_blocks(const batch blocks) noexcept
+  {
+    if (blocks.head)
+    {
+      auto* tail = blocks.head;
+      while (tail->next)
+      {
+        tail = tail->next;
+      }
+
+      const auto lock = std::lock_guard{m_mutex};
+      tail->next = m_free_blocks.head;
+      m_free_blocks = {blocks.head, blocks.count + m_free_blocks.count};
+    }
+  }
+};
+
+/**
+ * Base class for types whose instances should be allocated from an object_pool. Only
+ * objects of type T are pooled, objects of types derived from T are allocated with the
+ * global allocation functions.
+ *
+ * @tparam T the derived type
+ */
+template <typename T>
+class pool_allocated
+{
+public:
+  static void* operator new(const std::size_t size)
+  {
+    return size == sizeof(T) ? get_pool().allocate() : ::operator new(size);
+  }
+
+  static void operator delete(void* ptr, const std::size_t size) noexcept
+  {
+    if (size == sizeof(T))
+    {
+      get_pool().deallocate(ptr);
+    }
+    else
+    {
+      ::operator delete(ptr);
+    }
+  }
+
+private:
+  static auto& get_pool() { return object_pool<sizeof(T), alignof(T)>::get_instance(); }
+};
+
+} // namespace kdl
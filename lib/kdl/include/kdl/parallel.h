@@ -20,84 +20,186 @@
 
 #pragma once
 
+#include "kdl/thread_pool.h"
 #include "kdl/vector_utils.h"
 
-#ifdef _WIN32
-#include <ppl.h>
-#endif
-
+#include <algorithm>
 #include <atomic>
-#include <future> // for std::async
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <optional>
-#include <thread>
+#include <type_traits>
 #include <utility> // for std::declval
 #include <vector>
 
 namespace kdl
 {
+namespace detail
+{
+/**
+ * The shared state of one parallel_for invocation. The index range is split into chunks
+ * of `grain_size` indices which are claimed by the participating threads one at a time.
+ */
+template <class L>
+struct parallel_for_job
+{
+  const size_t count;
+  const size_t grain_size;
+  const size_t chunk_count;
+  L& lambda;
+
+  std::atomic<size_t> next_chunk{0};
+  std::atomic<size_t> completed_chunks{0};
+  std::atomic<bool> failed{false};
+
+  std::mutex mutex;
+  std::condition_variable done;
+  std::exception_ptr exception;
+
+  parallel_for_job(const size_t i_count, const size_t i_grain_size, L& i_lambda)
+    : count{i_count}
+    , grain_size{i_grain_size}
+    , chunk_count{(i_count + i_grain_size - 1) / i_grain_size}
+    , lambda{i_lambda}
+  {
+  }
+
+  /**
+   * Claims the next chunk and runs the lambda for its indices. Returns false if all
+   * chunks have already been claimed. The lambda is never accessed after the last chunk
+   * was claimed, so a late worker cannot touch it once parallel_for has returned.
+   */
+  bool run_next_chunk()
+  {
+    const auto chunk = next_chunk.fetch_add(1);
+    if (chunk >= chunk_count)
+    {
+      return false;
+    }
+
+    if (!failed)
+    {
+      try
+      {
+        const auto begin = chunk * grain_size;
+        const auto end = std::min(count, begin + grain_size);
+        for (size_t i = begin; i < end; ++i)
+        {
+          lambda(i);
+        }
+      }
+      catch (...)
+      {
+        const auto lock = std::lock_guard{mutex};
+        if (!exception)
+        {
+          exception = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+
+    if (completed_chunks.fetch_add(1) + 1 == chunk_count)
+    {
+      const auto lock = std::lock_guard{mutex};
+      done.notify_all();
+    }
+    return true;
+  }
+
+  void wait()
+  {
+    auto lock = std::unique_lock{mutex};
+    done.wait(lock, [&]() { return completed_chunks == chunk_count; });
+  }
+};
+} // namespace detail
+
 /**
  * Runs the given lambda `count` times, passing it indices `0` through `count - 1`.
  *
- * Lambda is executed in parallel, using the number of threads returned by
- * std::thread::hardware_concurrency().
+ * The indices are split into chunks of `grain_size` consecutive indices. The chunks are
+ * executed in parallel by the worker threads of kdl::thread_pool::global() and by the
+ * calling thread. The calling thread keeps claiming chunks until none are left, so calling
+ * this function from within a lambda passed to it (or from any other pool task) cannot
+ * deadlock, even if all worker threads are busy.
  *
- * Because the threads are spawned with std::async(std::launch::async, ...) and no thread
- * pool is used, there is a relatively large overhead and this should only be used on
- * large/slow to process data sets.
+ * If the lambda throws, the remaining chunks are skipped and the first exception is
+ * rethrown to the caller once all running chunks have finished.
  *
  * @tparam L type of lambda
  * @param count the maximum value (exclusive) to pass to lambda
+ * @param grain_size the number of consecutive indices processed by one thread at a time
  * @param lambda the lambda to run
  */
 template <class L>
-void parallel_for(const size_t count, L&& lambda)
+void parallel_for(const size_t count, const size_t grain_size, L&& lambda)
 {
-#ifdef _WIN32
-  concurrency::parallel_for<size_t>(0, count, lambda);
-#else
-  size_t numThreads = static_cast<size_t>(std::thread::hardware_concurrency());
-  if (numThreads == 0)
+  if (count == 0)
   {
-    numThreads = 1;
+    return;
   }
 
-  std::atomic<size_t> nextIndex(0);
+  auto& pool = thread_pool::global();
+  const auto effective_grain_size = std::max(grain_size, size_t(1));
+  if (count <= effective_grain_size || pool.thread_count() == 0)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      lambda(i);
+    }
+    return;
+  }
 
-  std::vector<std::future<void>> threads;
-  threads.resize(numThreads);
+  using job_type = detail::parallel_for_job<std::remove_reference_t<L>>;
+  const auto job = std::make_shared<job_type>(count, effective_grain_size, lambda);
 
-  for (size_t i = 0; i < numThreads; ++i)
+  const auto helper_count = std::min(job->chunk_count - 1, pool.thread_count());
+  for (size_t i = 0; i < helper_count; ++i)
   {
-    threads[i] = std::async(std::launch::async, [&]() {
-      while (true)
+    pool.submit([job]() {
+      while (job->run_next_chunk())
       {
-        const size_t ourIndex = std::atomic_fetch_add(&nextIndex, static_cast<size_t>(1));
-        if (ourIndex >= count)
-        {
-          break;
-        }
-        lambda(ourIndex);
       }
     });
   }
 
-  for (size_t i = 0; i < numThreads; ++i)
+  while (job->run_next_chunk())
   {
-    threads[i].wait();
   }
-#endif
+  job->wait();
+
+  if (job->exception)
+  {
+    std::rethrow_exception(job->exception);
+  }
+}
+
+/**
+ * Runs the given lambda `count` times, passing it indices `0` through `count - 1`.
+ *
+ * Uses a grain size that yields about four chunks per participating thread, which
+ * balances the load for lambdas with uneven running times while keeping the scheduling
+ * overhead low. See the overload taking a grain size for details.
+ *
+ * @tparam L type of lambda
+ * @param count the maximum value (exclusive) to pass to lambda
+ * @param lambda the lambda to run
+ */
+template <class L>
+void parallel_for(const size_t count, L&& lambda)
+{
+  const auto thread_count = thread_pool::global().thread_count() + 1;
+  parallel_for(count, count / (thread_count * 4), std::forward<L>(lambda));
 }
 
 /**
  * Applies the given lambda to each element of the input (passing elements as rvalue
  * references), and returns a vector of the resulting values, in their original order.
  *
- * The lambda is executed in parallel, using the number of threads returned by
- * std::thread::hardware_concurrency().
- *
- * Because the threads are spawned with std::async(std::launch::async, ...) and no thread
- * pool is used, there is a relatively large overhead and this should only be used on
- * large/slow to process data sets.
+ * The lambda is executed in parallel using parallel_for.
  *
  * @tparam T the type of the vector elements
  * @tparam L the type of the lambda to apply
@@ -0,0 +1,226 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace kdl
+{
+/**
+ * A fixed size pool of worker threads that execute submitted tasks.
+ *
+ * Every worker owns a task queue. Tasks submitted from a worker thread are pushed onto
+ * that worker's queue and popped in LIFO order, which keeps nested work on the thread
+ * that created it. Tasks submitted from other threads are distributed over the queues
+ * round robin. A worker whose own queue is empty steals the oldest task from the queues
+ * of the other workers before it goes to sleep.
+ *
+ * Submitted tasks must not throw.
+ */
+class thread_pool
+{
+public:
+  using task = std::function<void()>;
+
+private:
+  struct task_queue
+  {
+    std::mutex mutex;
+    std::deque<task> tasks;
+  };
+
+  std::vector<std::unique_ptr<task_queue>> m_queues;
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::atomic<size_t> m_pending_count{0};
+  std::atomic<size_t> m_next_queue{0};
+  bool m_stop{false};
+
+public:
+  /**
+   * Creates a pool with the given number of worker threads. A pool without any worker
+   * threads is valid; it never runs any tasks by itself.
+   */
+  explicit thread_pool(const size_t thread_count)
+  {
+    m_queues.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+      m_queues.push_back(std::make_unique<task_queue>());
+    }
+
+    m_threads.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+      m_threads.emplace_back([this, i]() { run_worker(i); });
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  /**
+   * Finishes all pending tasks and joins the worker threads.
+   */
+  ~thread_pool()
+  {
+    {
+      const auto lock = std::lock_guard{m_mutex};
+      m_stop = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+      thread.join();
+    }
+  }
+
+  /**
+   * Returns the process wide pool. It has one worker thread less than the number of
+   * hardware threads because the threads that submit work to it are expected to take part
+   * in executing that work.
+   */
+  static thread_pool& global()
+  {
+    static auto pool = thread_pool{
+      std::max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(2)) - 1};
+    return pool;
+  }
+
+  /**
+   * Returns the number of worker threads.
+   */
+  size_t thread_count() const { return m_threads.size(); }
+
+  /**
+   * Indicates whether the calling thread is a worker thread of this pool.
+   */
+  bool is_worker_thread() const { return current_worker().pool == this; }
+
+  /**
+   * Submits the given task for execution on one of the worker threads.
+   */
+  void submit(task t)
+  {
+    if (m_queues.empty())
+    {
+      return;
+    }
+
+    const auto& worker = current_worker();
+    const auto index = worker.pool == this
+                         ? worker.index
+                         : m_next_queue.fetch_add(1) % m_queues.size();
+
+    // count the task before publishing it, otherwise a worker could pop it and
+    // decrement the counter first
+    {
+      const auto lock = std::lock_guard{m_mutex};
+      ++m_pending_count;
+    }
+
+    {
+      auto& queue = *m_queues[index];
+      const auto lock = std::lock_guard{queue.mutex};
+      queue.tasks.push_back(std::move(t));
+    }
+    m_condition.notify_one();
+  }
+
+private:
+  struct worker_info
+  {
+    const thread_pool* pool{nullptr};
+    size_t index{0};
+  };
+
+  static worker_info& current_worker()
+  {
+    thread_local auto worker = worker_info{};
+    return worker;
+  }
+
+  std::optional<task> pop_task(const size_t index)
+  {
+    // newest task from our own queue first
+    {
+      auto& queue = *m_queues[index];
+      const auto lock = std::lock_guard{queue.mutex};
+      if (!queue.tasks.empty())
+      {
+        auto result = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return result;
+      }
+    }
+
+    // then steal the oldest task of another worker
+    for (size_t i = 1; i < m_queues.size(); ++i)
+    {
+      auto& queue = *m_queues[(index + i) % m_queues.size()];
+      const auto lock = std::lock_guard{queue.mutex};
+      if (!queue.tasks.empty())
+      {
+        auto result = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return result;
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  void run_worker(const size_t index)
+  {
+    current_worker() = worker_info{this, index};
+
+    while (true)
+    {
+      if (auto t = pop_task(index))
+      {
+        --m_pending_count;
+        (*t)();
+        continue;
+      }
+
+      auto lock = std::unique_lock{m_mutex};
+      m_condition.wait(lock, [&]() { return m_stop || m_pending_count > 0; });
+      if (m_stop && m_pending_count == 0)
+      {
+        return;
+      }
+    }
+  }
+};
+} // namespace kdl
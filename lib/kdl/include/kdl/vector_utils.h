@@ -26,6 +26,7 @@
 #include <cassert>
 #include <functional>
 #include <iterator>
+#include <optional>
 #include <type_traits>
 #include <vector>
 
@@ -22,6 +22,8 @@
 #include "kdl/vector_utils.h"
 
 #include <iterator>
+#include <string>
+#include <vector>
 
 #include "catch2.h"
 
@@ -113,6 +115,43 @@ TEST_CASE("compact_trie_test.remove")
   assertMatches(index, "*", {});
 }
 
+TEST_CASE("compact_trie_test.remove_many_values")
+{
+  test_index index;
+
+  auto values = std::vector<std::string>{};
+  for (std::size_t i = 0u; i < 32u; ++i)
+  {
+    values.push_back("value" + std::to_string(i));
+    index.insert("key", values.back());
+  }
+  index.insert("key", "value0");
+  index.insert("key2", "value");
+
+  auto expected = values;
+  expected.push_back("value0");
+  assertMatches(index, "key", expected);
+
+  for (std::size_t i = 1u; i < 32u; ++i)
+  {
+    CHECK(index.remove("key", values[i]));
+  }
+  CHECK_FALSE(index.remove("key", "value1"));
+  assertMatches(index, "key", {"value0", "value0"});
+  assertMatches(index, "key*", {"value0", "value0", "value"});
+
+  CHECK(index.remove("key", "value0"));
+  CHECK(index.remove("key", "value0"));
+  assertMatches(index, "key", {});
+  assertMatches(index, "key*", {"value"});
+
+  // removed nodes are reused
+  index.insert("kez", "value3");
+  index.insert("key", "value4");
+  assertMatches(index, "ke?", {"value3", "value4"});
+  assertMatches(index, "*", {"value", "value3", "value4"});
+}
+
 TEST_CASE("compact_trie_test.find_matches_with_exact_pattern")
 {
   test_index index;
@@ -0,0 +1,202 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/object_pool.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "catch2.h"
+
+namespace kdl
+{
+namespace
+{
+struct pooled : public pool_allocated<pooled>
+{
+  int value;
+  char padding[20];
+
+  explicit pooled(const int i_value)
+    : value{i_value}
+  {
+  }
+};
+
+struct derived_pooled : public pooled
+{
+  double more;
+
+  explicit derived_pooled(const int i_value)
+    : pooled{i_value}
+    , more{0.0}
+  {
+  }
+};
+} // namespace
+
+TEST_CASE("object_pool_test.allocate_deallocate")
+{
+  using pool = object_pool<24, 8, 4>;
+  auto& p = pool::get_instance();
+
+  auto blocks = std::vector<void*>{};
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    blocks.push_back(p.allocate());
+  }
+
+  // all blocks are distinct and aligned
+  CHECK(std::unordered_set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+  for (auto* block : blocks)
+  {
+    CHECK(reinterpret_cast<std::uintptr_t>(block) % 8 == 0);
+  }
+  CHECK(p.chunk_count() == 3u);
+
+  // freed blocks are reused
+  for (auto* block : blocks)
+  {
+    p.deallocate(block);
+  }
+  for (std::size_t i = 0; i < 10; ++i)
+  {
+    blocks[i] = p.allocate();
+  }
+  CHECK(p.chunk_count() == 3u);
+
+  for (auto* block : blocks)
+  {
+    p.deallocate(block);
+  }
+}
+
+TEST_CASE("object_pool_test.reuse_blocks_of_exited_threads")
+{
+  using pool = object_pool<16, 8, 4>;
+  auto& p = pool::get_instance();
+
+  std::thread{[&]() {
+    auto* block = p.allocate();
+    p.deallocate(block);
+  }}.join();
+  REQUIRE(p.chunk_count() == 1u);
+
+  // the blocks of the exited thread are handed to this thread
+  auto blocks = std::vector<void*>{};
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    blocks.push_back(p.allocate());
+  }
+  CHECK(p.chunk_count() == 1u);
+
+  for (auto* block : blocks)
+  {
+    p.deallocate(block);
+  }
+}
+
+TEST_CASE("object_pool_test.reuse_blocks_freed_by_other_threads")
+{
+  using pool = object_pool<32, 8, 4>;
+  auto& p = pool::get_instance();
+
+  // blocks are allocated by a thread that keeps running and freed by this thread, like
+  // objects that are created by a worker and destroyed by the UI thread
+  auto allocate_requested = std::condition_variable{};
+  auto allocate_done = std::condition_variable{};
+  auto mutex = std::mutex{};
+  auto requested = std::size_t{0};
+  auto stop = false;
+  auto blocks = std::vector<void*>{};
+
+  auto worker = std::thread{[&]() {
+    auto lock = std::unique_lock{mutex};
+    while (true)
+    {
+      allocate_requested.wait(lock, [&]() { return stop || requested > 0; });
+      if (stop)
+      {
+        return;
+      }
+      for (; requested > 0; --requested)
+      {
+        blocks.push_back(p.allocate());
+      }
+      allocate_done.notify_one();
+    }
+  }};
+
+  const auto allocate_on_worker = [&](const std::size_t count) {
+    auto lock = std::unique_lock{mutex};
+    requested = count;
+    allocate_requested.notify_one();
+    allocate_done.wait(lock, [&]() { return requested == 0; });
+    return std::exchange(blocks, {});
+  };
+
+  for (std::size_t round = 0; round < 10; ++round)
+  {
+    for (auto* block : allocate_on_worker(40))
+    {
+      p.deallocate(block);
+    }
+  }
+
+  // the first round needs 10 chunks, after that the blocks freed by this thread beyond
+  // its limit of 8 are reused by the worker, which needs at most 2 more chunks
+  CHECK(p.chunk_count() <= 12u);
+
+  {
+    const auto lock = std::lock_guard{mutex};
+    stop = true;
+    allocate_requested.notify_one();
+  }
+  worker.join();
+}
+
+TEST_CASE("object_pool_test.pool_allocated")
+{
+  auto& p = object_pool<sizeof(pooled), alignof(pooled)>::get_instance();
+
+  auto objects = std::vector<std::unique_ptr<pooled>>{};
+  for (int i = 0; i < 100; ++i)
+  {
+    objects.push_back(std::make_unique<pooled>(i));
+  }
+  CHECK(p.chunk_count() == 1u);
+
+  for (int i = 0; i < 100; ++i)
+  {
+    CHECK(objects[std::size_t(i)]->value == i);
+  }
+  objects.clear();
+
+  // derived types use the global allocation functions
+  auto derived = std::make_unique<derived_pooled>(1);
+  CHECK(derived->value == 1);
+}
+} // namespace kdl
@@ -26,6 +26,7 @@
 #include <atomic>
 #include <chrono>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -140,4 +141,61 @@ TEST_CASE("overhead for small work batches")
 
   CHECK(static_cast<size_t>(counter) == OuterLoop * InnerLoop);
 }
+
+TEST_CASE("for with grain size")
+{
+  constexpr size_t TestSize = 1'001;
+
+  const auto grain_size = GENERATE(size_t(0), size_t(1), size_t(7), size_t(1'000), size_t(5'000));
+  CAPTURE(grain_size);
+
+  std::array<std::atomic<size_t>, TestSize> visits;
+  for (auto& visit : visits)
+  {
+    visit = 0;
+  }
+
+  kdl::parallel_for(TestSize, grain_size, [&](const size_t i) { ++visits[i]; });
+
+  for (size_t i = 0; i < TestSize; ++i)
+  {
+    CHECK(visits[i] == 1u);
+  }
+}
+
+TEST_CASE("nested for")
+{
+  constexpr size_t OuterSize = 64;
+  constexpr size_t InnerSize = 1'000;
+
+  auto counter = std::atomic<size_t>{0};
+  kdl::parallel_for(OuterSize, size_t(1), [&](const size_t) {
+    kdl::parallel_for(InnerSize, [&](const size_t) { ++counter; });
+  });
+
+  CHECK(static_cast<size_t>(counter) == OuterSize * InnerSize);
+}
+
+TEST_CASE("for rethrows exception")
+{
+  auto counter = std::atomic<size_t>{0};
+  CHECK_THROWS_AS(
+    kdl::parallel_for(
+      10'000,
+      size_t(10),
+      [&](const size_t i) {
+        ++counter;
+        if (i == 5'000)
+        {
+          throw std::runtime_error{"error"};
+        }
+      }),
+    std::runtime_error);
+  CHECK(static_cast<size_t>(counter) <= 10'000u);
+
+  // the pool is still usable afterwards
+  counter = 0;
+  kdl::parallel_for(100, [&](const size_t) { ++counter; });
+  CHECK(static_cast<size_t>(counter) == 100u);
+}
 } // namespace kdl
@@ -0,0 +1,78 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "kdl/thread_pool.h"
+
+#include <atomic>
+
+#include "catch2.h"
+
+namespace kdl
+{
+TEST_CASE("thread_pool.submit")
+{
+  auto counter = std::atomic<size_t>{0};
+  auto on_worker_thread = std::atomic<size_t>{0};
+
+  {
+    auto pool = thread_pool{4};
+    CHECK(pool.thread_count() == 4u);
+    CHECK_FALSE(pool.is_worker_thread());
+
+    for (size_t i = 0; i < 1'000; ++i)
+    {
+      pool.submit([&]() {
+        ++counter;
+        if (pool.is_worker_thread())
+        {
+          ++on_worker_thread;
+        }
+      });
+    }
+  } // the destructor runs all pending tasks
+
+  CHECK(static_cast<size_t>(counter) == 1'000u);
+  CHECK(static_cast<size_t>(on_worker_thread) == 1'000u);
+}
+
+TEST_CASE("thread_pool.submitFromWorker")
+{
+  auto counter = std::atomic<size_t>{0};
+
+  {
+    auto pool = thread_pool{2};
+    for (size_t i = 0; i < 100; ++i)
+    {
+      pool.submit([&]() {
+        ++counter;
+        pool.submit([&]() { ++counter; });
+      });
+    }
+  }
+
+  CHECK(static_cast<size_t>(counter) == 200u);
+}
+
+TEST_CASE("thread_pool.global")
+{
+  CHECK(&thread_pool::global() == &thread_pool::global());
+  CHECK(thread_pool::global().thread_count() > 0u);
+}
+} // namespace kdl
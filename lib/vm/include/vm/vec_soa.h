@@ -0,0 +1,546 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "vm/bbox.h"
+#include "vm/constants.h"
+#include "vm/mat.h"
+#include "vm/plane.h"
+#include "vm/ray.h"
+#include "vm/scalar.h"
+#include "vm/util.h"
+#include "vm/vec.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace vm
+{
+/**
+ * A sequence of vectors that is stored as one contiguous array per component (structure
+ * of arrays).
+ *
+ * The batch functions below process such sequences in simple loops over the component
+ * arrays without any data dependent branches, so that the compiler can vectorize them
+ * for whatever instruction set it targets. They evaluate the same expressions in the same
+ * order as the corresponding functions that process one vector at a time.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ */
+template <typename T, std::size_t S>
+class vec_soa
+{
+  static_assert(S > 0, "vec_soa must have at least one component");
+
+private:
+  std::array<std::vector<T>, S> m_components;
+
+public:
+  /**
+   * Creates a new empty sequence.
+   */
+  vec_soa() = default;
+
+  /**
+   * Creates a new sequence containing the vectors in the given range.
+   *
+   * @tparam I the iterator type
+   * @tparam G the type of the function that transforms the iterated type to a vector
+   * @param cur the start of the range
+   * @param end the end of the range
+   * @param get the function that transforms the iterated type to a vector
+   */
+  template <typename I, typename G = identity>
+  vec_soa(I cur, I end, const G& get = G())
+  {
+    while (cur != end)
+    {
+      push_back(get(*cur));
+      ++cur;
+    }
+  }
+
+  /**
+   * Creates a new sequence containing the given vectors.
+   */
+  explicit vec_soa(const std::vector<vec<T, S>>& vecs)
+  {
+    reserve(vecs.size());
+    for (const auto& v : vecs)
+    {
+      push_back(v);
+    }
+  }
+
+  /**
+   * Returns the number of vectors in this sequence.
+   */
+  std::size_t size() const { return m_components[0].size(); }
+
+  /**
+   * Indicates whether this sequence is empty.
+   */
+  bool empty() const { return m_components[0].empty(); }
+
+  /**
+   * Reserves memory for the given number of vectors.
+   */
+  void reserve(const std::size_t capacity)
+  {
+    for (auto& component : m_components)
+    {
+      component.reserve(capacity);
+    }
+  }
+
+  /**
+   * Removes all vectors from this sequence, but keeps the allocated memory.
+   */
+  void clear()
+  {
+    for (auto& component : m_components)
+    {
+      component.clear();
+    }
+  }
+
+  /**
+   * Appends the given vector to this sequence.
+   */
+  void push_back(const vec<T, S>& v)
+  {
+    for (std::size_t i = 0; i < S; ++i)
+    {
+      m_components[i].push_back(v[i]);
+    }
+  }
+
+  /**
+   * Returns the vector at the given index.
+   */
+  vec<T, S> operator[](const std::size_t index) const
+  {
+    assert(index < size());
+    vec<T, S> result;
+    for (std::size_t i = 0; i < S; ++i)
+    {
+      result[i] = m_components[i][index];
+    }
+    return result;
+  }
+
+  /**
+   * Returns the values of the given component of all vectors.
+   */
+  const T* component(const std::size_t i) const
+  {
+    assert(i < S);
+    return m_components[i].data();
+  }
+
+  /**
+   * Returns the values of the given component of all vectors.
+   */
+  T* component(const std::size_t i)
+  {
+    assert(i < S);
+    return m_components[i].data();
+  }
+
+  /**
+   * Returns a vector containing the vectors in this sequence.
+   */
+  std::vector<vec<T, S>> to_vector() const
+  {
+    std::vector<vec<T, S>> result;
+    result.reserve(size());
+    for (std::size_t i = 0; i < size(); ++i)
+    {
+      result.push_back((*this)[i]);
+    }
+    return result;
+  }
+};
+
+/**
+ * The number of points above, below and inside a plane.
+ */
+struct plane_status_count
+{
+  std::size_t above = 0u;
+  std::size_t below = 0u;
+  std::size_t inside = 0u;
+};
+
+/**
+ * Computes the distances of the given points to the given plane, see
+ * plane::point_distance.
+ *
+ * @tparam T the component type
+ * @param p the plane
+ * @param points the points
+ * @return the distances of the points, in the order of the points
+ */
+template <typename T>
+std::vector<T> point_distances(const plane<T, 3>& p, const vec_soa<T, 3>& points)
+{
+  const auto count = points.size();
+  const auto* x = points.component(0);
+  const auto* y = points.component(1);
+  const auto* z = points.component(2);
+
+  auto result = std::vector<T>(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    result[i] =
+      T(0) + x[i] * p.normal[0] + y[i] * p.normal[1] + z[i] * p.normal[2] - p.distance;
+  }
+  return result;
+}
+
+/**
+ * Determines the relative positions of the given points to the given plane, see
+ * plane::point_status.
+ *
+ * @tparam T the component type
+ * @param p the plane
+ * @param points the points
+ * @param epsilon the maximum absolute distance up to which a point will be considered to
+ * be inside
+ * @return the positions of the points, in the order of the points
+ */
+template <typename T>
+std::vector<plane_status> point_status(
+  const plane<T, 3>& p,
+  const vec_soa<T, 3>& points,
+  const T epsilon = constants<T>::point_status_epsilon())
+{
+  const auto distances = point_distances(p, points);
+
+  auto result = std::vector<plane_status>(distances.size());
+  for (std::size_t i = 0; i < distances.size(); ++i)
+  {
+    const auto dist = distances[i];
+    result[i] = dist > epsilon    ? plane_status::above
+                : dist < -epsilon ? plane_status::below
+                                  : plane_status::inside;
+  }
+  return result;
+}
+
+/**
+ * Counts how many of the points in the given index range are above, below and inside the
+ * given plane, see plane::point_status.
+ *
+ * Callers that only need to know whether there are points on both sides of the plane can
+ * count the points in small blocks and stop as soon as they have found such points.
+ *
+ * @tparam T the component type
+ * @param p the plane
+ * @param points the points
+ * @param first the index of the first point to count
+ * @param last the index after the last point to count
+ * @param epsilon the maximum absolute distance up to which a point will be considered to
+ * be inside
+ * @return the number of points above, below and inside the plane
+ */
+template <typename T>
+plane_status_count count_point_status(
+  const plane<T, 3>& p,
+  const vec_soa<T, 3>& points,
+  const std::size_t first,
+  const std::size_t last,
+  const T epsilon = constants<T>::point_status_epsilon())
+{
+  assert(first <= last && last <= points.size());
+
+  const auto* x = points.component(0);
+  const auto* y = points.component(1);
+  const auto* z = points.component(2);
+
+  auto above = std::size_t(0);
+  auto below = std::size_t(0);
+  for (std::size_t i = first; i < last; ++i)
+  {
+    const auto dist =
+      T(0) + x[i] * p.normal[0] + y[i] * p.normal[1] + z[i] * p.normal[2] - p.distance;
+    above += dist > epsilon ? 1u : 0u;
+    below += dist < -epsilon ? 1u : 0u;
+  }
+  return {above, below, last - first - above - below};
+}
+
+/**
+ * Counts how many of the given points are above, below and inside the given plane, see
+ * plane::point_status.
+ *
+ * @tparam T the component type
+ * @param p the plane
+ * @param points the points
+ * @param epsilon the maximum absolute distance up to which a point will be considered to
+ * be inside
+ * @return the number of points above, below and inside the plane
+ */
+template <typename T>
+plane_status_count count_point_status(
+  const plane<T, 3>& p,
+  const vec_soa<T, 3>& points,
+  const T epsilon = constants<T>::point_status_epsilon())
+{
+  return count_point_status(p, points, 0u, points.size(), epsilon);
+}
+
+/**
+ * Transforms the given points by the given matrix, see operator*(const mat<T, R, C>&,
+ * const vec<T, C - 1>&).
+ *
+ * @tparam T the component type
+ * @param m the transformation matrix
+ * @param points the points to transform
+ * @return the transformed points, in the order of the given points
+ */
+template <typename T>
+vec_soa<T, 3> transform(const mat<T, 4, 4>& m, const vec_soa<T, 3>& points)
+{
+  const auto count = points.size();
+  const auto* x = points.component(0);
+  const auto* y = points.component(1);
+  const auto* z = points.component(2);
+
+  auto result = points;
+  auto* rx = result.component(0);
+  auto* ry = result.component(1);
+  auto* rz = result.component(2);
+
+  // the terms are accumulated in the same order as in the matrix vector product
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const auto tx = T(0) + m[0][0] * x[i] + m[1][0] * y[i] + m[2][0] * z[i] + m[3][0];
+    const auto ty = T(0) + m[0][1] * x[i] + m[1][1] * y[i] + m[2][1] * z[i] + m[3][1];
+    const auto tz = T(0) + m[0][2] * x[i] + m[1][2] * y[i] + m[2][2] * z[i] + m[3][2];
+    const auto tw = T(0) + m[0][3] * x[i] + m[1][3] * y[i] + m[2][3] * z[i] + m[3][3];
+    rx[i] = tx / tw;
+    ry[i] = ty / tw;
+    rz[i] = tz / tw;
+  }
+  return result;
+}
+
+/**
+ * Computes the smallest bounding box containing the given points. If no points are given,
+ * an empty bounding box at the origin is returned.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ * @param points the points
+ * @return the bounding box
+ */
+template <typename T, std::size_t S>
+bbox<T, S> bounds(const vec_soa<T, S>& points)
+{
+  if (points.empty())
+  {
+    return bbox<T, S>();
+  }
+
+  // Compilers will not vectorize a floating point min / max reduction on their own because
+  // that might change the result for NaN values, so we keep several independent minima and
+  // maxima and merge them at the end.
+  constexpr auto lanes = std::size_t(4);
+
+  const auto count = points.size();
+  const auto vectorizedCount = count - count % lanes;
+
+  bbox<T, S> result;
+  for (std::size_t c = 0; c < S; ++c)
+  {
+    const auto* values = points.component(c);
+
+    T min[lanes];
+    T max[lanes];
+    for (std::size_t l = 0; l < lanes; ++l)
+    {
+      min[l] = max[l] = values[0];
+    }
+
+    for (std::size_t i = 0; i < vectorizedCount; i += lanes)
+    {
+      for (std::size_t l = 0; l < lanes; ++l)
+      {
+        min[l] = values[i + l] < min[l] ? values[i + l] : min[l];
+        max[l] = values[i + l] > max[l] ? values[i + l] : max[l];
+      }
+    }
+    for (std::size_t i = vectorizedCount; i < count; ++i)
+    {
+      min[0] = values[i] < min[0] ? values[i] : min[0];
+      max[0] = values[i] > max[0] ? values[i] : max[0];
+    }
+
+    result.min[c] = min[0];
+    result.max[c] = max[0];
+    for (std::size_t l = 1; l < lanes; ++l)
+    {
+      result.min[c] = min[l] < result.min[c] ? min[l] : result.min[c];
+      result.max[c] = max[l] > result.max[c] ? max[l] : result.max[c];
+    }
+  }
+  return result;
+}
+
+/**
+ * Computes the points of intersection of the given ray and the given triangles, see
+ * intersect_ray_triangle. The i-th triangle is given by the i-th elements of p1, p2 and
+ * p3.
+ *
+ * @tparam T the component type
+ * @param r the ray
+ * @param p1 the first points of the triangles
+ * @param p2 the second points of the triangles
+ * @param p3 the third points of the triangles
+ * @return for each triangle, the distance to the point of intersection or NaN if the ray
+ * does not intersect the triangle
+ */
+template <typename T>
+std::vector<T> intersect_ray_triangles(
+  const ray<T, 3>& r,
+  const vec_soa<T, 3>& p1,
+  const vec_soa<T, 3>& p2,
+  const vec_soa<T, 3>& p3)
+{
+  assert(p1.size() == p2.size() && p1.size() == p3.size());
+
+  const auto count = p1.size();
+  const auto& o = r.origin;
+  const auto& d = r.direction;
+  const auto epsilon = constants<T>::almost_zero();
+
+  auto result = std::vector<T>(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const auto x1 = p1.component(0)[i], y1 = p1.component(1)[i], z1 = p1.component(2)[i];
+
+    // e1 = p2 - p1, e2 = p3 - p1
+    const auto e1x = p2.component(0)[i] - x1;
+    const auto e1y = p2.component(1)[i] - y1;
+    const auto e1z = p2.component(2)[i] - z1;
+    const auto e2x = p3.component(0)[i] - x1;
+    const auto e2y = p3.component(1)[i] - y1;
+    const auto e2z = p3.component(2)[i] - z1;
+
+    // p = cross(d, e2), a = dot(p, e1)
+    const auto px = d[1] * e2z - d[2] * e2y;
+    const auto py = d[2] * e2x - d[0] * e2z;
+    const auto pz = d[0] * e2y - d[1] * e2x;
+    const auto a = T(0) + px * e1x + py * e1y + pz * e1z;
+
+    // t = o - p1, q = cross(t, e1)
+    const auto tx = o[0] - x1;
+    const auto ty = o[1] - y1;
+    const auto tz = o[2] - z1;
+    const auto qx = ty * e1z - tz * e1y;
+    const auto qy = tz * e1x - tx * e1z;
+    const auto qz = tx * e1y - ty * e1x;
+
+    const auto u = (T(0) + qx * e2x + qy * e2y + qz * e2z) / a;
+    const auto v = (T(0) + px * tx + py * ty + pz * tz) / a;
+    const auto w = (T(0) + qx * d[0] + qy * d[1] + qz * d[2]) / a;
+
+    const auto hit = !is_zero(a, epsilon) && !(u < -epsilon) && !(v < -epsilon)
+                     && !(w < -epsilon) && !(v + w - T(1) > epsilon);
+    result[i] = hit ? u : nan<T>();
+  }
+  return result;
+}
+
+/**
+ * Computes the points of intersection of the given ray and the given bounding boxes, see
+ * intersect_ray_bbox. The i-th bounding box is given by the i-th elements of min and max.
+ *
+ * @tparam T the component type
+ * @tparam S the number of components
+ * @param r the ray
+ * @param min the minimum points of the bounding boxes
+ * @param max the maximum points of the bounding boxes
+ * @return for each bounding box, the distance to the closest intersection point, or NaN
+ * if the ray does not intersect the bounding box
+ */
+template <typename T, std::size_t S>
+std::vector<T> intersect_ray_bboxes(
+  const ray<T, S>& r, const vec_soa<T, S>& min, const vec_soa<T, S>& max)
+{
+  assert(min.size() == max.size());
+
+  const auto count = min.size();
+
+  auto result = std::vector<T>(count);
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    // compute the candidate planes and their distances
+    T distances[S]{};
+    bool inside[S]{};
+    auto allInside = true;
+    for (std::size_t c = 0; c < S; ++c)
+    {
+      const auto bmin = min.component(c)[i];
+      const auto bmax = max.component(c)[i];
+      const auto below = r.origin[c] < bmin;
+      const auto above = !below && r.origin[c] > bmax;
+      const auto origin = below ? bmin
+                          : above
+                            ? bmax
+                            : (r.direction[c] < T(0) ? bmin : bmax);
+      inside[c] = !below && !above;
+      allInside = allInside && inside[c];
+      distances[c] =
+        r.direction[c] != T(0) ? (origin - r.origin[c]) / r.direction[c] : T(-1);
+    }
+
+    // select the closest hit plane if the origin is inside, otherwise the farthest
+    auto bestPlane = std::size_t(0);
+    auto distance = distances[0];
+    auto found = false;
+    for (std::size_t c = 0; c < S; ++c)
+    {
+      const auto better = allInside ? distances[c] < distance
+                                    : !inside[c] && (!found || distances[c] > distance);
+      bestPlane = better ? c : bestPlane;
+      distance = better ? distances[c] : distance;
+      found = found || !inside[c];
+    }
+
+    // check whether the final candidate actually hits the box
+    auto hit = !(distance < T(0));
+    for (std::size_t c = 0; c < S; ++c)
+    {
+      const auto coord = r.origin[c] + distance * r.direction[c];
+      hit = hit
+            && (bestPlane == c
+                || !(coord < min.component(c)[i] || coord > max.component(c)[i]));
+    }
+    result[i] = hit ? distance : nan<T>();
+  }
+  return result;
+}
+} // namespace vm
@@ -0,0 +1,306 @@
+/*
+ Copyright 2023 Kristian Duske
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ software and associated documentation files (the "Software"), to deal in the Software
+ without restriction, including without limitation the rights to use, copy, modify, merge,
+ publish, distribute, sublicense, and/or sell copies of the Software, and to permit
+ persons to whom the Software is furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all copies or
+ substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+*/
+
+#include "vm/approx.h"
+#include "vm/bbox.h"
+#include "vm/bbox_io.h"
+#include "vm/forward.h"
+#include "vm/intersection.h"
+#include "vm/mat.h"
+#include "vm/mat_ext.h"
+#include "vm/plane.h"
+#include "vm/ray.h"
+#include "vm/scalar.h"
+#include "vm/vec.h"
+#include "vm/vec_io.h"
+#include "vm/vec_soa.h"
+
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace vm
+{
+namespace
+{
+std::vector<vec3d> make_points()
+{
+  return {
+    vec3d(0.0, 0.0, 0.0),
+    vec3d(1.0, 2.0, 3.0),
+    vec3d(-4.0, 5.0, -6.0),
+    vec3d(7.0, -8.0, 9.0),
+    vec3d(0.0, 0.0, 1.0),
+    vec3d(0.0, 0.0, -1.0),
+    vec3d(12.0, 0.0, 1.0),
+    vec3d(-3.0, -3.0, 0.0),
+    vec3d(5.0, 5.0, 5.0),
+    vec3d(-9.0, 1.0, 2.0),
+    vec3d(2.0, -7.0, -1.0),
+  };
+}
+} // namespace
+
+TEST_CASE("vec_soa.constructor_default")
+{
+  const auto soa = vec_soa<double, 3>();
+  CHECK(soa.empty());
+  CHECK(soa.size() == 0u);
+}
+
+TEST_CASE("vec_soa.constructor_with_vectors")
+{
+  const auto points = make_points();
+  const auto soa = vec_soa<double, 3>(points);
+
+  CHECK_FALSE(soa.empty());
+  CHECK(soa.size() == points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    CHECK(soa[i] == points[i]);
+    CHECK(soa.component(0)[i] == points[i].x());
+    CHECK(soa.component(1)[i] == points[i].y());
+    CHECK(soa.component(2)[i] == points[i].z());
+  }
+  CHECK(soa.to_vector() == points);
+}
+
+TEST_CASE("vec_soa.constructor_with_range")
+{
+  const auto planes = std::vector<plane3d>{
+    plane3d(1.0, vec3d::pos_x()),
+    plane3d(2.0, vec3d::pos_y()),
+  };
+  const auto soa = vec_soa<double, 3>(
+    std::begin(planes), std::end(planes), [](const auto& p) { return p.normal; });
+
+  CHECK(soa.to_vector() == std::vector<vec3d>{vec3d::pos_x(), vec3d::pos_y()});
+}
+
+TEST_CASE("vec_soa.push_back")
+{
+  auto soa = vec_soa<float, 2>();
+  soa.push_back(vec2f(1.0f, 2.0f));
+  soa.push_back(vec2f(3.0f, 4.0f));
+
+  CHECK(soa.size() == 2u);
+  CHECK(soa[0] == vec2f(1.0f, 2.0f));
+  CHECK(soa[1] == vec2f(3.0f, 4.0f));
+}
+
+TEST_CASE("vec_soa.clear")
+{
+  auto soa = vec_soa<double, 3>(make_points());
+  soa.clear();
+
+  CHECK(soa.empty());
+  CHECK(soa.size() == 0u);
+}
+
+TEST_CASE("vec_soa.point_distances")
+{
+  const auto points = make_points();
+  const auto soa = vec_soa<double, 3>(points);
+  const auto p = plane3d(vec3d(1.0, 2.0, 1.0), normalize(vec3d(1.0, -2.0, 3.0)));
+
+  const auto distances = point_distances(p, soa);
+  REQUIRE(distances.size() == points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    CHECK(distances[i] == approx(p.point_distance(points[i])));
+  }
+}
+
+TEST_CASE("vec_soa.point_status")
+{
+  const auto points = make_points();
+  const auto soa = vec_soa<double, 3>(points);
+  const auto p = plane3d(0.0, vec3d::pos_z());
+
+  const auto status = point_status(p, soa);
+  REQUIRE(status.size() == points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    CHECK(status[i] == p.point_status(points[i]));
+  }
+
+  CHECK(point_status(p, vec_soa<double, 3>()).empty());
+}
+
+TEST_CASE("vec_soa.count_point_status")
+{
+  const auto points = make_points();
+  const auto soa = vec_soa<double, 3>(points);
+  const auto p = plane3d(0.0, vec3d::pos_z());
+
+  const auto count = count_point_status(p, soa);
+  CHECK(count.above == 6u);
+  CHECK(count.below == 3u);
+  CHECK(count.inside == 2u);
+
+  const auto rangeCount = count_point_status(p, soa, 3u, 6u);
+  CHECK(rangeCount.above == 2u);
+  CHECK(rangeCount.below == 1u);
+  CHECK(rangeCount.inside == 0u);
+
+  const auto emptyCount = count_point_status(p, soa, 4u, 4u);
+  CHECK(emptyCount.above == 0u);
+  CHECK(emptyCount.below == 0u);
+  CHECK(emptyCount.inside == 0u);
+
+  const auto epsilonCount = count_point_status(p, soa, 1.0);
+  CHECK(epsilonCount.above == 4u);
+  CHECK(epsilonCount.below == 1u);
+  CHECK(epsilonCount.inside == 6u);
+}
+
+TEST_CASE("vec_soa.transform")
+{
+  const auto points = make_points();
+  const auto soa = vec_soa<double, 3>(points);
+
+  const auto m = translation_matrix(vec3d(1.0, -2.0, 3.0))
+                 * rotation_matrix(to_radians(15.0), to_radians(30.0), to_radians(45.0))
+                 * scaling_matrix(vec3d(2.0, 3.0, 4.0));
+
+  const auto transformed = transform(m, soa);
+  REQUIRE(transformed.size() == points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+  {
+    CHECK(transformed[i] == approx(m * points[i]));
+  }
+}
+
+TEST_CASE("vec_soa.bounds")
+{
+  CHECK(bounds(vec_soa<double, 3>()) == bbox3d());
+
+  const auto single = std::vector<vec3d>{vec3d(1.0, 2.0, 3.0)};
+  CHECK(
+    bounds(vec_soa<double, 3>(single))
+    == bbox3d(vec3d(1.0, 2.0, 3.0), vec3d(1.0, 2.0, 3.0)));
+
+  const auto points = make_points();
+  CHECK(
+    bounds(vec_soa<double, 3>(points))
+    == bbox3d::merge_all(std::begin(points), std::end(points)));
+
+  // more points than fit into the vectorized loop
+  auto morePoints = points;
+  morePoints.insert(std::end(morePoints), std::begin(points), std::end(points));
+  morePoints.push_back(vec3d(-20.0, 20.0, 0.0));
+  CHECK(
+    bounds(vec_soa<double, 3>(morePoints))
+    == bbox3d::merge_all(std::begin(morePoints), std::end(morePoints)));
+}
+
+TEST_CASE("vec_soa.intersect_ray_triangles")
+{
+  auto p1 = vec_soa<double, 3>();
+  auto p2 = vec_soa<double, 3>();
+  auto p3 = vec_soa<double, 3>();
+
+  const auto add_triangle = [&](const vec3d& a, const vec3d& b, const vec3d& c) {
+    p1.push_back(a);
+    p2.push_back(b);
+    p3.push_back(c);
+  };
+
+  // same triangle as in intersection.intersect_ray_triangle
+  add_triangle(vec3d(2.0, 5.0, 2.0), vec3d(4.0, 7.0, 2.0), vec3d(3.0, 2.0, 2.0));
+  // degenerate triangle
+  add_triangle(vec3d(0.0, 0.0, 2.0), vec3d(1.0, 0.0, 2.0), vec3d(2.0, 0.0, 2.0));
+  // triangle behind the ray origins
+  add_triangle(vec3d(0.0, 0.0, -2.0), vec3d(8.0, 0.0, -2.0), vec3d(0.0, 8.0, -2.0));
+  // large triangle
+  add_triangle(vec3d(-8.0, -8.0, 4.0), vec3d(8.0, -8.0, 4.0), vec3d(0.0, 8.0, 6.0));
+
+  const auto rays = std::vector<ray3d>{
+    ray3d(vec3d::zero(), vec3d::pos_x()),
+    ray3d(vec3d::zero(), vec3d::pos_z()),
+    ray3d(vec3d(0.0, 0.0, 2.0), vec3d::pos_y()),
+    ray3d(vec3d(3.0, 5.0, 0.0), vec3d::pos_z()),
+    ray3d(vec3d(2.0, 5.0, 0.0), vec3d::pos_z()),
+    ray3d(vec3d(3.0, 2.0, 0.0), vec3d::pos_z()),
+    ray3d(vec3d(1.0, 1.0, -4.0), normalize(vec3d(0.1, 0.2, 1.0))),
+  };
+
+  for (const auto& r : rays)
+  {
+    const auto distances = intersect_ray_triangles(r, p1, p2, p3);
+    REQUIRE(distances.size() == p1.size());
+    for (std::size_t i = 0; i < p1.size(); ++i)
+    {
+      const auto expected = intersect_ray_triangle(r, p1[i], p2[i], p3[i]);
+      if (is_nan(expected))
+      {
+        CHECK(is_nan(distances[i]));
+      }
+      else
+      {
+        CHECK(distances[i] == approx(expected));
+      }
+    }
+  }
+}
+
+TEST_CASE("vec_soa.intersect_ray_bboxes")
+{
+  const auto boxes = std::vector<bbox3f>{
+    // same bounding box as in intersection.intersect_ray_bbox
+    bbox3f(vec3f(-12.0f, -3.0f, 4.0f), vec3f(8.0f, 9.0f, 8.0f)),
+    bbox3f(vec3f(-1.0f, -1.0f, -1.0f), vec3f(1.0f, 1.0f, 1.0f)),
+    bbox3f(vec3f(2.0f, 2.0f, 2.0f), vec3f(3.0f, 3.0f, 3.0f)),
+    bbox3f(vec3f(-4.0f, -4.0f, -8.0f), vec3f(4.0f, 4.0f, -6.0f)),
+  };
+
+  const auto min = vec_soa<float, 3>(
+    std::begin(boxes), std::end(boxes), [](const auto& b) { return b.min; });
+  const auto max = vec_soa<float, 3>(
+    std::begin(boxes), std::end(boxes), [](const auto& b) { return b.max; });
+
+  const auto rays = std::vector<ray3f>{
+    ray3f(vec3f::zero(), vec3f::neg_z()),
+    ray3f(vec3f::zero(), vec3f::pos_z()),
+    ray3f(vec3f::zero(), normalize(vec3f(1.0f, 1.0f, 1.0f))),
+    ray3f(vec3f(-10.0f, -7.0f, 14.0f), normalize(vec3f(8.0f, 10.0f, -6.0f))),
+    ray3f(vec3f(0.5f, 0.5f, 0.5f), normalize(vec3f(1.0f, -2.0f, 0.5f))),
+    ray3f(vec3f(10.0f, 10.0f, 10.0f), vec3f::neg_x()),
+  };
+
+  for (const auto& r : rays)
+  {
+    const auto distances = intersect_ray_bboxes(r, min, max);
+    REQUIRE(distances.size() == boxes.size());
+    for (std::size_t i = 0; i < boxes.size(); ++i)
+    {
+      const auto expected = intersect_ray_bbox(r, boxes[i]);
+      if (is_nan(expected))
+      {
+        CHECK(is_nan(distances[i]));
+      }
+      else
+      {
+        CHECK(distances[i] == approx(expected));
+      }
+    }
+  }
+}
+} // namespace vm